@@ -0,0 +1,20 @@
+SET(ZSTD_ROOT_DIR "" CACHE PATH "Zstandard root directory")
+
+FIND_PATH(ZSTD_INCLUDE_DIR
+  zstd.h
+  HINTS ${ZSTD_ROOT_DIR}/include
+)
+FIND_LIBRARY(ZSTD_LIBRARY
+  zstd
+  HINTS ${ZSTD_ROOT_DIR}/lib
+)
+
+INCLUDE(FindPackageHandleStandardArgs)
+FIND_PACKAGE_HANDLE_STANDARD_ARGS(ZSTD DEFAULT_MSG ZSTD_LIBRARY ZSTD_INCLUDE_DIR)
+
+IF(ZSTD_FOUND)
+  SET(ZSTD_INCLUDE_DIRS ${ZSTD_INCLUDE_DIR})
+  SET(ZSTD_LIBRARIES ${ZSTD_LIBRARY})
+ENDIF(ZSTD_FOUND)
+
+MARK_AS_ADVANCED(ZSTD_LIBRARY ZSTD_INCLUDE_DIR)
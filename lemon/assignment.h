@@ -0,0 +1,733 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_ASSIGNMENT_H
+#define LEMON_ASSIGNMENT_H
+
+/// \ingroup matching
+/// \file
+/// \brief Auction and shortest augmenting path algorithms for the
+/// assignment problem.
+
+#include <vector>
+#include <limits>
+
+#include <lemon/core.h>
+#include <lemon/maps.h>
+#include <lemon/bin_heap.h>
+#include <lemon/bipartite_matching.h>
+#include <lemon/bits/parallel.h>
+
+namespace lemon {
+
+  namespace _assignment_bits {
+
+    template <typename V, bool integer = std::numeric_limits<V>::is_integer>
+    struct LargeValueSelector {
+      typedef double LargeValue;
+    };
+
+    template <typename V>
+    struct LargeValueSelector<V, true> {
+#ifdef LEMON_HAVE_LONG_LONG
+      typedef long long LargeValue;
+#else
+      typedef long LargeValue;
+#endif
+    };
+
+  }
+
+  /// \addtogroup matching
+  /// @{
+
+  /// \brief Algorithms for the assignment problem.
+  ///
+  /// This class solves the assignment problem, i.e. it finds a perfect
+  /// matching of maximum total weight in a bipartite graph that has
+  /// the same number of red and blue nodes. For this problem it is a
+  /// much lighter alternative of \ref MaxWeightedPerfectMatching,
+  /// since it exploits that blossoms cannot occur.
+  ///
+  /// Two methods are implemented (see \ref Method).
+  /// - \ref AUCTION The forward/reverse auction algorithm with
+  ///   epsilon-scaling \cite bertsekas88auction,
+  ///   \cite bertsekas93reverse. The bids of the red nodes can be
+  ///   computed by several threads (see \ref threadNum()).
+  /// - \ref SHORTEST_PATH A Jonker-Volgenant style shortest augmenting
+  ///   path algorithm \cite jonker87shortest, which augments the
+  ///   matching along Dijkstra shortest paths with respect to the
+  ///   reduced weights.
+  ///
+  /// The algorithm can be executed with the run() function.
+  /// After it the matching can be obtained using the query functions,
+  /// which are the same as the primal query functions of
+  /// \ref MaxWeightedPerfectMatching.
+  ///
+  /// \tparam BGR The bipartite graph type the algorithm runs on.
+  /// \tparam WM The type edge weight map. The default type is
+  /// \ref concepts::BpGraph::EdgeMap "BGR::EdgeMap<int>".
+  ///
+  /// \warning If the weights are not integer, the auction method finds
+  /// a matching whose weight is optimal only up to a small relative
+  /// error (about 10<sup>-9</sup>). Use the \ref SHORTEST_PATH method
+  /// if the exact optimum is required for such weights.
+#ifdef DOXYGEN
+  template <typename BGR, typename WM>
+#else
+  template <typename BGR,
+            typename WM = typename BGR::template EdgeMap<int> >
+#endif
+  class Assignment {
+  public:
+
+    /// The bipartite graph type of the algorithm
+    typedef BGR BpGraph;
+    /// The type of the edge weight map
+    typedef WM WeightMap;
+    /// The value type of the edge weights
+    typedef typename WeightMap::Value Value;
+
+    /// The type of the matching map
+    typedef typename BpGraph::template NodeMap<typename BpGraph::Arc>
+    MatchingMap;
+
+    /// \brief Constants for selecting the method of the algorithm.
+    ///
+    /// Enum type containing constants for selecting the method
+    /// of the \ref run() function.
+    enum Method {
+      /// Forward/reverse auction algorithm with epsilon-scaling.
+      AUCTION,
+      /// Jonker-Volgenant style shortest augmenting path algorithm.
+      SHORTEST_PATH
+    };
+
+  private:
+
+    TEMPLATE_BPGRAPH_TYPEDEFS(BpGraph);
+
+    typedef typename _assignment_bits::LargeValueSelector<Value>::LargeValue
+    LargeValue;
+
+    typedef std::vector<int> IntVector;
+    typedef std::vector<LargeValue> LargeValueVector;
+
+  private:
+
+    const BpGraph &_graph;
+    const WeightMap &_weight;
+
+    MatchingMap *_matching;
+
+    int _thread_num;
+
+    // The red and the blue nodes in the order of their indices
+    std::vector<Node> _red_nodes;
+    std::vector<Node> _blue_nodes;
+
+    // The edges grouped by their red nodes: the edges of the i-th red
+    // node are at the positions [_first[i], _first[i+1]).
+    IntVector _first;
+    IntVector _source;
+    IntVector _target;
+    std::vector<Edge> _edges;
+    LargeValueVector _cost;
+
+    // The positions of the edges grouped by their blue nodes
+    IntVector _blue_first;
+    IntVector _blue_arc;
+
+    // The matching edges of the red and the blue nodes (or -1)
+    IntVector _red_mate;
+    IntVector _blue_mate;
+
+    // Prices of the blue nodes and profits of the red nodes
+    LargeValueVector _price;
+    LargeValueVector _profit;
+
+    // Data of the auction rounds
+    IntVector _bidders;
+    IntVector _next_bidders;
+    IntVector _bid_arc;
+    LargeValueVector _bid_value;
+    IntVector _winner;
+    IntVector _touched;
+    IntVector _free_objects;
+    LargeValue _epsilon;
+    LargeValue _delta;
+
+    // Data of the shortest path searches
+    LargeValueVector _dist;
+    IntVector _pred;
+
+  public:
+
+    /// \brief Constructor
+    ///
+    /// Constructor.
+    Assignment(const BpGraph &graph, const WeightMap &weight)
+      : _graph(graph), _weight(weight), _matching(0), _thread_num(1)
+    {}
+
+    ~Assignment() {
+      if (_matching) {
+        delete _matching;
+      }
+    }
+
+    /// \brief Set the number of threads used by the algorithm.
+    ///
+    /// This function sets the number of threads used by the algorithm.
+    /// The default value is 1, i.e. the algorithm runs serially.
+    /// A value less than 1 means the number of available processors.
+    ///
+    /// The threads compute the bids of the auction rounds, so this
+    /// setting affects only the \ref AUCTION method. The bids are
+    /// evaluated in the same order regardless of the number of threads,
+    /// hence the found matching does not depend on this setting.
+    /// If LEMON is built without threading support, this setting
+    /// has no effect.
+    ///
+    /// \return <tt>(*this)</tt>
+    Assignment& threadNum(int num) {
+      _thread_num = num < 1 ? bits::hardwareThreadNum() : num;
+      return *this;
+    }
+
+    /// \brief Return the number of threads used by the algorithm.
+    ///
+    /// This function returns the number of threads used by the algorithm.
+    int threadNum() const {
+      return _thread_num;
+    }
+
+    /// \name Execution Control
+    /// The simplest way to execute the algorithm is to use the
+    /// \ref run() member function.
+
+    /// @{
+
+    /// \brief Run the algorithm.
+    ///
+    /// This function runs the algorithm.
+    ///
+    /// \param method The method to be used (see \ref Method).
+    /// \param factor The epsilon-scaling factor of the \ref AUCTION
+    /// method. It must be at least 2.
+    ///
+    /// \return \c true if a perfect matching exists, i.e. the numbers
+    /// of the red and the blue nodes are equal and every node can be
+    /// covered by a matching.
+    bool run(Method method = AUCTION, int factor = 4) {
+      createStructures();
+      bool found;
+      if (int(_red_nodes.size()) != int(_blue_nodes.size())) {
+        found = false;
+      } else if (method == SHORTEST_PATH) {
+        found = startShortestPath();
+      } else {
+        found = checkFeasibility();
+        if (found) startAuction(factor < 2 ? 2 : factor);
+      }
+      extractMatching(found);
+      return found;
+    }
+
+    /// @}
+
+    /// \name Primal Solution
+    /// Functions to get the primal solution, i.e. the maximum weighted
+    /// perfect matching.\n
+    /// The \ref run() function should be called before using them.
+
+    /// @{
+
+    /// \brief Return the weight of the matching.
+    ///
+    /// This function returns the weight of the found matching.
+    ///
+    /// \pre \ref run() must be called before using this function.
+    Value matchingWeight() const {
+      Value sum = 0;
+      for (int i = 0; i < int(_red_nodes.size()); ++i) {
+        Arc a = (*_matching)[_red_nodes[i]];
+        if (a != INVALID) {
+          sum += _weight[a];
+        }
+      }
+      return sum;
+    }
+
+    /// \brief Return \c true if the given edge is in the matching.
+    ///
+    /// This function returns \c true if the given edge is in the found
+    /// matching.
+    ///
+    /// \pre \ref run() must be called before using this function.
+    bool matching(const Edge& edge) const {
+      return static_cast<const Edge&>((*_matching)[_graph.u(edge)]) == edge;
+    }
+
+    /// \brief Return the matching arc (or edge) incident to the given node.
+    ///
+    /// This function returns the matching arc (or edge) incident to the
+    /// given node in the found matching or \c INVALID if the node is
+    /// not covered by the matching.
+    ///
+    /// \pre \ref run() must be called before using this function.
+    Arc matching(const Node& node) const {
+      return (*_matching)[node];
+    }
+
+    /// \brief Return a const reference to the matching map.
+    ///
+    /// This function returns a const reference to a node map that stores
+    /// the matching arc (or edge) incident to each node.
+    const MatchingMap& matchingMap() const {
+      return *_matching;
+    }
+
+    /// \brief Return the mate of the given node.
+    ///
+    /// This function returns the mate of the given node in the found
+    /// matching or \c INVALID if the node is not covered by the matching.
+    ///
+    /// \pre \ref run() must be called before using this function.
+    Node mate(const Node& node) const {
+      return _graph.target((*_matching)[node]);
+    }
+
+    /// @}
+
+  private:
+
+    // Functor computing the bids of a range of bidders
+    class BidWorker {
+    private:
+      Assignment &_alg;
+    public:
+      BidWorker(Assignment &alg) : _alg(alg) {}
+      void operator()(int, int begin, int end) {
+        _alg.computeBids(begin, end);
+      }
+    };
+
+    void createStructures() {
+      if (!_matching) {
+        _matching = new MatchingMap(_graph);
+      }
+
+      _red_nodes.clear();
+      _blue_nodes.clear();
+      IntVector blue_index(_graph.maxBlueId() + 1);
+      for (BlueNodeIt n(_graph); n != INVALID; ++n) {
+        blue_index[_graph.id(n)] = _blue_nodes.size();
+        _blue_nodes.push_back(n);
+      }
+      for (RedNodeIt n(_graph); n != INVALID; ++n) {
+        _red_nodes.push_back(n);
+      }
+
+      int red_num = _red_nodes.size();
+      int blue_num = _blue_nodes.size();
+      int edge_num = countEdges(_graph);
+
+      _first.resize(red_num + 1);
+      _source.resize(edge_num);
+      _target.resize(edge_num);
+      _edges.resize(edge_num);
+      _cost.resize(edge_num);
+      int k = 0;
+      for (int i = 0; i < red_num; ++i) {
+        _first[i] = k;
+        for (IncEdgeIt e(_graph, _red_nodes[i]); e != INVALID; ++e, ++k) {
+          _source[k] = i;
+          _target[k] = blue_index[_graph.id(_graph.blueNode(e))];
+          _edges[k] = e;
+          _cost[k] = static_cast<LargeValue>(_weight[e]);
+        }
+      }
+      _first[red_num] = k;
+
+      _blue_first.assign(blue_num + 1, 0);
+      for (int k = 0; k < edge_num; ++k) {
+        ++_blue_first[_target[k] + 1];
+      }
+      for (int j = 0; j < blue_num; ++j) {
+        _blue_first[j + 1] += _blue_first[j];
+      }
+      _blue_arc.resize(edge_num);
+      IntVector pos(_blue_first.begin(), _blue_first.end() - 1);
+      for (int k = 0; k < edge_num; ++k) {
+        _blue_arc[pos[_target[k]]++] = k;
+      }
+
+      _red_mate.assign(red_num, -1);
+      _blue_mate.assign(blue_num, -1);
+    }
+
+    // Check whether a perfect matching exists
+    bool checkFeasibility() {
+      MaxBipartiteMatching<BpGraph> mbm(_graph);
+      mbm.threadNum(_thread_num);
+      mbm.run();
+      return mbm.matchingSize() == int(_red_nodes.size());
+    }
+
+    // Augment the matching along the _pred arcs ending at the blue node b
+    void augment(int b) {
+      while (true) {
+        int k = _pred[b];
+        int r = _source[k];
+        int prev = _red_mate[r];
+        _red_mate[r] = k;
+        _blue_mate[b] = k;
+        if (prev == -1) break;
+        b = _target[prev];
+      }
+    }
+
+    void startAuction(int factor) {
+      int n = _red_nodes.size();
+      int m = _cost.size();
+      if (n == 0) return;
+
+      // Scale the weights so that an epsilon-optimal matching with
+      // epsilon = 1 is optimal for integer weights
+      const bool integer = std::numeric_limits<Value>::is_integer;
+      LargeValue max_cost = _cost[0], min_cost = _cost[0];
+      for (int k = 0; k < m; ++k) {
+        if (integer) _cost[k] *= n + 1;
+        if (_cost[k] > max_cost) max_cost = _cost[k];
+        if (_cost[k] < min_cost) min_cost = _cost[k];
+      }
+      LargeValue range = max_cost - min_cost;
+      LargeValue max_abs = max_cost > -min_cost ? max_cost : -min_cost;
+
+      LargeValue final_eps;
+      if (integer) {
+        final_eps = 1;
+      } else {
+        LargeValue c = max_abs > 0 ? max_abs : 1;
+        final_eps = c * 1e-9 / n;
+        LargeValue min_eps =
+          c * n * 64 * std::numeric_limits<LargeValue>::epsilon();
+        if (final_eps < min_eps) final_eps = min_eps;
+      }
+
+      _price.assign(n, 0);
+      _profit.resize(n);
+      _winner.assign(n, -1);
+
+      LargeValue eps = max_abs / factor;
+      if (eps < final_eps) eps = final_eps;
+      while (true) {
+        _epsilon = eps;
+        _delta = range + eps;
+        auctionPhase();
+        if (eps <= final_eps) break;
+        eps = eps / factor;
+        if (eps < final_eps) eps = final_eps;
+      }
+    }
+
+    // Find an epsilon-optimal perfect matching starting from the
+    // current prices
+    void auctionPhase() {
+      int n = _red_nodes.size();
+
+      _red_mate.assign(n, -1);
+      _blue_mate.assign(n, -1);
+      for (int i = 0; i < n; ++i) {
+        LargeValue best = _cost[_first[i]] - _price[_target[_first[i]]];
+        for (int k = _first[i] + 1; k != _first[i + 1]; ++k) {
+          LargeValue v = _cost[k] - _price[_target[k]];
+          if (v > best) best = v;
+        }
+        _profit[i] = best;
+      }
+
+      _bidders.resize(n);
+      for (int i = 0; i < n; ++i) {
+        _bidders[i] = i;
+      }
+      _free_objects.resize(n);
+      for (int j = 0; j < n; ++j) {
+        _free_objects[j] = n - 1 - j;
+      }
+
+      // Alternate forward and reverse iterations, switching after
+      // the number of the assigned nodes has increased
+      int assigned = 0;
+      bool forward = true;
+      while (assigned < n) {
+        int start = assigned;
+        if (forward) {
+          while (assigned == start) {
+            forwardRound(assigned);
+          }
+        } else {
+          while (assigned == start) {
+            int j = _free_objects.back();
+            _free_objects.pop_back();
+            if (_blue_mate[j] == -1) {
+              reverseStep(j, assigned);
+            }
+          }
+        }
+        forward = !forward;
+      }
+    }
+
+    // Compute the bids of the bidders in the given range
+    void computeBids(int begin, int end) {
+      for (int idx = begin; idx < end; ++idx) {
+        int i = _bidders[idx];
+        int best = _first[i];
+        LargeValue v1 = _cost[best] - _price[_target[best]];
+        LargeValue v2 = v1 - _delta;
+        bool second = false;
+        for (int k = _first[i] + 1; k != _first[i + 1]; ++k) {
+          LargeValue v = _cost[k] - _price[_target[k]];
+          if (v > v1) {
+            v2 = v1;
+            v1 = v;
+            best = k;
+            second = true;
+          } else if (!second || v > v2) {
+            v2 = v;
+            second = true;
+          }
+        }
+        _bid_arc[idx] = best;
+        _bid_value[idx] = _cost[best] - v2 + _epsilon;
+      }
+    }
+
+    // Perform a Jacobi forward auction round: every unassigned red
+    // node bids for its best blue node and each blue node is given
+    // to its highest bidder
+    void forwardRound(int &assigned) {
+      int num = 0;
+      for (int idx = 0; idx < int(_bidders.size()); ++idx) {
+        if (_red_mate[_bidders[idx]] == -1) {
+          _bidders[num++] = _bidders[idx];
+        }
+      }
+      _bidders.resize(num);
+      _bid_arc.resize(num);
+      _bid_value.resize(num);
+
+      BidWorker worker(*this);
+      bits::parallelFor(num, _thread_num, worker, 256);
+
+      _touched.clear();
+      for (int idx = 0; idx < num; ++idx) {
+        int j = _target[_bid_arc[idx]];
+        int w = _winner[j];
+        if (w == -1) {
+          _winner[j] = idx;
+          _touched.push_back(j);
+        } else if (_bid_value[idx] > _bid_value[w]) {
+          _winner[j] = idx;
+        }
+      }
+
+      _next_bidders.clear();
+      for (int idx = 0; idx < num; ++idx) {
+        if (_winner[_target[_bid_arc[idx]]] != idx) {
+          _next_bidders.push_back(_bidders[idx]);
+        }
+      }
+      for (int t = 0; t < int(_touched.size()); ++t) {
+        int j = _touched[t];
+        int idx = _winner[j];
+        int k = _bid_arc[idx];
+        int old = _blue_mate[j];
+        if (old == -1) {
+          ++assigned;
+        } else {
+          _red_mate[_source[old]] = -1;
+          _next_bidders.push_back(_source[old]);
+        }
+        _blue_mate[j] = k;
+        _red_mate[_source[k]] = k;
+        _price[j] = _bid_value[idx];
+        _profit[_source[k]] = _cost[k] - _price[j];
+        _winner[j] = -1;
+      }
+      _bidders.swap(_next_bidders);
+    }
+
+    // Perform a reverse auction step: the unassigned blue node j
+    // bids for its best red node
+    void reverseStep(int j, int &assigned) {
+      int best = _blue_arc[_blue_first[j]];
+      LargeValue v1 = _cost[best] - _profit[_source[best]];
+      LargeValue v2 = v1 - _delta;
+      bool second = false;
+      for (int t = _blue_first[j] + 1; t != _blue_first[j + 1]; ++t) {
+        int k = _blue_arc[t];
+        LargeValue v = _cost[k] - _profit[_source[k]];
+        if (v > v1) {
+          v2 = v1;
+          v1 = v;
+          best = k;
+          second = true;
+        } else if (!second || v > v2) {
+          v2 = v;
+          second = true;
+        }
+      }
+
+      int i = _source[best];
+      _profit[i] = _cost[best] - v2 + _epsilon;
+      _price[j] = _cost[best] - _profit[i];
+      int old = _red_mate[i];
+      if (old == -1) {
+        ++assigned;
+      } else {
+        _blue_mate[_target[old]] = -1;
+        _free_objects.push_back(_target[old]);
+      }
+      _red_mate[i] = best;
+      _blue_mate[j] = best;
+    }
+
+    bool startShortestPath() {
+      int n = _red_nodes.size();
+      int m = _cost.size();
+
+      // Minimize the negated weights. The prices of the blue nodes are
+      // the dual variables, the dual variables of the matched red nodes
+      // are determined by the prices of their mates.
+      for (int k = 0; k < m; ++k) {
+        _cost[k] = -_cost[k];
+      }
+
+      // Column reduction and greedy initialization on the tight edges
+      _price.resize(n);
+      for (int j = 0; j < n; ++j) {
+        if (_blue_first[j] == _blue_first[j + 1]) return false;
+        int best = _blue_arc[_blue_first[j]];
+        for (int t = _blue_first[j] + 1; t != _blue_first[j + 1]; ++t) {
+          if (_cost[_blue_arc[t]] < _cost[best]) best = _blue_arc[t];
+        }
+        _price[j] = _cost[best];
+        if (_red_mate[_source[best]] == -1) {
+          _red_mate[_source[best]] = best;
+          _blue_mate[j] = best;
+        }
+      }
+
+      _dist.resize(n);
+      _pred.resize(n);
+      RangeMap<int> heap_cross_ref(n, Heap::PRE_HEAP);
+      Heap heap(heap_cross_ref);
+      IntVector scanned;
+
+      for (int s = 0; s < n; ++s) {
+        if (_red_mate[s] != -1) continue;
+
+        // Dijkstra search on the reduced weights
+        _touched.clear();
+        scanned.clear();
+        for (int k = _first[s]; k != _first[s + 1]; ++k) {
+          relax(heap, _target[k], _cost[k] - _price[_target[k]], k);
+        }
+        int found = -1;
+        LargeValue d = 0;
+        while (!heap.empty()) {
+          int b = heap.top();
+          d = heap.prio();
+          heap.pop();
+          scanned.push_back(b);
+          if (_blue_mate[b] == -1) {
+            found = b;
+            break;
+          }
+          int r = _source[_blue_mate[b]];
+          LargeValue pot = _cost[_blue_mate[b]] - _price[b];
+          for (int k = _first[r]; k != _first[r + 1]; ++k) {
+            int t = _target[k];
+            if (heap.state(t) == Heap::POST_HEAP) continue;
+            relax(heap, t, d + _cost[k] - pot - _price[t], k);
+          }
+        }
+
+        if (found == -1) return false;
+
+        // Update the prices and augment the matching
+        for (int i = 0; i < int(scanned.size()); ++i) {
+          _price[scanned[i]] += _dist[scanned[i]] - d;
+        }
+        augment(found);
+
+        heap.clear();
+        for (int i = 0; i < int(_touched.size()); ++i) {
+          heap_cross_ref[_touched[i]] = Heap::PRE_HEAP;
+        }
+      }
+      return true;
+    }
+
+    typedef BinHeap<LargeValue, RangeMap<int> > Heap;
+
+    void relax(Heap &heap, int b, LargeValue d, int k) {
+      switch (heap.state(b)) {
+      case Heap::PRE_HEAP:
+        heap.push(b, d);
+        _dist[b] = d;
+        _pred[b] = k;
+        _touched.push_back(b);
+        break;
+      case Heap::IN_HEAP:
+        if (d < _dist[b]) {
+          heap.decrease(b, d);
+          _dist[b] = d;
+          _pred[b] = k;
+        }
+        break;
+      case Heap::POST_HEAP:
+        break;
+      }
+    }
+
+    void extractMatching(bool found) {
+      for (NodeIt n(_graph); n != INVALID; ++n) {
+        _matching->set(n, INVALID);
+      }
+      if (!found) return;
+      for (int i = 0; i < int(_red_nodes.size()); ++i) {
+        int k = _red_mate[i];
+        if (k == -1) continue;
+        Edge e = _edges[k];
+        _matching->set(_red_nodes[i], _graph.direct(e, _red_nodes[i]));
+        _matching->set(_blue_nodes[_target[k]],
+                       _graph.direct(e, _blue_nodes[_target[k]]));
+      }
+    }
+
+  };
+
+  /// @}
+
+} //END OF NAMESPACE LEMON
+
+#endif //LEMON_ASSIGNMENT_H
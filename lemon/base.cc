@@ -33,5 +33,6 @@ namespace lemon {
 #endif
 
   TimeStamp::Format TimeStamp::_format = TimeStamp::NORMAL;
+  TimeStamp::Clock TimeStamp::_clock = TimeStamp::PROCESS_TIME;
 
 } //namespace lemon
@@ -23,8 +23,11 @@
 ///\file
 ///\brief BFS algorithm.
 
+#include <vector>
+#include <algorithm>
 #include <lemon/list_graph.h>
 #include <lemon/bits/path_dump.h>
+#include <lemon/bits/parallel.h>
 #include <lemon/core.h>
 #include <lemon/error.h>
 #include <lemon/maps.h>
@@ -1749,6 +1752,711 @@ namespace lemon {
 
   };
 
+  namespace _bfs_bits {
+
+    // The bottom-up steps of ParallelBfs iterate the entering arcs,
+    // so they are disabled by default for the digraph types that
+    // cannot iterate them efficiently (indicated by SlowInArcTag).
+    template <typename Digraph, typename Enable = void>
+    struct BottomUpSelector {
+      static const bool enabled = true;
+    };
+
+    template <typename Digraph>
+    struct BottomUpSelector<
+      Digraph, typename enable_if<typename Digraph::SlowInArcTag,
+                                  void>::type>
+    {
+      static const bool enabled = false;
+    };
+
+  }
+
+  ///Direction-optimizing parallel BFS algorithm class.
+
+  ///\ingroup search
+  ///This class provides a parallel implementation of the BFS algorithm
+  ///for large digraphs with small diameter (e.g. social networks),
+  ///which computes the same distances as \ref Bfs.
+  ///
+  ///The nodes are processed level by level, and the nodes of a level
+  ///are processed in parallel. A level is processed either in the
+  ///usual \e top-down way (the leaving arcs of the nodes of the current
+  ///level are scanned) or in the \e bottom-up way (each unreached node
+  ///looks for an entering arc from the current level, which is stored
+  ///in a bitmap). The bottom-up steps are used when the current level
+  ///is large, since they need to scan much less arcs then. The reached
+  ///nodes are also stored in a bitmap indexed by the node ids, so the
+  ///algorithm is most efficient for digraphs with dense ids, like
+  ///\ref StaticDigraph and \ref CompactDigraph.
+  ///
+  ///The bottom-up steps iterate the entering arcs, therefore they are
+  ///disabled by default for \ref CompactDigraph, which cannot iterate
+  ///them efficiently (see \ref directionOptimizing()).
+  ///
+  ///Unlike \ref BfsVisit, this class does not call a visitor, and unlike
+  ///\ref Bfs, it can only be executed level by level. The distances do
+  ///not depend on the number of threads, but the predecessor arcs (i.e.
+  ///the shortest path tree) may depend on the scheduling of the threads
+  ///if several threads are used.
+  ///
+  ///\tparam GR The type of the digraph the algorithm runs on.
+  ///The default type is \ref ListDigraph.
+  ///\tparam TR The traits class that defines various types used by the
+  ///algorithm. By default, it is \ref BfsDefaultTraits
+  ///"BfsDefaultTraits<GR>" (the \c ProcessedMap type is not used).
+  ///In most cases, this parameter should not be set directly,
+  ///consider to use the named template parameters instead.
+#ifdef DOXYGEN
+  template <typename GR,
+            typename TR>
+#else
+  template <typename GR=ListDigraph,
+            typename TR=BfsDefaultTraits<GR> >
+#endif
+  class ParallelBfs {
+  public:
+
+    ///The type of the digraph the algorithm runs on.
+    typedef typename TR::Digraph Digraph;
+
+    ///\brief The type of the map that stores the predecessor arcs of the
+    ///shortest paths.
+    typedef typename TR::PredMap PredMap;
+    ///The type of the map that stores the distances of the nodes.
+    typedef typename TR::DistMap DistMap;
+    ///The type of the map that indicates which nodes are reached.
+    typedef typename TR::ReachedMap ReachedMap;
+    ///The type of the paths.
+    typedef PredMapPath<Digraph, PredMap> Path;
+
+    ///The \ref lemon::BfsDefaultTraits "traits class" of the algorithm.
+    typedef TR Traits;
+
+  private:
+
+    typedef typename Digraph::Node Node;
+    typedef typename Digraph::NodeIt NodeIt;
+    typedef typename Digraph::Arc Arc;
+    typedef typename Digraph::OutArcIt OutArcIt;
+    typedef typename Digraph::InArcIt InArcIt;
+
+    //Pointer to the underlying digraph.
+    const Digraph *G;
+    //Pointer to the map of predecessor arcs.
+    PredMap *_pred;
+    //Indicates if _pred is locally allocated (true) or not.
+    bool local_pred;
+    //Pointer to the map of distances.
+    DistMap *_dist;
+    //Indicates if _dist is locally allocated (true) or not.
+    bool local_dist;
+    //Pointer to the map of reached status of the nodes.
+    ReachedMap *_reached;
+    //Indicates if _reached is locally allocated (true) or not.
+    bool local_reached;
+
+    //The number of threads.
+    int _thread_num;
+    //Indicates if the bottom-up steps can be used.
+    bool _bottom_up;
+
+    //Bitmaps of the reached nodes and of the current level (indexed by
+    //the node ids, 32 nodes in a word). The bits of the ids that do not
+    //belong to a node are set in _visited.
+    std::vector<int> _visited, _level_bits;
+    //The ids of the nodes of the current level.
+    std::vector<int> _level;
+    //The thread local parts of the next level.
+    std::vector<std::vector<int> > _next;
+    //The number of arcs scanned by the threads in the current step.
+    std::vector<long long> _scanned;
+    //The distance of the nodes of the current level.
+    int _curr_dist;
+    //Indicates if the next step is top-down.
+    bool _top_down;
+    //The number of the nodes and an estimate of the unscanned arcs.
+    int _node_num;
+    long long _unscanned;
+
+    //Creates the maps if necessary.
+    void create_maps()
+    {
+      if(!_pred) {
+        local_pred = true;
+        _pred = Traits::createPredMap(*G);
+      }
+      if(!_dist) {
+        local_dist = true;
+        _dist = Traits::createDistMap(*G);
+      }
+      if(!_reached) {
+        local_reached = true;
+        _reached = Traits::createReachedMap(*G);
+      }
+    }
+
+  protected:
+
+    ParallelBfs() {}
+
+  public:
+
+    typedef ParallelBfs Create;
+
+    ///\name Named Template Parameters
+
+    ///@{
+
+    template <class T>
+    struct SetPredMapTraits : public Traits {
+      typedef T PredMap;
+      static PredMap *createPredMap(const Digraph &)
+      {
+        LEMON_ASSERT(false, "PredMap is not initialized");
+        return 0; // ignore warnings
+      }
+    };
+    ///\brief \ref named-templ-param "Named parameter" for setting
+    ///\c PredMap type.
+    ///
+    ///\ref named-templ-param "Named parameter" for setting
+    ///\c PredMap type.
+    ///It must conform to the \ref concepts::WriteMap "WriteMap" concept.
+    template <class T>
+    struct SetPredMap : public ParallelBfs< Digraph, SetPredMapTraits<T> > {
+      typedef ParallelBfs< Digraph, SetPredMapTraits<T> > Create;
+    };
+
+    template <class T>
+    struct SetDistMapTraits : public Traits {
+      typedef T DistMap;
+      static DistMap *createDistMap(const Digraph &)
+      {
+        LEMON_ASSERT(false, "DistMap is not initialized");
+        return 0; // ignore warnings
+      }
+    };
+    ///\brief \ref named-templ-param "Named parameter" for setting
+    ///\c DistMap type.
+    ///
+    ///\ref named-templ-param "Named parameter" for setting
+    ///\c DistMap type.
+    ///It must conform to the \ref concepts::WriteMap "WriteMap" concept.
+    template <class T>
+    struct SetDistMap : public ParallelBfs< Digraph, SetDistMapTraits<T> > {
+      typedef ParallelBfs< Digraph, SetDistMapTraits<T> > Create;
+    };
+
+    template <class T>
+    struct SetReachedMapTraits : public Traits {
+      typedef T ReachedMap;
+      static ReachedMap *createReachedMap(const Digraph &)
+      {
+        LEMON_ASSERT(false, "ReachedMap is not initialized");
+        return 0; // ignore warnings
+      }
+    };
+    ///\brief \ref named-templ-param "Named parameter" for setting
+    ///\c ReachedMap type.
+    ///
+    ///\ref named-templ-param "Named parameter" for setting
+    ///\c ReachedMap type.
+    ///It must conform to
+    ///the \ref concepts::ReadWriteMap "ReadWriteMap" concept.
+    template <class T>
+    struct SetReachedMap
+      : public ParallelBfs< Digraph, SetReachedMapTraits<T> > {
+      typedef ParallelBfs< Digraph, SetReachedMapTraits<T> > Create;
+    };
+
+    ///@}
+
+  public:
+
+    ///Constructor.
+
+    ///Constructor.
+    ///\param g The digraph the algorithm runs on.
+    ParallelBfs(const Digraph &g) :
+      G(&g),
+      _pred(NULL), local_pred(false),
+      _dist(NULL), local_dist(false),
+      _reached(NULL), local_reached(false),
+      _thread_num(1),
+      _bottom_up(_bfs_bits::BottomUpSelector<Digraph>::enabled)
+    { }
+
+    ///Destructor.
+    ~ParallelBfs()
+    {
+      if(local_pred) delete _pred;
+      if(local_dist) delete _dist;
+      if(local_reached) delete _reached;
+    }
+
+    ///Sets the map that stores the predecessor arcs.
+
+    ///Sets the map that stores the predecessor arcs.
+    ///If you don't use this function before calling \ref run(Node) "run()"
+    ///or \ref init(), an instance will be allocated automatically.
+    ///The destructor deallocates this automatically allocated map,
+    ///of course.
+    ///\return <tt> (*this) </tt>
+    ParallelBfs &predMap(PredMap &m)
+    {
+      if(local_pred) {
+        delete _pred;
+        local_pred=false;
+      }
+      _pred = &m;
+      return *this;
+    }
+
+    ///Sets the map that indicates which nodes are reached.
+
+    ///Sets the map that indicates which nodes are reached.
+    ///If you don't use this function before calling \ref run(Node) "run()"
+    ///or \ref init(), an instance will be allocated automatically.
+    ///The destructor deallocates this automatically allocated map,
+    ///of course.
+    ///\return <tt> (*this) </tt>
+    ParallelBfs &reachedMap(ReachedMap &m)
+    {
+      if(local_reached) {
+        delete _reached;
+        local_reached=false;
+      }
+      _reached = &m;
+      return *this;
+    }
+
+    ///Sets the map that stores the distances of the nodes.
+
+    ///Sets the map that stores the distances of the nodes calculated by
+    ///the algorithm.
+    ///If you don't use this function before calling \ref run(Node) "run()"
+    ///or \ref init(), an instance will be allocated automatically.
+    ///The destructor deallocates this automatically allocated map,
+    ///of course.
+    ///\return <tt> (*this) </tt>
+    ParallelBfs &distMap(DistMap &m)
+    {
+      if(local_dist) {
+        delete _dist;
+        local_dist=false;
+      }
+      _dist = &m;
+      return *this;
+    }
+
+    /// \brief Sets the number of threads.
+    ///
+    /// This function sets the number of threads used by the algorithm.
+    /// If it is less than one, the number of the hardware threads is
+    /// used. By default, the algorithm runs on a single thread.
+    ///
+    /// The predecessor and distance maps are written concurrently for
+    /// different nodes (as in the case of the default node maps), while
+    /// the reached map is written only by the calling thread.
+    /// If LEMON is built without threading support, the computation is
+    /// performed on the calling thread.
+    /// \return <tt>(*this)</tt>
+    ParallelBfs &threadNum(int num)
+    {
+      _thread_num = num < 1 ? bits::hardwareThreadNum() : num;
+      return *this;
+    }
+
+    /// \brief Returns the number of threads.
+    ///
+    /// Returns the number of threads used by the algorithm.
+    int threadNum() const
+    {
+      return _thread_num;
+    }
+
+    /// \brief Enables or disables the bottom-up steps.
+    ///
+    /// This function enables or disables the bottom-up steps, which
+    /// iterate the entering arcs of the unreached nodes. They are
+    /// enabled by default, except for the digraph types that cannot
+    /// iterate the entering arcs efficiently (e.g. \ref CompactDigraph).
+    /// \return <tt>(*this)</tt>
+    ParallelBfs &directionOptimizing(bool enable)
+    {
+      _bottom_up = enable;
+      return *this;
+    }
+
+    /// \brief Returns whether the bottom-up steps are enabled.
+    ///
+    /// Returns whether the bottom-up steps are enabled.
+    bool directionOptimizing() const
+    {
+      return _bottom_up;
+    }
+
+  private:
+
+    enum Phase { TOP_DOWN, BOTTOM_UP, LEVEL_BITS };
+
+    // The parameters of the switching between the directions: a
+    // bottom-up step follows if the arcs scanned in the last top-down
+    // step exceed the 1/ALPHA part of the unscanned arcs, and a top-down
+    // step follows if the level shrinks below the 1/BETA part of the
+    // nodes.
+    static const int ALPHA = 15;
+    static const int BETA = 18;
+
+    static bool testBit(const std::vector<int>& bits, int i) {
+      return (static_cast<const volatile int&>(bits[i >> 5]) &
+              int(1u << (i & 31))) != 0;
+    }
+
+    // Atomically set a bit, it returns false if it has already been set
+    static bool setBit(std::vector<int>& bits, int i) {
+      int mask = int(1u << (i & 31));
+      int old;
+      while (!((old = static_cast<const volatile int&>(bits[i >> 5]))
+               & mask)) {
+        if (bits::atomicCompareAndSwap(bits[i >> 5], old, old | mask)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // Scan the leaving arcs of the nodes of the current level
+    void topDown(int thread, int begin, int end) {
+      long long scanned = 0;
+      for (int k = begin; k < end; ++k) {
+        Node u = G->nodeFromId(_level[k]);
+        for (OutArcIt a(*G, u); a != INVALID; ++a) {
+          ++scanned;
+          Node v = G->target(a);
+          int i = G->id(v);
+          if (!testBit(_visited, i) && setBit(_visited, i)) {
+            _dist->set(v, _curr_dist + 1);
+            _pred->set(v, a);
+            _next[thread].push_back(i);
+          }
+        }
+      }
+      _scanned[thread] += scanned;
+    }
+
+    // Look for an entering arc from the current level for the unreached
+    // nodes. A word of the bitmap is processed by a single thread, so it
+    // can be updated without atomic operations.
+    void bottomUp(int thread, int begin, int end) {
+      long long scanned = 0;
+      for (int w = begin; w < end; ++w) {
+        int word = _visited[w];
+        if (word == ~0) continue;
+        for (int b = 0; b < 32; ++b) {
+          if (word & int(1u << b)) continue;
+          Node v = G->nodeFromId((w << 5) + b);
+          for (InArcIt a(*G, v); a != INVALID; ++a) {
+            ++scanned;
+            if (testBit(_level_bits, G->id(G->source(a)))) {
+              word |= int(1u << b);
+              _dist->set(v, _curr_dist + 1);
+              _pred->set(v, a);
+              _next[thread].push_back((w << 5) + b);
+              break;
+            }
+          }
+        }
+        _visited[w] = word;
+      }
+      _scanned[thread] += scanned;
+    }
+
+    class Worker {
+    private:
+      ParallelBfs &_alg;
+      Phase _phase;
+    public:
+      Worker(ParallelBfs &alg, Phase phase) : _alg(alg), _phase(phase) {}
+      void operator()(int thread, int begin, int end) {
+        switch (_phase) {
+        case TOP_DOWN:
+          _alg.topDown(thread, begin, end);
+          break;
+        case BOTTOM_UP:
+          _alg.bottomUp(thread, begin, end);
+          break;
+        case LEVEL_BITS:
+          for (int k = begin; k < end; ++k) {
+            setBit(_alg._level_bits, _alg._level[k]);
+          }
+          break;
+        }
+      }
+    };
+
+    void runPhase(int size, Phase phase, int grain) {
+      _next.resize(_thread_num);
+      _scanned.assign(_thread_num, 0);
+      Worker worker(*this, phase);
+      bits::parallelFor(size, _thread_num, worker, grain);
+    }
+
+  public:
+
+    ///\name Execution Control
+    ///The simplest way to execute the algorithm is to use one of the
+    ///member functions called \ref run(Node) "run()".\n
+    ///If you need better control on the execution, you have to call
+    ///\ref init() first, then you can add several source nodes with
+    ///\ref addSource(). Finally the actual path computation can be
+    ///performed with one of the \ref start() functions.
+
+    ///@{
+
+    ///\brief Initializes the internal data structures.
+    ///
+    ///Initializes the internal data structures.
+    void init()
+    {
+      create_maps();
+      _visited.assign((G->maxNodeId() + 32) >> 5, ~0);
+      _level_bits.assign(_visited.size(), 0);
+      _level.clear();
+      _node_num = 0;
+      for ( NodeIt u(*G) ; u!=INVALID ; ++u ) {
+        _pred->set(u,INVALID);
+        _reached->set(u,false);
+        int i = G->id(u);
+        _visited[i >> 5] &= ~int(1u << (i & 31));
+        ++_node_num;
+      }
+      _curr_dist = 0;
+      _top_down = true;
+      _unscanned = countArcs(*G);
+    }
+
+    ///Adds a new source node.
+
+    ///Adds a new source node to the current level.
+    ///
+    ///\pre The nodes of the current level must have distance zero, i.e.
+    ///no level has been processed yet.
+    void addSource(Node s)
+    {
+      int i = G->id(s);
+      if (setBit(_visited, i)) {
+        _reached->set(s,true);
+        _pred->set(s,INVALID);
+        _dist->set(s,0);
+        _level.push_back(i);
+      }
+    }
+
+    ///Processes the next level.
+
+    ///Processes the nodes of the current level (in parallel), and the
+    ///newly reached nodes form the next level.
+    ///
+    ///\pre The current level must not be empty.
+    void processNextLevel()
+    {
+      int size = _level.size();
+      bool top_down = _top_down;
+      if (top_down) {
+        runPhase(size, TOP_DOWN, 256);
+      } else {
+        std::fill(_level_bits.begin(), _level_bits.end(), 0);
+        runPhase(size, LEVEL_BITS, 1024);
+        runPhase(_visited.size(), BOTTOM_UP, 64);
+      }
+      long long scanned = 0;
+      _level.clear();
+      for (int t = 0; t < _thread_num; ++t) {
+        scanned += _scanned[t];
+        _level.insert(_level.end(), _next[t].begin(), _next[t].end());
+        _next[t].clear();
+      }
+      for (int k = 0; k < int(_level.size()); ++k) {
+        _reached->set(G->nodeFromId(_level[k]), true);
+      }
+      ++_curr_dist;
+
+      if (top_down) {
+        _unscanned -= scanned;
+        _top_down = !_bottom_up || int(_level.size()) <= size ||
+          scanned * ALPHA <= _unscanned;
+      } else {
+        _top_down = int(_level.size()) < size &&
+          int(_level.size()) * BETA < _node_num;
+      }
+    }
+
+    ///Returns \c false if there are nodes to be processed.
+
+    ///Returns \c false if there are nodes to be processed
+    ///in the current level.
+    bool emptyQueue() const { return _level.empty(); }
+
+    ///Returns the number of the nodes to be processed.
+
+    ///Returns the number of the nodes to be processed
+    ///in the current level.
+    int queueSize() const { return _level.size(); }
+
+    ///Executes the algorithm.
+
+    ///Executes the algorithm.
+    ///
+    ///This method runs the %BFS algorithm from the root node(s)
+    ///in order to compute the shortest path to each node.
+    ///
+    ///\pre init() must be called and at least one root node should be
+    ///added with addSource() before using this function.
+    void start()
+    {
+      while ( !emptyQueue() ) processNextLevel();
+    }
+
+    ///Executes the algorithm until the given target node is reached.
+
+    ///Executes the algorithm until the given target node is reached.
+    ///The level of the target node is processed completely.
+    ///
+    ///\pre init() must be called and at least one root node should be
+    ///added with addSource() before using this function.
+    void start(Node t)
+    {
+      while ( !emptyQueue() && !(*_reached)[t] ) processNextLevel();
+    }
+
+    ///Runs the algorithm from the given source node.
+
+    ///This method runs the %BFS algorithm from node \c s
+    ///in order to compute the shortest path to each node.
+    ///
+    ///\note <tt>b.run(s)</tt> is just a shortcut of the following code.
+    ///\code
+    ///  b.init();
+    ///  b.addSource(s);
+    ///  b.start();
+    ///\endcode
+    void run(Node s) {
+      init();
+      addSource(s);
+      start();
+    }
+
+    ///Finds the shortest path between \c s and \c t.
+
+    ///This method runs the %BFS algorithm from node \c s
+    ///in order to compute the shortest path to node \c t
+    ///(it stops searching when \c t is reached).
+    ///
+    ///\return \c true if \c t is reachable form \c s.
+    ///
+    ///\note Apart from the return value, <tt>b.run(s,t)</tt> is just a
+    ///shortcut of the following code.
+    ///\code
+    ///  b.init();
+    ///  b.addSource(s);
+    ///  b.start(t);
+    ///\endcode
+    bool run(Node s,Node t) {
+      init();
+      addSource(s);
+      start(t);
+      return reached(t);
+    }
+
+    ///@}
+
+    ///\name Query Functions
+    ///The results of the algorithm can be obtained using these
+    ///functions.\n
+    ///Either \ref run(Node) "run()" or \ref init() should be called
+    ///before using them.
+
+    ///@{
+
+    ///The shortest path to the given node.
+
+    ///Returns the shortest path to the given node from the root(s).
+    ///
+    ///\warning \c t should be reached from the root(s).
+    ///
+    ///\pre Either \ref run(Node) "run()" or \ref init()
+    ///must be called before using this function.
+    Path path(Node t) const { return Path(*G, *_pred, t); }
+
+    ///The distance of the given node from the root(s).
+
+    ///Returns the distance of the given node from the root(s).
+    ///
+    ///\warning If node \c v is not reached from the root(s), then
+    ///the return value of this function is undefined.
+    ///
+    ///\pre Either \ref run(Node) "run()" or \ref init()
+    ///must be called before using this function.
+    int dist(Node v) const { return (*_dist)[v]; }
+
+    ///\brief Returns the 'previous arc' of the shortest path tree for
+    ///the given node.
+    ///
+    ///This function returns the 'previous arc' of the shortest path
+    ///tree for the node \c v, i.e. it returns the last arc of a
+    ///shortest path from a root to \c v. It is \c INVALID if \c v
+    ///is not reached from the root(s) or if \c v is a root.
+    ///
+    ///\pre Either \ref run(Node) "run()" or \ref init()
+    ///must be called before using this function.
+    Arc predArc(Node v) const { return (*_pred)[v];}
+
+    ///\brief Returns the 'previous node' of the shortest path tree for
+    ///the given node.
+    ///
+    ///This function returns the 'previous node' of the shortest path
+    ///tree for the node \c v, i.e. it returns the last but one node
+    ///of a shortest path from a root to \c v. It is \c INVALID
+    ///if \c v is not reached from the root(s) or if \c v is a root.
+    ///
+    ///\pre Either \ref run(Node) "run()" or \ref init()
+    ///must be called before using this function.
+    Node predNode(Node v) const { return (*_pred)[v]==INVALID ? INVALID:
+                                  G->source((*_pred)[v]); }
+
+    ///\brief Returns a const reference to the node map that stores the
+    /// distances of the nodes.
+    ///
+    ///Returns a const reference to the node map that stores the distances
+    ///of the nodes calculated by the algorithm.
+    ///
+    ///\pre Either \ref run(Node) "run()" or \ref init()
+    ///must be called before using this function.
+    const DistMap &distMap() const { return *_dist;}
+
+    ///\brief Returns a const reference to the node map that stores the
+    ///predecessor arcs.
+    ///
+    ///Returns a const reference to the node map that stores the predecessor
+    ///arcs, which form the shortest path tree (forest).
+    ///
+    ///\pre Either \ref run(Node) "run()" or \ref init()
+    ///must be called before using this function.
+    const PredMap &predMap() const { return *_pred;}
+
+    ///Checks if the given node is reached from the root(s).
+
+    ///Returns \c true if \c v is reached from the root(s).
+    ///
+    ///\pre Either \ref run(Node) "run()" or \ref init()
+    ///must be called before using this function.
+    bool reached(Node v) const { return (*_reached)[v]; }
+
+    ///@}
+  };
+
 } //END OF NAMESPACE LEMON
 
 #endif
@@ -0,0 +1,519 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_BIPARTITE_MATCHING_H
+#define LEMON_BIPARTITE_MATCHING_H
+
+#include <vector>
+#include <climits>
+
+#include <lemon/core.h>
+#include <lemon/bits/parallel.h>
+
+///\ingroup matching
+///\file
+///\brief Maximum matching algorithms in bipartite graphs.
+
+namespace lemon {
+
+  /// \ingroup matching
+  ///
+  /// \brief Maximum cardinality matching in bipartite graphs
+  ///
+  /// This class implements the Hopcroft-Karp algorithm for finding a
+  /// maximum cardinality matching in a bipartite graph. In each phase,
+  /// a breadth-first search computes the layers of the shortest
+  /// augmenting paths and then a maximal set of node-disjoint shortest
+  /// augmenting paths is found by depth-first searches. The number of
+  /// phases is at most <tt>O(sqrt(n))</tt>, so the running time is
+  /// <tt>O(m sqrt(n))</tt>.
+  ///
+  /// Since blossoms cannot occur in bipartite graphs, this algorithm is
+  /// usually much faster than \ref MaxMatching on such graphs.
+  /// It can be started from the empty matching or from a matching
+  /// found by the Karp-Sipser heuristic (see \ref greedyInit()).
+  /// The breadth-first searches can be executed by several threads
+  /// (see \ref threadNum()).
+  ///
+  /// \tparam BGR The bipartite graph type the algorithm runs on.
+  template <typename BGR>
+  class MaxBipartiteMatching {
+  public:
+
+    /// The bipartite graph type of the algorithm
+    typedef BGR BpGraph;
+
+    /// The type of the matching map
+    typedef typename BpGraph::template NodeMap<typename BpGraph::Arc>
+    MatchingMap;
+
+  private:
+
+    TEMPLATE_BPGRAPH_TYPEDEFS(BpGraph);
+
+    typedef std::vector<int> IntVector;
+
+    static const int INF = INT_MAX;
+
+    const BpGraph &_graph;
+    MatchingMap *_matching;
+
+    int _thread_num;
+
+    // The red and the blue nodes in the order of their indices
+    std::vector<Node> _red_nodes;
+    std::vector<Node> _blue_nodes;
+
+    // The edges grouped by their red nodes: the edges of the i-th red
+    // node are at the positions [_first[i], _first[i+1]).
+    IntVector _first;
+    IntVector _source;
+    IntVector _target;
+    std::vector<Edge> _edges;
+
+    // The positions of the edges grouped by their blue nodes
+    IntVector _blue_first;
+    IntVector _blue_arc;
+
+    // The matching edges of the red and the blue nodes (or -1)
+    IntVector _red_mate;
+    IntVector _blue_mate;
+    int _size;
+
+    // Data of the phases
+    IntVector _dist;
+    IntVector _it;
+    IntVector _frontier;
+    std::vector<IntVector> _next;
+    IntVector _stack;
+    IntVector _stack_arc;
+    int _dist_limit;
+    volatile int _found;
+
+  public:
+
+    /// \brief Constructor
+    ///
+    /// Constructor.
+    MaxBipartiteMatching(const BpGraph &graph)
+      : _graph(graph), _matching(0), _thread_num(1), _size(0) {}
+
+    ~MaxBipartiteMatching() {
+      if (_matching) {
+        delete _matching;
+      }
+    }
+
+    /// \brief Set the number of threads used by the algorithm.
+    ///
+    /// This function sets the number of threads used by the algorithm.
+    /// The default value is 1, i.e. the algorithm runs serially.
+    /// A value less than 1 means the number of available processors.
+    ///
+    /// The threads process the layers of the breadth-first searches.
+    /// The layers do not depend on the number of threads and the
+    /// augmenting paths are searched serially, hence the found matching
+    /// does not depend on this setting either.
+    /// If LEMON is built without threading support, this setting
+    /// has no effect.
+    ///
+    /// \return <tt>(*this)</tt>
+    MaxBipartiteMatching& threadNum(int num) {
+      _thread_num = num < 1 ? bits::hardwareThreadNum() : num;
+      return *this;
+    }
+
+    /// \brief Return the number of threads used by the algorithm.
+    ///
+    /// This function returns the number of threads used by the algorithm.
+    int threadNum() const {
+      return _thread_num;
+    }
+
+    /// \name Execution Control
+    /// The simplest way to execute the algorithm is to use the
+    /// \c run() member function.\n
+    /// If you need better control on the execution, you have to call
+    /// one of the functions \ref init() or \ref greedyInit() first,
+    /// then you can start the algorithm with \ref start().
+
+    ///@{
+
+    /// \brief Set the initial matching to the empty matching.
+    ///
+    /// This function sets the initial matching to the empty matching.
+    void init() {
+      createStructures();
+    }
+
+    /// \brief Find an initial matching with the Karp-Sipser heuristic.
+    ///
+    /// This function finds an initial matching with the Karp-Sipser
+    /// heuristic. It repeatedly matches a node that has exactly one
+    /// unmatched neighbor to this neighbor, and if there is no such
+    /// node, it matches an arbitrary unmatched edge.
+    /// The found matching is usually close to a maximum one.
+    void greedyInit() {
+      createStructures();
+
+      int red_num = _red_nodes.size();
+      int blue_num = _blue_nodes.size();
+
+      // Number of the edges to unmatched nodes (red nodes first)
+      IntVector deg(red_num + blue_num);
+      IntVector queue;
+      for (int i = 0; i < red_num; ++i) {
+        deg[i] = _first[i + 1] - _first[i];
+        if (deg[i] == 1) queue.push_back(i);
+      }
+      for (int j = 0; j < blue_num; ++j) {
+        deg[red_num + j] = _blue_first[j + 1] - _blue_first[j];
+        if (deg[red_num + j] == 1) queue.push_back(red_num + j);
+      }
+
+      int head = 0, next_red = 0;
+      while (true) {
+        int k = -1;
+        while (head < int(queue.size()) && k == -1) {
+          int v = queue[head++];
+          if (v < red_num) {
+            if (_red_mate[v] != -1 || deg[v] != 1) continue;
+            for (int a = _first[v]; a != _first[v + 1]; ++a) {
+              if (_blue_mate[_target[a]] == -1) {
+                k = a;
+                break;
+              }
+            }
+          } else {
+            int j = v - red_num;
+            if (_blue_mate[j] != -1 || deg[v] != 1) continue;
+            for (int t = _blue_first[j]; t != _blue_first[j + 1]; ++t) {
+              if (_red_mate[_source[_blue_arc[t]]] == -1) {
+                k = _blue_arc[t];
+                break;
+              }
+            }
+          }
+        }
+        while (k == -1 && next_red < red_num) {
+          if (_red_mate[next_red] == -1) {
+            for (int a = _first[next_red]; a != _first[next_red + 1]; ++a) {
+              if (_blue_mate[_target[a]] == -1) {
+                k = a;
+                break;
+              }
+            }
+          }
+          if (k == -1) ++next_red;
+        }
+        if (k == -1) break;
+
+        int r = _source[k], b = _target[k];
+        _red_mate[r] = k;
+        _blue_mate[b] = k;
+        ++_size;
+        for (int a = _first[r]; a != _first[r + 1]; ++a) {
+          int v = red_num + _target[a];
+          if (_blue_mate[_target[a]] == -1 && --deg[v] == 1) {
+            queue.push_back(v);
+          }
+        }
+        for (int t = _blue_first[b]; t != _blue_first[b + 1]; ++t) {
+          int v = _source[_blue_arc[t]];
+          if (_red_mate[v] == -1 && --deg[v] == 1) {
+            queue.push_back(v);
+          }
+        }
+      }
+    }
+
+    /// \brief Start the Hopcroft-Karp algorithm
+    ///
+    /// This function starts the Hopcroft-Karp algorithm.
+    ///
+    /// \pre \ref init() or \ref greedyInit() must be called before
+    /// using this function.
+    void start() {
+      int red_num = _red_nodes.size();
+      _dist.resize(red_num);
+      _it.resize(red_num);
+      _next.resize(_thread_num);
+
+      while (bfs()) {
+        for (int i = 0; i < red_num; ++i) {
+          _it[i] = _first[i];
+        }
+        for (int i = 0; i < red_num; ++i) {
+          if (_red_mate[i] == -1 && augment(i)) {
+            ++_size;
+          }
+        }
+      }
+      extractMatching();
+    }
+
+    /// \brief Run the algorithm.
+    ///
+    /// This function runs the algorithm.
+    ///
+    /// \note mbm.run() is just a shortcut of the following code.
+    /// \code
+    ///   mbm.greedyInit();
+    ///   mbm.start();
+    /// \endcode
+    void run() {
+      greedyInit();
+      start();
+    }
+
+    /// @}
+
+    /// \name Primal Solution
+    /// Functions to get the primal solution, i.e. the maximum matching.\n
+    /// Either \ref run() or \ref start() function should be called before
+    /// using them.
+
+    /// @{
+
+    /// \brief Return the size (cardinality) of the matching.
+    ///
+    /// This function returns the size (cardinality) of the found matching.
+    int matchingSize() const {
+      return _size;
+    }
+
+    /// \brief Return \c true if the given edge is in the matching.
+    ///
+    /// This function returns \c true if the given edge is in the found
+    /// matching.
+    bool matching(const Edge& edge) const {
+      return edge == (*_matching)[_graph.u(edge)];
+    }
+
+    /// \brief Return the matching arc (or edge) incident to the given node.
+    ///
+    /// This function returns the matching arc (or edge) incident to the
+    /// given node in the found matching or \c INVALID if the node is
+    /// not covered by the matching.
+    Arc matching(const Node& n) const {
+      return (*_matching)[n];
+    }
+
+    /// \brief Return a const reference to the matching map.
+    ///
+    /// This function returns a const reference to a node map that stores
+    /// the matching arc (or edge) incident to each node.
+    const MatchingMap& matchingMap() const {
+      return *_matching;
+    }
+
+    /// \brief Return the mate of the given node.
+    ///
+    /// This function returns the mate of the given node in the found
+    /// matching or \c INVALID if the node is not covered by the matching.
+    Node mate(const Node& n) const {
+      return (*_matching)[n] != INVALID ?
+        _graph.target((*_matching)[n]) : INVALID;
+    }
+
+    /// @}
+
+  private:
+
+    // Functor processing a range of the current BFS layer
+    class LayerWorker {
+    private:
+      MaxBipartiteMatching &_alg;
+      int _level;
+    public:
+      LayerWorker(MaxBipartiteMatching &alg, int level)
+        : _alg(alg), _level(level) {}
+      void operator()(int thread, int begin, int end) {
+        _alg.processLayer(thread, begin, end, _level);
+      }
+    };
+
+    void createStructures() {
+      if (!_matching) {
+        _matching = new MatchingMap(_graph);
+      }
+
+      _red_nodes.clear();
+      _blue_nodes.clear();
+      IntVector blue_index(_graph.maxBlueId() + 1);
+      for (BlueNodeIt n(_graph); n != INVALID; ++n) {
+        blue_index[_graph.id(n)] = _blue_nodes.size();
+        _blue_nodes.push_back(n);
+      }
+      for (RedNodeIt n(_graph); n != INVALID; ++n) {
+        _red_nodes.push_back(n);
+      }
+
+      int red_num = _red_nodes.size();
+      int blue_num = _blue_nodes.size();
+      int edge_num = countEdges(_graph);
+
+      _first.resize(red_num + 1);
+      _source.resize(edge_num);
+      _target.resize(edge_num);
+      _edges.resize(edge_num);
+      int k = 0;
+      for (int i = 0; i < red_num; ++i) {
+        _first[i] = k;
+        for (IncEdgeIt e(_graph, _red_nodes[i]); e != INVALID; ++e, ++k) {
+          _source[k] = i;
+          _target[k] = blue_index[_graph.id(_graph.blueNode(e))];
+          _edges[k] = e;
+        }
+      }
+      _first[red_num] = k;
+
+      _blue_first.assign(blue_num + 1, 0);
+      for (int k = 0; k < edge_num; ++k) {
+        ++_blue_first[_target[k] + 1];
+      }
+      for (int j = 0; j < blue_num; ++j) {
+        _blue_first[j + 1] += _blue_first[j];
+      }
+      _blue_arc.resize(edge_num);
+      IntVector pos(_blue_first.begin(), _blue_first.end() - 1);
+      for (int k = 0; k < edge_num; ++k) {
+        _blue_arc[pos[_target[k]]++] = k;
+      }
+
+      _red_mate.assign(red_num, -1);
+      _blue_mate.assign(blue_num, -1);
+      _size = 0;
+    }
+
+    // Compute the layers of the shortest augmenting paths. The
+    // distance of a red node is the number of the matching edges on
+    // the shortest alternating path from an unmatched red node to it.
+    // It returns false if there is no augmenting path.
+    bool bfs() {
+      int red_num = _red_nodes.size();
+      _frontier.clear();
+      for (int i = 0; i < red_num; ++i) {
+        if (_red_mate[i] == -1) {
+          _dist[i] = 0;
+          _frontier.push_back(i);
+        } else {
+          _dist[i] = INF;
+        }
+      }
+
+      _found = 0;
+      int level = 0;
+      while (!_frontier.empty() && !_found) {
+        for (int t = 0; t < _thread_num; ++t) {
+          _next[t].clear();
+        }
+        LayerWorker worker(*this, level);
+        bits::parallelFor(_frontier.size(), _thread_num, worker);
+        _frontier.clear();
+        for (int t = 0; t < _thread_num; ++t) {
+          _frontier.insert(_frontier.end(), _next[t].begin(), _next[t].end());
+        }
+        ++level;
+      }
+      _dist_limit = level - 1;
+      return _found != 0;
+    }
+
+    void processLayer(int thread, int begin, int end, int level) {
+      IntVector &next = _next[thread];
+      for (int idx = begin; idx < end; ++idx) {
+        int r = _frontier[idx];
+        for (int k = _first[r]; k != _first[r + 1]; ++k) {
+          int m = _blue_mate[_target[k]];
+          if (m == -1) {
+            _found = 1;
+          } else {
+            int s = _source[m];
+            if (_dist[s] == INF &&
+                bits::atomicCompareAndSwap(_dist[s], INF, level + 1)) {
+              next.push_back(s);
+            }
+          }
+        }
+      }
+    }
+
+    // Find a shortest augmenting path from the unmatched red node s
+    // along the layers and augment the matching along it
+    bool augment(int s) {
+      _stack.clear();
+      _stack_arc.clear();
+      _stack.push_back(s);
+      _stack_arc.push_back(-1);
+      while (!_stack.empty()) {
+        int r = _stack.back();
+        bool advanced = false;
+        for (; _it[r] != _first[r + 1]; ++_it[r]) {
+          int k = _it[r];
+          int m = _blue_mate[_target[k]];
+          if (m == -1) {
+            if (_dist[r] != _dist_limit) continue;
+            _stack_arc.back() = k;
+            for (int i = 0; i < int(_stack.size()); ++i) {
+              int a = _stack_arc[i];
+              _red_mate[_stack[i]] = a;
+              _blue_mate[_target[a]] = a;
+            }
+            return true;
+          }
+          int t = _source[m];
+          if (_dist[t] == _dist[r] + 1) {
+            _stack_arc.back() = k;
+            _stack.push_back(t);
+            _stack_arc.push_back(-1);
+            advanced = true;
+            break;
+          }
+        }
+        if (!advanced) {
+          _dist[r] = INF;
+          _stack.pop_back();
+          _stack_arc.pop_back();
+          if (!_stack.empty()) {
+            ++_it[_stack.back()];
+          }
+        }
+      }
+      return false;
+    }
+
+    void extractMatching() {
+      for (NodeIt n(_graph); n != INVALID; ++n) {
+        _matching->set(n, INVALID);
+      }
+      for (int i = 0; i < int(_red_nodes.size()); ++i) {
+        int k = _red_mate[i];
+        if (k == -1) continue;
+        Edge e = _edges[k];
+        _matching->set(_red_nodes[i], _graph.direct(e, _red_nodes[i]));
+        _matching->set(_blue_nodes[_target[k]],
+                       _graph.direct(e, _blue_nodes[_target[k]]));
+      }
+    }
+
+  };
+
+} //END OF NAMESPACE LEMON
+
+#endif //LEMON_BIPARTITE_MATCHING_H
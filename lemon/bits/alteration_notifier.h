@@ -244,6 +244,21 @@ namespace lemon {
       // the subclasses.
       virtual void clear() = 0;
 
+      // \brief The member function to notificate the observer about
+      // the items are renumbered.
+      //
+      // The renumber() member function notificates the observer about
+      // the identifiers of the items are changed. The i-th element of
+      // the given vector is the new identifier of the item whose old
+      // identifier was i (or -1 if there was no such item). The default
+      // implementation calls clear() and build(), the subclasses
+      // storing data for the items should override it. Like clear(),
+      // it can throw only \ref ImmediateDetach exception.
+      virtual void renumber(const std::vector<Index>&) {
+        clear();
+        build();
+      }
+
     };
 
   protected:
@@ -319,14 +334,14 @@ namespace lemon {
     // \brief Returns the id of the item.
     //
     // Returns the id of the item provided by the container.
-    int id(const Item& item) const {
+    Index id(const Item& item) const {
       return container->id(item);
     }
 
     // \brief Returns the maximum id of the container.
     //
     // Returns the maximum id of the container.
-    int maxId() const {
+    Index maxId() const {
       return container->maxId(Item());
     }
 
@@ -447,6 +462,27 @@ namespace lemon {
       }
     }
 
+    // \brief Notifies all the registed observers about the items are
+    // renumbered.
+    //
+    // Notifies all the registed observers about the identifiers of the
+    // items are changed. The i-th element of the given vector is the new
+    // identifier of the item whose old identifier was i (or -1 if there
+    // was no such item).
+    void renumber(const std::vector<Index>& ids) {
+      typename Observers::iterator it = _observers.end();
+      while (it != _observers.begin()) {
+        --it;
+        try {
+          (*it)->renumber(ids);
+        } catch (const ImmediateDetach&) {
+          (*it)->_index = _observers.end();
+          (*it)->_notifier = 0;
+          it = _observers.erase(it);
+        }
+      }
+    }
+
     // \brief Notifies all the registed observers about all items are
     // erased.
     //
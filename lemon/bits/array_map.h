@@ -52,6 +52,8 @@ namespace lemon {
     typedef _Item Item;
     // The reference map tag.
     typedef True ReferenceMapTag;
+    // The values of different keys can be set concurrently.
+    typedef True ConcurrentSetTag;
 
     // The key type of the map.
     typedef _Item Key;
@@ -87,7 +89,7 @@ namespace lemon {
       Notifier* nf = Parent::notifier();
       Item it;
       for (nf->first(it); it != INVALID; nf->next(it)) {
-        int id = nf->id(it);;
+        Index id = nf->id(it);;
         allocator.construct(&(values[id]), Value());
       }
     }
@@ -101,7 +103,7 @@ namespace lemon {
       Notifier* nf = Parent::notifier();
       Item it;
       for (nf->first(it); it != INVALID; nf->next(it)) {
-        int id = nf->id(it);;
+        Index id = nf->id(it);;
         allocator.construct(&(values[id]), value);
       }
     }
@@ -120,7 +122,7 @@ namespace lemon {
       Notifier* nf = Parent::notifier();
       Item it;
       for (nf->first(it); it != INVALID; nf->next(it)) {
-        int id = nf->id(it);;
+        Index id = nf->id(it);;
         allocator.construct(&(values[id]), copy.values[id]);
       }
     }
@@ -178,7 +180,7 @@ namespace lemon {
     // The subscript operator. The map can be subscripted by the
     // actual keys of the graph.
     Value& operator[](const Key& key) {
-      int id = Parent::notifier()->id(key);
+      Index id = Parent::notifier()->id(key);
       return values[id];
     }
 
@@ -187,7 +189,7 @@ namespace lemon {
     // The const subscript operator. The map can be subscripted by the
     // actual keys of the graph.
     const Value& operator[](const Key& key) const {
-      int id = Parent::notifier()->id(key);
+      Index id = Parent::notifier()->id(key);
       return values[id];
     }
 
@@ -207,16 +209,16 @@ namespace lemon {
     // and it overrides the add() member function of the observer base.
     virtual void add(const Key& key) {
       Notifier* nf = Parent::notifier();
-      int id = nf->id(key);
+      Index id = nf->id(key);
       if (id >= capacity) {
-        int new_capacity = (capacity == 0 ? 1 : capacity);
+        Index new_capacity = (capacity == 0 ? 1 : capacity);
         while (new_capacity <= id) {
           new_capacity <<= 1;
         }
         Value* new_values = allocator.allocate(new_capacity);
         Item it;
         for (nf->first(it); it != INVALID; nf->next(it)) {
-          int jd = nf->id(it);;
+          Index jd = nf->id(it);;
           if (id != jd) {
             allocator.construct(&(new_values[jd]), values[jd]);
             allocator.destroy(&(values[jd]));
@@ -235,31 +237,27 @@ namespace lemon {
     // and it overrides the add() member function of the observer base.
     virtual void add(const std::vector<Key>& keys) {
       Notifier* nf = Parent::notifier();
-      int max_id = -1;
+      Index max_id = -1;
       for (int i = 0; i < int(keys.size()); ++i) {
-        int id = nf->id(keys[i]);
+        Index id = nf->id(keys[i]);
         if (id > max_id) {
           max_id = id;
         }
       }
       if (max_id >= capacity) {
-        int new_capacity = (capacity == 0 ? 1 : capacity);
+        Index new_capacity = (capacity == 0 ? 1 : capacity);
         while (new_capacity <= max_id) {
           new_capacity <<= 1;
         }
         Value* new_values = allocator.allocate(new_capacity);
+        std::vector<bool> added(max_id + 1, false);
+        for (int i = 0; i < int(keys.size()); ++i) {
+          added[nf->id(keys[i])] = true;
+        }
         Item it;
         for (nf->first(it); it != INVALID; nf->next(it)) {
-          int id = nf->id(it);
-          bool found = false;
-          for (int i = 0; i < int(keys.size()); ++i) {
-            int jd = nf->id(keys[i]);
-            if (id == jd) {
-              found = true;
-              break;
-            }
-          }
-          if (found) continue;
+          Index id = nf->id(it);
+          if (added[id]) continue;
           allocator.construct(&(new_values[id]), values[id]);
           allocator.destroy(&(values[id]));
         }
@@ -268,7 +266,7 @@ namespace lemon {
         capacity = new_capacity;
       }
       for (int i = 0; i < int(keys.size()); ++i) {
-        int id = nf->id(keys[i]);
+        Index id = nf->id(keys[i]);
         allocator.construct(&(values[id]), Value());
       }
     }
@@ -278,7 +276,7 @@ namespace lemon {
     // Erase a key from the map. It is called by the observer notifier
     // and it overrides the erase() member function of the observer base.
     virtual void erase(const Key& key) {
-      int id = Parent::notifier()->id(key);
+      Index id = Parent::notifier()->id(key);
       allocator.destroy(&(values[id]));
     }
 
@@ -288,7 +286,7 @@ namespace lemon {
     // and it overrides the erase() member function of the observer base.
     virtual void erase(const std::vector<Key>& keys) {
       for (int i = 0; i < int(keys.size()); ++i) {
-        int id = Parent::notifier()->id(keys[i]);
+        Index id = Parent::notifier()->id(keys[i]);
         allocator.destroy(&(values[id]));
       }
     }
@@ -302,7 +300,7 @@ namespace lemon {
       allocate_memory();
       Item it;
       for (nf->first(it); it != INVALID; nf->next(it)) {
-        int id = nf->id(it);;
+        Index id = nf->id(it);;
         allocator.construct(&(values[id]), Value());
       }
     }
@@ -316,7 +314,7 @@ namespace lemon {
       if (capacity != 0) {
         Item it;
         for (nf->first(it); it != INVALID; nf->next(it)) {
-          int id = nf->id(it);
+          Index id = nf->id(it);
           allocator.destroy(&(values[id]));
         }
         allocator.deallocate(values, capacity);
@@ -324,10 +322,28 @@ namespace lemon {
       }
     }
 
+    // \brief Renumbers the keys of the map.
+    //
+    // It moves the values to the new identifiers of the keys. It is
+    // called by the observer notifier and it overrides the renumber()
+    // member function of the observer base.
+    virtual void renumber(const std::vector<Index>& ids) {
+      Value* old_values = values;
+      Index old_capacity = capacity;
+      allocate_memory();
+      for (Index i = 0; i < Index(ids.size()); ++i) {
+        if (ids[i] != -1) {
+          allocator.construct(&(values[ids[i]]), old_values[i]);
+          allocator.destroy(&(old_values[i]));
+        }
+      }
+      if (old_capacity != 0) allocator.deallocate(old_values, old_capacity);
+    }
+
   private:
 
     void allocate_memory() {
-      int max_id = Parent::notifier()->maxId();
+      Index max_id = Parent::notifier()->maxId();
       if (max_id == -1) {
         capacity = 0;
         values = 0;
@@ -340,7 +356,7 @@ namespace lemon {
       values = allocator.allocate(capacity);
     }
 
-    int capacity;
+    Index capacity;
     Value* values;
     Allocator allocator;
 
@@ -50,19 +50,19 @@ namespace lemon {
     typedef typename Parent::Node Node;
     typedef typename Parent::Arc Arc;
 
-    int maxId(Node) const {
+    Index maxId(Node) const {
       return Parent::maxNodeId();
     }
 
-    int maxId(Arc) const {
+    Index maxId(Arc) const {
       return Parent::maxArcId();
     }
 
-    static Node fromId(int id, Node) {
+    static Node fromId(Index id, Node) {
       return Parent::nodeFromId(id);
     }
 
-    static Arc fromId(int id, Arc) {
+    static Arc fromId(Index id, Arc) {
       return Parent::arcFromId(id);
     }
 
@@ -294,6 +294,24 @@ namespace lemon {
       return arc;
     }
 
+    void addNodes(Index n, std::vector<Node>& nodes) {
+      nodes.resize(n);
+      for (Index i = 0; i < n; ++i) {
+        nodes[i] = Parent::addNode();
+      }
+      notifier(Node()).add(nodes);
+    }
+
+    template <typename ArcListIterator>
+    void addArcs(ArcListIterator begin, ArcListIterator end,
+                 std::vector<Arc>& arcs) {
+      arcs.clear();
+      for ( ; begin != end; ++begin) {
+        arcs.push_back(Parent::addArc((*begin).first, (*begin).second));
+      }
+      notifier(Arc()).add(arcs);
+    }
+
     void clear() {
       notifier(Arc()).clear();
       notifier(Node()).clear();
@@ -0,0 +1,186 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_BITS_PARALLEL_H
+#define LEMON_BITS_PARALLEL_H
+
+//\file
+//\brief Minimal threading primitives used by the parallel algorithms.
+//
+//The implementation follows the \c LEMON_THREADING build option
+//(see \ref lemon/bits/lock.h). If no threading library is available,
+//every function here runs serially on the calling thread, so the
+//algorithms built on top of it produce the same results either way.
+
+#include <vector>
+#include <lemon/config.h>
+#include <lemon/bits/lock.h>
+
+#if defined(LEMON_USE_PTHREAD)
+#include <pthread.h>
+#include <unistd.h>
+#elif defined(LEMON_USE_WIN32_THREADS)
+#include <lemon/bits/windows.h>
+#endif
+
+namespace lemon {
+  namespace bits {
+
+    // Number of processors available for the parallel algorithms
+    inline int hardwareThreadNum() {
+#if defined(LEMON_USE_PTHREAD) && defined(_SC_NPROCESSORS_ONLN)
+      long num = sysconf(_SC_NPROCESSORS_ONLN);
+      return num > 0 ? int(num) : 1;
+#elif defined(LEMON_USE_WIN32_THREADS)
+      return getWinProcNum();
+#else
+      return 1;
+#endif
+    }
+
+    // Atomic fetch-and-add on an integer shared by several threads
+    inline int atomicFetchAdd(volatile int &value, int delta) {
+#if defined(LEMON_USE_PTHREAD)
+      return __sync_fetch_and_add(&value, delta);
+#elif defined(LEMON_USE_WIN32_THREADS)
+      return winFetchAdd(&value, delta);
+#else
+      int old = value;
+      value += delta;
+      return old;
+#endif
+    }
+
+    // Atomic compare-and-swap on an integer shared by several threads.
+    // It returns true if value was equal to expected and it has been
+    // replaced by desired.
+    inline bool atomicCompareAndSwap(volatile int &value,
+                                     int expected, int desired) {
+#if defined(LEMON_USE_PTHREAD)
+      return __sync_bool_compare_and_swap(&value, expected, desired);
+#elif defined(LEMON_USE_WIN32_THREADS)
+      return winCompareAndSwap(&value, expected, desired);
+#else
+      if (value != expected) return false;
+      value = desired;
+      return true;
+#endif
+    }
+
+    template <typename F>
+    struct ThreadData {
+      F *func;
+      int id;
+    };
+
+    template <typename F>
+    void *threadEntry(void *arg) {
+      ThreadData<F> *data = static_cast<ThreadData<F>*>(arg);
+      (*data->func)(data->id);
+      return 0;
+    }
+
+    // Call func(i) for every i in [0, num) on num threads, the
+    // calling thread executing func(0). It returns when all calls
+    // have finished.
+    template <typename F>
+    void runThreads(int num, F &func) {
+#if defined(LEMON_USE_PTHREAD) || defined(LEMON_USE_WIN32_THREADS)
+      if (num > 1) {
+        std::vector<ThreadData<F> > data(num);
+#if defined(LEMON_USE_PTHREAD)
+        std::vector<pthread_t> threads(num);
+#else
+        std::vector<void*> threads(num);
+#endif
+        std::vector<bool> started(num, false);
+        for (int i = 1; i < num; ++i) {
+          data[i].func = &func;
+          data[i].id = i;
+#if defined(LEMON_USE_PTHREAD)
+          started[i] = pthread_create(&threads[i], 0,
+                                      &threadEntry<F>, &data[i]) == 0;
+#else
+          threads[i] = startWinThread(&threadEntry<F>, &data[i]);
+          started[i] = threads[i] != 0;
+#endif
+        }
+        func(0);
+        for (int i = 1; i < num; ++i) {
+          if (started[i]) {
+#if defined(LEMON_USE_PTHREAD)
+            pthread_join(threads[i], 0);
+#else
+            joinWinThread(threads[i]);
+#endif
+          } else {
+            // Fall back to the calling thread
+            func(i);
+          }
+        }
+        return;
+      }
+#endif
+      for (int i = 0; i < num; ++i) {
+        func(i);
+      }
+    }
+
+    template <typename F>
+    class ParallelForWorker {
+    private:
+      F &_func;
+      int _size, _grain;
+      volatile int _next;
+    public:
+      ParallelForWorker(F &func, int size, int grain)
+        : _func(func), _size(size), _grain(grain), _next(0) {}
+      void operator()(int thread) {
+        while (true) {
+          int begin = atomicFetchAdd(_next, _grain);
+          if (begin >= _size) break;
+          int end = begin + _grain < _size ? begin + _grain : _size;
+          _func(thread, begin, end);
+        }
+      }
+    };
+
+    // Process the index range [0, size) in chunks of grain indices
+    // using num threads. The chunks are distributed dynamically and
+    // func(thread, begin, end) is called for each of them, where
+    // thread is in [0, num). If the range is small or num is 1,
+    // func(0, 0, size) is called on the calling thread.
+    template <typename F>
+    void parallelFor(int size, int num, F &func, int grain = 1024) {
+      if (size <= 0) return;
+      if (grain < 1) grain = 1;
+      if (num > (size + grain - 1) / grain) {
+        num = (size + grain - 1) / grain;
+      }
+      if (num <= 1) {
+        func(0, 0, size);
+        return;
+      }
+      ParallelForWorker<F> worker(func, size, grain);
+      runThreads(num, worker);
+    }
+
+  }
+}
+
+#endif
@@ -20,6 +20,9 @@
 #define LEMON_BITS_SOLVER_BITS_H
 
 #include <vector>
+#include <utility>
+#include <algorithm>
+#include <cmath>
 
 namespace lemon {
 
@@ -188,6 +191,185 @@ namespace lemon {
       }
 
     };
+
+    // Sparse vector of (index, value) pairs storing the coefficients of
+    // the linear expressions. The terms added by add() are appended to
+    // the end of the storage, so building an expression term by term
+    // does not allocate per term. Duplicate indices are allowed
+    // temporarily, the terms are sorted and merged by normalize(),
+    // which is called lazily by the non-const functions that need the
+    // canonical form. The const accessors (value(), normalized() and
+    // the const iterators) do not modify the storage.
+    template <typename V>
+    class SparseVector {
+    public:
+
+      typedef std::pair<int, V> value_type;
+      typedef typename std::vector<value_type>::iterator iterator;
+      typedef typename std::vector<value_type>::const_iterator
+        const_iterator;
+
+    private:
+
+      struct IndexLess {
+        bool operator()(const value_type& a, const value_type& b) const {
+          return a.first < b.first;
+        }
+      };
+
+      std::vector<value_type> _items;
+      bool _normal;
+
+    public:
+
+      SparseVector() : _normal(true) {}
+
+      // Sort the terms by index and merge the terms with equal indices
+      void normalize() {
+        if (_normal) return;
+        std::stable_sort(_items.begin(), _items.end(), IndexLess());
+        typename std::vector<value_type>::iterator it = _items.begin(),
+          jt = _items.begin();
+        while (jt != _items.end()) {
+          *it = *jt;
+          for (++jt; jt != _items.end() && jt->first == it->first; ++jt) {
+            it->second += jt->second;
+          }
+          ++it;
+        }
+        _items.erase(it, _items.end());
+        _normal = true;
+      }
+
+      // Whether the terms are sorted and the indices are unique
+      bool normal() const { return _normal; }
+
+      iterator begin() { normalize(); return _items.begin(); }
+      iterator end() { normalize(); return _items.end(); }
+
+      // The stored terms, they are in canonical form only if normal()
+      // is true (otherwise use normalized())
+      const_iterator begin() const { return _items.begin(); }
+      const_iterator end() const { return _items.end(); }
+
+      // The vector itself if it is normalized, otherwise a normalized
+      // copy of it stored in tmp
+      const SparseVector& normalized(SparseVector& tmp) const {
+        if (_normal) return *this;
+        tmp = *this;
+        tmp.normalize();
+        return tmp;
+      }
+
+      // The coefficient of idx
+      V value(int idx) const {
+        if (_normal) {
+          const_iterator it = std::lower_bound(_items.begin(), _items.end(),
+                                               value_type(idx, V()),
+                                               IndexLess());
+          return it != _items.end() && it->first == idx ? it->second : V();
+        }
+        V sum = V();
+        for (const_iterator it = _items.begin(); it != _items.end(); ++it) {
+          if (it->first == idx) sum += it->second;
+        }
+        return sum;
+      }
+
+      // Reference to the coefficient of idx, a zero term is inserted
+      // if idx is not stored yet
+      V& operator[](int idx) {
+        normalize();
+        iterator it = std::lower_bound(_items.begin(), _items.end(),
+                                       value_type(idx, V()), IndexLess());
+        if (it == _items.end() || it->first != idx) {
+          it = _items.insert(it, value_type(idx, V()));
+        }
+        return it->second;
+      }
+
+      // Set the coefficient of idx to v
+      void set(int idx, const V& v) {
+        normalize();
+        iterator it = std::lower_bound(_items.begin(), _items.end(),
+                                       value_type(idx, V()), IndexLess());
+        if (it != _items.end() && it->first == idx) {
+          it->second = v;
+        } else {
+          _items.insert(it, value_type(idx, v));
+        }
+      }
+
+      void erase(int idx) {
+        normalize();
+        iterator it = std::lower_bound(_items.begin(), _items.end(),
+                                       value_type(idx, V()), IndexLess());
+        if (it != _items.end() && it->first == idx) _items.erase(it);
+      }
+
+      // Add v to the coefficient of idx (in amortized constant time)
+      void add(int idx, const V& v) {
+        if (_normal && !_items.empty() && _items.back().first >= idx) {
+          _normal = false;
+        }
+        _items.push_back(value_type(idx, v));
+      }
+
+      // Add s times the terms of the given vector
+      void add(const SparseVector& other, const V& s) {
+        if (&other == this) {
+          scale(1 + s);
+          return;
+        }
+        if (other._items.empty()) return;
+        if (_normal && (!other._normal || (!_items.empty() &&
+            _items.back().first >= other._items.front().first))) {
+          _normal = false;
+        }
+        _items.reserve(_items.size() + other._items.size());
+        for (const_iterator it = other._items.begin();
+             it != other._items.end(); ++it) {
+          _items.push_back(value_type(it->first, s * it->second));
+        }
+      }
+
+      void scale(const V& s) {
+        for (iterator it = _items.begin(); it != _items.end(); ++it) {
+          it->second *= s;
+        }
+      }
+
+      void divide(const V& s) {
+        for (iterator it = _items.begin(); it != _items.end(); ++it) {
+          it->second /= s;
+        }
+      }
+
+      // Remove the terms whose absolute value does not exceed epsilon
+      void simplify(const V& epsilon) {
+        normalize();
+        iterator it = _items.begin();
+        for (iterator jt = _items.begin(); jt != _items.end(); ++jt) {
+          if (std::fabs(jt->second) > epsilon) *it++ = *jt;
+        }
+        _items.erase(it, _items.end());
+      }
+
+      void reserve(int n) {
+        _items.reserve(n);
+      }
+
+      void clear() {
+        _items.clear();
+        _normal = true;
+      }
+
+      void swap(SparseVector& other) {
+        _items.swap(other._items);
+        std::swap(_normal, other._normal);
+      }
+
+    };
   }
 }
 
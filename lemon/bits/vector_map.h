@@ -61,6 +61,8 @@ namespace lemon {
     typedef _Item Item;
     // The reference map tag.
     typedef True ReferenceMapTag;
+    // The values of different keys can be set concurrently.
+    typedef True ConcurrentSetTag;
 
     // The key type of the map.
     typedef _Item Key;
@@ -176,8 +178,8 @@ namespace lemon {
     // It adds a new key to the map. It is called by the observer notifier
     // and it overrides the add() member function of the observer base.
     virtual void add(const Key& key) {
-      int id = Parent::notifier()->id(key);
-      if (id >= int(container.size())) {
+      Index id = Parent::notifier()->id(key);
+      if (id >= Index(container.size())) {
         container.resize(id + 1);
       }
     }
@@ -187,9 +189,9 @@ namespace lemon {
     // It adds more new keys to the map. It is called by the observer notifier
     // and it overrides the add() member function of the observer base.
     virtual void add(const std::vector<Key>& keys) {
-      int max = container.size() - 1;
+      Index max = Index(container.size()) - 1;
       for (int i = 0; i < int(keys.size()); ++i) {
-        int id = Parent::notifier()->id(keys[i]);
+        Index id = Parent::notifier()->id(keys[i]);
         if (id >= max) {
           max = id;
         }
@@ -220,7 +222,7 @@ namespace lemon {
     // It builds the map. It is called by the observer notifier
     // and it overrides the build() member function of the observer base.
     virtual void build() {
-      int size = Parent::notifier()->maxId() + 1;
+      Index size = Parent::notifier()->maxId() + 1;
       container.reserve(size);
       container.resize(size);
     }
@@ -233,6 +235,21 @@ namespace lemon {
       container.clear();
     }
 
+    // \brief Renumbers the keys of the map.
+    //
+    // It moves the values to the new identifiers of the keys. It is
+    // called by the observer notifier and it overrides the renumber()
+    // member function of the observer base.
+    virtual void renumber(const std::vector<Index>& ids) {
+      Container new_container(Parent::notifier()->maxId() + 1);
+      for (Index i = 0; i < Index(ids.size()); ++i) {
+        if (ids[i] != -1) {
+          new_container[ids[i]] = container[i];
+        }
+      }
+      container.swap(new_container);
+    }
+
   private:
 
     Container container;
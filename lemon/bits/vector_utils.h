@@ -0,0 +1,65 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_BITS_VECTOR_UTILS_H
+#define LEMON_BITS_VECTOR_UTILS_H
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <cstddef>
+
+//\ingroup graphbits
+//\file
+//\brief Helper functions for the vector based graph storages
+namespace lemon {
+  namespace bits {
+
+    // Enlarges the capacity of the vector for k new elements
+    // keeping the amortized constant time of the insertions
+    template <typename T>
+    void reserveMore(std::vector<T>& v, std::ptrdiff_t k) {
+      std::size_t size = v.size() + k;
+      if (size > v.capacity()) {
+        v.reserve(std::max(size, 2 * v.size()));
+      }
+    }
+
+    template <typename Iterator>
+    std::ptrdiff_t rangeSize(Iterator, Iterator, std::input_iterator_tag) {
+      return 0;
+    }
+
+    template <typename Iterator>
+    std::ptrdiff_t rangeSize(Iterator begin, Iterator end,
+                             std::forward_iterator_tag) {
+      return std::distance(begin, end);
+    }
+
+    // Returns the length of the range [begin, end) if it can be traversed
+    // twice, otherwise 0 (a single pass input range is not measured)
+    template <typename Iterator>
+    std::ptrdiff_t rangeSize(Iterator begin, Iterator end) {
+      return rangeSize(begin, end,
+        typename std::iterator_traits<Iterator>::iterator_category());
+    }
+
+  }
+}
+
+#endif
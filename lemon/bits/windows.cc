@@ -20,6 +20,7 @@
 ///\brief Some basic non-inline functions and static global data.
 
 #include<lemon/bits/windows.h>
+#include<lemon/concept_check.h>
 
 #if defined(LEMON_WIN32) && defined(__GNUC__)
 #pragma GCC diagnostic ignored "-Wold-style-cast"
@@ -95,6 +96,32 @@ namespace lemon {
 #endif
     }
 
+    void getWinThreadTimes(double &rtime,
+                           double &utime, double &stime)
+    {
+#ifdef LEMON_WIN32
+      static const double ch = 4294967296.0e-7;
+      static const double cl = 1.0e-7;
+
+      FILETIME system;
+      GetSystemTimeAsFileTime(&system);
+      rtime = ch * system.dwHighDateTime + cl * system.dwLowDateTime;
+
+      FILETIME create, exit, kernel, user;
+      if (GetThreadTimes(GetCurrentThread(),&create, &exit, &kernel, &user)) {
+        utime = ch * user.dwHighDateTime + cl * user.dwLowDateTime;
+        stime = ch * kernel.dwHighDateTime + cl * kernel.dwLowDateTime;
+      } else {
+        rtime = 0;
+        utime = 0;
+        stime = 0;
+      }
+#else
+      double cutime, cstime;
+      getWinProcTimes(rtime, utime, stime, cutime, cstime);
+#endif
+    }
+
     std::string getWinFormattedDate()
     {
       std::ostringstream os;
@@ -135,6 +162,82 @@ namespace lemon {
 #endif
     }
 
+    int getWinProcNum()
+    {
+#ifdef LEMON_WIN32
+      SYSTEM_INFO info;
+      GetSystemInfo(&info);
+      return info.dwNumberOfProcessors > 0 ? info.dwNumberOfProcessors : 1;
+#else
+      long num = sysconf(_SC_NPROCESSORS_ONLN);
+      return num > 0 ? int(num) : 1;
+#endif
+    }
+
+#ifdef LEMON_WIN32
+    namespace {
+      struct WinThreadData {
+        void *(*func)(void*);
+        void *arg;
+      };
+
+      DWORD WINAPI winThreadEntry(LPVOID param) {
+        WinThreadData *data = static_cast<WinThreadData*>(param);
+        data->func(data->arg);
+        delete data;
+        return 0;
+      }
+    }
+#endif
+
+    void *startWinThread(void *(*func)(void*), void *arg) {
+#ifdef LEMON_WIN32
+      WinThreadData *data = new WinThreadData;
+      data->func = func;
+      data->arg = arg;
+      HANDLE thread = CreateThread(0, 0, &winThreadEntry, data, 0, 0);
+      if (thread == 0) delete data;
+      return thread;
+#else
+      ignore_unused_variable_warning(func);
+      ignore_unused_variable_warning(arg);
+      return 0;
+#endif
+    }
+
+    void joinWinThread(void *thread) {
+#ifdef LEMON_WIN32
+      HANDLE handle = static_cast<HANDLE>(thread);
+      WaitForSingleObject(handle, INFINITE);
+      CloseHandle(handle);
+#else
+      ignore_unused_variable_warning(thread);
+#endif
+    }
+
+    int winFetchAdd(volatile int *value, int delta) {
+#ifdef LEMON_WIN32
+      return InterlockedExchangeAdd(reinterpret_cast<volatile LONG*>(value),
+                                    delta);
+#else
+      int old = *value;
+      *value += delta;
+      return old;
+#endif
+    }
+
+    bool winCompareAndSwap(volatile int *value, int expected, int desired) {
+#ifdef LEMON_WIN32
+      return InterlockedCompareExchange(
+        reinterpret_cast<volatile LONG*>(value), desired, expected) ==
+        expected;
+#else
+      if (*value != expected) return false;
+      *value = desired;
+      return true;
+#endif
+    }
+
     WinLock::WinLock() {
 #ifdef LEMON_WIN32
       CRITICAL_SECTION *lock = new CRITICAL_SECTION;
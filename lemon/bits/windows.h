@@ -27,8 +27,16 @@ namespace lemon {
     void getWinProcTimes(double &rtime,
                          double &utime, double &stime,
                          double &cutime, double &cstime);
+    void getWinThreadTimes(double &rtime,
+                           double &utime, double &stime);
     std::string getWinFormattedDate();
     int getWinRndSeed();
+    int getWinProcNum();
+
+    void *startWinThread(void *(*func)(void*), void *arg);
+    void joinWinThread(void *thread);
+    int winFetchAdd(volatile int *value, int delta);
+    bool winCompareAndSwap(volatile int *value, int expected, int desired);
 
     class WinLock {
     public:
@@ -21,7 +21,9 @@
 
 #include <lemon/tolerance.h>
 #include <lemon/elevator.h>
+#include <lemon/bits/parallel.h>
 #include <limits>
+#include <vector>
 
 ///\ingroup max_flow
 ///\file
@@ -166,6 +168,15 @@ namespace lemon {
      Note that this algorithm also provides a feasible solution for the
      \ref min_cost_flow "minimum cost flow problem".
 
+     The \ref start() function can use several threads (see
+     \ref threadNum()). In this case, a synchronous parallel variant of
+     the push-relabel method is applied, in which all active nodes
+     push and relabel simultaneously in rounds, and the distance labels
+     are recomputed from time to time by a parallel breadth-first
+     search. The result of the parallel variant does not depend on the
+     number of threads, but it may differ from the result of the
+     sequential one.
+
      \tparam GR The type of the digraph the algorithm runs on.
      \tparam LM The type of the lower bound map. The default
      map type is \ref concepts::Digraph::ArcMap "GR::ArcMap<int>".
@@ -240,6 +251,8 @@ template< typename GR,
     Tolerance _tol;
     int _el;
 
+    int _thread_num;
+
   public:
 
     typedef Circulation Create;
@@ -345,7 +358,7 @@ template< typename GR,
                 const UpperMap &upper, const SupplyMap &supply)
       : _g(graph), _lo(&lower), _up(&upper), _supply(&supply),
         _flow(NULL), _local_flow(false), _level(NULL), _local_level(false),
-        _excess(NULL) {}
+        _excess(NULL), _thread_num(1) {}
 
     /// Destructor.
     ~Circulation() {
@@ -390,6 +403,291 @@ template< typename GR,
       }
     }
 
+    // Data of the parallel push-relabel method
+    struct ParallelData {
+      std::vector<Node> nodes;
+      IntNodeMap index;
+      std::vector<int> label;
+      std::vector<int> new_label;
+      std::vector<int> flag;
+      typename Digraph::template ArcMap<Value> delta;
+      std::vector<std::vector<int> > touched, relabel, next;
+      std::vector<std::vector<Arc> > pushed;
+
+      ParallelData(const Digraph& g, int thread_num)
+        : index(g), delta(g, 0), touched(thread_num),
+          relabel(thread_num), next(thread_num), pushed(thread_num) {}
+    };
+
+    enum ParallelPhase {
+      PUSH, UPDATE, CLEAR, RELABEL, SEARCH
+    };
+
+    // Execute a phase of the parallel method on a range of items
+    class ParallelWorker {
+    private:
+      Circulation &_circ;
+      ParallelData &_data;
+      const std::vector<int> &_items;
+      ParallelPhase _phase;
+      int _dist;
+    public:
+      ParallelWorker(Circulation &circ, ParallelData &data,
+                     const std::vector<int> &items, ParallelPhase phase,
+                     int dist = 0)
+        : _circ(circ), _data(data), _items(items), _phase(phase),
+          _dist(dist) {}
+      void operator()(int thread, int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+          switch (_phase) {
+          case PUSH:
+            _circ.parallelPush(_data, thread, _items[i]);
+            break;
+          case UPDATE:
+            _circ.parallelUpdate(_data, _items[i]);
+            break;
+          case CLEAR:
+            _circ.parallelClear(_data, _items[i]);
+            break;
+          case RELABEL:
+            _data.new_label[i] = _circ.parallelRelabel(_data, _items[i]);
+            break;
+          case SEARCH:
+            _circ.parallelSearch(_data, thread, _items[i], _dist);
+            break;
+          }
+        }
+      }
+    };
+
+    void runPhase(ParallelData& d, const std::vector<int>& items,
+                  ParallelPhase phase, int dist = 0) {
+      ParallelWorker worker(*this, d, items, phase, dist);
+      bits::parallelFor(items.size(), _thread_num, worker, 256);
+    }
+
+    // Move the contents of the thread local lists into a single list
+    static void gatherLists(std::vector<std::vector<int> >& lists,
+                            std::vector<int>& result) {
+      result.clear();
+      for (int t = 0; t < int(lists.size()); ++t) {
+        result.insert(result.end(), lists[t].begin(), lists[t].end());
+        lists[t].clear();
+      }
+    }
+
+    // Mark a node as touched in the current round
+    void touchNode(ParallelData& d, int thread, int i) {
+      if (bits::atomicCompareAndSwap(d.flag[i], 0, 1)) {
+        d.touched[thread].push_back(i);
+      }
+    }
+
+    // Push the excess of an active node to the nodes on lower levels.
+    // An arc can only be used from its endpoint with the higher label,
+    // so the threads modify disjoint sets of arcs, and the changes of
+    // the excesses are collected in the delta map.
+    void parallelPush(ParallelData& d, int thread, int i) {
+      Node act = d.nodes[i];
+      int actlevel = d.label[i];
+      Value exc = (*_excess)[act];
+      touchNode(d, thread, i);
+
+      for (OutArcIt e(_g, act); e != INVALID; ++e) {
+        int j = d.index[_g.target(e)];
+        if (d.label[j] >= actlevel) continue;
+        Value fc = (*_up)[e] - (*_flow)[e];
+        if (!_tol.positive(fc)) continue;
+        touchNode(d, thread, j);
+        d.pushed[thread].push_back(e);
+        if (!_tol.less(fc, exc)) {
+          _flow->set(e, (*_flow)[e] + exc);
+          d.delta[e] = exc;
+          return;
+        }
+        _flow->set(e, (*_up)[e]);
+        d.delta[e] = fc;
+        exc -= fc;
+      }
+      for (InArcIt e(_g, act); e != INVALID; ++e) {
+        int j = d.index[_g.source(e)];
+        if (d.label[j] >= actlevel) continue;
+        Value fc = (*_flow)[e] - (*_lo)[e];
+        if (!_tol.positive(fc)) continue;
+        touchNode(d, thread, j);
+        d.pushed[thread].push_back(e);
+        if (!_tol.less(fc, exc)) {
+          _flow->set(e, (*_flow)[e] - exc);
+          d.delta[e] = -exc;
+          return;
+        }
+        _flow->set(e, (*_lo)[e]);
+        d.delta[e] = -fc;
+        exc -= fc;
+      }
+      if (_tol.positive(exc)) d.relabel[thread].push_back(i);
+    }
+
+    // Update the excess of a touched node
+    void parallelUpdate(ParallelData& d, int i) {
+      Node n = d.nodes[i];
+      Value exc = (*_excess)[n];
+      for (InArcIt e(_g, n); e != INVALID; ++e) exc += d.delta[e];
+      for (OutArcIt e(_g, n); e != INVALID; ++e) exc -= d.delta[e];
+      (*_excess)[n] = exc;
+      d.flag[i] = 0;
+    }
+
+    // Clear the delta values of the arcs used by a thread
+    void parallelClear(ParallelData& d, int thread) {
+      std::vector<Arc>& arcs = d.pushed[thread];
+      for (int k = 0; k < int(arcs.size()); ++k) d.delta[arcs[k]] = 0;
+      arcs.clear();
+    }
+
+    // Compute the new label of a node that still has excess
+    int parallelRelabel(ParallelData& d, int i) {
+      Node n = d.nodes[i];
+      int mlevel = _node_num;
+      for (OutArcIt e(_g, n); e != INVALID; ++e) {
+        if (_tol.positive((*_up)[e] - (*_flow)[e])) {
+          int l = d.label[d.index[_g.target(e)]] + 1;
+          if (l < mlevel) mlevel = l;
+        }
+      }
+      for (InArcIt e(_g, n); e != INVALID; ++e) {
+        if (_tol.positive((*_flow)[e] - (*_lo)[e])) {
+          int l = d.label[d.index[_g.source(e)]] + 1;
+          if (l < mlevel) mlevel = l;
+        }
+      }
+      return mlevel;
+    }
+
+    // Label the unvisited nodes that have a residual arc to the given
+    // node of the current level of the breadth-first search
+    void parallelSearch(ParallelData& d, int thread, int i, int dist) {
+      Node n = d.nodes[i];
+      for (InArcIt e(_g, n); e != INVALID; ++e) {
+        if (!_tol.positive((*_up)[e] - (*_flow)[e])) continue;
+        int j = d.index[_g.source(e)];
+        if (d.label[j] == _node_num &&
+            bits::atomicCompareAndSwap(d.label[j], _node_num, dist)) {
+          d.next[thread].push_back(j);
+        }
+      }
+      for (OutArcIt e(_g, n); e != INVALID; ++e) {
+        if (!_tol.positive((*_flow)[e] - (*_lo)[e])) continue;
+        int j = d.index[_g.target(e)];
+        if (d.label[j] == _node_num &&
+            bits::atomicCompareAndSwap(d.label[j], _node_num, dist)) {
+          d.next[thread].push_back(j);
+        }
+      }
+    }
+
+    // Set the labels to the exact distances from the deficit nodes in
+    // the residual graph. It returns false if a node having excess
+    // cannot reach any deficit node, i.e. no feasible solution exists.
+    bool parallelGlobalRelabel(ParallelData& d) {
+      std::vector<int> level;
+      for (int i = 0; i < _node_num; ++i) {
+        if (_tol.negative((*_excess)[d.nodes[i]])) {
+          d.label[i] = 0;
+          level.push_back(i);
+        } else {
+          d.label[i] = _node_num;
+        }
+      }
+      for (int dist = 1; !level.empty(); ++dist) {
+        runPhase(d, level, SEARCH, dist);
+        gatherLists(d.next, level);
+      }
+      for (int i = 0; i < _node_num; ++i) {
+        if (d.label[i] == _node_num &&
+            _tol.positive((*_excess)[d.nodes[i]])) return false;
+      }
+      return true;
+    }
+
+    // Store the labels in the elevator. The nodes on the top level
+    // form the barrier if no feasible solution exists.
+    void parallelFinish(ParallelData& d, bool feasible) {
+      int max_level = feasible ? _node_num - 1 : _node_num;
+      std::vector<std::vector<int> > buckets;
+      for (int i = 0; i < _node_num; ++i) {
+        int l = d.label[i] < max_level ? d.label[i] : max_level;
+        if (l == _node_num) continue;
+        if (l >= int(buckets.size())) buckets.resize(l + 1);
+        buckets[l].push_back(i);
+      }
+      _level->initStart();
+      for (int l = 0; l < int(buckets.size()); ++l) {
+        if (l > 0) _level->initNewLevel();
+        for (int k = 0; k < int(buckets[l].size()); ++k) {
+          _level->initAddItem(d.nodes[buckets[l][k]]);
+        }
+      }
+      _level->initFinish();
+      _el = _node_num;
+    }
+
+    // The parallel variant of start()
+    bool parallelStart() {
+      ParallelData d(_g, _thread_num);
+      for (NodeIt n(_g); n != INVALID; ++n) {
+        d.index[n] = d.nodes.size();
+        d.nodes.push_back(n);
+      }
+      d.label.resize(_node_num);
+      d.flag.resize(_node_num, 0);
+      std::vector<int> threads;
+      for (int t = 0; t < _thread_num; ++t) threads.push_back(t);
+
+      bool feasible = parallelGlobalRelabel(d);
+      std::vector<int> active, touched, relabel;
+      if (feasible) {
+        for (int i = 0; i < _node_num; ++i) {
+          if (_tol.positive((*_excess)[d.nodes[i]])) active.push_back(i);
+        }
+      }
+
+      int relabel_num = 0;
+      while (!active.empty()) {
+        runPhase(d, active, PUSH);
+        gatherLists(d.touched, touched);
+        gatherLists(d.relabel, relabel);
+        runPhase(d, touched, UPDATE);
+        runPhase(d, threads, CLEAR);
+
+        d.new_label.resize(relabel.size());
+        runPhase(d, relabel, RELABEL);
+        bool top = false;
+        for (int k = 0; k < int(relabel.size()); ++k) {
+          d.label[relabel[k]] = d.new_label[k];
+          if (d.new_label[k] == _node_num) top = true;
+        }
+        relabel_num += relabel.size();
+        if (top || relabel_num >= _node_num) {
+          relabel_num = 0;
+          if (!parallelGlobalRelabel(d)) {
+            feasible = false;
+            break;
+          }
+        }
+
+        active.clear();
+        for (int k = 0; k < int(touched.size()); ++k) {
+          int i = touched[k];
+          if (d.label[i] < _node_num &&
+              _tol.positive((*_excess)[d.nodes[i]])) active.push_back(i);
+        }
+      }
+
+      parallelFinish(d, feasible);
+      return feasible;
+    }
+
   public:
 
     /// Sets the lower bound map.
@@ -480,6 +778,31 @@ template< typename GR,
       return _tol;
     }
 
+    /// \brief Sets the number of threads used by the algorithm.
+    ///
+    /// This function sets the number of threads used by \ref start().
+    /// If the given number is less than one, then the number of the
+    /// hardware threads is used. By default, the algorithm is executed
+    /// on a single thread.
+    /// If LEMON is built without threading support, the parallel
+    /// variant is executed on a single thread.
+    ///
+    /// \note If more than one thread is used, then a parallel variant
+    /// of the algorithm is applied, so the found flow and barrier may
+    /// differ from the ones found by the sequential algorithm.
+    /// \return <tt>(*this)</tt>
+    Circulation& threadNum(int num) {
+      _thread_num = num < 1 ? bits::hardwareThreadNum() : num;
+      return *this;
+    }
+
+    /// \brief Returns the number of threads used by the algorithm.
+    ///
+    /// Returns the number of threads used by the algorithm.
+    int threadNum() const {
+      return _thread_num;
+    }
+
     /// \name Execution Control
     /// The simplest way to execute the algorithm is to call \ref run().\n
     /// If you need better control on the initial solution or the execution,
@@ -571,6 +894,7 @@ template< typename GR,
     ///\sa barrierMap()
     bool start()
     {
+      if (_thread_num > 1) return parallelStart();
 
       Node act;
       while((act=_level->highestActive())!=INVALID) {
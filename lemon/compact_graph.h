@@ -49,8 +49,8 @@ namespace lemon {
     class Node {
       friend class CompactDigraphBase;
     protected:
-      int id;
-      Node(int _id) : id(_id) {}
+      Index id;
+      Node(Index _id) : id(_id) {}
     public:
       Node() {}
       Node (Invalid) : id(-1) {}
@@ -62,9 +62,9 @@ namespace lemon {
     class Arc {
       friend class CompactDigraphBase;
     protected:
-      int id;
-      int source;
-      Arc(int _id, int _source) : id(_id), source(_source) {}
+      Index id;
+      Index source;
+      Arc(Index _id, Index _source) : id(_id), source(_source) {}
     public:
       Arc() { }
       Arc (Invalid) : id(-1), source(-1) {}
@@ -83,7 +83,7 @@ namespace lemon {
 
     void nextSource(Arc& e) const {
       if (e.id == -1) return;
-      int last = node_first_out[e.source] - 1;
+      Index last = node_first_out[e.source] - 1;
       while (e.id == last) {
         --e.source;
         last = node_first_out[e.source] - 1;
@@ -125,23 +125,26 @@ namespace lemon {
       } while(e != INVALID && target(e) != arcTarget);
     }
 
-    static int id(const Node& n) { return n.id; }
-    static Node nodeFromId(int id) { return Node(id); }
-    int maxNodeId() const { return node_num - 1; }
+    static Index id(const Node& n) { return n.id; }
+    static Node nodeFromId(Index id) { return Node(id); }
+    Index maxNodeId() const { return node_num - 1; }
 
-    static int id(const Arc& e) { return e.id; }
-    Arc arcFromId(int id) const {
-      int *l = std::upper_bound(node_first_out, node_first_out + node_num, id) - 1;
-      int src = l - node_first_out;
+    static Index id(const Arc& e) { return e.id; }
+    Arc arcFromId(Index id) const {
+      Index *l =
+        std::upper_bound(node_first_out, node_first_out + node_num, id) - 1;
+      Index src = l - node_first_out;
       return Arc(id, src);
     }
-    int maxArcId() const { return arc_num - 1; }
+    Index maxArcId() const { return arc_num - 1; }
 
     typedef True NodeNumTag;
     typedef True ArcNumTag;
+    // The entering arcs cannot be iterated efficiently
+    typedef True SlowInArcTag;
 
-    int nodeNum() const { return node_num; }
-    int arcNum() const { return arc_num; }
+    Index nodeNum() const { return node_num; }
+    Index arcNum() const { return arc_num; }
 
   private:
 
@@ -185,11 +188,11 @@ namespace lemon {
       node_num = countNodes(digraph);
       arc_num = countArcs(digraph);
 
-      node_first_out = new int[node_num + 1];
+      node_first_out = new Index[node_num + 1];
 
-      arc_target = new int[arc_num];
+      arc_target = new Index[arc_num];
 
-      int node_index = 0;
+      Index node_index = 0;
       for (typename Digraph::NodeIt n(digraph); n != INVALID; ++n) {
         nodeRef[n] = Node(node_index);
         ++node_index;
@@ -197,9 +200,9 @@ namespace lemon {
 
       ArcLess<Digraph, NodeRefMap> arcLess(digraph, nodeRef);
 
-      int arc_index = 0;
+      Index arc_index = 0;
       for (typename Digraph::NodeIt n(digraph); n != INVALID; ++n) {
-        int source = nodeRef[n].id;
+        Index source = nodeRef[n].id;
         std::vector<GArc> arcs;
         for (typename Digraph::OutArcIt e(digraph, n); e != INVALID; ++e) {
           arcs.push_back(e);
@@ -209,7 +212,7 @@ namespace lemon {
           std::sort(arcs.begin(), arcs.end(), arcLess);
           for (typename std::vector<GArc>::iterator it = arcs.begin();
                it != arcs.end(); ++it) {
-            int target = nodeRef[digraph.target(*it)].id;
+            Index target = nodeRef[digraph.target(*it)].id;
             arcRef[*it] = Arc(arc_index, source);
             arc_target[arc_index] = target;
             ++arc_index;
@@ -222,21 +225,21 @@ namespace lemon {
     }
 
     template <typename ArcListIterator>
-    void build(int n, ArcListIterator first, ArcListIterator last) {
+    void build(Index n, ArcListIterator first, ArcListIterator last) {
       built = true;
 
       node_num = n;
-      arc_num = static_cast<int>(std::distance(first, last));
+      arc_num = static_cast<Index>(std::distance(first, last));
 
-      node_first_out = new int[node_num + 1];
+      node_first_out = new Index[node_num + 1];
 
-      arc_target = new int[arc_num];
+      arc_target = new Index[arc_num];
 
-      int arc_index = 0;
-      for (int i = 0; i != node_num; ++i) {
+      Index arc_index = 0;
+      for (Index i = 0; i != node_num; ++i) {
         node_first_out[i] = arc_index;
         for ( ; first != last && (*first).first == i; ++first) {
-          int j = (*first).second;
+          Index j = (*first).second;
           LEMON_ASSERT(j >= 0 && j < node_num,
             "Wrong arc list for CompactDigraph::build()");
           arc_target[arc_index] = j;
@@ -250,10 +253,10 @@ namespace lemon {
 
   protected:
     bool built;
-    int node_num;
-    int arc_num;
-    int *node_first_out;
-    int *arc_target;
+    Index node_num;
+    Index arc_num;
+    Index *node_first_out;
+    Index *arc_target;
   };
 
   typedef DigraphExtender<CompactDigraphBase> ExtendedCompactDigraphBase;
@@ -267,9 +270,10 @@ namespace lemon {
   /// similar to \ref StaticDigraph. It is more memory efficient but does
   /// not provide efficient iteration over incoming arcs.
   ///
-  /// It stores only one \c int values for each node and one \c int value
-  /// for each arc. Its \ref InArcIt implementation is inefficient and
-  /// provided only for compatibility with the \ref concepts::Digraph "Digraph concept".
+  /// It stores only one \ref Index value for each node and one
+  /// \ref Index value for each arc. Its \ref InArcIt implementation is
+  /// inefficient and provided only for compatibility with the
+  /// \ref concepts::Digraph "Digraph concept".
   ///
   /// This type fully conforms to the \ref concepts::Digraph "Digraph concept".
   /// Most of its member functions and nested classes are documented
@@ -300,35 +304,35 @@ namespace lemon {
     ///
     /// This function returns the node with the given index.
     /// \sa index()
-    static Node node(int ix) { return Parent::nodeFromId(ix); }
+    static Node node(Index ix) { return Parent::nodeFromId(ix); }
 
     /// \brief The arc with the given index.
     ///
     /// This function returns the arc with the given index.
     /// \sa index()
-    Arc arc(int ix) { return arcFromId(ix); }
+    Arc arc(Index ix) { return arcFromId(ix); }
 
     /// \brief The index of the given node.
     ///
     /// This function returns the index of the the given node.
     /// \sa node()
-    static int index(Node node) { return Parent::id(node); }
+    static Index index(Node node) { return Parent::id(node); }
 
     /// \brief The index of the given arc.
     ///
     /// This function returns the index of the the given arc.
     /// \sa arc()
-    static int index(Arc arc) { return Parent::id(arc); }
+    static Index index(Arc arc) { return Parent::id(arc); }
 
     /// \brief Number of nodes.
     ///
     /// This function returns the number of nodes.
-    int nodeNum() const { return node_num; }
+    Index nodeNum() const { return node_num; }
 
     /// \brief Number of arcs.
     ///
     /// This function returns the number of arcs.
-    int arcNum() const { return arc_num; }
+    Index arcNum() const { return arc_num; }
 
     /// \brief Build the digraph copying another digraph.
     ///
@@ -391,7 +395,7 @@ namespace lemon {
     ///   gr.build(4, arcs.begin(), arcs.end());
     /// \endcode
     template <typename ArcListIterator>
-    void build(int n, ArcListIterator begin, ArcListIterator end) {
+    void build(Index n, ArcListIterator begin, ArcListIterator end) {
       if (built) Parent::clear();
       CompactDigraphBase::build(n, begin, end);
       notifier(Node()).build();
@@ -0,0 +1,572 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_COMPRESSED_GRAPH_H
+#define LEMON_COMPRESSED_GRAPH_H
+
+///\ingroup graphs
+///\file
+///\brief CompressedDigraph class.
+
+#include <lemon/core.h>
+#include <lemon/bits/graph_extender.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace lemon {
+
+  class CompressedDigraphBase {
+
+  public:
+
+    CompressedDigraphBase()
+      : built(false), node_num(0), arc_num(0),
+        node_first_out(NULL), node_first_byte(NULL),
+        arc_data(NULL) {}
+
+    ~CompressedDigraphBase() {
+      if (built) {
+        delete[] node_first_out;
+        delete[] node_first_byte;
+        delete[] arc_data;
+      }
+    }
+
+    class Node {
+      friend class CompressedDigraphBase;
+    protected:
+      Index id;
+      Node(Index _id) : id(_id) {}
+    public:
+      Node() {}
+      Node (Invalid) : id(-1) {}
+      bool operator==(const Node& node) const { return id == node.id; }
+      bool operator!=(const Node& node) const { return id != node.id; }
+      bool operator<(const Node& node) const { return id < node.id; }
+    };
+
+    class Arc {
+      friend class CompressedDigraphBase;
+    protected:
+      Index id;
+      Index source;
+      Index target;
+      // The position of the code of the next outgoing arc
+      std::size_t pos;
+      Arc(Index _id, Index _source, Index _target, std::size_t _pos)
+        : id(_id), source(_source), target(_target), pos(_pos) {}
+    public:
+      Arc() { }
+      Arc (Invalid) : id(-1), source(-1), target(-1), pos(0) {}
+      bool operator==(const Arc& arc) const { return id == arc.id; }
+      bool operator!=(const Arc& arc) const { return id != arc.id; }
+      bool operator<(const Arc& arc) const { return id < arc.id; }
+    };
+
+    Node source(const Arc& e) const { return Node(e.source); }
+    Node target(const Arc& e) const { return Node(e.target); }
+
+    void first(Node& n) const { n.id = node_num - 1; }
+    static void next(Node& n) { --n.id; }
+
+  private:
+
+#ifdef LEMON_64BIT_IDS
+    typedef unsigned long long Code;
+#else
+    typedef unsigned int Code;
+#endif
+
+    // The difference of two targets is stored in zigzag encoding
+    // (0, -1, 1, -2, ... are mapped to 0, 1, 2, 3, ...) using
+    // 7 bits per byte, the highest bit marks the continuation.
+    static Code encode(Index diff) {
+      return diff >= 0 ? Code(diff) << 1 : ((Code(-(diff + 1))) << 1) | 1;
+    }
+
+    static int codeLength(Code code) {
+      int len = 1;
+      while (code >= 0x80) {
+        code >>= 7;
+        ++len;
+      }
+      return len;
+    }
+
+    static void writeCode(unsigned char* data, std::size_t& pos, Code code) {
+      while (code >= 0x80) {
+        data[pos++] = static_cast<unsigned char>((code & 0x7f) | 0x80);
+        code >>= 7;
+      }
+      data[pos++] = static_cast<unsigned char>(code);
+    }
+
+    Index readDiff(std::size_t& pos) const {
+      Code code = 0;
+      int shift = 0;
+      unsigned char c;
+      do {
+        c = arc_data[pos++];
+        code |= Code(c & 0x7f) << shift;
+        shift += 7;
+      } while (c & 0x80);
+      return (code & 1) ? -Index(code >> 1) - 1 : Index(code >> 1);
+    }
+
+    // Sets e to the first outgoing arc of s, which must have one
+    void firstOf(Arc& e, Index s) const {
+      e.source = s;
+      e.id = node_first_out[s];
+      e.pos = node_first_byte[s];
+      e.target = s + readDiff(e.pos);
+    }
+
+    void nextSource(Arc& e) const {
+      do {
+        --e.source;
+      } while (e.source >= 0 &&
+               node_first_out[e.source] == node_first_out[e.source + 1]);
+      if (e.source >= 0) {
+        firstOf(e, e.source);
+      } else {
+        e = INVALID;
+      }
+    }
+
+  public:
+
+    void first(Arc& e) const {
+      e.source = node_num;
+      nextSource(e);
+    }
+    void next(Arc& e) const {
+      ++e.id;
+      if (e.id == node_first_out[e.source + 1]) {
+        nextSource(e);
+      } else {
+        e.target += readDiff(e.pos);
+      }
+    }
+
+    void firstOut(Arc& e, const Node& n) const {
+      if (node_first_out[n.id] == node_first_out[n.id + 1]) {
+        e = INVALID;
+      } else {
+        firstOf(e, n.id);
+      }
+    }
+    void nextOut(Arc& e) const {
+      ++e.id;
+      if (e.id == node_first_out[e.source + 1]) {
+        e = INVALID;
+      } else {
+        e.target += readDiff(e.pos);
+      }
+    }
+
+    void firstIn(Arc& e, const Node& n) const {
+      first(e);
+      while(e != INVALID && e.target != n.id) {
+        next(e);
+      }
+    }
+    void nextIn(Arc& e) const {
+      Index arcTarget = e.target;
+      do {
+        next(e);
+      } while(e != INVALID && e.target != arcTarget);
+    }
+
+    static Index id(const Node& n) { return n.id; }
+    static Node nodeFromId(Index id) { return Node(id); }
+    Index maxNodeId() const { return node_num - 1; }
+
+    static Index id(const Arc& e) { return e.id; }
+    Arc arcFromId(Index id) const {
+      if (id < 0) return INVALID;
+      Index *l =
+        std::upper_bound(node_first_out, node_first_out + node_num, id) - 1;
+      Arc e;
+      firstOf(e, l - node_first_out);
+      while (e.id != id) {
+        ++e.id;
+        e.target += readDiff(e.pos);
+      }
+      return e;
+    }
+    Index maxArcId() const { return arc_num - 1; }
+
+    typedef True NodeNumTag;
+    typedef True ArcNumTag;
+    // The entering arcs cannot be iterated efficiently
+    typedef True SlowInArcTag;
+
+    Index nodeNum() const { return node_num; }
+    Index arcNum() const { return arc_num; }
+
+  private:
+
+    template <typename Digraph, typename NodeRefMap>
+    class ArcLess {
+    public:
+      typedef typename Digraph::Arc Arc;
+
+      ArcLess(const Digraph &_graph, const NodeRefMap& _nodeRef)
+        : digraph(_graph), nodeRef(_nodeRef) {}
+
+      bool operator()(const Arc& left, const Arc& right) const {
+        return nodeRef[digraph.target(left)] < nodeRef[digraph.target(right)];
+      }
+    private:
+      const Digraph& digraph;
+      const NodeRefMap& nodeRef;
+    };
+
+  public:
+
+    typedef True BuildTag;
+
+    void clear() {
+      if (built) {
+        delete[] node_first_out;
+        delete[] node_first_byte;
+        delete[] arc_data;
+      }
+      built = false;
+      node_num = 0;
+      arc_num = 0;
+    }
+
+    template <typename Digraph, typename NodeRefMap, typename ArcRefMap>
+    void build(const Digraph& digraph, NodeRefMap& nodeRef, ArcRefMap& arcRef) {
+      typedef typename Digraph::Arc GArc;
+
+      built = true;
+
+      node_num = countNodes(digraph);
+      arc_num = countArcs(digraph);
+
+      node_first_out = new Index[node_num + 1];
+      node_first_byte = new std::size_t[node_num + 1];
+
+      Index node_index = 0;
+      for (typename Digraph::NodeIt n(digraph); n != INVALID; ++n) {
+        nodeRef[n] = Node(node_index);
+        ++node_index;
+      }
+
+      ArcLess<Digraph, NodeRefMap> arcLess(digraph, nodeRef);
+
+      // The codes are collected first, since their total length
+      // is not known in advance
+      std::vector<unsigned char> data;
+      unsigned char buf[(8 * sizeof(Code) + 6) / 7];
+      Index arc_index = 0;
+      for (typename Digraph::NodeIt n(digraph); n != INVALID; ++n) {
+        Index source = nodeRef[n].id;
+        node_first_out[source] = arc_index;
+        node_first_byte[source] = data.size();
+        std::vector<GArc> arcs;
+        for (typename Digraph::OutArcIt e(digraph, n); e != INVALID; ++e) {
+          arcs.push_back(e);
+        }
+        std::sort(arcs.begin(), arcs.end(), arcLess);
+        Index prev = source;
+        for (typename std::vector<GArc>::iterator it = arcs.begin();
+             it != arcs.end(); ++it) {
+          Index target = nodeRef[digraph.target(*it)].id;
+          std::size_t len = 0;
+          writeCode(buf, len, encode(target - prev));
+          data.insert(data.end(), buf, buf + len);
+          arcRef[*it] = Arc(arc_index, source, target, data.size());
+          prev = target;
+          ++arc_index;
+        }
+      }
+      node_first_out[node_num] = arc_num;
+      node_first_byte[node_num] = data.size();
+
+      arc_data = new unsigned char[data.size()];
+      std::copy(data.begin(), data.end(), arc_data);
+    }
+
+    template <typename ArcListIterator>
+    void build(Index n, ArcListIterator first, ArcListIterator last) {
+      built = true;
+
+      node_num = n;
+      arc_num = static_cast<Index>(std::distance(first, last));
+
+      node_first_out = new Index[node_num + 1];
+      node_first_byte = new std::size_t[node_num + 1];
+
+      // The first pass determines the lengths of the codes
+      std::size_t byte_num = 0;
+      Index prev = -1, prev_source = -1;
+      for (ArcListIterator it = first; it != last; ++it) {
+        Index i = (*it).first;
+        Index j = (*it).second;
+        LEMON_ASSERT(i >= prev_source && i < node_num &&
+                     j >= 0 && j < node_num,
+          "Wrong arc list for CompressedDigraph::build()");
+        if (i != prev_source) prev = i;
+        byte_num += codeLength(encode(j - prev));
+        prev = j;
+        prev_source = i;
+      }
+
+      arc_data = new unsigned char[byte_num];
+
+      Index arc_index = 0;
+      std::size_t pos = 0;
+      for (Index i = 0; i != node_num; ++i) {
+        node_first_out[i] = arc_index;
+        node_first_byte[i] = pos;
+        prev = i;
+        for ( ; first != last && (*first).first == i; ++first) {
+          Index j = (*first).second;
+          writeCode(arc_data, pos, encode(j - prev));
+          prev = j;
+          ++arc_index;
+        }
+      }
+      LEMON_ASSERT(first == last,
+        "Wrong arc list for CompressedDigraph::build()");
+      node_first_out[node_num] = arc_num;
+      node_first_byte[node_num] = pos;
+    }
+
+  protected:
+    bool built;
+    Index node_num;
+    Index arc_num;
+    Index *node_first_out;
+    std::size_t *node_first_byte;
+    unsigned char *arc_data;
+  };
+
+  typedef DigraphExtender<CompressedDigraphBase>
+  ExtendedCompressedDigraphBase;
+
+
+  /// \ingroup graphs
+  ///
+  /// \brief A static directed graph class with compressed adjacency lists.
+  ///
+  /// \ref CompressedDigraph is a static digraph implementation similar
+  /// to \ref CompactDigraph, but it stores the outgoing arcs of the
+  /// nodes in a compressed form, thus it requires even less memory.
+  /// The targets of the outgoing arcs of a node are stored as the
+  /// differences of the consecutive target indices (and the difference
+  /// of the first target and the node itself) encoded with a variable
+  /// number of bytes (7 bits per byte). These codes are decoded on the
+  /// fly by the arc iterators.
+  ///
+  /// The structure stores one \ref Index and one \c std::size_t value
+  /// for each node, and only one byte for each arc if the differences
+  /// are less than 64 (e.g. if the adjacent nodes have close indices),
+  /// two bytes if they are less than 8192 etc. The size of an \c Arc
+  /// object is larger, since it also stores the target node and the
+  /// position of the next code. Moreover, \ref arc() and
+  /// \ref concepts::Digraph::arcFromId() "arcFromId()" take linear time
+  /// in the out-degree of the source node, and the \ref InArcIt
+  /// implementation is inefficient and provided only for compatibility
+  /// with the \ref concepts::Digraph "Digraph concept". Therefore this
+  /// structure is suggested for huge digraphs that are processed by
+  /// iterating the outgoing arcs of the nodes.
+  ///
+  /// Since this digraph structure is completely static, its nodes and arcs
+  /// can be indexed with integers from the ranges <tt>[0..nodeNum()-1]</tt>
+  /// and <tt>[0..arcNum()-1]</tt>, respectively. The outgoing arcs of
+  /// a node have consecutive indices.
+  ///
+  /// This type fully conforms to the \ref concepts::Digraph "Digraph concept".
+  /// Most of its member functions and nested classes are documented
+  /// only in the concept class.
+  ///
+  /// \sa concepts::Digraph
+  class CompressedDigraph : public ExtendedCompressedDigraphBase {
+
+  private:
+    /// Graphs are \e not copy constructible. Use DigraphCopy instead.
+    CompressedDigraph(const CompressedDigraph &)
+      : ExtendedCompressedDigraphBase() {};
+    /// \brief Assignment of a graph to another one is \e not allowed.
+    /// Use DigraphCopy instead.
+    void operator=(const CompressedDigraph&) {}
+
+  public:
+
+    typedef ExtendedCompressedDigraphBase Parent;
+
+  public:
+
+    /// \brief Constructor
+    ///
+    /// Default constructor.
+    CompressedDigraph() : Parent() {}
+
+    /// \brief The node with the given index.
+    ///
+    /// This function returns the node with the given index.
+    /// \sa index()
+    static Node node(Index ix) { return Parent::nodeFromId(ix); }
+
+    /// \brief The arc with the given index.
+    ///
+    /// This function returns the arc with the given index.
+    /// Its time complexity is linear in the out-degree of the
+    /// source node of the arc.
+    /// \sa index()
+    Arc arc(Index ix) { return arcFromId(ix); }
+
+    /// \brief The index of the given node.
+    ///
+    /// This function returns the index of the the given node.
+    /// \sa node()
+    static Index index(Node node) { return Parent::id(node); }
+
+    /// \brief The index of the given arc.
+    ///
+    /// This function returns the index of the the given arc.
+    /// \sa arc()
+    static Index index(Arc arc) { return Parent::id(arc); }
+
+    /// \brief Number of nodes.
+    ///
+    /// This function returns the number of nodes.
+    Index nodeNum() const { return node_num; }
+
+    /// \brief Number of arcs.
+    ///
+    /// This function returns the number of arcs.
+    Index arcNum() const { return arc_num; }
+
+    /// \brief The memory usage of the adjacency lists.
+    ///
+    /// This function returns the number of bytes used for storing
+    /// the outgoing arcs of the nodes.
+    std::size_t byteNum() const {
+      return built ? node_first_byte[node_num] : 0;
+    }
+
+    /// \brief Build the digraph copying another digraph.
+    ///
+    /// This function builds the digraph copying another digraph of any
+    /// kind. It can be called more than once, but in such case, the whole
+    /// structure and all maps will be cleared and rebuilt.
+    /// The outgoing arcs of each node are ordered by the indices of
+    /// their target nodes.
+    ///
+    /// This method also makes possible to copy a digraph to a
+    /// CompressedDigraph structure using \ref DigraphCopy.
+    ///
+    /// \param digraph An existing digraph to be copied.
+    /// \param nodeRef The node references will be copied into this map.
+    /// Its key type must be \c Digraph::Node and its value type must be
+    /// \c CompressedDigraph::Node.
+    /// It must conform to the \ref concepts::ReadWriteMap "ReadWriteMap"
+    /// concept.
+    /// \param arcRef The arc references will be copied into this map.
+    /// Its key type must be \c Digraph::Arc and its value type must be
+    /// \c CompressedDigraph::Arc.
+    /// It must conform to the \ref concepts::WriteMap "WriteMap" concept.
+    ///
+    /// \note If you do not need the arc references, then you could use
+    /// \ref NullMap for the last parameter. However the node references
+    /// are required by the function itself, thus they must be readable
+    /// from the map.
+    template <typename Digraph, typename NodeRefMap, typename ArcRefMap>
+    void build(const Digraph& digraph, NodeRefMap& nodeRef, ArcRefMap& arcRef) {
+      if (built) Parent::clear();
+      Parent::build(digraph, nodeRef, arcRef);
+    }
+
+    /// \brief Build the digraph from an arc list.
+    ///
+    /// This function builds the digraph from the given arc list.
+    /// It can be called more than once, but in such case, the whole
+    /// structure and all maps will be cleared and rebuilt.
+    ///
+    /// The list of the arcs must be given in the range <tt>[begin, end)</tt>
+    /// specified by STL compatible itartors whose \c value_type must be
+    /// <tt>std::pair<int,int></tt>.
+    /// Each arc must be specified by a pair of integer indices
+    /// from the range <tt>[0..n-1]</tt>. <i>The pairs must be in a
+    /// non-decreasing order with respect to their first values.</i>
+    /// If the k-th pair in the list is <tt>(i,j)</tt>, then
+    /// <tt>arc(k-1)</tt> will connect <tt>node(i)</tt> to <tt>node(j)</tt>.
+    /// The range is traversed twice.
+    ///
+    /// The arcs are stored most compactly if the pairs having the same
+    /// first value are also sorted by their second values.
+    ///
+    /// \param n The number of nodes.
+    /// \param begin An iterator pointing to the beginning of the arc list.
+    /// \param end An iterator pointing to the end of the arc list.
+    ///
+    /// For example, a simple digraph can be constructed like this.
+    /// \code
+    ///   std::vector<std::pair<int,int> > arcs;
+    ///   arcs.push_back(std::make_pair(0,1));
+    ///   arcs.push_back(std::make_pair(0,2));
+    ///   arcs.push_back(std::make_pair(1,2));
+    ///   arcs.push_back(std::make_pair(1,3));
+    ///   arcs.push_back(std::make_pair(3,0));
+    ///   CompressedDigraph gr;
+    ///   gr.build(4, arcs.begin(), arcs.end());
+    /// \endcode
+    template <typename ArcListIterator>
+    void build(Index n, ArcListIterator begin, ArcListIterator end) {
+      if (built) Parent::clear();
+      CompressedDigraphBase::build(n, begin, end);
+      notifier(Node()).build();
+      notifier(Arc()).build();
+    }
+
+    /// \brief Clear the digraph.
+    ///
+    /// This function erases all nodes and arcs from the digraph.
+    void clear() {
+      Parent::clear();
+    }
+
+  public:
+
+    Node baseNode(const OutArcIt &arc) const {
+      return Parent::source(static_cast<const Arc&>(arc));
+    }
+
+    Node runningNode(const OutArcIt &arc) const {
+      return Parent::target(static_cast<const Arc&>(arc));
+    }
+
+    Node baseNode(const InArcIt &arc) const {
+      return Parent::target(static_cast<const Arc&>(arc));
+    }
+
+    Node runningNode(const InArcIt &arc) const {
+      return Parent::source(static_cast<const Arc&>(arc));
+    }
+
+  };
+
+}
+
+#endif
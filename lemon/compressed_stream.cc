@@ -0,0 +1,996 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+///\file
+///\brief Implementation of the compressed streams.
+
+#include <lemon/compressed_stream.h>
+#include <lemon/error.h>
+#include <lemon/concept_check.h>
+#include <lemon/bits/parallel.h>
+
+#include <fstream>
+#include <vector>
+#include <cstring>
+
+#ifdef LEMON_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef LEMON_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace lemon {
+
+  bool CompressedStreamBase::supported(Format format) {
+    switch (format) {
+    case PLAIN:
+      return true;
+    case GZIP:
+#ifdef LEMON_HAVE_ZLIB
+      return true;
+#else
+      return false;
+#endif
+    case ZSTD:
+#ifdef LEMON_HAVE_ZSTD
+      return true;
+#else
+      return false;
+#endif
+    }
+    return false;
+  }
+
+  CompressedStreamBase::Format
+  CompressedStreamBase::fileFormat(const std::string& fn) {
+    std::string::size_type n = fn.size();
+    if (n >= 3 && fn.compare(n - 3, 3, ".gz") == 0) return GZIP;
+    if (n >= 4 && fn.compare(n - 4, 4, ".zst") == 0) return ZSTD;
+    return PLAIN;
+  }
+
+  namespace _compressed_bits {
+
+    typedef CompressedStreamBase::Format Format;
+
+    // Size of the buffers of the sequential processing
+    const std::size_t BUFFER_SIZE = 1 << 16;
+    // Uncompressed size of a BGZF block
+    const std::size_t GZIP_BLOCK_SIZE = 0xff00;
+    // Uncompressed size of a zstd frame
+    const std::size_t ZSTD_FRAME_SIZE = 1 << 20;
+    // Maximal size of a zstd frame header (ZSTD_FRAMEHEADERSIZE_MAX is
+    // only declared in the static linking API of zstd.h)
+    const std::size_t ZSTD_HEADER_SIZE = 18;
+    // Upper limit of the sizes of the frames decompressed in parallel
+    const std::size_t MAX_FRAME_SIZE = 1 << 26;
+    // Upper limit of the data decompressed in a parallel round
+    const std::size_t MAX_ROUND_SIZE = 1 << 27;
+
+#ifdef LEMON_HAVE_ZSTD
+    // Compresses a zstd frame with a content checksum, so that corrupted
+    // frames are detected by the decompression
+    inline std::size_t zstdCompress(void* dst, std::size_t capacity,
+                                    const void* src, std::size_t len) {
+      ZSTD_CCtx* cctx = ZSTD_createCCtx();
+      if (!cctx) return static_cast<std::size_t>(-1);
+      std::size_t ret =
+        ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, 3);
+      if (!ZSTD_isError(ret)) {
+        ret = ZSTD_CCtx_setParameter(cctx, ZSTD_c_checksumFlag, 1);
+      }
+      if (!ZSTD_isError(ret)) {
+        ret = ZSTD_compress2(cctx, dst, capacity, src, len);
+      }
+      ZSTD_freeCCtx(cctx);
+      return ret;
+    }
+#endif
+
+    inline unsigned readLE16(const char* p) {
+      const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+      return u[0] | (u[1] << 8);
+    }
+
+    inline unsigned long readLE32(const char* p) {
+      const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+      return static_cast<unsigned long>(u[0]) |
+        (static_cast<unsigned long>(u[1]) << 8) |
+        (static_cast<unsigned long>(u[2]) << 16) |
+        (static_cast<unsigned long>(u[3]) << 24);
+    }
+
+    inline void writeLE16(char* p, unsigned value) {
+      p[0] = static_cast<char>(value & 0xff);
+      p[1] = static_cast<char>((value >> 8) & 0xff);
+    }
+
+    inline void writeLE32(char* p, unsigned long value) {
+      for (int i = 0; i < 4; ++i) {
+        p[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+      }
+    }
+
+    // A compressed block or frame processed in a parallel round
+    struct Block {
+      std::size_t in_offset, in_size;
+      std::size_t out_offset, out_size;
+    };
+
+    class InputBuffer : public std::streambuf {
+    public:
+
+      InputBuffer()
+        : _is(0), _local(false), _thread_num(1),
+          _format(CompressedStreamBase::PLAIN),
+          _in(BUFFER_SIZE), _in_pos(0), _in_end(0),
+          _detected(false), _in_eof(false), _serial(false),
+          _member(false) {
+#ifdef LEMON_HAVE_ZLIB
+        _zs_init = false;
+#endif
+#ifdef LEMON_HAVE_ZSTD
+        _zds = 0;
+#endif
+      }
+
+      ~InputBuffer() {
+        close();
+#ifdef LEMON_HAVE_ZLIB
+        if (_zs_init) inflateEnd(&_zs);
+#endif
+#ifdef LEMON_HAVE_ZSTD
+        if (_zds) ZSTD_freeDStream(_zds);
+#endif
+      }
+
+      bool open(const std::string& fn) {
+        close();
+        std::ifstream* is = new std::ifstream(fn.c_str(), std::ios::binary);
+        if (!(*is)) {
+          delete is;
+          return false;
+        }
+        _is = is;
+        _local = true;
+        return true;
+      }
+
+      void open(std::istream& is) {
+        close();
+        _is = &is;
+        _local = false;
+      }
+
+      bool isOpen() const {
+        return _is != 0;
+      }
+
+      void close() {
+        if (_local) delete _is;
+        _is = 0;
+        _local = false;
+        _format = CompressedStreamBase::PLAIN;
+        _in_pos = _in_end = 0;
+        _detected = _in_eof = _serial = _member = false;
+        setg(0, 0, 0);
+      }
+
+      void threadNum(int num) {
+        _thread_num = num;
+      }
+
+      int threadNum() const {
+        return _thread_num;
+      }
+
+      Format format() const {
+        return _format;
+      }
+
+    protected:
+
+      virtual int_type underflow() {
+        if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+        if (!_is) return traits_type::eof();
+        if (!_detected) detect();
+        std::size_t size = 0;
+        switch (_format) {
+        case CompressedStreamBase::PLAIN:
+          size = readPlain();
+          break;
+        case CompressedStreamBase::GZIP:
+#ifdef LEMON_HAVE_ZLIB
+          if (!_serial && _thread_num > 1) {
+            size = readGzipBlocks();
+          }
+          if (_serial || _thread_num <= 1) {
+            size = readGzip();
+          }
+#endif
+          break;
+        case CompressedStreamBase::ZSTD:
+#ifdef LEMON_HAVE_ZSTD
+          if (!_serial && _thread_num > 1) {
+            size = readZstdFrames();
+          }
+          if (_serial || _thread_num <= 1) {
+            size = readZstd();
+          }
+#endif
+          break;
+        }
+        if (size == 0) {
+          setg(0, 0, 0);
+          return traits_type::eof();
+        }
+        return traits_type::to_int_type(*gptr());
+      }
+
+    private:
+
+      std::size_t avail() const {
+        return _in_end - _in_pos;
+      }
+
+      const char* input() const {
+        return &_in[0] + _in_pos;
+      }
+
+      // Ensures that at least num unprocessed bytes are buffered,
+      // unless the end of the input is reached. It returns whether
+      // the required amount of data is available.
+      bool fill(std::size_t num) {
+        if (avail() >= num) return true;
+        if (_in_pos > 0) {
+          std::memmove(&_in[0], &_in[0] + _in_pos, avail());
+          _in_end -= _in_pos;
+          _in_pos = 0;
+        }
+        if (_in.size() < num) {
+          std::size_t cap = 2 * _in.size();
+          _in.resize(cap < num ? num : cap);
+        }
+        while (_in_end < num && !_in_eof) {
+          _is->read(&_in[0] + _in_end, _in.size() - _in_end);
+          std::streamsize len = _is->gcount();
+          _in_end += static_cast<std::size_t>(len);
+          if (len == 0 || !(*_is)) _in_eof = true;
+        }
+        return _in_end >= num;
+      }
+
+      void detect() {
+        fill(4);
+        const unsigned char* u =
+          reinterpret_cast<const unsigned char*>(input());
+        if (avail() >= 2 && u[0] == 0x1f && u[1] == 0x8b) {
+          _format = CompressedStreamBase::GZIP;
+        } else if (avail() >= 4 && u[0] == 0x28 && u[1] == 0xb5 &&
+                   u[2] == 0x2f && u[3] == 0xfd) {
+          _format = CompressedStreamBase::ZSTD;
+        } else {
+          _format = CompressedStreamBase::PLAIN;
+        }
+        _detected = true;
+        if (!CompressedStreamBase::supported(_format)) {
+          throw IoError(_format == CompressedStreamBase::GZIP ?
+                        "Reading gzip data is not supported" :
+                        "Reading zstd data is not supported");
+        }
+      }
+
+      std::size_t readPlain() {
+        if (avail() == 0 && !fill(1)) return 0;
+        std::size_t size = avail();
+        _out.resize(size);
+        std::memcpy(&_out[0], input(), size);
+        _in_pos = _in_end;
+        setg(&_out[0], &_out[0], &_out[0] + size);
+        return size;
+      }
+
+      // Collects the blocks of a parallel round. The check function
+      // returns the compressed and uncompressed sizes of the block
+      // starting at the given offset of the unprocessed input, or
+      // false if it cannot be processed independently.
+      template <typename Check>
+      std::size_t collectBlocks(Check check) {
+        _blocks.clear();
+        std::size_t offset = 0, total = 0;
+        std::size_t limit = 8 * static_cast<std::size_t>(_thread_num);
+        while (_blocks.size() < limit && total < MAX_ROUND_SIZE) {
+          fill(offset + 1);
+          if (avail() == offset) break;
+          Block block;
+          block.in_offset = offset;
+          block.out_offset = total;
+          if (!check(offset, block.in_size, block.out_size)) {
+            if (_blocks.empty()) _serial = true;
+            break;
+          }
+          _blocks.push_back(block);
+          offset += block.in_size;
+          total += block.out_size;
+        }
+        return total;
+      }
+
+      // Runs decompress(block) for the collected blocks in parallel
+      // and consumes their input.
+      template <typename Decompress>
+      std::size_t decompressBlocks(std::size_t total, Decompress& decompress) {
+        // The data of empty blocks may point to the end of the buffer
+        _out.resize(total + 1);
+        std::vector<char> failed(_blocks.size(), 0);
+        BlockWorker<Decompress> worker(decompress, _blocks, failed);
+        bits::parallelFor(static_cast<int>(_blocks.size()), _thread_num,
+                          worker, 1);
+        for (std::size_t i = 0; i < failed.size(); ++i) {
+          if (failed[i]) throw IoError("Corrupted compressed data");
+        }
+        const Block& last = _blocks.back();
+        _in_pos += last.in_offset + last.in_size;
+        return total;
+      }
+
+      template <typename Decompress>
+      struct BlockWorker {
+        Decompress& decompress;
+        const std::vector<Block>& blocks;
+        std::vector<char>& failed;
+        BlockWorker(Decompress& d, const std::vector<Block>& b,
+                    std::vector<char>& f)
+          : decompress(d), blocks(b), failed(f) {}
+        void operator()(int, int begin, int end) {
+          for (int i = begin; i < end; ++i) {
+            failed[i] = decompress(blocks[i]) ? 0 : 1;
+          }
+        }
+      };
+
+#ifdef LEMON_HAVE_ZLIB
+
+      std::size_t readGzip() {
+        if (!_zs_init) {
+          std::memset(&_zs, 0, sizeof(_zs));
+          // Automatic gzip and zlib header detection
+          if (inflateInit2(&_zs, 15 + 32) != Z_OK) {
+            throw IoError("Cannot initialize zlib");
+          }
+          _zs_init = true;
+        }
+        _out.resize(BUFFER_SIZE);
+        _zs.next_out = reinterpret_cast<Bytef*>(&_out[0]);
+        _zs.avail_out = static_cast<uInt>(BUFFER_SIZE);
+        while (_zs.avail_out == BUFFER_SIZE) {
+          bool more = avail() > 0 || fill(1);
+          if (!more && !_member) break;
+          if (!_member) {
+            // Start of a new member of a concatenated stream
+            inflateReset(&_zs);
+            _member = true;
+          }
+          _zs.next_in = reinterpret_cast<Bytef*>(&_in[0] + _in_pos);
+          _zs.avail_in = static_cast<uInt>(avail());
+          int ret = inflate(&_zs, Z_NO_FLUSH);
+          _in_pos = _in_end - _zs.avail_in;
+          if (ret == Z_STREAM_END) {
+            _member = false;
+          } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            throw IoError("Corrupted gzip data");
+          }
+          if (!more && _zs.avail_out == BUFFER_SIZE) {
+            throw IoError("Unexpected end of gzip data");
+          }
+        }
+        std::size_t size = BUFFER_SIZE - _zs.avail_out;
+        setg(&_out[0], &_out[0], &_out[0] + size);
+        return size;
+      }
+
+      // Checks whether a BGZF block starts at the given offset
+      struct GzipBlockCheck {
+        InputBuffer& buf;
+        GzipBlockCheck(InputBuffer& b) : buf(b) {}
+        bool operator()(std::size_t offset, std::size_t& in_size,
+                        std::size_t& out_size) {
+          if (!buf.fill(offset + 12)) return false;
+          const char* p = buf.input() + offset;
+          const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+          // Only the FEXTRA flag may be set
+          if (u[0] != 0x1f || u[1] != 0x8b || u[2] != 8 || u[3] != 4) {
+            return false;
+          }
+          std::size_t xlen = readLE16(p + 10);
+          if (!buf.fill(offset + 12 + xlen)) return false;
+          p = buf.input() + offset;
+          std::size_t bsize = 0;
+          for (std::size_t i = 12; i + 4 <= 12 + xlen; ) {
+            std::size_t slen = readLE16(p + i + 2);
+            if (i + 4 + slen > 12 + xlen) return false;
+            if (p[i] == 'B' && p[i + 1] == 'C' && slen == 2) {
+              bsize = readLE16(p + i + 4) + 1;
+            }
+            i += 4 + slen;
+          }
+          if (bsize < 12 + xlen + 8) return false;
+          if (!buf.fill(offset + bsize)) return false;
+          in_size = bsize;
+          out_size = readLE32(buf.input() + offset + bsize - 4);
+          return out_size <= 0x10000;
+        }
+      };
+
+      struct GzipBlockDecompress {
+        InputBuffer& buf;
+        GzipBlockDecompress(InputBuffer& b) : buf(b) {}
+        bool operator()(const Block& block) {
+          const char* p = buf.input() + block.in_offset;
+          std::size_t header = 12 + readLE16(p + 10);
+          z_stream zs;
+          std::memset(&zs, 0, sizeof(zs));
+          if (inflateInit2(&zs, -15) != Z_OK) return false;
+          Bytef* out = reinterpret_cast<Bytef*>(&buf._out[0]) +
+            block.out_offset;
+          zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(p)) +
+            header;
+          zs.avail_in = static_cast<uInt>(block.in_size - header - 8);
+          // Empty blocks are decompressed into a dummy byte
+          Bytef dummy;
+          zs.next_out = block.out_size > 0 ? out : &dummy;
+          zs.avail_out = static_cast<uInt>(block.out_size > 0 ?
+                                           block.out_size : 1);
+          int ret = inflate(&zs, Z_FINISH);
+          bool ok = ret == Z_STREAM_END && zs.total_out == block.out_size;
+          inflateEnd(&zs);
+          if (!ok) return false;
+          uLong crc = crc32(0L, Z_NULL, 0);
+          crc = crc32(crc, out, static_cast<uInt>(block.out_size));
+          return (crc & 0xffffffffUL) ==
+            readLE32(p + block.in_size - 8);
+        }
+      };
+
+      std::size_t readGzipBlocks() {
+        std::size_t total;
+        do {
+          GzipBlockCheck check(*this);
+          total = collectBlocks(check);
+          if (_blocks.empty()) return 0;
+          GzipBlockDecompress decompress(*this);
+          decompressBlocks(total, decompress);
+        } while (total == 0);
+        setg(&_out[0], &_out[0], &_out[0] + total);
+        return total;
+      }
+
+#endif
+
+#ifdef LEMON_HAVE_ZSTD
+
+      std::size_t readZstd() {
+        if (!_zds) {
+          _zds = ZSTD_createDStream();
+          if (!_zds || ZSTD_isError(ZSTD_initDStream(_zds))) {
+            throw IoError("Cannot initialize zstd");
+          }
+        }
+        _out.resize(BUFFER_SIZE);
+        ZSTD_outBuffer out = { &_out[0], BUFFER_SIZE, 0 };
+        while (out.pos == 0) {
+          bool more = avail() > 0 || fill(1);
+          if (!more && !_member) break;
+          ZSTD_inBuffer in = { &_in[0] + _in_pos, avail(), 0 };
+          std::size_t ret = ZSTD_decompressStream(_zds, &out, &in);
+          if (ZSTD_isError(ret)) {
+            throw IoError(std::string("Corrupted zstd data: ") +
+                          ZSTD_getErrorName(ret));
+          }
+          _in_pos += in.pos;
+          _member = ret != 0;
+          if (!more && out.pos == 0) {
+            throw IoError("Unexpected end of zstd data");
+          }
+        }
+        setg(&_out[0], &_out[0], &_out[0] + out.pos);
+        return out.pos;
+      }
+
+      // Checks whether a complete frame with known content size
+      // starts at the given offset
+      struct ZstdFrameCheck {
+        InputBuffer& buf;
+        ZstdFrameCheck(InputBuffer& b) : buf(b) {}
+        bool operator()(std::size_t offset, std::size_t& in_size,
+                        std::size_t& out_size) {
+          buf.fill(offset + ZSTD_HEADER_SIZE);
+          unsigned long long content =
+            ZSTD_getFrameContentSize(buf.input() + offset,
+                                     buf.avail() - offset);
+          if (content == ZSTD_CONTENTSIZE_UNKNOWN ||
+              content == ZSTD_CONTENTSIZE_ERROR ||
+              content > MAX_FRAME_SIZE) return false;
+          while (true) {
+            std::size_t len = buf.avail() - offset;
+            std::size_t size =
+              ZSTD_findFrameCompressedSize(buf.input() + offset, len);
+            if (!ZSTD_isError(size)) {
+              in_size = size;
+              out_size = static_cast<std::size_t>(content);
+              return true;
+            }
+            if (len >= MAX_FRAME_SIZE ||
+                !buf.fill(offset + 2 * len + BUFFER_SIZE)) return false;
+          }
+        }
+      };
+
+      struct ZstdFrameDecompress {
+        InputBuffer& buf;
+        ZstdFrameDecompress(InputBuffer& b) : buf(b) {}
+        bool operator()(const Block& block) {
+          if (block.out_size == 0) return true;
+          std::size_t ret =
+            ZSTD_decompress(&buf._out[0] + block.out_offset, block.out_size,
+                            buf.input() + block.in_offset, block.in_size);
+          return !ZSTD_isError(ret) && ret == block.out_size;
+        }
+      };
+
+      std::size_t readZstdFrames() {
+        std::size_t total;
+        do {
+          ZstdFrameCheck check(*this);
+          total = collectBlocks(check);
+          if (_blocks.empty()) return 0;
+          ZstdFrameDecompress decompress(*this);
+          decompressBlocks(total, decompress);
+        } while (total == 0);
+        setg(&_out[0], &_out[0], &_out[0] + total);
+        return total;
+      }
+
+#endif
+
+      std::istream* _is;
+      bool _local;
+      int _thread_num;
+      Format _format;
+
+      // Raw input, the bytes in [_in_pos, _in_end) are unprocessed
+      std::vector<char> _in;
+      std::size_t _in_pos, _in_end;
+      // Decompressed data
+      std::vector<char> _out;
+      std::vector<Block> _blocks;
+
+      bool _detected, _in_eof;
+      // Whether the rest of the input has to be processed sequentially
+      bool _serial;
+      // Whether a gzip member or a zstd frame is being decompressed
+      bool _member;
+
+#ifdef LEMON_HAVE_ZLIB
+      z_stream _zs;
+      bool _zs_init;
+#endif
+#ifdef LEMON_HAVE_ZSTD
+      ZSTD_DStream* _zds;
+#endif
+    };
+
+    class OutputBuffer : public std::streambuf {
+    public:
+
+      OutputBuffer()
+        : _os(0), _local(false), _thread_num(1),
+          _format(CompressedStreamBase::PLAIN), _written(false) {}
+
+      ~OutputBuffer() {
+        try {
+          close();
+        } catch (...) {}
+      }
+
+      bool open(const std::string& fn, Format format) {
+        close();
+        if (!CompressedStreamBase::supported(format)) return false;
+        std::ofstream* os = new std::ofstream(fn.c_str(), std::ios::binary);
+        if (!(*os)) {
+          delete os;
+          return false;
+        }
+        _os = os;
+        _local = true;
+        start(format);
+        return true;
+      }
+
+      bool open(std::ostream& os, Format format) {
+        close();
+        if (!CompressedStreamBase::supported(format)) return false;
+        _os = &os;
+        _local = false;
+        start(format);
+        return true;
+      }
+
+      bool isOpen() const {
+        return _os != 0;
+      }
+
+      // Writes the buffered data and terminates the compressed stream
+      bool close() {
+        if (!_os) return true;
+        bool ok = true;
+        try {
+          compress(true);
+          if (_format == CompressedStreamBase::GZIP) {
+            // The empty BGZF block marking the end of the data
+            static const unsigned char eof[28] = {
+              0x1f, 0x8b, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,
+              0x06, 0x00, 0x42, 0x43, 0x02, 0x00, 0x1b, 0x00, 0x03, 0x00,
+              0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+            };
+            _os->write(reinterpret_cast<const char*>(eof), 28);
+          }
+#ifdef LEMON_HAVE_ZSTD
+          if (_format == CompressedStreamBase::ZSTD && !_written) {
+            // A valid zstd stream contains at least one frame
+            char frame[32];
+            std::size_t len = zstdCompress(frame, sizeof(frame), 0, 0);
+            if (!ZSTD_isError(len)) _os->write(frame, len);
+          }
+#endif
+          _os->flush();
+          ok = !_os->fail();
+        } catch (const IoError&) {
+          ok = false;
+        }
+        if (_local) delete _os;
+        _os = 0;
+        _local = false;
+        setp(0, 0);
+        return ok;
+      }
+
+      void threadNum(int num) {
+        if (_os && num != _thread_num) {
+          compress(true);
+          _thread_num = num;
+          resize();
+        } else {
+          _thread_num = num;
+        }
+      }
+
+      int threadNum() const {
+        return _thread_num;
+      }
+
+      Format format() const {
+        return _format;
+      }
+
+    protected:
+
+      virtual int_type overflow(int_type c) {
+        if (!_os) return traits_type::eof();
+        if (pptr() == epptr()) compress(false);
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+          *pptr() = traits_type::to_char_type(c);
+          pbump(1);
+        }
+        return traits_type::not_eof(c);
+      }
+
+      virtual int sync() {
+        if (!_os) return 0;
+        // Incomplete blocks are kept to avoid degrading the compression
+        compress(_format == CompressedStreamBase::PLAIN);
+        _os->flush();
+        return _os->fail() ? -1 : 0;
+      }
+
+    private:
+
+      void start(Format format) {
+        _format = format;
+        _written = false;
+        resize();
+      }
+
+      std::size_t blockSize() const {
+        switch (_format) {
+        case CompressedStreamBase::GZIP:
+          return GZIP_BLOCK_SIZE;
+        case CompressedStreamBase::ZSTD:
+          return ZSTD_FRAME_SIZE;
+        default:
+          return BUFFER_SIZE;
+        }
+      }
+
+      void resize() {
+        std::size_t num = 1;
+        if (_thread_num > 1 && _format != CompressedStreamBase::PLAIN) {
+          num = 4 * static_cast<std::size_t>(_thread_num);
+        }
+        _buf.resize(num * blockSize());
+        setp(&_buf[0], &_buf[0] + _buf.size());
+      }
+
+      // Compresses and writes the complete blocks of the buffer, and
+      // also the last incomplete one if all is true
+      void compress(bool all) {
+        std::size_t size = pptr() - pbase();
+        std::size_t block = blockSize();
+        std::size_t num = all ? (size + block - 1) / block : size / block;
+        if (num == 0) return;
+        std::size_t used = size < num * block ? size : num * block;
+        if (_format == CompressedStreamBase::PLAIN) {
+          _os->write(&_buf[0], used);
+        } else {
+          _blocks.resize(num);
+          std::vector<char> failed(num, 0);
+          CompressWorker worker(*this, used, failed);
+          bits::parallelFor(static_cast<int>(num), _thread_num, worker, 1);
+          for (std::size_t i = 0; i < num; ++i) {
+            if (failed[i]) throw IoError("Compression failed");
+            _os->write(&_blocks[i][0], _blocks[i].size());
+          }
+        }
+        if (_os->fail()) throw IoError("Cannot write data");
+        _written = true;
+        std::memmove(&_buf[0], &_buf[0] + used, size - used);
+        setp(&_buf[0], &_buf[0] + _buf.size());
+        pbump(static_cast<int>(size - used));
+      }
+
+      struct CompressWorker {
+        OutputBuffer& buf;
+        std::size_t size;
+        std::vector<char>& failed;
+        CompressWorker(OutputBuffer& b, std::size_t s, std::vector<char>& f)
+          : buf(b), size(s), failed(f) {}
+        void operator()(int, int begin, int end) {
+          std::size_t block = buf.blockSize();
+          for (int i = begin; i < end; ++i) {
+            std::size_t offset = i * block;
+            std::size_t len = size - offset < block ? size - offset : block;
+            failed[i] = buf.compressBlock(&buf._buf[0] + offset, len,
+                                          buf._blocks[i]) ? 0 : 1;
+          }
+        }
+      };
+
+      bool compressBlock(const char* data, std::size_t len,
+                         std::vector<char>& out) {
+        switch (_format) {
+#ifdef LEMON_HAVE_ZLIB
+        case CompressedStreamBase::GZIP:
+          {
+            z_stream zs;
+            std::memset(&zs, 0, sizeof(zs));
+            if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                             -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+              return false;
+            }
+            out.resize(18 + deflateBound(&zs, static_cast<uLong>(len)) + 8);
+            zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+            zs.avail_in = static_cast<uInt>(len);
+            zs.next_out = reinterpret_cast<Bytef*>(&out[0]) + 18;
+            zs.avail_out = static_cast<uInt>(out.size() - 26);
+            int ret = deflate(&zs, Z_FINISH);
+            std::size_t clen = zs.total_out;
+            deflateEnd(&zs);
+            std::size_t bsize = 18 + clen + 8;
+            if (ret != Z_STREAM_END || bsize > 0x10000) return false;
+            static const unsigned char header[16] = {
+              0x1f, 0x8b, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00,
+              0x00, 0xff, 0x06, 0x00, 0x42, 0x43, 0x02, 0x00
+            };
+            std::memcpy(&out[0], header, 16);
+            writeLE16(&out[16], static_cast<unsigned>(bsize - 1));
+            uLong crc = crc32(0L, Z_NULL, 0);
+            crc = crc32(crc, reinterpret_cast<const Bytef*>(data),
+                        static_cast<uInt>(len));
+            writeLE32(&out[18 + clen], crc);
+            writeLE32(&out[22 + clen], static_cast<unsigned long>(len));
+            out.resize(bsize);
+            return true;
+          }
+#endif
+#ifdef LEMON_HAVE_ZSTD
+        case CompressedStreamBase::ZSTD:
+          {
+            out.resize(ZSTD_compressBound(len));
+            std::size_t clen = zstdCompress(&out[0], out.size(), data, len);
+            if (ZSTD_isError(clen)) return false;
+            out.resize(clen);
+            return true;
+          }
+#endif
+        default:
+          ignore_unused_variable_warning(data, len, out);
+          return false;
+        }
+      }
+
+      std::ostream* _os;
+      bool _local;
+      int _thread_num;
+      Format _format;
+      // Whether data has been written to the underlying stream
+      bool _written;
+
+      // Uncompressed data
+      std::vector<char> _buf;
+      // Compressed blocks of a parallel round
+      std::vector<std::vector<char> > _blocks;
+    };
+
+  }
+
+  CompressedIstream::CompressedIstream()
+    : std::istream(0), _buf(new _compressed_bits::InputBuffer) {
+    rdbuf(_buf);
+  }
+
+  CompressedIstream::CompressedIstream(const std::string& fn)
+    : std::istream(0), _buf(new _compressed_bits::InputBuffer) {
+    rdbuf(_buf);
+    open(fn);
+  }
+
+  CompressedIstream::CompressedIstream(const char* fn)
+    : std::istream(0), _buf(new _compressed_bits::InputBuffer) {
+    rdbuf(_buf);
+    open(std::string(fn));
+  }
+
+  CompressedIstream::CompressedIstream(std::istream& is)
+    : std::istream(0), _buf(new _compressed_bits::InputBuffer) {
+    rdbuf(_buf);
+    open(is);
+  }
+
+  CompressedIstream::~CompressedIstream() {
+    delete _buf;
+  }
+
+  void CompressedIstream::open(const std::string& fn) {
+    if (_buf->open(fn)) {
+      clear();
+    } else {
+      setstate(std::ios::failbit);
+    }
+  }
+
+  void CompressedIstream::open(std::istream& is) {
+    _buf->open(is);
+    clear();
+  }
+
+  bool CompressedIstream::is_open() const {
+    return _buf->isOpen();
+  }
+
+  void CompressedIstream::close() {
+    _buf->close();
+  }
+
+  CompressedIstream& CompressedIstream::threadNum(int num) {
+    _buf->threadNum(num < 1 ? bits::hardwareThreadNum() : num);
+    return *this;
+  }
+
+  int CompressedIstream::threadNum() const {
+    return _buf->threadNum();
+  }
+
+  CompressedStreamBase::Format CompressedIstream::format() const {
+    return _buf->format();
+  }
+
+  CompressedOstream::CompressedOstream()
+    : std::ostream(0), _buf(new _compressed_bits::OutputBuffer) {
+    rdbuf(_buf);
+  }
+
+  CompressedOstream::CompressedOstream(const std::string& fn)
+    : std::ostream(0), _buf(new _compressed_bits::OutputBuffer) {
+    rdbuf(_buf);
+    open(fn);
+  }
+
+  CompressedOstream::CompressedOstream(const char* fn)
+    : std::ostream(0), _buf(new _compressed_bits::OutputBuffer) {
+    rdbuf(_buf);
+    open(std::string(fn));
+  }
+
+  CompressedOstream::CompressedOstream(const std::string& fn, Format format)
+    : std::ostream(0), _buf(new _compressed_bits::OutputBuffer) {
+    rdbuf(_buf);
+    open(fn, format);
+  }
+
+  CompressedOstream::CompressedOstream(std::ostream& os, Format format)
+    : std::ostream(0), _buf(new _compressed_bits::OutputBuffer) {
+    rdbuf(_buf);
+    open(os, format);
+  }
+
+  CompressedOstream::~CompressedOstream() {
+    delete _buf;
+  }
+
+  void CompressedOstream::open(const std::string& fn) {
+    open(fn, fileFormat(fn));
+  }
+
+  void CompressedOstream::open(const std::string& fn, Format format) {
+    close();
+    if (_buf->open(fn, format)) {
+      clear();
+    } else {
+      setstate(std::ios::failbit);
+    }
+  }
+
+  void CompressedOstream::open(std::ostream& os, Format format) {
+    close();
+    if (_buf->open(os, format)) {
+      clear();
+    } else {
+      setstate(std::ios::failbit);
+    }
+  }
+
+  bool CompressedOstream::is_open() const {
+    return _buf->isOpen();
+  }
+
+  void CompressedOstream::close() {
+    if (_buf->isOpen() && !_buf->close()) {
+      setstate(std::ios::badbit);
+    }
+  }
+
+  CompressedOstream& CompressedOstream::threadNum(int num) {
+    try {
+      _buf->threadNum(num < 1 ? bits::hardwareThreadNum() : num);
+    } catch (const IoError&) {
+      setstate(std::ios::badbit);
+    }
+    return *this;
+  }
+
+  int CompressedOstream::threadNum() const {
+    return _buf->threadNum();
+  }
+
+  CompressedStreamBase::Format CompressedOstream::format() const {
+    return _buf->format();
+  }
+
+}
@@ -0,0 +1,292 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_COMPRESSED_STREAM_H
+#define LEMON_COMPRESSED_STREAM_H
+
+///\ingroup io_group
+///\file
+///\brief Streams reading and writing compressed files.
+
+#include <iostream>
+#include <string>
+
+#include <lemon/config.h>
+
+namespace lemon {
+
+  namespace _compressed_bits {
+    class InputBuffer;
+    class OutputBuffer;
+  }
+
+  /// \ingroup io_group
+  ///
+  /// \brief Common base class of the compressed streams.
+  ///
+  /// This class contains the format identifiers used by
+  /// \ref CompressedIstream and \ref CompressedOstream.
+  class CompressedStreamBase {
+  public:
+
+    /// \brief Compression formats.
+    ///
+    /// Compression formats.
+    enum Format {
+      /// Uncompressed data.
+      PLAIN,
+      /// The \c gzip format.
+      GZIP,
+      /// The \c zstd (Zstandard) format.
+      ZSTD
+    };
+
+    /// \brief Checks whether a format is supported.
+    ///
+    /// This function returns \c true if LEMON was compiled with the
+    /// library handling the given format. The \c GZIP format requires
+    /// \c zlib, the \c ZSTD format requires \c libzstd, while the
+    /// \c PLAIN format is always supported.
+    static bool supported(Format format);
+
+    /// \brief The format corresponding to a file name.
+    ///
+    /// This function returns \c GZIP for file names ending in \c ".gz",
+    /// \c ZSTD for file names ending in \c ".zst" and \c PLAIN otherwise.
+    static Format fileFormat(const std::string& fn);
+  };
+
+  /// \ingroup io_group
+  ///
+  /// \brief Input stream reading compressed or uncompressed data.
+  ///
+  /// This input stream reads a file or an other input stream, which
+  /// may contain \c gzip or \c zstd compressed data. The format is
+  /// detected automatically from the first bytes of the data, and
+  /// uncompressed data is passed through unchanged. Therefore, it can
+  /// be used in place of \c std::ifstream for the \ref DigraphReader
+  /// "LGF readers" and the \ref readDimacsMin() "DIMACS readers",
+  /// and the file name constructors of the LGF readers also use it.
+  ///
+  /// The data is decompressed on the fly in a streaming manner.
+  /// If more threads are allowed with \ref threadNum(int), the
+  /// independent blocks of the data are decompressed in parallel.
+  /// It is possible for \c gzip files consisting of \c BGZF blocks
+  /// (they are written by \ref CompressedOstream and \c bgzip)
+  /// and for \c zstd files consisting of several frames with known
+  /// content sizes (they are written by \ref CompressedOstream and
+  /// <tt>zstd -T0</tt>). Other files are decompressed sequentially.
+  ///
+  /// If the data is corrupted or its format is not supported
+  /// (see \ref CompressedStreamBase::supported() "supported()"),
+  /// the \c badbit of the stream is set. If this flag is enabled in
+  /// the exception mask, an \ref IoError is thrown.
+  class CompressedIstream : public CompressedStreamBase, public std::istream {
+  public:
+
+    /// \brief Default constructor.
+    ///
+    /// Default constructor. The stream has to be opened with
+    /// \ref open() before use.
+    CompressedIstream();
+
+    /// \brief Constructor.
+    ///
+    /// Constructor, which opens the given file. If the file cannot
+    /// be opened, the \c failbit of the stream is set.
+    explicit CompressedIstream(const std::string& fn);
+
+    /// \brief Constructor.
+    ///
+    /// Constructor, which opens the given file. If the file cannot
+    /// be opened, the \c failbit of the stream is set.
+    explicit CompressedIstream(const char* fn);
+
+    /// \brief Constructor.
+    ///
+    /// Constructor, which reads the data from the given input stream.
+    explicit CompressedIstream(std::istream& is);
+
+    /// \brief Destructor.
+    ~CompressedIstream();
+
+    /// \brief Opens a file.
+    ///
+    /// This function opens the given file. If the file cannot be
+    /// opened, the \c failbit of the stream is set.
+    void open(const std::string& fn);
+
+    /// \brief Reads from an input stream.
+    ///
+    /// This function sets the underlying input stream.
+    void open(std::istream& is);
+
+    /// \brief Checks whether the stream is open.
+    bool is_open() const;
+
+    /// \brief Closes the stream.
+    void close();
+
+    /// \brief Sets the number of threads.
+    ///
+    /// This function sets the number of threads used for decompressing
+    /// independent blocks of the data. If it is less than 1, the
+    /// number of processors is used. The default value is 1.
+    ///
+    /// \note This setting has no effect if LEMON was compiled without
+    /// threading support.
+    ///
+    /// \return <tt>(*this)</tt>
+    CompressedIstream& threadNum(int num);
+
+    /// \brief The number of threads.
+    int threadNum() const;
+
+    /// \brief The detected format.
+    ///
+    /// This function returns the format of the data. It is \c PLAIN
+    /// until the first character is read.
+    Format format() const;
+
+  private:
+    _compressed_bits::InputBuffer* _buf;
+
+    CompressedIstream(const CompressedIstream&);
+    void operator=(const CompressedIstream&);
+  };
+
+  /// \ingroup io_group
+  ///
+  /// \brief Output stream writing compressed or uncompressed data.
+  ///
+  /// This output stream writes \c gzip or \c zstd compressed or
+  /// uncompressed data to a file or to an other output stream.
+  /// When a file name is given, the format is chosen according to
+  /// its extension (see \ref CompressedStreamBase::fileFormat()
+  /// "fileFormat()"), so the file name constructors of the
+  /// \ref DigraphWriter "LGF writers", which use this class,
+  /// write compressed files when the file name ends with \c ".gz"
+  /// or \c ".zst".
+  ///
+  /// The data is split into independent blocks, which are compressed
+  /// in parallel if more threads are allowed with \ref threadNum(int).
+  /// A \c gzip stream consists of \c BGZF blocks, a \c zstd stream
+  /// consists of frames of about 1 MB with known content sizes, so
+  /// \ref CompressedIstream can also decompress them in parallel.
+  /// The output is complete only after \ref close() or the destructor
+  /// is called.
+  ///
+  /// If a format is not supported
+  /// (see \ref CompressedStreamBase::supported() "supported()")
+  /// or an error occurs, the \c badbit of the stream is set.
+  class CompressedOstream : public CompressedStreamBase, public std::ostream {
+  public:
+
+    /// \brief Default constructor.
+    ///
+    /// Default constructor. The stream has to be opened with
+    /// \ref open() before use.
+    CompressedOstream();
+
+    /// \brief Constructor.
+    ///
+    /// Constructor, which opens the given file. The format is chosen
+    /// according to the extension of the file name. If the file cannot
+    /// be opened, the \c failbit of the stream is set.
+    explicit CompressedOstream(const std::string& fn);
+
+    /// \brief Constructor.
+    ///
+    /// Constructor, which opens the given file. The format is chosen
+    /// according to the extension of the file name. If the file cannot
+    /// be opened, the \c failbit of the stream is set.
+    explicit CompressedOstream(const char* fn);
+
+    /// \brief Constructor.
+    ///
+    /// Constructor, which opens the given file and writes it in the
+    /// given format. If the file cannot be opened, the \c failbit of
+    /// the stream is set.
+    CompressedOstream(const std::string& fn, Format format);
+
+    /// \brief Constructor.
+    ///
+    /// Constructor, which writes to the given output stream in the
+    /// given format.
+    CompressedOstream(std::ostream& os, Format format);
+
+    /// \brief Destructor.
+    ///
+    /// Destructor, which closes the stream.
+    ~CompressedOstream();
+
+    /// \brief Opens a file.
+    ///
+    /// This function closes the stream and opens the given file.
+    /// The format is chosen according to the extension of the file
+    /// name.
+    void open(const std::string& fn);
+
+    /// \brief Opens a file.
+    ///
+    /// This function closes the stream and opens the given file.
+    void open(const std::string& fn, Format format);
+
+    /// \brief Writes to an output stream.
+    ///
+    /// This function closes the stream and sets the underlying output
+    /// stream.
+    void open(std::ostream& os, Format format);
+
+    /// \brief Checks whether the stream is open.
+    bool is_open() const;
+
+    /// \brief Closes the stream.
+    ///
+    /// This function compresses and writes the buffered data,
+    /// terminates the compressed stream and closes the file.
+    void close();
+
+    /// \brief Sets the number of threads.
+    ///
+    /// This function sets the number of threads used for compressing
+    /// the blocks of the data. If it is less than 1, the number of
+    /// processors is used. The default value is 1.
+    ///
+    /// \note This setting has no effect if LEMON was compiled without
+    /// threading support.
+    ///
+    /// \return <tt>(*this)</tt>
+    CompressedOstream& threadNum(int num);
+
+    /// \brief The number of threads.
+    int threadNum() const;
+
+    /// \brief The format of the stream.
+    Format format() const;
+
+  private:
+    _compressed_bits::OutputBuffer* _buf;
+
+    CompressedOstream(const CompressedOstream&);
+    void operator=(const CompressedOstream&);
+  };
+
+}
+
+#endif
@@ -24,12 +24,15 @@
 #include <lemon/core.h>
 #include <lemon/maps.h>
 #include <lemon/adaptors.h>
+#include <lemon/bits/parallel.h>
 
 #include <lemon/concepts/digraph.h>
 #include <lemon/concepts/graph.h>
 #include <lemon/concept_check.h>
 
 #include <stack>
+#include <vector>
+#include <algorithm>
 #include <functional>
 
 /// \ingroup graph_properties
@@ -175,6 +178,136 @@ namespace lemon {
     return compNum;
   }
 
+  namespace _connectivity_bits {
+
+    // Lock-free union-find structure on the indices of the nodes.
+    // A root is always linked below a root of smaller index, so the
+    // concurrent joins cannot create cycles.
+    class ParallelUnionFind {
+    public:
+      explicit ParallelUnionFind(int num) : _parent(num) {
+        for (int i = 0; i < num; ++i) _parent[i] = i;
+      }
+
+      int find(int i) {
+        while (true) {
+          int p = parent(i);
+          if (p == i) return i;
+          int gp = parent(p);
+          if (p != gp) bits::atomicCompareAndSwap(_parent[i], p, gp);
+          i = gp;
+        }
+      }
+
+      void join(int a, int b) {
+        while (true) {
+          a = find(a);
+          b = find(b);
+          if (a == b) return;
+          if (a < b) std::swap(a, b);
+          if (bits::atomicCompareAndSwap(_parent[a], a, b)) return;
+        }
+      }
+
+    private:
+      std::vector<int> _parent;
+
+      int parent(int i) const {
+        return static_cast<const volatile int&>(_parent[i]);
+      }
+    };
+
+    template <typename Graph>
+    class ConnectedComponentsWorker {
+    public:
+      typedef typename Graph::Node Node;
+      typedef typename Graph::OutArcIt OutArcIt;
+      typedef typename Graph::template NodeMap<int> IndexMap;
+
+      ConnectedComponentsWorker(const Graph& graph,
+                                const std::vector<Node>& nodes,
+                                const IndexMap& index,
+                                ParallelUnionFind& sets)
+        : _graph(graph), _nodes(nodes), _index(index), _sets(sets) {}
+
+      // Each edge is processed at its end node of larger index
+      void operator()(int, int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+          for (OutArcIt a(_graph, _nodes[i]); a != INVALID; ++a) {
+            int j = _index[_graph.target(a)];
+            if (j < i) _sets.join(i, j);
+          }
+        }
+      }
+
+    private:
+      const Graph& _graph;
+      const std::vector<Node>& _nodes;
+      const IndexMap& _index;
+      ParallelUnionFind& _sets;
+    };
+
+  }
+
+  /// \ingroup graph_properties
+  ///
+  /// \brief Find the connected components of an undirected graph
+  /// using several threads
+  ///
+  /// This function finds the connected components of the given undirected
+  /// graph using the given number of threads. The edges are processed
+  /// in parallel and they join the components in a lock-free union-find
+  /// structure.
+  ///
+  /// \param graph The undirected graph.
+  /// \retval compMap A writable node map. The values will be set from 0 to
+  /// the number of the connected components minus one. The numbering of
+  /// the components is the same as the one provided by
+  /// \ref connectedComponents(const Graph&, NodeMap&), i.e. the
+  /// components are numbered in the order of their first nodes with
+  /// respect to the node iterator. Each value of the map will be set
+  /// exactly once (by the calling thread), in the order of the node
+  /// iterator.
+  /// \param threadNum The number of threads. If it is less than one,
+  /// the number of the hardware threads is used.
+  /// If LEMON is built without threading support, the computation is
+  /// performed on the calling thread.
+  /// \return The number of connected components.
+  ///
+  /// \see connected(), countConnectedComponents()
+  template <class Graph, class NodeMap>
+  int connectedComponents(const Graph &graph, NodeMap &compMap,
+                          int threadNum) {
+    checkConcept<concepts::Graph, Graph>();
+    typedef typename Graph::Node Node;
+    typedef typename Graph::NodeIt NodeIt;
+    checkConcept<concepts::WriteMap<Node, int>, NodeMap>();
+
+    using namespace _connectivity_bits;
+
+    if (threadNum < 1) threadNum = bits::hardwareThreadNum();
+
+    std::vector<Node> nodes;
+    typename Graph::template NodeMap<int> index(graph);
+    for (NodeIt n(graph); n != INVALID; ++n) {
+      index[n] = nodes.size();
+      nodes.push_back(n);
+    }
+
+    ParallelUnionFind sets(nodes.size());
+    ConnectedComponentsWorker<Graph> worker(graph, nodes, index, sets);
+    bits::parallelFor(nodes.size(), threadNum, worker, 256);
+
+    int compNum = 0;
+    std::vector<int> num(nodes.size(), -1);
+    for (int i = 0; i < int(nodes.size()); ++i) {
+      int r = sets.find(i);
+      if (num[r] < 0) num[r] = compNum++;
+      compMap.set(nodes[i], num[r]);
+    }
+    return compNum;
+  }
+
   namespace _connectivity_bits {
 
     template <typename Digraph, typename Iterator >
@@ -451,6 +584,330 @@ namespace lemon {
     return compNum;
   }
 
+  namespace _connectivity_bits {
+
+    // Parallel computation of the strongly connected components.
+    // First the nodes that have no entering or no leaving arcs are
+    // trimmed iteratively, then the remaining nodes are processed by
+    // the coloring method: the largest node index is propagated along
+    // the arcs, and the nodes of a color that can reach the node of
+    // this index form a component. Finally the components are sorted
+    // topologically by a level-synchronous traversal of the condensed
+    // digraph. The result does not depend on the number of threads.
+    template <typename Digraph>
+    class ParallelStronglyConnectedComponents {
+    public:
+      typedef typename Digraph::Node Node;
+      typedef typename Digraph::NodeIt NodeIt;
+      typedef typename Digraph::OutArcIt OutArcIt;
+      typedef typename Digraph::InArcIt InArcIt;
+
+      ParallelStronglyConnectedComponents(const Digraph& digraph,
+                                          int thread_num)
+        : _digraph(digraph), _thread_num(thread_num), _index(digraph),
+          _next(thread_num) {}
+
+      // Compute the components, it returns their number
+      int run() {
+        for (NodeIt n(_digraph); n != INVALID; ++n) {
+          _index[n] = _nodes.size();
+          _nodes.push_back(n);
+        }
+        int num = _nodes.size();
+        _comp.assign(num, -1);
+        _count.resize(num);
+        _flag.assign(num, 0);
+        _color.resize(num);
+
+        std::vector<int> items, level;
+        for (int i = 0; i < num; ++i) items.push_back(i);
+        trim(items, IN_DEGREE, TRIM_SOURCE);
+        remaining(items);
+        trim(items, OUT_DEGREE, TRIM_SINK);
+        remaining(items);
+
+        while (!items.empty()) {
+          for (int k = 0; k < int(items.size()); ++k) {
+            _color[items[k]] = items[k];
+          }
+          level = items;
+          while (!level.empty()) {
+            runPhase(level, COLOR);
+            gather(level);
+            for (int k = 0; k < int(level.size()); ++k) _flag[level[k]] = 0;
+          }
+          level.clear();
+          for (int k = 0; k < int(items.size()); ++k) {
+            int i = items[k];
+            if (_color[i] == i) {
+              _comp[i] = i;
+              level.push_back(i);
+            }
+          }
+          while (!level.empty()) {
+            runPhase(level, SEARCH);
+            gather(level);
+          }
+          remaining(items);
+        }
+
+        return order();
+      }
+
+      // The index of the component of a node
+      int component(int i) const {
+        return _order[_color[i]];
+      }
+
+      const std::vector<Node>& nodes() const {
+        return _nodes;
+      }
+
+      void operator()(int thread, int begin, int end) {
+        for (int k = begin; k < end; ++k) {
+          int i = (*_items)[k];
+          switch (_phase) {
+          case IN_DEGREE:
+            _count[i] = 0;
+            for (InArcIt a(_digraph, _nodes[i]); a != INVALID; ++a) {
+              if (_index[_digraph.source(a)] != i) ++_count[i];
+            }
+            break;
+          case OUT_DEGREE:
+            _count[i] = 0;
+            for (OutArcIt a(_digraph, _nodes[i]); a != INVALID; ++a) {
+              int j = _index[_digraph.target(a)];
+              if (j != i && _comp[j] < 0) ++_count[i];
+            }
+            break;
+          case TRIM_SOURCE:
+            for (OutArcIt a(_digraph, _nodes[i]); a != INVALID; ++a) {
+              int j = _index[_digraph.target(a)];
+              if (j != i && bits::atomicFetchAdd(_count[j], -1) == 1) {
+                _comp[j] = j;
+                _next[thread].push_back(j);
+              }
+            }
+            break;
+          case TRIM_SINK:
+            for (InArcIt a(_digraph, _nodes[i]); a != INVALID; ++a) {
+              int j = _index[_digraph.source(a)];
+              if (j != i && value(_comp[j]) < 0 &&
+                  bits::atomicFetchAdd(_count[j], -1) == 1) {
+                _comp[j] = j;
+                _next[thread].push_back(j);
+              }
+            }
+            break;
+          case COLOR:
+            {
+              int c = value(_color[i]);
+              for (OutArcIt a(_digraph, _nodes[i]); a != INVALID; ++a) {
+                int j = _index[_digraph.target(a)];
+                if (_comp[j] >= 0) continue;
+                int old;
+                while ((old = value(_color[j])) < c) {
+                  if (bits::atomicCompareAndSwap(_color[j], old, c)) {
+                    if (bits::atomicCompareAndSwap(_flag[j], 0, 1)) {
+                      _next[thread].push_back(j);
+                    }
+                    break;
+                  }
+                }
+              }
+            }
+            break;
+          case SEARCH:
+            for (InArcIt a(_digraph, _nodes[i]); a != INVALID; ++a) {
+              int j = _index[_digraph.source(a)];
+              if (_color[j] == _color[i] && value(_comp[j]) < 0 &&
+                  bits::atomicCompareAndSwap(_comp[j], -1, _color[i])) {
+                _next[thread].push_back(j);
+              }
+            }
+            break;
+          case COMP_DEGREE:
+            _count[i] = 0;
+            for (int p = _first[i]; p < _first[i + 1]; ++p) {
+              int u = _members[p];
+              for (InArcIt a(_digraph, _nodes[u]); a != INVALID; ++a) {
+                if (_color[_index[_digraph.source(a)]] != i) ++_count[i];
+              }
+            }
+            break;
+          case COMP_ORDER:
+            for (int p = _first[i]; p < _first[i + 1]; ++p) {
+              int u = _members[p];
+              for (OutArcIt a(_digraph, _nodes[u]); a != INVALID; ++a) {
+                int c = _color[_index[_digraph.target(a)]];
+                if (c != i && bits::atomicFetchAdd(_count[c], -1) == 1) {
+                  _next[thread].push_back(c);
+                }
+              }
+            }
+            break;
+          }
+        }
+      }
+
+    private:
+
+      enum Phase {
+        IN_DEGREE, OUT_DEGREE, TRIM_SOURCE, TRIM_SINK, COLOR, SEARCH,
+        COMP_DEGREE, COMP_ORDER
+      };
+
+      static int value(const int& v) {
+        return static_cast<const volatile int&>(v);
+      }
+
+      void runPhase(const std::vector<int>& items, Phase phase) {
+        _items = &items;
+        _phase = phase;
+        bits::parallelFor(items.size(), _thread_num, *this, 256);
+      }
+
+      // Move the contents of the thread local lists into the given list
+      void gather(std::vector<int>& list) {
+        list.clear();
+        for (int t = 0; t < int(_next.size()); ++t) {
+          list.insert(list.end(), _next[t].begin(), _next[t].end());
+          _next[t].clear();
+        }
+      }
+
+      // Keep the nodes without component
+      void remaining(std::vector<int>& items) {
+        int k = 0;
+        for (int l = 0; l < int(items.size()); ++l) {
+          if (_comp[items[l]] < 0) items[k++] = items[l];
+        }
+        items.resize(k);
+      }
+
+      // Remove the nodes whose degree (computed in the first phase)
+      // becomes zero in the subgraph of the remaining nodes
+      void trim(const std::vector<int>& items, Phase degree, Phase peel) {
+        runPhase(items, degree);
+        std::vector<int> level;
+        for (int k = 0; k < int(items.size()); ++k) {
+          int i = items[k];
+          if (_count[i] == 0) {
+            _comp[i] = i;
+            level.push_back(i);
+          }
+        }
+        while (!level.empty()) {
+          runPhase(level, peel);
+          gather(level);
+        }
+      }
+
+      // Number the components in a topological order. The components
+      // are identified by their representative nodes, _color is reused
+      // for the dense indices of the components of the nodes.
+      int order() {
+        int num = _nodes.size();
+        std::vector<int> dense(num);
+        int comp_num = 0;
+        for (int i = 0; i < num; ++i) {
+          if (_comp[i] == i) dense[i] = comp_num++;
+        }
+        _first.assign(comp_num + 1, 0);
+        for (int i = 0; i < num; ++i) {
+          _color[i] = dense[_comp[i]];
+          ++_first[_color[i] + 1];
+        }
+        for (int c = 0; c < comp_num; ++c) _first[c + 1] += _first[c];
+        _members.resize(num);
+        std::vector<int> pos(_first.begin(), _first.end() - 1);
+        for (int i = 0; i < num; ++i) _members[pos[_color[i]]++] = i;
+
+        std::vector<int> comps, level;
+        for (int c = 0; c < comp_num; ++c) comps.push_back(c);
+        runPhase(comps, COMP_DEGREE);
+        for (int c = 0; c < comp_num; ++c) {
+          if (_count[c] == 0) level.push_back(c);
+        }
+        _order.resize(comp_num);
+        int next = 0;
+        while (!level.empty()) {
+          for (int k = 0; k < int(level.size()); ++k) {
+            _order[level[k]] = next++;
+          }
+          runPhase(level, COMP_ORDER);
+          gather(level);
+          std::sort(level.begin(), level.end());
+        }
+        return comp_num;
+      }
+
+      const Digraph& _digraph;
+      int _thread_num;
+      std::vector<Node> _nodes;
+      typename Digraph::template NodeMap<int> _index;
+
+      std::vector<int> _comp, _color, _count, _flag;
+      std::vector<int> _first, _members, _order;
+      std::vector<std::vector<int> > _next;
+
+      const std::vector<int>* _items;
+      Phase _phase;
+    };
+
+  }
+
+  /// \ingroup graph_properties
+  ///
+  /// \brief Find the strongly connected components of a directed graph
+  /// using several threads
+  ///
+  /// This function finds the strongly connected components of the given
+  /// directed graph using the given number of threads. In addition, the
+  /// numbering of the components will satisfy that there is no arc going
+  /// from a higher numbered component to a lower one (i.e. it provides a
+  /// topological order of the components), just like in the case of
+  /// \ref stronglyConnectedComponents(const Digraph&, NodeMap&).
+  ///
+  /// The nodes that cannot be in a cycle are removed iteratively (based
+  /// on the number of the entering and leaving arcs), then the other
+  /// components are found by the parallel coloring method, and finally
+  /// the components are numbered by a parallel topological traversal.
+  ///
+  /// \param digraph The digraph.
+  /// \retval compMap A writable node map. The values will be set from 0 to
+  /// the number of the strongly connected components minus one. Each value
+  /// of the map will be set exactly once (by the calling thread), in the
+  /// order of the node iterator. The numbering may differ from the one
+  /// found by the sequential function, but it does not depend on the
+  /// number of threads.
+  /// \param threadNum The number of threads. If it is less than one,
+  /// the number of the hardware threads is used.
+  /// If LEMON is built without threading support, the computation is
+  /// performed on the calling thread.
+  /// \return The number of strongly connected components.
+  ///
+  /// \see stronglyConnected(), countStronglyConnectedComponents()
+  template <typename Digraph, typename NodeMap>
+  int stronglyConnectedComponents(const Digraph& digraph, NodeMap& compMap,
+                                  int threadNum) {
+    checkConcept<concepts::Digraph, Digraph>();
+    typedef typename Digraph::Node Node;
+    checkConcept<concepts::WriteMap<Node, int>, NodeMap>();
+
+    using namespace _connectivity_bits;
+
+    if (threadNum < 1) threadNum = bits::hardwareThreadNum();
+
+    ParallelStronglyConnectedComponents<Digraph> scc(digraph, threadNum);
+    int compNum = scc.run();
+    const std::vector<Node>& nodes = scc.nodes();
+    for (int i = 0; i < int(nodes.size()); ++i) {
+      compMap.set(nodes[i], scc.component(i));
+    }
+    return compNum;
+  }
+
   /// \ingroup graph_properties
   ///
   /// \brief Find the cut arcs of the strongly connected components.
@@ -1257,6 +1714,483 @@ namespace lemon {
     return cutNum;
   }
 
+  namespace _connectivity_bits {
+
+    // Parallel computation of the bi-connected components and the cut
+    // items in the style of Tarjan and Vishkin. A breadth-first
+    // spanning forest is built in parallel, then the subtree sizes,
+    // a preorder numbering and the lowest and highest preorder numbers
+    // reachable from the subtrees by single non-tree edges are computed
+    // level by level. The cut nodes, the cut edges and the components
+    // are derived from these values locally.
+    template <typename Graph>
+    class ParallelBiConnectivity {
+    public:
+      typedef typename Graph::Node Node;
+      typedef typename Graph::Arc Arc;
+      typedef typename Graph::Edge Edge;
+      typedef typename Graph::NodeIt NodeIt;
+      typedef typename Graph::OutArcIt OutArcIt;
+
+      ParallelBiConnectivity(const Graph& graph, int thread_num)
+        : _graph(graph), _thread_num(thread_num), _index(graph),
+          _sets(countNodes(graph)), _next(thread_num) {}
+
+      // Build the spanning forest and compute the labels of the nodes
+      void run() {
+        for (NodeIt n(_graph); n != INVALID; ++n) {
+          _index[n] = _nodes.size();
+          _nodes.push_back(n);
+        }
+        int num = _nodes.size();
+        std::vector<int> all(num);
+        for (int i = 0; i < num; ++i) all[i] = i;
+        runPhase(all, JOIN_EDGES);
+
+        // The roots of the trees are the smallest nodes of the components
+        _parent.assign(num, -1);
+        _parent_arc.assign(num, INVALID);
+        std::vector<int> level;
+        for (int i = 0; i < num; ++i) {
+          if (_sets.find(i) == i) {
+            _parent[i] = i;
+            level.push_back(i);
+          }
+        }
+        _roots = level;
+        while (!level.empty()) {
+          _level_start.push_back(_order.size());
+          _order.insert(_order.end(), level.begin(), level.end());
+          runPhase(level, SEARCH);
+          gather(level);
+        }
+        _level_start.push_back(_order.size());
+
+        _size.resize(num);
+        _low.resize(num);
+        _high.resize(num);
+        _pre.resize(num);
+        for (int l = int(_level_start.size()) - 2; l >= 0; --l) {
+          runLevel(l, SIZE);
+        }
+        int pre = 0;
+        for (int k = 0; k < int(_roots.size()); ++k) {
+          _pre[_roots[k]] = pre;
+          pre += _size[_roots[k]];
+        }
+        for (int l = 0; l < int(_level_start.size()) - 1; ++l) {
+          runLevel(l, PREORDER);
+        }
+        for (int l = int(_level_start.size()) - 2; l >= 0; --l) {
+          runLevel(l, LOW);
+        }
+      }
+
+      // Compute the cut nodes, joinBlocks() must be called before
+      void cutNodes() {
+        _cut.assign(_nodes.size(), 0);
+        runPhase(_order, CUT_NODES);
+      }
+
+      // Join the tree edges (identified by their lower end nodes)
+      // that are in the same bi-node-connected component
+      void joinBlocks() {
+        _sets = ParallelUnionFind(_nodes.size());
+        runPhase(_order, JOIN_BLOCKS);
+      }
+
+      // Join the end nodes of the non-bridge edges
+      void joinBiEdgeConnected() {
+        _sets = ParallelUnionFind(_nodes.size());
+        runPhase(_order, JOIN_BI_EDGE);
+      }
+
+      bool cutNode(int i) const {
+        return _cut[i] != 0;
+      }
+
+      // Check whether the tree edge above a node is a bridge
+      bool bridge(int i) const {
+        return _parent[i] != i && _low[i] >= _pre[i] &&
+          _high[i] < _pre[i] + _size[i];
+      }
+
+      Edge parentEdge(int i) const {
+        return _parent_arc[i];
+      }
+
+      int index(const Node& node) const {
+        return _index[node];
+      }
+
+      const std::vector<Node>& nodes() const {
+        return _nodes;
+      }
+
+      // The lower end node of a tree edge or the end node of a
+      // non-tree edge having the larger preorder number
+      int lowerNode(const Edge& edge) const {
+        int u = _index[_graph.u(edge)], v = _index[_graph.v(edge)];
+        if (_parent_arc[v] != INVALID && Edge(_parent_arc[v]) == edge) {
+          return v;
+        }
+        if (_parent_arc[u] != INVALID && Edge(_parent_arc[u]) == edge) {
+          return u;
+        }
+        return _pre[u] > _pre[v] ? u : v;
+      }
+
+      int find(int i) {
+        return _sets.find(i);
+      }
+
+      void operator()(int thread, int begin, int end) {
+        for (int k = begin; k < end; ++k) {
+          int i = (*_items)[k];
+          Node node = _nodes[i];
+          switch (_phase) {
+          case JOIN_EDGES:
+            for (OutArcIt a(_graph, node); a != INVALID; ++a) {
+              int j = _index[_graph.target(a)];
+              if (j < i) _sets.join(i, j);
+            }
+            break;
+          case SEARCH:
+            for (OutArcIt a(_graph, node); a != INVALID; ++a) {
+              int j = _index[_graph.target(a)];
+              if (_parent[j] == -1 &&
+                  bits::atomicCompareAndSwap(_parent[j], -1, i)) {
+                _parent_arc[j] = a;
+                _next[thread].push_back(j);
+              }
+            }
+            break;
+          case SIZE:
+            _size[i] = 1;
+            for (OutArcIt a(_graph, node); a != INVALID; ++a) {
+              int j = _index[_graph.target(a)];
+              if (_parent_arc[j] == a) _size[i] += _size[j];
+            }
+            break;
+          case PREORDER:
+            {
+              int pre = _pre[i] + 1;
+              for (OutArcIt a(_graph, node); a != INVALID; ++a) {
+                int j = _index[_graph.target(a)];
+                if (_parent_arc[j] == a) {
+                  _pre[j] = pre;
+                  pre += _size[j];
+                }
+              }
+            }
+            break;
+          case LOW:
+            _low[i] = _high[i] = _pre[i];
+            for (OutArcIt a(_graph, node); a != INVALID; ++a) {
+              int j = _index[_graph.target(a)];
+              if (_parent_arc[j] == a) {
+                if (_low[j] < _low[i]) _low[i] = _low[j];
+                if (_high[j] > _high[i]) _high[i] = _high[j];
+              } else if (_parent_arc[i] == INVALID ||
+                         _graph.oppositeArc(_parent_arc[i]) != a) {
+                if (_pre[j] < _low[i]) _low[i] = _pre[j];
+                if (_pre[j] > _high[i]) _high[i] = _pre[j];
+              }
+            }
+            break;
+          case CUT_NODES:
+            {
+              // The blocks at a node are given by its tree edges
+              int block = _parent[i] != i ? _sets.find(i) : -1;
+              bool cut = false;
+              for (OutArcIt a(_graph, node); a != INVALID; ++a) {
+                int j = _index[_graph.target(a)];
+                if (j == i) {
+                  cut = true;
+                } else if (_parent_arc[j] == a) {
+                  int b = _sets.find(j);
+                  if (block == -1) block = b;
+                  else if (b != block) cut = true;
+                }
+              }
+              _cut[i] = cut ? 1 : 0;
+            }
+            break;
+          case JOIN_BLOCKS:
+            if (_parent[i] == i) break;
+            {
+              int p = _parent[i];
+              if (_parent[p] != p && (_low[i] < _pre[p] ||
+                                      _high[i] >= _pre[p] + _size[p])) {
+                _sets.join(i, p);
+              }
+              for (OutArcIt a(_graph, node); a != INVALID; ++a) {
+                int j = _index[_graph.target(a)];
+                if (_pre[j] < _pre[i] && _pre[j] + _size[j] <= _pre[i]) {
+                  _sets.join(i, j);
+                }
+              }
+            }
+            break;
+          case JOIN_BI_EDGE:
+            if (!bridge(i) && _parent[i] != i) _sets.join(i, _parent[i]);
+            for (OutArcIt a(_graph, node); a != INVALID; ++a) {
+              int j = _index[_graph.target(a)];
+              if (j < i && _parent_arc[j] != a && (_parent[i] == i ||
+                  _graph.oppositeArc(_parent_arc[i]) != a)) {
+                _sets.join(i, j);
+              }
+            }
+            break;
+          }
+        }
+      }
+
+    private:
+
+      enum Phase {
+        JOIN_EDGES, SEARCH, SIZE, PREORDER, LOW, CUT_NODES, JOIN_BLOCKS,
+        JOIN_BI_EDGE
+      };
+
+      void runPhase(const std::vector<int>& items, Phase phase) {
+        _items = &items;
+        _phase = phase;
+        bits::parallelFor(items.size(), _thread_num, *this, 256);
+      }
+
+      // Process a level of the spanning forest
+      void runLevel(int level, Phase phase) {
+        std::vector<int> items(_order.begin() + _level_start[level],
+                               _order.begin() + _level_start[level + 1]);
+        runPhase(items, phase);
+      }
+
+      // Move the contents of the thread local lists into the given list
+      void gather(std::vector<int>& list) {
+        list.clear();
+        for (int t = 0; t < int(_next.size()); ++t) {
+          list.insert(list.end(), _next[t].begin(), _next[t].end());
+          _next[t].clear();
+        }
+      }
+
+      const Graph& _graph;
+      int _thread_num;
+      std::vector<Node> _nodes;
+      typename Graph::template NodeMap<int> _index;
+      ParallelUnionFind _sets;
+
+      std::vector<int> _parent;
+      std::vector<Arc> _parent_arc;
+      std::vector<int> _roots, _order, _level_start;
+      std::vector<int> _size, _pre, _low, _high;
+      std::vector<char> _cut;
+      std::vector<std::vector<int> > _next;
+
+      const std::vector<int>* _items;
+      Phase _phase;
+    };
+
+  }
+
+  /// \ingroup graph_properties
+  ///
+  /// \brief Find the bi-node-connected components of an undirected graph
+  /// using several threads.
+  ///
+  /// This function finds the bi-node-connected components of the given
+  /// undirected graph using the given number of threads. It applies a
+  /// parallel method in the style of Tarjan and Vishkin, which uses a
+  /// breadth-first spanning forest instead of a depth-first search.
+  ///
+  /// \param graph The undirected graph.
+  /// \retval compMap A writable edge map. The values will be set from 0
+  /// to the number of the bi-node-connected components minus one. The
+  /// components are the same as the ones found by
+  /// \ref biNodeConnectedComponents(const Graph&, EdgeMap&), but they
+  /// are numbered in the order of their first edges with respect to the
+  /// edge iterator, so the numbering does not depend on the number of
+  /// threads. Each value of the map will be set exactly once (by the
+  /// calling thread), in the order of the edge iterator.
+  /// \param threadNum The number of threads. If it is less than one,
+  /// the number of the hardware threads is used.
+  /// If LEMON is built without threading support, the computation is
+  /// performed on the calling thread.
+  /// \return The number of bi-node-connected components.
+  ///
+  /// \see biNodeConnected(), countBiNodeConnectedComponents()
+  template <typename Graph, typename EdgeMap>
+  int biNodeConnectedComponents(const Graph& graph, EdgeMap& compMap,
+                                int threadNum) {
+    checkConcept<concepts::Graph, Graph>();
+    typedef typename Graph::Edge Edge;
+    typedef typename Graph::EdgeIt EdgeIt;
+    checkConcept<concepts::WriteMap<Edge, int>, EdgeMap>();
+
+    using namespace _connectivity_bits;
+
+    if (threadNum < 1) threadNum = bits::hardwareThreadNum();
+
+    ParallelBiConnectivity<Graph> bicon(graph, threadNum);
+    bicon.run();
+    bicon.joinBlocks();
+
+    int compNum = 0;
+    std::vector<int> num(bicon.nodes().size(), -1);
+    for (EdgeIt e(graph); e != INVALID; ++e) {
+      if (graph.u(e) == graph.v(e)) {
+        compMap.set(e, compNum++);
+      } else {
+        int r = bicon.find(bicon.lowerNode(e));
+        if (num[r] < 0) num[r] = compNum++;
+        compMap.set(e, num[r]);
+      }
+    }
+    return compNum;
+  }
+
+  /// \ingroup graph_properties
+  ///
+  /// \brief Find the bi-node-connected cut nodes in an undirected graph
+  /// using several threads.
+  ///
+  /// This function finds the bi-node-connected cut nodes in the given
+  /// undirected graph using the given number of threads (see
+  /// \ref biNodeConnectedComponents(const Graph&, EdgeMap&, int)).
+  ///
+  /// \param graph The undirected graph.
+  /// \retval cutMap A writable node map. It is set exactly in the same
+  /// way as by \ref biNodeConnectedCutNodes(const Graph&, NodeMap&), but
+  /// the values are set by the calling thread in the order of the node
+  /// iterator.
+  /// \param threadNum The number of threads. If it is less than one,
+  /// the number of the hardware threads is used.
+  /// \return The number of the cut nodes.
+  ///
+  /// \see biNodeConnected(), biNodeConnectedComponents()
+  template <typename Graph, typename NodeMap>
+  int biNodeConnectedCutNodes(const Graph& graph, NodeMap& cutMap,
+                              int threadNum) {
+    checkConcept<concepts::Graph, Graph>();
+    typedef typename Graph::Node Node;
+    typedef typename Graph::NodeIt NodeIt;
+    checkConcept<concepts::WriteMap<Node, bool>, NodeMap>();
+
+    using namespace _connectivity_bits;
+
+    if (threadNum < 1) threadNum = bits::hardwareThreadNum();
+
+    ParallelBiConnectivity<Graph> bicon(graph, threadNum);
+    bicon.run();
+    bicon.joinBlocks();
+    bicon.cutNodes();
+
+    int cutNum = 0;
+    for (NodeIt n(graph); n != INVALID; ++n) {
+      if (bicon.cutNode(bicon.index(n))) {
+        cutMap.set(n, true);
+        ++cutNum;
+      }
+    }
+    return cutNum;
+  }
+
+  /// \ingroup graph_properties
+  ///
+  /// \brief Find the bi-edge-connected components of an undirected graph
+  /// using several threads.
+  ///
+  /// This function finds the bi-edge-connected components of the given
+  /// undirected graph using the given number of threads (see
+  /// \ref biNodeConnectedComponents(const Graph&, EdgeMap&, int)).
+  ///
+  /// \param graph The undirected graph.
+  /// \retval compMap A writable node map. The values will be set from 0 to
+  /// the number of the bi-edge-connected components minus one. The
+  /// components are the same as the ones found by
+  /// \ref biEdgeConnectedComponents(const Graph&, NodeMap&), but they
+  /// are numbered in the order of their first nodes with respect to the
+  /// node iterator, so the numbering does not depend on the number of
+  /// threads. Each value of the map will be set exactly once (by the
+  /// calling thread), in the order of the node iterator.
+  /// \param threadNum The number of threads. If it is less than one,
+  /// the number of the hardware threads is used.
+  /// \return The number of bi-edge-connected components.
+  ///
+  /// \see biEdgeConnected(), countBiEdgeConnectedComponents()
+  template <typename Graph, typename NodeMap>
+  int biEdgeConnectedComponents(const Graph& graph, NodeMap& compMap,
+                                int threadNum) {
+    checkConcept<concepts::Graph, Graph>();
+    typedef typename Graph::Node Node;
+    checkConcept<concepts::WriteMap<Node, int>, NodeMap>();
+
+    using namespace _connectivity_bits;
+
+    if (threadNum < 1) threadNum = bits::hardwareThreadNum();
+
+    ParallelBiConnectivity<Graph> bicon(graph, threadNum);
+    bicon.run();
+    bicon.joinBiEdgeConnected();
+
+    const std::vector<Node>& nodes = bicon.nodes();
+    int compNum = 0;
+    std::vector<int> num(nodes.size(), -1);
+    for (int i = 0; i < int(nodes.size()); ++i) {
+      int r = bicon.find(i);
+      if (num[r] < 0) num[r] = compNum++;
+      compMap.set(nodes[i], num[r]);
+    }
+    return compNum;
+  }
+
+  /// \ingroup graph_properties
+  ///
+  /// \brief Find the bi-edge-connected cut edges in an undirected graph
+  /// using several threads.
+  ///
+  /// This function finds the bi-edge-connected cut edges in the given
+  /// undirected graph using the given number of threads (see
+  /// \ref biNodeConnectedComponents(const Graph&, EdgeMap&, int)).
+  ///
+  /// \param graph The undirected graph.
+  /// \retval cutMap A writable edge map. It is set exactly in the same
+  /// way as by \ref biEdgeConnectedCutEdges(const Graph&, EdgeMap&), but
+  /// the values are set by the calling thread in the order of the node
+  /// iterator (of the lower end nodes of the cut edges in the spanning
+  /// forest).
+  /// \param threadNum The number of threads. If it is less than one,
+  /// the number of the hardware threads is used.
+  /// \return The number of cut edges.
+  ///
+  /// \see biEdgeConnected(), biEdgeConnectedComponents()
+  template <typename Graph, typename EdgeMap>
+  int biEdgeConnectedCutEdges(const Graph& graph, EdgeMap& cutMap,
+                              int threadNum) {
+    checkConcept<concepts::Graph, Graph>();
+    typedef typename Graph::Node Node;
+    typedef typename Graph::Edge Edge;
+    checkConcept<concepts::WriteMap<Edge, bool>, EdgeMap>();
+
+    using namespace _connectivity_bits;
+
+    if (threadNum < 1) threadNum = bits::hardwareThreadNum();
+
+    ParallelBiConnectivity<Graph> bicon(graph, threadNum);
+    bicon.run();
+
+    const std::vector<Node>& nodes = bicon.nodes();
+    int cutNum = 0;
+    for (int i = 0; i < int(nodes.size()); ++i) {
+      if (bicon.bridge(i)) {
+        cutMap.set(bicon.parentEdge(i), true);
+        ++cutNum;
+      }
+    }
+    return cutNum;
+  }
+
 
   namespace _connectivity_bits {
 
@@ -1417,6 +2351,234 @@ namespace lemon {
     return true;
   }
 
+  namespace _connectivity_bits {
+
+    // Parallel topological sort by the level-synchronous method of Kahn.
+    // The counters of the entering arcs are decreased atomically, and
+    // the nodes whose counter becomes zero form the next level. Each
+    // level is sorted, so the result does not depend on the number of
+    // threads. The nodes of the directed cycles and the nodes reachable
+    // from them are not ordered.
+    template <typename Digraph>
+    class ParallelTopologicalSort {
+    public:
+      typedef typename Digraph::Node Node;
+      typedef typename Digraph::NodeIt NodeIt;
+      typedef typename Digraph::OutArcIt OutArcIt;
+      typedef typename Digraph::InArcIt InArcIt;
+
+      ParallelTopologicalSort(const Digraph& digraph, int thread_num)
+        : _digraph(digraph), _thread_num(thread_num), _index(digraph),
+          _next(thread_num) {}
+
+      // Compute the order, it returns true if the digraph is DAG
+      bool run() {
+        _nodes.clear();
+        _order.clear();
+        _level_start.clear();
+        for (NodeIt n(_digraph); n != INVALID; ++n) {
+          _index[n] = _nodes.size();
+          _nodes.push_back(n);
+        }
+        int num = _nodes.size();
+        _count.resize(num);
+
+        std::vector<int> items(num), level;
+        for (int i = 0; i < num; ++i) items[i] = i;
+        runPhase(items, IN_DEGREE);
+        for (int i = 0; i < num; ++i) {
+          if (_count[i] == 0) level.push_back(i);
+        }
+        while (!level.empty()) {
+          _level_start.push_back(_order.size());
+          _order.insert(_order.end(), level.begin(), level.end());
+          runPhase(level, DECREASE);
+          gather(level);
+          std::sort(level.begin(), level.end());
+        }
+        _level_start.push_back(_order.size());
+        return int(_order.size()) == num;
+      }
+
+      const std::vector<Node>& nodes() const {
+        return _nodes;
+      }
+
+      int index(const Node& node) const {
+        return _index[node];
+      }
+
+      // The indices of the ordered nodes level by level
+      const std::vector<int>& order() const {
+        return _order;
+      }
+
+      int levelNum() const {
+        return _level_start.size() - 1;
+      }
+
+      // The position of the first node of a level in order()
+      int levelStart(int level) const {
+        return _level_start[level];
+      }
+
+      void operator()(int thread, int begin, int end) {
+        for (int k = begin; k < end; ++k) {
+          int i = (*_items)[k];
+          switch (_phase) {
+          case IN_DEGREE:
+            _count[i] = 0;
+            for (InArcIt a(_digraph, _nodes[i]); a != INVALID; ++a) {
+              ++_count[i];
+            }
+            break;
+          case DECREASE:
+            for (OutArcIt a(_digraph, _nodes[i]); a != INVALID; ++a) {
+              int j = _index[_digraph.target(a)];
+              if (bits::atomicFetchAdd(_count[j], -1) == 1) {
+                _next[thread].push_back(j);
+              }
+            }
+            break;
+          }
+        }
+      }
+
+    private:
+
+      enum Phase { IN_DEGREE, DECREASE };
+
+      void runPhase(const std::vector<int>& items, Phase phase) {
+        _items = &items;
+        _phase = phase;
+        bits::parallelFor(items.size(), _thread_num, *this, 256);
+      }
+
+      // Move the contents of the thread local lists into the given list
+      void gather(std::vector<int>& list) {
+        list.clear();
+        for (int t = 0; t < int(_next.size()); ++t) {
+          list.insert(list.end(), _next[t].begin(), _next[t].end());
+          _next[t].clear();
+        }
+      }
+
+      const Digraph& _digraph;
+      int _thread_num;
+      std::vector<Node> _nodes;
+      typename Digraph::template NodeMap<int> _index;
+
+      std::vector<int> _count, _order, _level_start;
+      std::vector<std::vector<int> > _next;
+
+      const std::vector<int>* _items;
+      Phase _phase;
+    };
+
+  }
+
+  /// \ingroup graph_properties
+  ///
+  /// \brief Sort the nodes of a DAG into topolgical order using several
+  /// threads.
+  ///
+  /// This function sorts the nodes of the given acyclic digraph (DAG)
+  /// into topolgical order using the given number of threads.
+  ///
+  /// The nodes are processed level by level according to the method of
+  /// Kahn: the first level consists of the nodes without entering arcs,
+  /// and a node is put on the next level when all of its entering arcs
+  /// have been processed. The nodes of a level are numbered in the order
+  /// of the node iterator, so the numbering does not depend on the number
+  /// of threads, but it may differ from the one found by
+  /// \ref topologicalSort(const Digraph&, NodeMap&).
+  ///
+  /// \param digraph The digraph, which must be DAG.
+  /// \retval order A writable node map. The values will be set from 0 to
+  /// the number of the nodes in the digraph minus one. Each value of the
+  /// map will be set exactly once (by the calling thread), in the order
+  /// of the node iterator.
+  /// \param threadNum The number of threads. If it is less than one,
+  /// the number of the hardware threads is used.
+  /// If LEMON is built without threading support, the computation is
+  /// performed on the calling thread.
+  ///
+  /// \see dag(), checkedTopologicalSort()
+  template <typename Digraph, typename NodeMap>
+  void topologicalSort(const Digraph& digraph, NodeMap& order,
+                       int threadNum) {
+    using namespace _connectivity_bits;
+
+    checkConcept<concepts::Digraph, Digraph>();
+    checkConcept<concepts::WriteMap<typename Digraph::Node, int>, NodeMap>();
+
+    typedef typename Digraph::Node Node;
+
+    if (threadNum < 1) threadNum = bits::hardwareThreadNum();
+
+    ParallelTopologicalSort<Digraph> sort(digraph, threadNum);
+    sort.run();
+    const std::vector<Node>& nodes = sort.nodes();
+    const std::vector<int>& sorted = sort.order();
+    int num = nodes.size();
+    std::vector<int> pos(num, -1);
+    for (int k = 0; k < int(sorted.size()); ++k) pos[sorted[k]] = k;
+    int next = sorted.size();
+    for (int i = 0; i < num; ++i) {
+      order.set(nodes[i], pos[i] >= 0 ? pos[i] : next++);
+    }
+  }
+
+  /// \ingroup graph_properties
+  ///
+  /// \brief Sort the nodes of a DAG into topolgical order using several
+  /// threads.
+  ///
+  /// This function sorts the nodes of the given acyclic digraph (DAG)
+  /// into topolgical order using the given number of threads, and it
+  /// also checks whether the given digraph is DAG. The numbering is the
+  /// same as the one of
+  /// \ref topologicalSort(const Digraph&, NodeMap&, int).
+  ///
+  /// \param digraph The digraph.
+  /// \retval order A writable node map. If the digraph is DAG, the values
+  /// will be set from 0 to the number of the nodes in the digraph minus
+  /// one. Otherwise the nodes of the directed cycles and the nodes
+  /// reachable from them are set to -1. Each value of the map will be set
+  /// exactly once (by the calling thread), in the order of the node
+  /// iterator.
+  /// \param threadNum The number of threads. If it is less than one,
+  /// the number of the hardware threads is used.
+  /// If LEMON is built without threading support, the computation is
+  /// performed on the calling thread.
+  /// \return \c false if the digraph is not DAG.
+  ///
+  /// \see dag(), topologicalSort()
+  template <typename Digraph, typename NodeMap>
+  bool checkedTopologicalSort(const Digraph& digraph, NodeMap& order,
+                              int threadNum) {
+    using namespace _connectivity_bits;
+
+    checkConcept<concepts::Digraph, Digraph>();
+    checkConcept<concepts::WriteMap<typename Digraph::Node, int>, NodeMap>();
+
+    typedef typename Digraph::Node Node;
+
+    if (threadNum < 1) threadNum = bits::hardwareThreadNum();
+
+    ParallelTopologicalSort<Digraph> sort(digraph, threadNum);
+    bool result = sort.run();
+    const std::vector<Node>& nodes = sort.nodes();
+    const std::vector<int>& sorted = sort.order();
+    int num = nodes.size();
+    std::vector<int> pos(num, -1);
+    for (int k = 0; k < int(sorted.size()); ++k) pos[sorted[k]] = k;
+    for (int i = 0; i < num; ++i) {
+      order.set(nodes[i], pos[i]);
+    }
+    return result;
+  }
+
   /// \ingroup graph_properties
   ///
   /// \brief Check whether an undirected graph is acyclic.
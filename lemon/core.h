@@ -50,6 +50,7 @@
 
 #include <lemon/bits/enable_if.h>
 #include <lemon/bits/traits.h>
+#include <lemon/bits/parallel.h>
 #include <lemon/assert.h>
 
 
@@ -77,6 +78,22 @@ namespace lemon {
   extern const Invalid INVALID;
 #endif
 
+  /// \brief The type of the item identifiers of the large graph
+  /// structures.
+  ///
+  /// The type of the node and arc identifiers (and of the item counts)
+  /// of the graph structures that support very large graphs, i.e.
+  /// \ref SmartDigraph, \ref StaticDigraph, \ref CompactDigraph and
+  /// \ref CompressedDigraph, and of the indices of the graph maps.
+  /// By default, it is \c int, but it is a 64-bit integer type if LEMON
+  /// is configured with the \c LEMON_64BIT_IDS option, which allows more
+  /// than 2<sup>31</sup> items at the expense of a larger memory usage.
+#ifdef LEMON_64BIT_IDS
+  typedef long long Index;
+#else
+  typedef int Index;
+#endif
+
   /// \addtogroup gutils
   /// @{
 
@@ -207,9 +224,9 @@ namespace lemon {
   /// The complexity of the function is linear because
   /// it iterates on all of the items.
   template <typename Graph, typename Item>
-  inline int countItems(const Graph& g) {
+  inline Index countItems(const Graph& g) {
     typedef typename ItemSetTraits<Graph, Item>::ItemIt ItemIt;
-    int num = 0;
+    Index num = 0;
     for (ItemIt it(g); it != INVALID; ++it) {
       ++num;
     }
@@ -222,7 +239,7 @@ namespace lemon {
 
     template <typename Graph, typename Enable = void>
     struct CountNodesSelector {
-      static int count(const Graph &g) {
+      static Index count(const Graph &g) {
         return countItems<Graph, typename Graph::Node>(g);
       }
     };
@@ -232,7 +249,7 @@ namespace lemon {
       Graph, typename
       enable_if<typename Graph::NodeNumTag, void>::type>
     {
-      static int count(const Graph &g) {
+      static Index count(const Graph &g) {
         return g.nodeNum();
       }
     };
@@ -248,7 +265,7 @@ namespace lemon {
   /// \c NodeNumTag tag then this function calls directly the member
   /// function to query the cardinality of the node set.
   template <typename Graph>
-  inline int countNodes(const Graph& g) {
+  inline Index countNodes(const Graph& g) {
     return _core_bits::CountNodesSelector<Graph>::count(g);
   }
 
@@ -256,7 +273,7 @@ namespace lemon {
 
     template <typename Graph, typename Enable = void>
     struct CountRedNodesSelector {
-      static int count(const Graph &g) {
+      static Index count(const Graph &g) {
         return countItems<Graph, typename Graph::RedNode>(g);
       }
     };
@@ -266,7 +283,7 @@ namespace lemon {
       Graph, typename
       enable_if<typename Graph::NodeNumTag, void>::type>
     {
-      static int count(const Graph &g) {
+      static Index count(const Graph &g) {
         return g.redNum();
       }
     };
@@ -282,7 +299,7 @@ namespace lemon {
   /// \e NodeNumTag tag then this function calls directly the member
   /// function to query the cardinality of the node set.
   template <typename Graph>
-  inline int countRedNodes(const Graph& g) {
+  inline Index countRedNodes(const Graph& g) {
     return _graph_utils_bits::CountRedNodesSelector<Graph>::count(g);
   }
 
@@ -290,7 +307,7 @@ namespace lemon {
 
     template <typename Graph, typename Enable = void>
     struct CountBlueNodesSelector {
-      static int count(const Graph &g) {
+      static Index count(const Graph &g) {
         return countItems<Graph, typename Graph::BlueNode>(g);
       }
     };
@@ -300,7 +317,7 @@ namespace lemon {
       Graph, typename
       enable_if<typename Graph::NodeNumTag, void>::type>
     {
-      static int count(const Graph &g) {
+      static Index count(const Graph &g) {
         return g.blueNum();
       }
     };
@@ -316,7 +333,7 @@ namespace lemon {
   /// \e NodeNumTag tag then this function calls directly the member
   /// function to query the cardinality of the node set.
   template <typename Graph>
-  inline int countBlueNodes(const Graph& g) {
+  inline Index countBlueNodes(const Graph& g) {
     return _graph_utils_bits::CountBlueNodesSelector<Graph>::count(g);
   }
 
@@ -326,7 +343,7 @@ namespace lemon {
 
     template <typename Graph, typename Enable = void>
     struct CountArcsSelector {
-      static int count(const Graph &g) {
+      static Index count(const Graph &g) {
         return countItems<Graph, typename Graph::Arc>(g);
       }
     };
@@ -336,7 +353,7 @@ namespace lemon {
       Graph,
       typename enable_if<typename Graph::ArcNumTag, void>::type>
     {
-      static int count(const Graph &g) {
+      static Index count(const Graph &g) {
         return g.arcNum();
       }
     };
@@ -352,7 +369,7 @@ namespace lemon {
   /// \c ArcNumTag tag then this function calls directly the member
   /// function to query the cardinality of the arc set.
   template <typename Graph>
-  inline int countArcs(const Graph& g) {
+  inline Index countArcs(const Graph& g) {
     return _core_bits::CountArcsSelector<Graph>::count(g);
   }
 
@@ -362,7 +379,7 @@ namespace lemon {
 
     template <typename Graph, typename Enable = void>
     struct CountEdgesSelector {
-      static int count(const Graph &g) {
+      static Index count(const Graph &g) {
         return countItems<Graph, typename Graph::Edge>(g);
       }
     };
@@ -372,7 +389,7 @@ namespace lemon {
       Graph,
       typename enable_if<typename Graph::EdgeNumTag, void>::type>
     {
-      static int count(const Graph &g) {
+      static Index count(const Graph &g) {
         return g.edgeNum();
       }
     };
@@ -388,7 +405,7 @@ namespace lemon {
   /// \c EdgeNumTag tag then this function calls directly the member
   /// function to query the cardinality of the edge set.
   template <typename Graph>
-  inline int countEdges(const Graph& g) {
+  inline Index countEdges(const Graph& g) {
     return _core_bits::CountEdgesSelector<Graph>::count(g);
 
   }
@@ -437,9 +454,59 @@ namespace lemon {
     public:
       virtual void copy(const Digraph& from, const RefMap& refMap) = 0;
 
+      // Copies the data of the given items using several threads
+      virtual void copy(const std::vector<Item>& items,
+                        const RefMap& refMap, int threadNum) = 0;
+
       virtual ~MapCopyBase() {}
     };
 
+    // The elements of a vector<bool> cannot be written concurrently
+    template <typename Value>
+    struct ConcurrentValue {
+      static const bool value = true;
+    };
+
+    template <>
+    struct ConcurrentValue<bool> {
+      static const bool value = false;
+    };
+
+    // Only the maps declaring ConcurrentSetTag (e.g. the standard graph
+    // maps) are filled using several threads
+    template <typename Map, typename Enable = void>
+    struct ConcurrentSet {
+      static const bool value = false;
+    };
+
+    template <typename Map>
+    struct ConcurrentSet<
+      Map, typename enable_if<typename Map::ConcurrentSetTag, void>::type> {
+      static const bool value =
+        ConcurrentValue<typename Map::Value>::value;
+    };
+
+    // Calls copier.copyItem() for the items of a range of indices
+    template <typename Item, typename RefMap, typename Copier>
+    class ParallelItemCopy {
+    public:
+
+      ParallelItemCopy(const std::vector<Item>& items,
+                       const RefMap& refMap, Copier& copier)
+        : _items(items), _ref_map(refMap), _copier(copier) {}
+
+      void operator()(int, int begin, int end) {
+        for (int i = begin; i != end; ++i) {
+          _copier.copyItem(_items[i], _ref_map);
+        }
+      }
+
+    private:
+      const std::vector<Item>& _items;
+      const RefMap& _ref_map;
+      Copier& _copier;
+    };
+
     template <typename Digraph, typename Item, typename RefMap,
               typename FromMap, typename ToMap>
     class MapCopy : public MapCopyBase<Digraph, Item, RefMap> {
@@ -455,6 +522,18 @@ namespace lemon {
         }
       }
 
+      virtual void copy(const std::vector<Item>& items,
+                        const RefMap& refMap, int threadNum) {
+        ParallelItemCopy<Item, RefMap, MapCopy> worker(items, refMap, *this);
+        bits::parallelFor(int(items.size()),
+                          ConcurrentSet<ToMap>::value ? threadNum : 1,
+                          worker);
+      }
+
+      void copyItem(const Item& item, const RefMap& refMap) {
+        _tmap.set(refMap[item], _map[item]);
+      }
+
     private:
       const FromMap& _map;
       ToMap& _tmap;
@@ -470,6 +549,11 @@ namespace lemon {
         _it = refMap[_item];
       }
 
+      virtual void copy(const std::vector<Item>&,
+                        const RefMap& refMap, int) {
+        _it = refMap[_item];
+      }
+
     private:
       Item _item;
       It& _it;
@@ -488,6 +572,17 @@ namespace lemon {
         }
       }
 
+      virtual void copy(const std::vector<Item>& items,
+                        const RefMap& refMap, int threadNum) {
+        ParallelItemCopy<Item, RefMap, RefCopy> worker(items, refMap, *this);
+        bits::parallelFor(int(items.size()),
+                          ConcurrentSet<Ref>::value ? threadNum : 1, worker);
+      }
+
+      void copyItem(const Item& item, const RefMap& refMap) {
+        _map.set(item, refMap[item]);
+      }
+
     private:
       Ref& _map;
     };
@@ -506,6 +601,19 @@ namespace lemon {
         }
       }
 
+      virtual void copy(const std::vector<Item>& items,
+                        const RefMap& refMap, int threadNum) {
+        ParallelItemCopy<Item, RefMap, CrossRefCopy>
+          worker(items, refMap, *this);
+        bits::parallelFor(int(items.size()),
+                          ConcurrentSet<CrossRef>::value ? threadNum : 1,
+                          worker);
+      }
+
+      void copyItem(const Item& item, const RefMap& refMap) {
+        _cmap.set(refMap[item], item);
+      }
+
     private:
       CrossRef& _cmap;
     };
@@ -682,7 +790,7 @@ namespace lemon {
     /// Constructor of DigraphCopy for copying the content of the
     /// \c from digraph into the \c to digraph.
     DigraphCopy(const From& from, To& to)
-      : _from(from), _to(to) {}
+      : _from(from), _to(to), _thread_num(1) {}
 
     /// \brief Destructor of DigraphCopy
     ///
@@ -795,6 +903,36 @@ namespace lemon {
       return *this;
     }
 
+    /// \brief Set the number of threads.
+    ///
+    /// This function sets the number of threads used for copying the
+    /// assigned maps and references. The default value is 1, i.e. the
+    /// copying runs serially. A value less than 1 means the number of
+    /// available processors.
+    ///
+    /// The digraph itself is built serially (using its \c build()
+    /// function if it is available), then the maps are filled in
+    /// parallel chunks of items. Only the maps that allow setting the
+    /// values of different keys concurrently, i.e. the standard graph
+    /// maps with non-\c bool values, are filled in parallel, the other
+    /// ones (e.g. \ref CrossRefMap or the maps with \c bool values) are
+    /// always copied serially.
+    /// If LEMON is built without threading support, this setting
+    /// has no effect.
+    ///
+    /// \return <tt>(*this)</tt>
+    DigraphCopy& threadNum(int num) {
+      _thread_num = num < 1 ? bits::hardwareThreadNum() : num;
+      return *this;
+    }
+
+    /// \brief Return the number of threads.
+    ///
+    /// This function returns the number of threads used for copying.
+    int threadNum() const {
+      return _thread_num;
+    }
+
     /// \brief Execute copying.
     ///
     /// This function executes the copying of the digraph along with the
@@ -804,6 +942,19 @@ namespace lemon {
       ArcRefMap arcRefMap(_from);
       _core_bits::DigraphCopySelector<To>::
         copy(_from, _to, nodeRefMap, arcRefMap);
+      if (_thread_num > 1) {
+        std::vector<Node> nodes;
+        for (NodeIt n(_from); n != INVALID; ++n) nodes.push_back(n);
+        for (int i = 0; i < int(_node_maps.size()); ++i) {
+          _node_maps[i]->copy(nodes, nodeRefMap, _thread_num);
+        }
+        std::vector<Arc> arcs;
+        for (ArcIt a(_from); a != INVALID; ++a) arcs.push_back(a);
+        for (int i = 0; i < int(_arc_maps.size()); ++i) {
+          _arc_maps[i]->copy(arcs, arcRefMap, _thread_num);
+        }
+        return;
+      }
       for (int i = 0; i < int(_node_maps.size()); ++i) {
         _node_maps[i]->copy(_from, nodeRefMap);
       }
@@ -823,6 +974,8 @@ namespace lemon {
     std::vector<_core_bits::MapCopyBase<From, Arc, ArcRefMap>* >
       _arc_maps;
 
+    int _thread_num;
+
   };
 
   /// \brief Copy a digraph to another digraph.
@@ -928,7 +1081,7 @@ namespace lemon {
     /// Constructor of GraphCopy for copying the content of the
     /// \c from graph into the \c to graph.
     GraphCopy(const From& from, To& to)
-      : _from(from), _to(to) {}
+      : _from(from), _to(to), _thread_num(1) {}
 
     /// \brief Destructor of GraphCopy
     ///
@@ -1092,6 +1245,36 @@ namespace lemon {
       return *this;
     }
 
+    /// \brief Set the number of threads.
+    ///
+    /// This function sets the number of threads used for copying the
+    /// assigned maps and references. The default value is 1, i.e. the
+    /// copying runs serially. A value less than 1 means the number of
+    /// available processors.
+    ///
+    /// The graph itself is built serially (using its \c build()
+    /// function if it is available), then the maps are filled in
+    /// parallel chunks of items. Only the maps that allow setting the
+    /// values of different keys concurrently, i.e. the standard graph
+    /// maps with non-\c bool values, are filled in parallel, the other
+    /// ones (e.g. \ref CrossRefMap or the maps with \c bool values) are
+    /// always copied serially.
+    /// If LEMON is built without threading support, this setting
+    /// has no effect.
+    ///
+    /// \return <tt>(*this)</tt>
+    GraphCopy& threadNum(int num) {
+      _thread_num = num < 1 ? bits::hardwareThreadNum() : num;
+      return *this;
+    }
+
+    /// \brief Return the number of threads.
+    ///
+    /// This function returns the number of threads used for copying.
+    int threadNum() const {
+      return _thread_num;
+    }
+
     /// \brief Execute copying.
     ///
     /// This function executes the copying of the graph along with the
@@ -1102,6 +1285,26 @@ namespace lemon {
       ArcRefMap arcRefMap(_from, _to, edgeRefMap, nodeRefMap);
       _core_bits::GraphCopySelector<To>::
         copy(_from, _to, nodeRefMap, edgeRefMap);
+      if (_thread_num > 1) {
+        std::vector<Node> nodes;
+        for (NodeIt n(_from); n != INVALID; ++n) nodes.push_back(n);
+        for (int i = 0; i < int(_node_maps.size()); ++i) {
+          _node_maps[i]->copy(nodes, nodeRefMap, _thread_num);
+        }
+        std::vector<Edge> edges;
+        for (EdgeIt e(_from); e != INVALID; ++e) edges.push_back(e);
+        for (int i = 0; i < int(_edge_maps.size()); ++i) {
+          _edge_maps[i]->copy(edges, edgeRefMap, _thread_num);
+        }
+        if (!_arc_maps.empty()) {
+          std::vector<Arc> arcs;
+          for (ArcIt a(_from); a != INVALID; ++a) arcs.push_back(a);
+          for (int i = 0; i < int(_arc_maps.size()); ++i) {
+            _arc_maps[i]->copy(arcs, arcRefMap, _thread_num);
+          }
+        }
+        return;
+      }
       for (int i = 0; i < int(_node_maps.size()); ++i) {
         _node_maps[i]->copy(_from, nodeRefMap);
       }
@@ -1127,6 +1330,8 @@ namespace lemon {
     std::vector<_core_bits::MapCopyBase<From, Edge, EdgeRefMap>* >
       _edge_maps;
 
+    int _thread_num;
+
   };
 
   /// \brief Copy a graph to another graph.
@@ -33,6 +33,7 @@
 #include <lemon/static_graph.h>
 #include <lemon/circulation.h>
 #include <lemon/bellman_ford.h>
+#include <lemon/stats.h>
 
 namespace lemon {
 
@@ -66,6 +67,13 @@ namespace lemon {
     /// otherwise it is \c double.
     /// \c Cost must be convertible to \c LargeCost.
     typedef double LargeCost;
+
+    /// \brief The type of the statistics collector
+    ///
+    /// The type of the statistics collector. It is \ref NoStats,
+    /// which records nothing. Use \ref Stats to record the operation
+    /// counters and the phase times of the algorithm.
+    typedef NoStats Stats;
   };
 
   // Default traits class for integer cost types
@@ -80,6 +88,7 @@ namespace lemon {
 #else
     typedef long LargeCost;
 #endif
+    typedef NoStats Stats;
   };
 
 
@@ -153,6 +162,9 @@ namespace lemon {
     /// otherwise it is \c double.
     typedef typename TR::LargeCost LargeCost;
 
+    /// The type of the statistics collector
+    typedef typename TR::Stats Stats;
+
     /// \brief The \ref lemon::CostScalingDefaultTraits "traits class"
     /// of the algorithm
     typedef TR Traits;
@@ -205,6 +217,39 @@ namespace lemon {
       PARTIAL_AUGMENT
     };
 
+    /// \brief Operation counters of the algorithm.
+    ///
+    /// Operation counters of the algorithm, see \ref stats().
+    enum StatCounter {
+      /// The number of push operations, i.e. flow modifications on
+      /// single arcs (including the arcs of the augmenting paths).
+      PUSHES,
+      /// The number of augmentations along admissible paths.
+      AUGMENTATIONS,
+      /// The number of relabel operations.
+      RELABELS,
+      /// The number of global update heuristic steps.
+      GLOBAL_UPDATES,
+      /// The number of cost scaling phases.
+      SCALING_PHASES,
+      /// The number of scaling phases completed by the price
+      /// refinement heuristic.
+      PRICE_REFINEMENTS
+    };
+
+    /// \brief Phases of the algorithm.
+    ///
+    /// Phases of the algorithm, see \ref stats().
+    enum StatPhase {
+      /// The initialization of the data structures.
+      INIT_PHASE,
+      /// The cost scaling phases.
+      SCALING_PHASE,
+      /// The computation of the dual solution and the transformation
+      /// of the results.
+      FINISH_PHASE
+    };
+
   private:
 
     TEMPLATE_DIGRAPH_TYPEDEFS(GR);
@@ -293,6 +338,9 @@ namespace lemon {
     IntVector _rank;
     int _max_rank;
 
+    // Operation statistics
+    Stats _stats;
+
   public:
 
     /// \brief Constant for infinite upper bounds (capacities).
@@ -324,6 +372,24 @@ namespace lemon {
       typedef  CostScaling<GR, V, C, SetLargeCostTraits<T> > Create;
     };
 
+    template <typename T>
+    struct SetStatsTraits : public Traits {
+      typedef T Stats;
+    };
+
+    /// \brief \ref named-templ-param "Named parameter" for setting
+    /// \c Stats type.
+    ///
+    /// \ref named-templ-param "Named parameter" for setting \c Stats
+    /// type, which records the operation counters and the phase times
+    /// of the algorithm. Use \ref lemon::Stats "Stats" for enabling
+    /// the statistics, see \ref stats().
+    template <typename T>
+    struct SetStats
+      : public CostScaling<GR, V, C, SetStatsTraits<T> > {
+      typedef  CostScaling<GR, V, C, SetStatsTraits<T> > Create;
+    };
+
     /// @}
 
   protected:
@@ -509,7 +575,10 @@ namespace lemon {
     ProblemType run(Method method = PARTIAL_AUGMENT, int factor = 16) {
       LEMON_ASSERT(factor >= 2, "The scaling factor must be at least 2");
       _alpha = factor;
+      _stats.reset();
+      _stats.startPhase(INIT_PHASE);
       ProblemType pt = init();
+      _stats.stopPhase(INIT_PHASE);
       if (pt != OPTIMAL) return pt;
       start(method);
       return OPTIMAL;
@@ -750,6 +819,17 @@ namespace lemon {
       }
     }
 
+    /// \brief Returns the statistics of the algorithm.
+    ///
+    /// Returns the operation counters and the phase times of the last
+    /// execution, which are indexed by \ref StatCounter and
+    /// \ref StatPhase, respectively. They are recorded only if the
+    /// \ref SetStats "Stats" type is set to \ref lemon::Stats "Stats",
+    /// otherwise all values are zero.
+    const Stats& stats() const {
+      return _stats;
+    }
+
     /// @}
 
   private:
@@ -919,6 +999,7 @@ namespace lemon {
     void start(Method method) {
       const int MAX_PARTIAL_PATH_LENGTH = 4;
 
+      _stats.startPhase(SCALING_PHASE);
       switch (method) {
         case PUSH:
           startPush();
@@ -930,6 +1011,8 @@ namespace lemon {
           startAugment(MAX_PARTIAL_PATH_LENGTH);
           break;
       }
+      _stats.stopPhase(SCALING_PHASE);
+      _stats.startPhase(FINISH_PHASE);
 
       // Compute node potentials (dual solution)
       for (int i = 0; i != _res_node_num; ++i) {
@@ -996,6 +1079,7 @@ namespace lemon {
           if (_forward[j]) _res_cap[_reverse[j]] += _lower[j];
         }
       }
+      _stats.stopPhase(FINISH_PHASE);
     }
 
     // Initialize a cost scaling phase
@@ -1365,10 +1449,14 @@ namespace lemon {
                                         1 : _epsilon / _alpha )
       {
         ++eps_phase_cnt;
+        _stats.count(SCALING_PHASES);
 
         // Price refinement heuristic
         if (eps_phase_cnt >= PRICE_REFINEMENT_LIMIT) {
-          if (priceRefinement()) continue;
+          if (priceRefinement()) {
+            _stats.count(PRICE_REFINEMENTS);
+            continue;
+          }
         }
 
         // Initialize current phase
@@ -1429,6 +1517,7 @@ namespace lemon {
             _pi[tip] -= min_red_cost + _epsilon;
             _next_out[tip] = _first_out[tip];
             ++relabel_cnt;
+            _stats.count(RELABELS);
 
             // Step back
             if (tip != start) {
@@ -1459,11 +1548,16 @@ namespace lemon {
               _active_nodes.push_back(v);
             }
           }
+          if (path.size() > 0) {
+            _stats.count(AUGMENTATIONS);
+            _stats.count(PUSHES, path.size());
+          }
           path.clear();
 
           // Global update heuristic
           if (relabel_cnt >= next_global_update_limit) {
             globalUpdate();
+            _stats.count(GLOBAL_UPDATES);
             next_global_update_limit += global_update_skip;
           }
         }
@@ -1491,10 +1585,14 @@ namespace lemon {
                                         1 : _epsilon / _alpha )
       {
         ++eps_phase_cnt;
+        _stats.count(SCALING_PHASES);
 
         // Price refinement heuristic
         if (eps_phase_cnt >= PRICE_REFINEMENT_LIMIT) {
-          if (priceRefinement()) continue;
+          if (priceRefinement()) {
+            _stats.count(PRICE_REFINEMENTS);
+            continue;
+          }
         }
 
         // Initialize current phase
@@ -1534,6 +1632,7 @@ namespace lemon {
 
                 // Push flow along the arc
                 if (ahead < delta && !hyper[t]) {
+                  _stats.count(PUSHES);
                   _res_cap[a] -= ahead;
                   _res_cap[_reverse[a]] += ahead;
                   _excess[n] -= ahead;
@@ -1544,6 +1643,7 @@ namespace lemon {
                   _next_out[n] = a;
                   goto next_node;
                 } else {
+                  _stats.count(PUSHES);
                   _res_cap[a] -= delta;
                   _res_cap[_reverse[a]] += delta;
                   _excess[n] -= delta;
@@ -1577,6 +1677,7 @@ namespace lemon {
             _next_out[n] = _first_out[n];
             hyper[n] = false;
             ++relabel_cnt;
+            _stats.count(RELABELS);
           }
 
           // Remove nodes that are not active nor hyper
@@ -1590,6 +1691,7 @@ namespace lemon {
           // Global update heuristic
           if (relabel_cnt >= next_global_update_limit) {
             globalUpdate();
+            _stats.count(GLOBAL_UPDATES);
             for (int u = 0; u != _res_node_num; ++u)
               hyper[u] = false;
             next_global_update_limit += global_update_skip;
@@ -20,9 +20,11 @@
 #define LEMON_COUNTER_H
 
 #include <string>
+#include <vector>
 #include <iostream>
 
 #include <lemon/core.h>
+#include <lemon/bits/parallel.h>
 
 ///\ingroup timecount
 ///\file
@@ -245,6 +247,319 @@ namespace lemon
     operator int() {return 0;}
   };
 
+  /// Thread-safe counter class with per-thread shards
+
+  /// This class can be used in the same way as \ref Counter, but it
+  /// can also be shared by several threads. Each thread has its own
+  /// shard of the counter, which can be accessed by \ref operator[]()
+  /// using the index of the thread (e.g. the thread index passed to
+  /// the work items of the parallel algorithms). Modifying a shard
+  /// is as cheap as modifying a \ref Counter, and the shards are placed
+  /// in different cache lines, so the threads do not contend. The
+  /// value of the counter is the sum of the shards, which is computed
+  /// when it is read.
+  ///
+  /// The operators of the counter itself (e.g. \c operator++) can also
+  /// be used from any thread, but they are protected by a lock, so they
+  /// should not be used in the inner loops.
+  ///
+  /// The counters can be organized into a hierarchy. A child counter
+  /// is created with its parent as the first parameter of the
+  /// constructor, and its value is included in the value of the parent.
+  /// The usual \ref SubCounter "SubCounter"s can also be used, they
+  /// add their value to the counter on destruction.
+  /// The whole hierarchy can be written in JSON or CSV format by
+  /// \ref writeJson() and \ref writeCsv(), respectively.
+  ///
+  /// A report containing the given title and the value of the counter
+  /// is automatically printed on destruction, just like for
+  /// \ref Counter.
+  ///
+  /// \code
+  /// ParallelCounter ops("Operations: ");
+  /// ops.threadNum(4);
+  /// ParallelCounter scans(ops, "Scans: ");
+  /// // in the work item of thread t
+  /// ++scans[t];
+  /// ops[t] += 2;
+  /// // after the workers finished
+  /// ops.writeJson(std::cout);
+  /// \endcode
+  ///
+  /// \note The value of the counter is exact only if no thread is
+  /// modifying the shards at the time of reading. A child counter
+  /// must be destroyed before its parent, and its value is added to
+  /// the parent on destruction.
+  ///
+  /// \sa Counter
+  class ParallelCounter
+  {
+  public:
+
+    /// Shard of a \ref ParallelCounter used by a single thread.
+    class Shard
+    {
+      friend class ParallelCounter;
+      long long _count;
+      char _padding[64 - sizeof(long long)];
+    public:
+      Shard() : _count(0) {}
+      ///\e
+      Shard &operator++() { _count++; return *this;}
+      ///\e
+      long long operator++(int) { return _count++;}
+      ///\e
+      Shard &operator--() { _count--; return *this;}
+      ///\e
+      long long operator--(int) { return _count--;}
+      ///\e
+      Shard &operator+=(long long c) { _count+=c; return *this;}
+      ///\e
+      Shard &operator-=(long long c) { _count-=c; return *this;}
+      /// Returns the value of the shard.
+      long long value() const { return _count; }
+    };
+
+    /// SubCounter class
+
+    /// Subcounter class, see \ref Counter::SubCounter.
+    /// It adds its value to the parent counter on destruction.
+    typedef _SubCounter<ParallelCounter> SubCounter;
+
+    /// SubCounter class without printing report on destruction
+
+    /// Subcounter class without printing report on destruction,
+    /// see \ref Counter::NoSubCounter.
+    typedef _NoSubCounter<ParallelCounter> NoSubCounter;
+
+  private:
+
+    std::string _title;
+    std::ostream &_os;
+    ParallelCounter *_parent;
+    std::vector<Shard> _shards;
+    long long _base;
+    std::vector<ParallelCounter*> _children;
+    mutable bits::Lock _lock;
+
+    void attach() {
+      if (_parent) {
+        _shards.resize(_parent->_shards.size());
+        _parent->_lock.lock();
+        _parent->_children.push_back(this);
+        _parent->_lock.unlock();
+      }
+    }
+
+    static void writeString(std::ostream &os, const std::string &str,
+                            bool json) {
+      os << '"';
+      for (int i = 0; i < int(str.size()); ++i) {
+        char c = str[i];
+        if (c == '"') {
+          os << (json ? "\\\"" : "\"\"");
+        } else if (json && c == '\\') {
+          os << "\\\\";
+        } else if (json && static_cast<unsigned char>(c) < 0x20) {
+          const char *hex = "0123456789abcdef";
+          os << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+        } else {
+          os << c;
+        }
+      }
+      os << '"';
+    }
+
+    void writeJson(std::ostream &os, int indent) const {
+      std::string pad(indent, ' ');
+      os << pad << "{\"title\": ";
+      writeString(os, _title, true);
+      os << ", \"value\": " << value() << ", \"threads\": [";
+      for (int i = 0; i < int(_shards.size()); ++i) {
+        os << (i > 0 ? ", " : "") << _shards[i]._count;
+      }
+      os << "]";
+      _lock.lock();
+      if (!_children.empty()) {
+        os << ",\n" << pad << " \"children\": [\n";
+        for (int i = 0; i < int(_children.size()); ++i) {
+          if (i > 0) os << ",\n";
+          _children[i]->writeJson(os, indent + 2);
+        }
+        os << "]";
+      }
+      _lock.unlock();
+      os << "}";
+    }
+
+    void writeCsv(std::ostream &os, const std::string &path) const {
+      writeString(os, path + _title, false);
+      os << ',' << value() << '\n';
+      _lock.lock();
+      for (int i = 0; i < int(_children.size()); ++i) {
+        _children[i]->writeCsv(os, path + _title + '/');
+      }
+      _lock.unlock();
+    }
+
+    ParallelCounter(const ParallelCounter&);
+    void operator=(const ParallelCounter&);
+
+  public:
+
+    /// Constructor.
+    ParallelCounter()
+      : _title(), _os(std::cerr), _parent(0), _shards(1), _base(0) {}
+    /// Constructor.
+    ParallelCounter(std::string title,std::ostream &os=std::cerr)
+      : _title(title), _os(os), _parent(0), _shards(1), _base(0) {}
+    /// Constructor.
+    ParallelCounter(const char *title,std::ostream &os=std::cerr)
+      : _title(title), _os(os), _parent(0), _shards(1), _base(0) {}
+
+    /// Constructor of a child counter.
+
+    /// Constructor of a child counter. The number of the threads
+    /// is inherited from the parent counter.
+    ParallelCounter(ParallelCounter &parent,std::string title,
+                    std::ostream &os=std::cerr)
+      : _title(title), _os(os), _parent(&parent), _base(0) { attach(); }
+    /// Constructor of a child counter.
+
+    /// Constructor of a child counter. The number of the threads
+    /// is inherited from the parent counter.
+    ParallelCounter(ParallelCounter &parent,const char *title,
+                    std::ostream &os=std::cerr)
+      : _title(title), _os(os), _parent(&parent), _base(0) { attach(); }
+
+    /// Destructor.
+
+    /// Destructor. Prints the given title and the value of the counter,
+    /// and adds the value of a child counter to its parent.
+    ~ParallelCounter() {
+      long long count = value();
+      _os << _title << count << std::endl;
+      if (_parent) {
+        _parent->_lock.lock();
+        for (int i = 0; i < int(_parent->_children.size()); ++i) {
+          if (_parent->_children[i] == this) {
+            _parent->_children.erase(_parent->_children.begin() + i);
+            break;
+          }
+        }
+        _parent->_base += count;
+        _parent->_lock.unlock();
+      }
+    }
+
+    /// Sets the number of the threads.
+
+    /// This function sets the number of the threads, i.e. the number
+    /// of the shards. If it is less than 1, the number of processors
+    /// is used. The default value is 1.
+    /// The values of the shards are added to the counter.
+    /// \return <tt>(*this)</tt>
+    ParallelCounter &threadNum(int num) {
+      if (num < 1) num = bits::hardwareThreadNum();
+      _lock.lock();
+      for (int i = 0; i < int(_shards.size()); ++i) {
+        _base += _shards[i]._count;
+      }
+      _shards.assign(num, Shard());
+      _lock.unlock();
+      return *this;
+    }
+    /// Returns the number of the threads.
+    int threadNum() const { return _shards.size(); }
+
+    /// Returns the shard of the given thread.
+
+    /// Returns the shard of the given thread, which can be modified
+    /// without synchronization by that thread.
+    Shard &operator[](int thread) { return _shards[thread]; }
+    /// Returns the shard of the given thread.
+    const Shard &operator[](int thread) const { return _shards[thread]; }
+
+    ///\e
+    ParallelCounter &operator++() { return *this += 1; }
+    ///\e
+    long long operator++(int) {
+      _lock.lock(); long long c = _base++; _lock.unlock(); return c;
+    }
+    ///\e
+    ParallelCounter &operator--() { return *this -= 1; }
+    ///\e
+    long long operator--(int) {
+      _lock.lock(); long long c = _base--; _lock.unlock(); return c;
+    }
+    ///\e
+    ParallelCounter &operator+=(long long c) {
+      _lock.lock(); _base+=c; _lock.unlock(); return *this;
+    }
+    ///\e
+    ParallelCounter &operator-=(long long c) {
+      _lock.lock(); _base-=c; _lock.unlock(); return *this;
+    }
+
+    /// Resets the counter to the given value.
+
+    /// Resets the counter and all of its shards to the given value.
+    /// \note This function does not reset the child counters and the
+    /// \ref SubCounter "SubCounter"s.
+    void reset(long long c=0) {
+      _lock.lock();
+      _base = c;
+      for (int i = 0; i < int(_shards.size()); ++i) {
+        _shards[i]._count = 0;
+      }
+      _lock.unlock();
+    }
+
+    /// Returns the value of the counter.
+
+    /// Returns the value of the counter, i.e. the sum of its shards
+    /// and the values of its child counters.
+    long long value() const {
+      _lock.lock();
+      long long count = _base;
+      for (int i = 0; i < int(_shards.size()); ++i) {
+        count += _shards[i]._count;
+      }
+      for (int i = 0; i < int(_children.size()); ++i) {
+        count += _children[i]->value();
+      }
+      _lock.unlock();
+      return count;
+    }
+    /// Returns the value of the counter.
+    operator long long() const { return value(); }
+
+    /// Returns the title of the counter.
+    const std::string &title() const { return _title; }
+
+    /// Writes the counter hierarchy in JSON format.
+
+    /// Writes the counter and its child counters in JSON format.
+    /// Each counter is written as an object with the \c "title",
+    /// \c "value", \c "threads" (the values of the shards) and
+    /// \c "children" (if any) members.
+    void writeJson(std::ostream &os) const {
+      writeJson(os, 0);
+      os << std::endl;
+    }
+
+    /// Writes the counter hierarchy in CSV format.
+
+    /// Writes the counter and its child counters in CSV format.
+    /// Each line contains the path of a counter (the titles separated
+    /// by '/') and its value. The first line is a header.
+    void writeCsv(std::ostream &os) const {
+      os << "counter,value\n";
+      writeCsv(os, std::string());
+      os.flush();
+    }
+  };
+
   ///@}
 }
 
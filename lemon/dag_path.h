@@ -0,0 +1,670 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_DAG_PATH_H
+#define LEMON_DAG_PATH_H
+
+///\ingroup shortest_path
+///\file
+///\brief Shortest and longest paths in directed acyclic graphs.
+
+#include <vector>
+#include <lemon/list_graph.h>
+#include <lemon/bits/path_dump.h>
+#include <lemon/bits/parallel.h>
+#include <lemon/core.h>
+#include <lemon/error.h>
+#include <lemon/maps.h>
+#include <lemon/path.h>
+#include <lemon/connectivity.h>
+
+namespace lemon {
+
+  /// \brief Default operation traits for the DagPath algorithm class.
+  ///
+  /// This operation traits class defines all computational operations and
+  /// constants which are used in the DagPath algorithm. Using these
+  /// operations, the algorithm finds shortest paths (e.g. the earliest
+  /// arrival times in a timing graph).
+  template <typename V>
+  struct DagPathDefaultOperationTraits {
+    /// \e
+    typedef V Value;
+    /// \brief Gives back the zero value of the type.
+    static Value zero() {
+      return static_cast<Value>(0);
+    }
+    /// \brief Gives back the sum of the given two elements.
+    static Value plus(const Value& left, const Value& right) {
+      return left + right;
+    }
+    /// \brief Gives back true only if the first value is better
+    /// (i.e. less) than the second.
+    static bool less(const Value& left, const Value& right) {
+      return left < right;
+    }
+  };
+
+  /// \brief Operation traits for finding longest paths with the DagPath
+  /// algorithm class.
+  ///
+  /// This operation traits class can be used to find longest paths
+  /// (e.g. the latest arrival times in a timing graph) with the DagPath
+  /// algorithm. It differs from \ref DagPathDefaultOperationTraits only
+  /// in the comparison: a value is considered better if it is greater.
+  template <typename V>
+  struct DagPathLongestOperationTraits {
+    /// \e
+    typedef V Value;
+    /// \brief Gives back the zero value of the type.
+    static Value zero() {
+      return static_cast<Value>(0);
+    }
+    /// \brief Gives back the sum of the given two elements.
+    static Value plus(const Value& left, const Value& right) {
+      return left + right;
+    }
+    /// \brief Gives back true only if the first value is better
+    /// (i.e. greater) than the second.
+    static bool less(const Value& left, const Value& right) {
+      return right < left;
+    }
+  };
+
+  ///Default traits class of DagPath class.
+
+  ///Default traits class of DagPath class.
+  ///\tparam GR The type of the digraph.
+  ///\tparam LEN The type of the length map.
+  template<typename GR, typename LEN>
+  struct DagPathDefaultTraits
+  {
+    ///The type of the digraph the algorithm runs on.
+    typedef GR Digraph;
+
+    ///The type of the map that stores the arc lengths.
+
+    ///The type of the map that stores the arc lengths.
+    ///It must conform to the \ref concepts::ReadMap "ReadMap" concept.
+    typedef LEN LengthMap;
+    ///The type of the arc lengths.
+    typedef typename LEN::Value Value;
+
+    /// Operation traits for %DagPath algorithm.
+
+    /// This class defines the operations that are used in the algorithm.
+    /// \see DagPathDefaultOperationTraits, DagPathLongestOperationTraits
+    typedef DagPathDefaultOperationTraits<Value> OperationTraits;
+
+    ///\brief The type of the map that stores the predecessor
+    ///arcs of the paths.
+    ///
+    ///The type of the map that stores the predecessor
+    ///arcs of the paths.
+    ///It must conform to the \ref concepts::WriteMap "WriteMap" concept.
+    typedef typename Digraph::template NodeMap<typename Digraph::Arc> PredMap;
+    ///Instantiates a \c PredMap.
+
+    ///This function instantiates a \ref PredMap.
+    ///\param g is the digraph, to which we would like to define the
+    ///\ref PredMap.
+    static PredMap *createPredMap(const Digraph &g)
+    {
+      return new PredMap(g);
+    }
+
+    ///The type of the map that stores the distances of the nodes.
+
+    ///The type of the map that stores the distances of the nodes.
+    ///It must conform to the \ref concepts::ReadWriteMap "ReadWriteMap"
+    ///concept.
+    typedef typename Digraph::template NodeMap<typename LEN::Value> DistMap;
+    ///Instantiates a \c DistMap.
+
+    ///This function instantiates a \ref DistMap.
+    ///\param g is the digraph, to which we would like to define
+    ///the \ref DistMap.
+    static DistMap *createDistMap(const Digraph &g)
+    {
+      return new DistMap(g);
+    }
+  };
+
+  ///%DagPath algorithm class.
+
+  /// \ingroup shortest_path
+  ///This class computes shortest or longest paths from the given source
+  ///nodes in a directed acyclic graph (DAG) with arbitrary arc lengths.
+  ///
+  ///The nodes are processed in a topological order, and each node takes
+  ///the best of the distances of its predecessors plus the lengths of
+  ///the entering arcs, so the running time is linear in the size of the
+  ///digraph. The topological order is computed level by level by
+  ///the method of Kahn (see
+  ///\ref topologicalSort(const Digraph&, NodeMap&, int)), and the nodes
+  ///of a level are processed in parallel if the number of threads is set
+  ///with \ref threadNum(). The results do not depend on the number of
+  ///threads.
+  ///
+  ///By default, the algorithm finds shortest paths (e.g. the earliest
+  ///arrival times in a timing graph). Longest paths (e.g. the latest
+  ///arrival times) can be found by setting the
+  ///\ref DagPathLongestOperationTraits "longest path operation traits"
+  ///with the \ref SetOperationTraits named parameter.
+  ///\code
+  ///  DagPath<ListDigraph> earliest(g, delay);
+  ///  earliest.threadNum(4).run(s);
+  ///  DagPath<ListDigraph>::SetOperationTraits<
+  ///    DagPathLongestOperationTraits<int> >::Create latest(g, delay);
+  ///  latest.threadNum(4).run(s);
+  ///\endcode
+  ///
+  ///\tparam GR The type of the digraph the algorithm runs on.
+  ///The default type is \ref ListDigraph.
+  ///\tparam LEN A \ref concepts::ReadMap "readable" arc map that specifies
+  ///the lengths of the arcs.
+  ///It is read once for each arc (possibly by several threads
+  ///concurrently). The default map type is \ref
+  ///concepts::Digraph::ArcMap "GR::ArcMap<int>".
+  ///\tparam TR The traits class that defines various types used by the
+  ///algorithm. By default, it is \ref DagPathDefaultTraits
+  ///"DagPathDefaultTraits<GR, LEN>".
+  ///In most cases, this parameter should not be set directly,
+  ///consider to use the named template parameters instead.
+#ifdef DOXYGEN
+  template <typename GR, typename LEN, typename TR>
+#else
+  template <typename GR=ListDigraph,
+            typename LEN=typename GR::template ArcMap<int>,
+            typename TR=DagPathDefaultTraits<GR,LEN> >
+#endif
+  class DagPath {
+  public:
+
+    ///The type of the digraph the algorithm runs on.
+    typedef typename TR::Digraph Digraph;
+
+    ///The type of the arc lengths.
+    typedef typename TR::Value Value;
+    ///The type of the map that stores the arc lengths.
+    typedef typename TR::LengthMap LengthMap;
+    ///\brief The type of the map that stores the predecessor arcs of the
+    ///paths.
+    typedef typename TR::PredMap PredMap;
+    ///The type of the map that stores the distances of the nodes.
+    typedef typename TR::DistMap DistMap;
+    ///The type of the paths.
+    typedef PredMapPath<Digraph, PredMap> Path;
+    /// \brief The \ref lemon::DagPathDefaultOperationTraits
+    /// "operation traits class" of the algorithm.
+    typedef typename TR::OperationTraits OperationTraits;
+
+    ///The \ref lemon::DagPathDefaultTraits "traits class" of the algorithm.
+    typedef TR Traits;
+
+  private:
+
+    typedef typename Digraph::Node Node;
+    typedef typename Digraph::NodeIt NodeIt;
+    typedef typename Digraph::Arc Arc;
+    typedef typename Digraph::InArcIt InArcIt;
+
+    typedef _connectivity_bits::ParallelTopologicalSort<Digraph> Sort;
+
+    //Pointer to the underlying digraph.
+    const Digraph *G;
+    //Pointer to the length map.
+    const LengthMap *_length;
+    //Pointer to the map of predecessors arcs.
+    PredMap *_pred;
+    //Indicates if _pred is locally allocated (true) or not.
+    bool local_pred;
+    //Pointer to the map of distances.
+    DistMap *_dist;
+    //Indicates if _dist is locally allocated (true) or not.
+    bool local_dist;
+
+    //The number of threads.
+    int _thread_num;
+    //The topological order of the nodes (computed by init()).
+    Sort *_sort;
+    //Indicates if the digraph is DAG.
+    bool _dag;
+    //The state of the nodes (by their indices in the order).
+    std::vector<char> _state;
+
+    enum State { UNREACHED = 0, SOURCE = 1, REACHED = 2 };
+
+    //Creates the maps if necessary.
+    void create_maps()
+    {
+      if(!_pred) {
+        local_pred = true;
+        _pred = Traits::createPredMap(*G);
+      }
+      if(!_dist) {
+        local_dist = true;
+        _dist = Traits::createDistMap(*G);
+      }
+    }
+
+  public:
+
+    typedef DagPath Create;
+
+    ///\name Named Template Parameters
+
+    ///@{
+
+    template <class T>
+    struct SetPredMapTraits : public Traits {
+      typedef T PredMap;
+      static PredMap *createPredMap(const Digraph &)
+      {
+        LEMON_ASSERT(false, "PredMap is not initialized");
+        return 0; // ignore warnings
+      }
+    };
+    ///\brief \ref named-templ-param "Named parameter" for setting
+    ///\c PredMap type.
+    ///
+    ///\ref named-templ-param "Named parameter" for setting
+    ///\c PredMap type.
+    ///It must conform to the \ref concepts::WriteMap "WriteMap" concept.
+    template <class T>
+    struct SetPredMap
+      : public DagPath< Digraph, LengthMap, SetPredMapTraits<T> > {
+      typedef DagPath< Digraph, LengthMap, SetPredMapTraits<T> > Create;
+    };
+
+    template <class T>
+    struct SetDistMapTraits : public Traits {
+      typedef T DistMap;
+      static DistMap *createDistMap(const Digraph &)
+      {
+        LEMON_ASSERT(false, "DistMap is not initialized");
+        return 0; // ignore warnings
+      }
+    };
+    ///\brief \ref named-templ-param "Named parameter" for setting
+    ///\c DistMap type.
+    ///
+    ///\ref named-templ-param "Named parameter" for setting
+    ///\c DistMap type.
+    ///It must conform to the \ref concepts::ReadWriteMap "ReadWriteMap"
+    ///concept.
+    template <class T>
+    struct SetDistMap
+      : public DagPath< Digraph, LengthMap, SetDistMapTraits<T> > {
+      typedef DagPath< Digraph, LengthMap, SetDistMapTraits<T> > Create;
+    };
+
+    template <class T>
+    struct SetOperationTraitsTraits : public Traits {
+      typedef T OperationTraits;
+    };
+
+    /// \brief \ref named-templ-param "Named parameter" for setting
+    ///\c OperationTraits type
+    ///
+    ///\ref named-templ-param "Named parameter" for setting
+    ///\c OperationTraits type.
+    /// For more information, see \ref DagPathDefaultOperationTraits and
+    /// \ref DagPathLongestOperationTraits.
+    template <class T>
+    struct SetOperationTraits
+      : public DagPath<Digraph, LengthMap, SetOperationTraitsTraits<T> > {
+      typedef DagPath<Digraph, LengthMap, SetOperationTraitsTraits<T> >
+      Create;
+    };
+
+    ///@}
+
+  protected:
+
+    DagPath() {}
+
+  public:
+
+    ///Constructor.
+
+    ///Constructor.
+    ///\param g The digraph the algorithm runs on.
+    ///\param length The length map used by the algorithm.
+    DagPath(const Digraph& g, const LengthMap& length) :
+      G(&g), _length(&length),
+      _pred(NULL), local_pred(false),
+      _dist(NULL), local_dist(false),
+      _thread_num(1), _sort(NULL), _dag(true)
+    { }
+
+    ///Destructor.
+    ~DagPath()
+    {
+      if(local_pred) delete _pred;
+      if(local_dist) delete _dist;
+      delete _sort;
+    }
+
+    ///Sets the length map.
+
+    ///Sets the length map.
+    ///\return <tt> (*this) </tt>
+    DagPath &lengthMap(const LengthMap &m)
+    {
+      _length = &m;
+      return *this;
+    }
+
+    ///Sets the map that stores the predecessor arcs.
+
+    ///Sets the map that stores the predecessor arcs.
+    ///If you don't use this function before calling \ref run(Node) "run()"
+    ///or \ref init(), an instance will be allocated automatically.
+    ///The destructor deallocates this automatically allocated map,
+    ///of course.
+    ///\return <tt> (*this) </tt>
+    DagPath &predMap(PredMap &m)
+    {
+      if(local_pred) {
+        delete _pred;
+        local_pred=false;
+      }
+      _pred = &m;
+      return *this;
+    }
+
+    ///Sets the map that stores the distances of the nodes.
+
+    ///Sets the map that stores the distances of the nodes calculated by the
+    ///algorithm.
+    ///If you don't use this function before calling \ref run(Node) "run()"
+    ///or \ref init(), an instance will be allocated automatically.
+    ///The destructor deallocates this automatically allocated map,
+    ///of course.
+    ///\return <tt> (*this) </tt>
+    DagPath &distMap(DistMap &m)
+    {
+      if(local_dist) {
+        delete _dist;
+        local_dist=false;
+      }
+      _dist = &m;
+      return *this;
+    }
+
+    /// \brief Sets the number of threads.
+    ///
+    /// This function sets the number of threads used by the algorithm.
+    /// If it is less than one, the number of the hardware threads is
+    /// used. By default, the algorithm runs on a single thread.
+    ///
+    /// If several threads are used, the predecessor and distance maps
+    /// are written concurrently for different nodes (as in the case of
+    /// the default node maps), and the length map is read concurrently.
+    /// If LEMON is built without threading support, the computation is
+    /// performed on the calling thread.
+    /// \return <tt>(*this)</tt>
+    DagPath &threadNum(int num)
+    {
+      _thread_num = num < 1 ? bits::hardwareThreadNum() : num;
+      return *this;
+    }
+
+    /// \brief Returns the number of threads.
+    ///
+    /// Returns the number of threads used by the algorithm.
+    int threadNum() const
+    {
+      return _thread_num;
+    }
+
+  private:
+
+    // Computes the distance of a node from the distances of its
+    // predecessors. These are on lower levels, so they are final.
+    void processNode(int i)
+    {
+      Node v = _sort->nodes()[i];
+      bool found = _state[i] == SOURCE;
+      Value best = found ? (*_dist)[v] : OperationTraits::zero();
+      Arc pred = INVALID;
+      for (InArcIt a(*G, v); a != INVALID; ++a) {
+        Node u = G->source(a);
+        if (_state[_sort->index(u)] == UNREACHED) continue;
+        Value d = OperationTraits::plus((*_dist)[u], (*_length)[a]);
+        if (!found || OperationTraits::less(d, best)) {
+          found = true;
+          best = d;
+          pred = a;
+        }
+      }
+      if (pred != INVALID) {
+        _dist->set(v, best);
+        _pred->set(v, pred);
+        _state[i] = REACHED;
+      }
+    }
+
+    class Worker {
+    private:
+      DagPath &_alg;
+      int _offset;
+    public:
+      Worker(DagPath &alg, int offset) : _alg(alg), _offset(offset) {}
+      void operator()(int, int begin, int end) {
+        const std::vector<int>& order = _alg._sort->order();
+        for (int k = begin; k < end; ++k) {
+          _alg.processNode(order[_offset + k]);
+        }
+      }
+    };
+
+  public:
+
+    ///\name Execution Control
+    ///The simplest way to execute the %DagPath algorithm is to use
+    ///one of the member functions called \ref run(Node) "run()".\n
+    ///If you need better control on the execution, you have to call
+    ///\ref init() first, then you can add several source nodes with
+    ///\ref addSource(). Finally the actual path computation can be
+    ///performed with \ref start().
+
+    ///@{
+
+    ///\brief Initializes the internal data structures.
+    ///
+    ///Initializes the internal data structures and computes the
+    ///topological order of the nodes (using the given number of
+    ///threads). If the digraph is not DAG, the nodes of the directed
+    ///cycles and the nodes reachable from them are not processed
+    ///(see \ref dag()).
+    void init()
+    {
+      create_maps();
+      delete _sort;
+      _sort = new Sort(*G, _thread_num);
+      _dag = _sort->run();
+      _state.assign(_sort->nodes().size(), UNREACHED);
+      for ( NodeIt u(*G) ; u!=INVALID ; ++u ) {
+        _pred->set(u,INVALID);
+      }
+    }
+
+    ///Adds a new source node.
+
+    ///Adds a new source node.
+    ///The optional second parameter is the initial distance of the node.
+    ///If the node has already been added, its distance is replaced
+    ///only if \c dst is better.
+    ///A source node keeps its initial distance unless a better path
+    ///is found to it from another source.
+    void addSource(Node s,Value dst=OperationTraits::zero())
+    {
+      int i = _sort->index(s);
+      if (_state[i] == UNREACHED ||
+          OperationTraits::less(dst, (*_dist)[s])) {
+        _state[i] = SOURCE;
+        _dist->set(s, dst);
+      }
+    }
+
+    ///Executes the algorithm.
+
+    ///Executes the algorithm.
+    ///
+    ///This method runs the %DagPath algorithm from the source node(s)
+    ///in order to compute the shortest (or longest) path to each node.
+    ///The levels of the topological order are processed one after the
+    ///other, and the nodes of a level are processed in parallel.
+    ///
+    ///\pre init() must be called and at least one source node should be
+    ///added with addSource() before using this function.
+    void start()
+    {
+      for (int l = 0; l < _sort->levelNum(); ++l) {
+        int begin = _sort->levelStart(l);
+        Worker worker(*this, begin);
+        bits::parallelFor(_sort->levelStart(l + 1) - begin, _thread_num,
+                          worker, 256);
+      }
+    }
+
+    ///Runs the algorithm from the given source node.
+
+    ///This method runs the %DagPath algorithm from node \c s
+    ///in order to compute the shortest (or longest) path to each node.
+    ///
+    ///The algorithm computes
+    ///- the path tree,
+    ///- the distance of each node from the root.
+    ///
+    ///\note <tt>d.run(s)</tt> is just a shortcut of the following code.
+    ///\code
+    ///  d.init();
+    ///  d.addSource(s);
+    ///  d.start();
+    ///\endcode
+    void run(Node s) {
+      init();
+      addSource(s);
+      start();
+    }
+
+    ///@}
+
+    ///\name Query Functions
+    ///The results of the %DagPath algorithm can be obtained using these
+    ///functions.\n
+    ///Either \ref run(Node) "run()" or \ref init() should be called
+    ///before using them.
+
+    ///@{
+
+    ///Checks if the digraph is DAG.
+
+    ///Returns \c true if the digraph is DAG, i.e. all nodes are
+    ///processed by the algorithm.
+    ///
+    ///\pre Either \ref run(Node) "run()" or \ref init()
+    ///must be called before using this function.
+    bool dag() const { return _dag; }
+
+    ///The path to the given node.
+
+    ///Returns the shortest (or longest) path to the given node from the
+    ///root(s).
+    ///
+    ///\warning \c t should be reached from the root(s).
+    ///
+    ///\pre Either \ref run(Node) "run()" or \ref init()
+    ///must be called before using this function.
+    Path path(Node t) const { return Path(*G, *_pred, t); }
+
+    ///The distance of the given node from the root(s).
+
+    ///Returns the distance of the given node from the root(s).
+    ///
+    ///\warning If node \c v is not reached from the root(s), then
+    ///the return value of this function is undefined.
+    ///
+    ///\pre Either \ref run(Node) "run()" or \ref init()
+    ///must be called before using this function.
+    Value dist(Node v) const { return (*_dist)[v]; }
+
+    ///\brief Returns the 'previous arc' of the path tree for
+    ///the given node.
+    ///
+    ///This function returns the 'previous arc' of the path tree for
+    ///the node \c v, i.e. it returns the last arc of a shortest (or
+    ///longest) path from a root to \c v. It is \c INVALID if \c v
+    ///is not reached from the root(s) or if \c v is a root.
+    ///
+    ///\pre Either \ref run(Node) "run()" or \ref init()
+    ///must be called before using this function.
+    Arc predArc(Node v) const { return (*_pred)[v]; }
+
+    ///\brief Returns the 'previous node' of the path tree for
+    ///the given node.
+    ///
+    ///This function returns the 'previous node' of the path tree for
+    ///the node \c v, i.e. it returns the last but one node of a shortest
+    ///(or longest) path from a root to \c v. It is \c INVALID
+    ///if \c v is not reached from the root(s) or if \c v is a root.
+    ///
+    ///\pre Either \ref run(Node) "run()" or \ref init()
+    ///must be called before using this function.
+    Node predNode(Node v) const { return (*_pred)[v]==INVALID ? INVALID:
+                                  G->source((*_pred)[v]); }
+
+    ///\brief Returns a const reference to the node map that stores the
+    ///distances of the nodes.
+    ///
+    ///Returns a const reference to the node map that stores the distances
+    ///of the nodes calculated by the algorithm.
+    ///
+    ///\pre Either \ref run(Node) "run()" or \ref init()
+    ///must be called before using this function.
+    const DistMap &distMap() const { return *_dist;}
+
+    ///\brief Returns a const reference to the node map that stores the
+    ///predecessor arcs.
+    ///
+    ///Returns a const reference to the node map that stores the predecessor
+    ///arcs, which form the path tree (forest).
+    ///
+    ///\pre Either \ref run(Node) "run()" or \ref init()
+    ///must be called before using this function.
+    const PredMap &predMap() const { return *_pred;}
+
+    ///Checks if the given node is reached from the root(s).
+
+    ///Returns \c true if \c v is reached from the root(s).
+    ///
+    ///\pre Either \ref run(Node) "run()" or \ref init()
+    ///must be called before using this function.
+    bool reached(Node v) const {
+      return _state[_sort->index(v)] != UNREACHED;
+    }
+
+    ///@}
+  };
+
+} //END OF NAMESPACE LEMON
+
+#endif
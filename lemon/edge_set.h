@@ -293,6 +293,19 @@ namespace lemon {
       Parent::clear();
     }
 
+    void renumberNodes(const std::vector<Index>& ids) {
+      for (int i = 0; i < int(ListArcSetBase<GR>::arcs.size()); ++i) {
+        renumberNode(ids, ListArcSetBase<GR>::arcs[i].source);
+        renumberNode(ids, ListArcSetBase<GR>::arcs[i].target);
+      }
+    }
+
+    void renumberNode(const std::vector<Index>& ids, Node& node) {
+      if (node != INVALID) {
+        node = Parent::_graph->nodeFromId(ids[Parent::_graph->id(node)]);
+      }
+    }
+
     class NodesImpl : public NodesImplBase {
       typedef NodesImplBase Parent;
 
@@ -318,6 +331,10 @@ namespace lemon {
         _arcset.clearNodes();
         Parent::clear();
       }
+      virtual void renumber(const std::vector<Index>& ids) {
+        _arcset.renumberNodes(ids);
+        Parent::renumber(ids);
+      }
 
     private:
       ListArcSet& _arcset;
@@ -720,6 +737,18 @@ namespace lemon {
       Parent::clear();
     }
 
+    void renumberNodes(const std::vector<Index>& ids) {
+      for (int i = 0; i < int(ListEdgeSetBase<GR>::arcs.size()); ++i) {
+        renumberNode(ids, ListEdgeSetBase<GR>::arcs[i].target);
+      }
+    }
+
+    void renumberNode(const std::vector<Index>& ids, Node& node) {
+      if (node != INVALID) {
+        node = Parent::_graph->nodeFromId(ids[Parent::_graph->id(node)]);
+      }
+    }
+
     class NodesImpl : public NodesImplBase {
       typedef NodesImplBase Parent;
 
@@ -745,6 +774,10 @@ namespace lemon {
         _arcset.clearNodes();
         Parent::clear();
       }
+      virtual void renumber(const std::vector<Index>& ids) {
+        _arcset.renumberNodes(ids);
+        Parent::renumber(ids);
+      }
 
     private:
       ListEdgeSet& _arcset;
@@ -989,6 +1022,19 @@ namespace lemon {
       Parent::clear();
     }
 
+    void renumberNodes(const std::vector<Index>& ids) {
+      for (int i = 0; i < int(SmartArcSetBase<GR>::arcs.size()); ++i) {
+        renumberNode(ids, SmartArcSetBase<GR>::arcs[i].source);
+        renumberNode(ids, SmartArcSetBase<GR>::arcs[i].target);
+      }
+    }
+
+    void renumberNode(const std::vector<Index>& ids, Node& node) {
+      if (node != INVALID) {
+        node = Parent::_graph->nodeFromId(ids[Parent::_graph->id(node)]);
+      }
+    }
+
     class NodesImpl : public NodesImplBase {
       typedef NodesImplBase Parent;
 
@@ -1028,6 +1074,10 @@ namespace lemon {
         _arcset.clearNodes();
         Parent::clear();
       }
+      virtual void renumber(const std::vector<Index>& ids) {
+        _arcset.renumberNodes(ids);
+        Parent::renumber(ids);
+      }
 
     private:
       SmartArcSet& _arcset;
@@ -1340,6 +1390,18 @@ namespace lemon {
       Parent::clear();
     }
 
+    void renumberNodes(const std::vector<Index>& ids) {
+      for (int i = 0; i < int(SmartEdgeSetBase<GR>::arcs.size()); ++i) {
+        renumberNode(ids, SmartEdgeSetBase<GR>::arcs[i].target);
+      }
+    }
+
+    void renumberNode(const std::vector<Index>& ids, Node& node) {
+      if (node != INVALID) {
+        node = Parent::_graph->nodeFromId(ids[Parent::_graph->id(node)]);
+      }
+    }
+
     class NodesImpl : public NodesImplBase {
       typedef NodesImplBase Parent;
 
@@ -1379,6 +1441,10 @@ namespace lemon {
         _arcset.clearNodes();
         Parent::clear();
       }
+      virtual void renumber(const std::vector<Index>& ids) {
+        _arcset.renumberNodes(ids);
+        Parent::renumber(ids);
+      }
 
     private:
       SmartEdgeSet& _arcset;
@@ -30,6 +30,17 @@
 #include <lemon/path.h>
 #include <lemon/tolerance.h>
 #include <lemon/connectivity.h>
+#include <lemon/bits/parallel.h>
+
+// The thresholds of processing a large component in parallel. They can be
+// lowered by defining these macros before including this file (e.g. for
+// testing the parallel code on small graphs).
+#ifndef LEMON_MMC_PARALLEL_COMP_SIZE
+#define LEMON_MMC_PARALLEL_COMP_SIZE 4096
+#endif
+#ifndef LEMON_MMC_PARALLEL_GRAIN
+#define LEMON_MMC_PARALLEL_GRAIN 1024
+#endif
 
 namespace lemon {
 
@@ -104,6 +115,11 @@ namespace lemon {
   /// significantly faster for some problem instances, but slower for others.
   /// The algorithm runs in time O(nm) and uses space O(n<sup>2</sup>+m).
   ///
+  /// The algorithm can use several threads (see \ref threadNum()).
+  /// In this case, the small strongly connected components are
+  /// processed concurrently, while the rounds of the large components
+  /// are distributed among the threads.
+  ///
   /// \tparam GR The type of the digraph the algorithm runs on.
   /// \tparam CM The type of the cost map. The default
   /// map type is \ref concepts::Digraph::ArcMap "GR::ArcMap<int>".
@@ -180,23 +196,49 @@ namespace lemon {
     int _comp_num;
     typename Digraph::template NodeMap<int> _comp;
     std::vector<std::vector<Node> > _comp_nodes;
-    std::vector<Node>* _nodes;
     typename Digraph::template NodeMap<std::vector<Arc> > _out_arcs;
+    // The index of each node in the node list of its component
+    typename Digraph::template NodeMap<int> _index;
+
+    // Data of a found cycle
+    struct CycleData {
+      bool found;
+      LargeCost cost;
+      int size;
+      Node node;
+      int level;
+      CycleData() : found(false), cost(0), size(1), node(INVALID), level(0) {}
+    };
+
+    // Working data of a thread processing a component
+    struct ThreadData {
+      // The nodes of the current component
+      std::vector<Node>* nodes;
+      // The processed nodes in the last round
+      std::vector<Node> process;
+      // Data used for checking early termination (indexed by _index)
+      std::vector<std::pair<int, int> > level;
+      std::vector<LargeCost> pi;
+      // The minimum mean cycle of the current component
+      CycleData curr;
+    };
 
     // Data for the found cycles
-    bool _curr_found, _best_found;
-    LargeCost _curr_cost, _best_cost;
-    int _curr_size, _best_size;
-    Node _curr_node, _best_node;
-    int _curr_level, _best_level;
+    bool _best_found;
+    LargeCost _best_cost;
+    int _best_size;
+    Node _best_node;
+    int _best_level;
 
     Path *_cycle_path;
     bool _local_path;
 
     // Node map for storing path data
     PathDataNodeMap _data;
-    // The processed nodes in the last round
-    std::vector<Node> _process;
+
+    // Data for the parallel execution
+    int _thread_num;
+    std::vector<ThreadData> _thread_data;
 
     Tolerance _tolerance;
 
@@ -260,8 +302,8 @@ namespace lemon {
     HartmannOrlinMmc( const Digraph &digraph,
                       const CostMap &cost ) :
       _gr(digraph), _cost(cost), _comp(digraph), _out_arcs(digraph),
-      _best_found(false), _best_cost(0), _best_size(1),
-      _cycle_path(NULL), _local_path(false), _data(digraph),
+      _index(digraph), _best_found(false), _best_cost(0), _best_size(1),
+      _cycle_path(NULL), _local_path(false), _data(digraph), _thread_num(1),
       INF(std::numeric_limits<LargeCost>::has_infinity ?
           std::numeric_limits<LargeCost>::infinity() :
           std::numeric_limits<LargeCost>::max())
@@ -313,6 +355,32 @@ namespace lemon {
       return _tolerance;
     }
 
+    /// \brief Set the number of threads used by the algorithm.
+    ///
+    /// This function sets the number of threads used by the algorithm.
+    /// The default value is 1, i.e. the algorithm runs serially.
+    /// A value less than 1 means the number of available processors.
+    ///
+    /// If LEMON is built without threading support, this setting
+    /// has no effect.
+    ///
+    /// \note Using more threads, the found cycle may differ from the
+    /// one found by the serial algorithm if several cycles have the
+    /// minimum mean cost, but \ref cycleMean() is the same.
+    ///
+    /// \return <tt>(*this)</tt>
+    HartmannOrlinMmc& threadNum(int num) {
+      _thread_num = num < 1 ? bits::hardwareThreadNum() : num;
+      return *this;
+    }
+
+    /// \brief Return the number of threads used by the algorithm.
+    ///
+    /// This function returns the number of threads used by the algorithm.
+    int threadNum() const {
+      return _thread_num;
+    }
+
     /// \name Execution control
     /// The simplest way to execute the algorithm is to call the \ref run()
     /// function.\n
@@ -349,18 +417,37 @@ namespace lemon {
       findComponents();
 
       // Find the minimum cycle mean in the components
-      for (int comp = 0; comp < _comp_num; ++comp) {
-        if (!initComponent(comp)) continue;
-        processRounds();
-
-        // Update the best cycle (global minimum mean cycle)
-        if ( _curr_found && (!_best_found ||
-             _curr_cost * _best_size < _best_cost * _curr_size) ) {
-          _best_found = true;
-          _best_cost = _curr_cost;
-          _best_size = _curr_size;
-          _best_node = _curr_node;
-          _best_level = _curr_level;
+      if (_thread_num <= 1 || _comp_num <= 1) {
+        ThreadData &td = _thread_data[0];
+        for (int comp = 0; comp < _comp_num; ++comp) {
+          processComponent(comp, td, _thread_num > 1);
+
+          // Update the best cycle (global minimum mean cycle)
+          updateBestCycle(td.curr);
+        }
+      } else {
+        // Process the large components one after the other using
+        // parallel rounds, then the small components concurrently
+        std::vector<CycleData> cycles(_comp_num);
+        std::vector<int> small_comps;
+        int node_num = countNodes(_gr);
+        for (int comp = 0; comp < _comp_num; ++comp) {
+          int size = _comp_nodes[comp].size();
+          if (size >= PARALLEL_COMP_SIZE &&
+              size >= node_num / _thread_num) {
+            ThreadData &td = _thread_data[0];
+            processComponent(comp, td, true);
+            cycles[comp] = td.curr;
+          } else {
+            small_comps.push_back(comp);
+          }
+        }
+        ComponentWorker worker(*this, small_comps, cycles);
+        bits::parallelFor(small_comps.size(), _thread_num, worker, 1);
+
+        // Update the best cycle in the order of the components
+        for (int comp = 0; comp < _comp_num; ++comp) {
+          updateBestCycle(cycles[comp]);
         }
       }
       return _best_found;
@@ -458,12 +545,52 @@ namespace lemon {
 
   private:
 
+    // The minimum size of the components that are processed using
+    // parallel rounds
+    static const int PARALLEL_COMP_SIZE = LEMON_MMC_PARALLEL_COMP_SIZE;
+    // The minimum number of nodes processed by a thread in a round
+    static const int PARALLEL_GRAIN = LEMON_MMC_PARALLEL_GRAIN;
+
+    // Process a range of the small components on a thread
+    class ComponentWorker {
+    private:
+      HartmannOrlinMmc &_mmc;
+      const std::vector<int> &_comps;
+      std::vector<CycleData> &_cycles;
+    public:
+      ComponentWorker(HartmannOrlinMmc &mmc, const std::vector<int> &comps,
+                      std::vector<CycleData> &cycles)
+        : _mmc(mmc), _comps(comps), _cycles(cycles) {}
+      void operator()(int thread, int begin, int end) {
+        ThreadData &td = _mmc._thread_data[thread];
+        for (int i = begin; i < end; ++i) {
+          _mmc.processComponent(_comps[i], td, false);
+          _cycles[_comps[i]] = td.curr;
+        }
+      }
+    };
+
+    // Process a round for a range of nodes on a thread
+    class RoundWorker {
+    private:
+      HartmannOrlinMmc &_mmc;
+      const ThreadData &_td;
+      int _k;
+    public:
+      RoundWorker(HartmannOrlinMmc &mmc, const ThreadData &td, int k)
+        : _mmc(mmc), _td(td), _k(k) {}
+      void operator()(int, int begin, int end) {
+        _mmc.processRoundRange(_td, _k, begin, end);
+      }
+    };
+
     // Initialization
     void init() {
       if (!_cycle_path) {
         _local_path = true;
         _cycle_path = new Path;
       }
+      _thread_data.resize(_thread_num);
       _cycle_path->clear();
       _best_found = false;
       _best_cost = 0;
@@ -481,6 +608,7 @@ namespace lemon {
       if (_comp_num == 1) {
         _comp_nodes[0].clear();
         for (NodeIt n(_gr); n != INVALID; ++n) {
+          _index[n] = _comp_nodes[0].size();
           _comp_nodes[0].push_back(n);
           _out_arcs[n].clear();
           for (OutArcIt a(_gr, n); a != INVALID; ++a) {
@@ -492,6 +620,7 @@ namespace lemon {
           _comp_nodes[i].clear();
         for (NodeIt n(_gr); n != INVALID; ++n) {
           int k = _comp[n];
+          _index[n] = _comp_nodes[k].size();
           _comp_nodes[k].push_back(n);
           _out_arcs[n].clear();
           for (OutArcIt a(_gr, n); a != INVALID; ++a) {
@@ -501,15 +630,35 @@ namespace lemon {
       }
     }
 
+    // Update the best cycle (global minimum mean cycle)
+    void updateBestCycle(const CycleData &curr) {
+      if ( curr.found && (!_best_found ||
+           curr.cost * _best_size < _best_cost * curr.size) ) {
+        _best_found = true;
+        _best_cost = curr.cost;
+        _best_size = curr.size;
+        _best_node = curr.node;
+        _best_level = curr.level;
+      }
+    }
+
+    // Find the minimum mean cycle in the given component
+    void processComponent(int comp, ThreadData &td, bool parallel) {
+      td.curr = CycleData();
+      if (!initComponent(comp, td)) return;
+      processRounds(td, parallel);
+    }
+
     // Initialize path data for the current component
-    bool initComponent(int comp) {
-      _nodes = &(_comp_nodes[comp]);
-      int n = _nodes->size();
-      if (n < 1 || (n == 1 && _out_arcs[(*_nodes)[0]].size() == 0)) {
+    bool initComponent(int comp, ThreadData &td) {
+      td.nodes = &(_comp_nodes[comp]);
+      const std::vector<Node> &nodes = *td.nodes;
+      int n = nodes.size();
+      if (n < 1 || (n == 1 && _out_arcs[nodes[0]].size() == 0)) {
         return false;
       }
       for (int i = 0; i < n; ++i) {
-        _data[(*_nodes)[i]].resize(n + 1, PathData(INF));
+        _data[nodes[i]].resize(n + 1, PathData(INF));
       }
       return true;
     }
@@ -517,39 +666,46 @@ namespace lemon {
     // Process all rounds of computing path data for the current component.
     // _data[v][k] is the cost of a shortest directed walk from the root
     // node to node v containing exactly k arcs.
-    void processRounds() {
-      Node start = (*_nodes)[0];
+    void processRounds(ThreadData &td, bool parallel) {
+      Node start = (*td.nodes)[0];
       _data[start][0] = PathData(0);
-      _process.clear();
-      _process.push_back(start);
+      td.process.clear();
+      td.process.push_back(start);
 
-      int k, n = _nodes->size();
+      int k, n = td.nodes->size();
       int next_check = 4;
       bool terminate = false;
-      for (k = 1; k <= n && int(_process.size()) < n && !terminate; ++k) {
-        processNextBuildRound(k);
+      for (k = 1; k <= n && int(td.process.size()) < n && !terminate; ++k) {
+        processNextBuildRound(td, k);
         if (k == next_check || k == n) {
-          terminate = checkTermination(k);
+          terminate = checkTermination(td, k);
           next_check = next_check * 3 / 2;
         }
       }
+      parallel = parallel && _thread_num > 1;
       for ( ; k <= n && !terminate; ++k) {
-        processNextFullRound(k);
+        if (parallel) {
+          RoundWorker worker(*this, td, k);
+          bits::parallelFor(n, _thread_num, worker, PARALLEL_GRAIN);
+        } else {
+          processNextFullRound(td, k);
+        }
         if (k == next_check || k == n) {
-          terminate = checkTermination(k);
+          terminate = checkTermination(td, k);
           next_check = next_check * 3 / 2;
         }
       }
     }
 
-    // Process one round and rebuild _process
-    void processNextBuildRound(int k) {
+    // Process one round and rebuild td.process
+    void processNextBuildRound(ThreadData &td, int k) {
       std::vector<Node> next;
+      std::vector<Node> &process = td.process;
       Node u, v;
       Arc e;
       LargeCost d;
-      for (int i = 0; i < int(_process.size()); ++i) {
-        u = _process[i];
+      for (int i = 0; i < int(process.size()); ++i) {
+        u = process[i];
         for (int j = 0; j < int(_out_arcs[u].size()); ++j) {
           e = _out_arcs[u][j];
           v = _gr.target(e);
@@ -560,16 +716,17 @@ namespace lemon {
           }
         }
       }
-      _process.swap(next);
+      process.swap(next);
     }
 
-    // Process one round using _nodes instead of _process
-    void processNextFullRound(int k) {
+    // Process one round using td.nodes instead of td.process
+    void processNextFullRound(const ThreadData &td, int k) {
+      const std::vector<Node> &nodes = *td.nodes;
       Node u, v;
       Arc e;
       LargeCost d;
-      for (int i = 0; i < int(_nodes->size()); ++i) {
-        u = (*_nodes)[i];
+      for (int i = 0; i < int(nodes.size()); ++i) {
+        u = nodes[i];
         for (int j = 0; j < int(_out_arcs[u].size()); ++j) {
           e = _out_arcs[u][j];
           v = _gr.target(e);
@@ -581,35 +738,63 @@ namespace lemon {
       }
     }
 
+    // Process one round for the given range of td.nodes. In contrast
+    // to processNextFullRound(), the path data of every node in the range
+    // is computed from its incoming arcs, so the ranges can be processed
+    // concurrently.
+    void processRoundRange(const ThreadData &td, int k, int begin, int end) {
+      const std::vector<Node> &nodes = *td.nodes;
+      Node u, v;
+      LargeCost d;
+      for (int i = begin; i < end; ++i) {
+        v = nodes[i];
+        int c = _comp[v];
+        PathData &pd = _data[v][k];
+        for (InArcIt e(_gr, v); e != INVALID; ++e) {
+          u = _gr.source(e);
+          if (_comp[u] != c || _data[u][k-1].dist == INF) continue;
+          d = _data[u][k-1].dist + _cost[e];
+          if (_tolerance.less(d, pd.dist)) {
+            pd = PathData(d, e);
+          }
+        }
+      }
+    }
+
     // Check early termination
-    bool checkTermination(int k) {
+    bool checkTermination(ThreadData &td, int k) {
       typedef std::pair<int, int> Pair;
-      typename GR::template NodeMap<Pair> level(_gr, Pair(-1, 0));
-      typename GR::template NodeMap<LargeCost> pi(_gr);
-      int n = _nodes->size();
+      const std::vector<Node> &nodes = *td.nodes;
+      int n = nodes.size();
+      std::vector<Pair> &level = td.level;
+      std::vector<LargeCost> &pi = td.pi;
+      level.assign(n, Pair(-1, 0));
+      pi.resize(n);
+      CycleData &curr = td.curr;
       LargeCost cost;
       int size;
       Node u;
 
       // Search for cycles that are already found
-      _curr_found = false;
+      curr.found = false;
       for (int i = 0; i < n; ++i) {
-        u = (*_nodes)[i];
+        u = nodes[i];
         if (_data[u][k].dist == INF) continue;
         for (int j = k; j >= 0; --j) {
-          if (level[u].first == i && level[u].second > 0) {
+          Pair &lu = level[_index[u]];
+          if (lu.first == i && lu.second > 0) {
             // A cycle is found
-            cost = _data[u][level[u].second].dist - _data[u][j].dist;
-            size = level[u].second - j;
-            if (!_curr_found || cost * _curr_size < _curr_cost * size) {
-              _curr_cost = cost;
-              _curr_size = size;
-              _curr_node = u;
-              _curr_level = level[u].second;
-              _curr_found = true;
+            cost = _data[u][lu.second].dist - _data[u][j].dist;
+            size = lu.second - j;
+            if (!curr.found || cost * curr.size < curr.cost * size) {
+              curr.cost = cost;
+              curr.size = size;
+              curr.node = u;
+              curr.level = lu.second;
+              curr.found = true;
             }
           }
-          level[u] = Pair(i, j);
+          lu = Pair(i, j);
           if (j != 0) {
             u = _gr.source(_data[u][j].pred);
           }
@@ -618,29 +803,31 @@ namespace lemon {
 
       // If at least one cycle is found, check the optimality condition
       LargeCost d;
-      if (_curr_found && k < n) {
+      if (curr.found && k < n) {
         // Find node potentials
         for (int i = 0; i < n; ++i) {
-          u = (*_nodes)[i];
-          pi[u] = INF;
+          u = nodes[i];
+          pi[i] = INF;
           for (int j = 0; j <= k; ++j) {
             if (_data[u][j].dist < INF) {
-              d = _data[u][j].dist * _curr_size - j * _curr_cost;
-              if (_tolerance.less(d, pi[u])) pi[u] = d;
+              d = _data[u][j].dist * curr.size - j * curr.cost;
+              if (_tolerance.less(d, pi[i])) pi[i] = d;
             }
           }
         }
 
-        // Check the optimality condition for all arcs
-        bool done = true;
-        for (ArcIt a(_gr); a != INVALID; ++a) {
-          if (_tolerance.less(_cost[a] * _curr_size - _curr_cost,
-                              pi[_gr.target(a)] - pi[_gr.source(a)]) ) {
-            done = false;
-            break;
+        // Check the optimality condition for the arcs of the component
+        for (int i = 0; i < n; ++i) {
+          u = nodes[i];
+          for (int j = 0; j < int(_out_arcs[u].size()); ++j) {
+            Arc a = _out_arcs[u][j];
+            if (_tolerance.less(_cost[a] * curr.size - curr.cost,
+                                pi[_index[_gr.target(a)]] - pi[i]) ) {
+              return false;
+            }
           }
         }
-        return done;
+        return true;
       }
       return (k == n);
     }
@@ -30,6 +30,17 @@
 #include <lemon/path.h>
 #include <lemon/tolerance.h>
 #include <lemon/connectivity.h>
+#include <lemon/bits/parallel.h>
+
+// The thresholds of processing a large component in parallel. They can be
+// lowered by defining these macros before including this file (e.g. for
+// testing the parallel code on small graphs).
+#ifndef LEMON_MMC_PARALLEL_COMP_SIZE
+#define LEMON_MMC_PARALLEL_COMP_SIZE 4096
+#endif
+#ifndef LEMON_MMC_PARALLEL_GRAIN
+#define LEMON_MMC_PARALLEL_GRAIN 1024
+#endif
 
 namespace lemon {
 
@@ -103,6 +114,11 @@ namespace lemon {
   /// minimum mean cycle problem, though the best known theoretical
   /// bound on its running time is exponential.
   ///
+  /// The algorithm can use several threads (see \ref threadNum()).
+  /// In this case, the small strongly connected components are
+  /// processed concurrently, while the policy improvement steps of
+  /// the large components are distributed among the threads.
+  ///
   /// \tparam GR The type of the digraph the algorithm runs on.
   /// \tparam CM The type of the cost map. The default
   /// map type is \ref concepts::Digraph::ArcMap "GR::ArcMap<int>".
@@ -175,18 +191,38 @@ namespace lemon {
     // The cost of the arcs
     const CostMap &_cost;
 
+    // Data of a found cycle
+    struct CycleData {
+      bool found;
+      LargeCost cost;
+      int size;
+      Node node;
+      CycleData() : found(false), cost(0), size(1), node(INVALID) {}
+    };
+
+    // Working data of a thread processing a component
+    struct ThreadData {
+      // The nodes of the current component
+      std::vector<Node>* nodes;
+      // Queue used for BFS search
+      std::vector<Node> queue;
+      // The current policy cycle
+      CycleData curr;
+    };
+
     // Data for the found cycles
-    bool _curr_found, _best_found;
-    LargeCost _curr_cost, _best_cost;
-    int _curr_size, _best_size;
-    Node _curr_node, _best_node;
+    bool _best_found;
+    LargeCost _best_cost;
+    int _best_size;
+    Node _best_node;
 
     Path *_cycle_path;
     bool _local_path;
 
     // Internal data used by the algorithm
+    // (_reached is not a bool map, since it is written concurrently)
     typename Digraph::template NodeMap<Arc> _policy;
-    typename Digraph::template NodeMap<bool> _reached;
+    typename Digraph::template NodeMap<char> _reached;
     typename Digraph::template NodeMap<int> _level;
     typename Digraph::template NodeMap<LargeCost> _dist;
 
@@ -194,12 +230,13 @@ namespace lemon {
     int _comp_num;
     typename Digraph::template NodeMap<int> _comp;
     std::vector<std::vector<Node> > _comp_nodes;
-    std::vector<Node>* _nodes;
     typename Digraph::template NodeMap<std::vector<Arc> > _in_arcs;
 
-    // Queue used for BFS search
-    std::vector<Node> _queue;
-    int _qfront, _qback;
+    // Data for the parallel execution
+    int _thread_num;
+    std::vector<ThreadData> _thread_data;
+    volatile int _iter_count;
+    int _iter_limit;
 
     Tolerance _tolerance;
 
@@ -265,7 +302,7 @@ namespace lemon {
       _gr(digraph), _cost(cost), _best_found(false),
       _best_cost(0), _best_size(1), _cycle_path(NULL), _local_path(false),
       _policy(digraph), _reached(digraph), _level(digraph), _dist(digraph),
-      _comp(digraph), _in_arcs(digraph),
+      _comp(digraph), _in_arcs(digraph), _thread_num(1),
       INF(std::numeric_limits<LargeCost>::has_infinity ?
           std::numeric_limits<LargeCost>::infinity() :
           std::numeric_limits<LargeCost>::max())
@@ -317,6 +354,32 @@ namespace lemon {
       return _tolerance;
     }
 
+    /// \brief Set the number of threads used by the algorithm.
+    ///
+    /// This function sets the number of threads used by the algorithm.
+    /// The default value is 1, i.e. the algorithm runs serially.
+    /// A value less than 1 means the number of available processors.
+    ///
+    /// If LEMON is built without threading support, this setting
+    /// has no effect.
+    ///
+    /// \note Using more threads, the found cycle may differ from the
+    /// one found by the serial algorithm if several cycles have the
+    /// minimum mean cost, but \ref cycleMean() is the same.
+    ///
+    /// \return <tt>(*this)</tt>
+    HowardMmc& threadNum(int num) {
+      _thread_num = num < 1 ? bits::hardwareThreadNum() : num;
+      return *this;
+    }
+
+    /// \brief Return the number of threads used by the algorithm.
+    ///
+    /// This function returns the number of threads used by the algorithm.
+    int threadNum() const {
+      return _thread_num;
+    }
+
     /// \name Execution control
     /// The simplest way to execute the algorithm is to call the \ref run()
     /// function.\n
@@ -368,30 +431,49 @@ namespace lemon {
       findComponents();
 
       // Find the minimum cycle mean in the components
-      int iter_count = 0;
+      _iter_count = 0;
+      _iter_limit = limit;
       bool iter_limit_reached = false;
-      for (int comp = 0; comp < _comp_num; ++comp) {
-        // Find the minimum mean cycle in the current component
-        if (!buildPolicyGraph(comp)) continue;
-        while (true) {
-          if (++iter_count > limit) {
-            iter_limit_reached = true;
-            break;
+      if (_thread_num <= 1 || _comp_num <= 1) {
+        ThreadData &td = _thread_data[0];
+        for (int comp = 0; comp < _comp_num; ++comp) {
+          // Find the minimum mean cycle in the current component
+          iter_limit_reached =
+            !processComponent(comp, td, _thread_num > 1);
+
+          // Update the best cycle (global minimum mean cycle)
+          updateBestCycle(td.curr);
+
+          if (iter_limit_reached) break;
+        }
+      } else {
+        // Process the large components one after the other using
+        // parallel policy improvement, then the small components
+        // concurrently
+        std::vector<CycleData> cycles(_comp_num);
+        std::vector<int> small_comps;
+        int node_num = countNodes(_gr);
+        for (int comp = 0; comp < _comp_num && !iter_limit_reached; ++comp) {
+          int size = _comp_nodes[comp].size();
+          if (size >= PARALLEL_COMP_SIZE &&
+              size >= node_num / _thread_num) {
+            ThreadData &td = _thread_data[0];
+            iter_limit_reached = !processComponent(comp, td, true);
+            cycles[comp] = td.curr;
+          } else {
+            small_comps.push_back(comp);
           }
-          findPolicyCycle();
-          if (!computeNodeDistances()) break;
         }
-
-        // Update the best cycle (global minimum mean cycle)
-        if ( _curr_found && (!_best_found ||
-             _curr_cost * _best_size < _best_cost * _curr_size) ) {
-          _best_found = true;
-          _best_cost = _curr_cost;
-          _best_size = _curr_size;
-          _best_node = _curr_node;
+        if (!iter_limit_reached) {
+          ComponentWorker worker(*this, small_comps, cycles);
+          bits::parallelFor(small_comps.size(), _thread_num, worker, 1);
+          iter_limit_reached = _iter_count > _iter_limit;
         }
 
-        if (iter_limit_reached) break;
+        // Update the best cycle in the order of the components
+        for (int comp = 0; comp < _comp_num; ++comp) {
+          updateBestCycle(cycles[comp]);
+        }
       }
 
       if (iter_limit_reached) {
@@ -479,13 +561,59 @@ namespace lemon {
 
   private:
 
+    // The minimum size of the components that are processed using
+    // parallel policy improvement
+    static const int PARALLEL_COMP_SIZE = LEMON_MMC_PARALLEL_COMP_SIZE;
+    // The minimum number of nodes processed by a thread in a round
+    static const int PARALLEL_GRAIN = LEMON_MMC_PARALLEL_GRAIN;
+
+    // Process a range of the small components on a thread
+    class ComponentWorker {
+    private:
+      HowardMmc &_mmc;
+      const std::vector<int> &_comps;
+      std::vector<CycleData> &_cycles;
+    public:
+      ComponentWorker(HowardMmc &mmc, const std::vector<int> &comps,
+                      std::vector<CycleData> &cycles)
+        : _mmc(mmc), _comps(comps), _cycles(cycles) {}
+      void operator()(int thread, int begin, int end) {
+        ThreadData &td = _mmc._thread_data[thread];
+        for (int i = begin; i < end; ++i) {
+          _mmc.processComponent(_comps[i], td, false);
+          _cycles[_comps[i]] = td.curr;
+        }
+      }
+    };
+
+    // Improve the policy of a range of nodes on a thread
+    class ImproveWorker {
+    private:
+      HowardMmc &_mmc;
+      const ThreadData &_td;
+      std::vector<char> _improved;
+    public:
+      ImproveWorker(HowardMmc &mmc, const ThreadData &td)
+        : _mmc(mmc), _td(td), _improved(mmc._thread_num, false) {}
+      void operator()(int thread, int begin, int end) {
+        if (_mmc.improvePolicy(_td, begin, end)) _improved[thread] = true;
+      }
+      bool improved() const {
+        for (int i = 0; i < int(_improved.size()); ++i) {
+          if (_improved[i]) return true;
+        }
+        return false;
+      }
+    };
+
     // Initialize
     void init() {
       if (!_cycle_path) {
         _local_path = true;
         _cycle_path = new Path;
       }
-      _queue.resize(countNodes(_gr));
+      _thread_data.resize(_thread_num);
+      _thread_data[0].queue.resize(countNodes(_gr));
       _best_found = false;
       _best_cost = 0;
       _best_size = 1;
@@ -520,21 +648,51 @@ namespace lemon {
       }
     }
 
+    // Update the best cycle (global minimum mean cycle)
+    void updateBestCycle(const CycleData &curr) {
+      if ( curr.found && (!_best_found ||
+           curr.cost * _best_size < _best_cost * curr.size) ) {
+        _best_found = true;
+        _best_cost = curr.cost;
+        _best_size = curr.size;
+        _best_node = curr.node;
+      }
+    }
+
+    // Find the minimum mean cycle in the given component
+    // (return false if the iteration limit is reached)
+    bool processComponent(int comp, ThreadData &td, bool parallel) {
+      td.curr = CycleData();
+      if (!buildPolicyGraph(comp, td)) return true;
+      if (int(td.queue.size()) < int(td.nodes->size())) {
+        td.queue.resize(td.nodes->size());
+      }
+      while (true) {
+        if (bits::atomicFetchAdd(_iter_count, 1) >= _iter_limit) {
+          return false;
+        }
+        findPolicyCycle(td);
+        if (!computeNodeDistances(td, parallel)) break;
+      }
+      return true;
+    }
+
     // Build the policy graph in the given strongly connected component
     // (the out-degree of every node is 1)
-    bool buildPolicyGraph(int comp) {
-      _nodes = &(_comp_nodes[comp]);
-      if (_nodes->size() < 1 ||
-          (_nodes->size() == 1 && _in_arcs[(*_nodes)[0]].size() == 0)) {
+    bool buildPolicyGraph(int comp, ThreadData &td) {
+      td.nodes = &(_comp_nodes[comp]);
+      const std::vector<Node> &nodes = *td.nodes;
+      if (nodes.size() < 1 ||
+          (nodes.size() == 1 && _in_arcs[nodes[0]].size() == 0)) {
         return false;
       }
-      for (int i = 0; i < int(_nodes->size()); ++i) {
-        _dist[(*_nodes)[i]] = INF;
+      for (int i = 0; i < int(nodes.size()); ++i) {
+        _dist[nodes[i]] = INF;
       }
       Node u, v;
       Arc e;
-      for (int i = 0; i < int(_nodes->size()); ++i) {
-        v = (*_nodes)[i];
+      for (int i = 0; i < int(nodes.size()); ++i) {
+        v = nodes[i];
         for (int j = 0; j < int(_in_arcs[v].size()); ++j) {
           e = _in_arcs[v][j];
           u = _gr.source(e);
@@ -548,16 +706,18 @@ namespace lemon {
     }
 
     // Find the minimum mean cycle in the policy graph
-    void findPolicyCycle() {
-      for (int i = 0; i < int(_nodes->size()); ++i) {
-        _level[(*_nodes)[i]] = -1;
+    void findPolicyCycle(ThreadData &td) {
+      const std::vector<Node> &nodes = *td.nodes;
+      CycleData &curr = td.curr;
+      for (int i = 0; i < int(nodes.size()); ++i) {
+        _level[nodes[i]] = -1;
       }
       LargeCost ccost;
       int csize;
       Node u, v;
-      _curr_found = false;
-      for (int i = 0; i < int(_nodes->size()); ++i) {
-        u = (*_nodes)[i];
+      curr.found = false;
+      for (int i = 0; i < int(nodes.size()); ++i) {
+        u = nodes[i];
         if (_level[u] >= 0) continue;
         for (; _level[u] < 0; u = _gr.target(_policy[u])) {
           _level[u] = i;
@@ -570,68 +730,78 @@ namespace lemon {
             ccost += _cost[_policy[v]];
             ++csize;
           }
-          if ( !_curr_found ||
-               (ccost * _curr_size < _curr_cost * csize) ) {
-            _curr_found = true;
-            _curr_cost = ccost;
-            _curr_size = csize;
-            _curr_node = u;
+          if ( !curr.found ||
+               (ccost * curr.size < curr.cost * csize) ) {
+            curr.found = true;
+            curr.cost = ccost;
+            curr.size = csize;
+            curr.node = u;
           }
         }
       }
     }
 
     // Contract the policy graph and compute node distances
-    bool computeNodeDistances() {
+    bool computeNodeDistances(ThreadData &td, bool parallel) {
+      const std::vector<Node> &nodes = *td.nodes;
+      std::vector<Node> &queue = td.queue;
+      const LargeCost curr_cost = td.curr.cost;
+      const int curr_size = td.curr.size;
+
       // Find the component of the main cycle and compute node distances
       // using reverse BFS
-      for (int i = 0; i < int(_nodes->size()); ++i) {
-        _reached[(*_nodes)[i]] = false;
+      for (int i = 0; i < int(nodes.size()); ++i) {
+        _reached[nodes[i]] = false;
       }
-      _qfront = _qback = 0;
-      _queue[0] = _curr_node;
-      _reached[_curr_node] = true;
-      _dist[_curr_node] = 0;
+      int qfront = 0, qback = 0;
+      queue[0] = td.curr.node;
+      _reached[td.curr.node] = true;
+      _dist[td.curr.node] = 0;
       Node u, v;
       Arc e;
-      while (_qfront <= _qback) {
-        v = _queue[_qfront++];
+      while (qfront <= qback) {
+        v = queue[qfront++];
         for (int j = 0; j < int(_in_arcs[v].size()); ++j) {
           e = _in_arcs[v][j];
           u = _gr.source(e);
           if (_policy[u] == e && !_reached[u]) {
             _reached[u] = true;
-            _dist[u] = _dist[v] + _cost[e] * _curr_size - _curr_cost;
-            _queue[++_qback] = u;
+            _dist[u] = _dist[v] + _cost[e] * curr_size - curr_cost;
+            queue[++qback] = u;
           }
         }
       }
 
       // Connect all other nodes to this component and compute node
       // distances using reverse BFS
-      _qfront = 0;
-      while (_qback < int(_nodes->size())-1) {
-        v = _queue[_qfront++];
+      qfront = 0;
+      while (qback < int(nodes.size())-1) {
+        v = queue[qfront++];
         for (int j = 0; j < int(_in_arcs[v].size()); ++j) {
           e = _in_arcs[v][j];
           u = _gr.source(e);
           if (!_reached[u]) {
             _reached[u] = true;
             _policy[u] = e;
-            _dist[u] = _dist[v] + _cost[e] * _curr_size - _curr_cost;
-            _queue[++_qback] = u;
+            _dist[u] = _dist[v] + _cost[e] * curr_size - curr_cost;
+            queue[++qback] = u;
           }
         }
       }
 
       // Improve node distances
+      if (parallel && _thread_num > 1) {
+        ImproveWorker worker(*this, td);
+        bits::parallelFor(nodes.size(), _thread_num, worker, PARALLEL_GRAIN);
+        return worker.improved();
+      }
       bool improved = false;
-      for (int i = 0; i < int(_nodes->size()); ++i) {
-        v = (*_nodes)[i];
+      for (int i = 0; i < int(nodes.size()); ++i) {
+        v = nodes[i];
         for (int j = 0; j < int(_in_arcs[v].size()); ++j) {
           e = _in_arcs[v][j];
           u = _gr.source(e);
-          LargeCost delta = _dist[v] + _cost[e] * _curr_size - _curr_cost;
+          LargeCost delta = _dist[v] + _cost[e] * curr_size - curr_cost;
           if (_tolerance.less(delta, _dist[u])) {
             _dist[u] = delta;
             _policy[u] = e;
@@ -642,6 +812,34 @@ namespace lemon {
       return improved;
     }
 
+    // Improve the policy of the given range of nodes of the current
+    // component. Every node chooses its best outgoing arc with respect
+    // to the node distances of the previous step, so only the policy
+    // of the nodes in the range is modified (the node distances are
+    // recomputed in the next step).
+    bool improvePolicy(const ThreadData &td, int begin, int end) {
+      const std::vector<Node> &nodes = *td.nodes;
+      const LargeCost curr_cost = td.curr.cost;
+      const int curr_size = td.curr.size;
+      bool improved = false;
+      for (int i = begin; i < end; ++i) {
+        Node u = nodes[i];
+        int k = _comp[u];
+        LargeCost best = _dist[u];
+        for (OutArcIt e(_gr, u); e != INVALID; ++e) {
+          Node v = _gr.target(e);
+          if (_comp[v] != k) continue;
+          LargeCost delta = _dist[v] + _cost[e] * curr_size - curr_cost;
+          if (_tolerance.less(delta, best)) {
+            best = delta;
+            _policy[u] = e;
+            improved = true;
+          }
+        }
+      }
+      return improved;
+    }
+
   }; //class HowardMmc
 
   ///@}
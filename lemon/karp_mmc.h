@@ -30,6 +30,17 @@
 #include <lemon/path.h>
 #include <lemon/tolerance.h>
 #include <lemon/connectivity.h>
+#include <lemon/bits/parallel.h>
+
+// The thresholds of processing a large component in parallel. They can be
+// lowered by defining these macros before including this file (e.g. for
+// testing the parallel code on small graphs).
+#ifndef LEMON_MMC_PARALLEL_COMP_SIZE
+#define LEMON_MMC_PARALLEL_COMP_SIZE 4096
+#endif
+#ifndef LEMON_MMC_PARALLEL_GRAIN
+#define LEMON_MMC_PARALLEL_GRAIN 1024
+#endif
 
 namespace lemon {
 
@@ -101,6 +112,11 @@ namespace lemon {
   /// \cite karp78characterization, \cite dasdan98minmeancycle.
   /// It runs in time O(nm) and uses space O(n<sup>2</sup>+m).
   ///
+  /// The algorithm can use several threads (see \ref threadNum()).
+  /// In this case, the small strongly connected components are
+  /// processed concurrently, while the rounds of the large components
+  /// are distributed among the threads.
+  ///
   /// \tparam GR The type of the digraph the algorithm runs on.
   /// \tparam CM The type of the cost map. The default
   /// map type is \ref concepts::Digraph::ArcMap "GR::ArcMap<int>".
@@ -174,7 +190,6 @@ namespace lemon {
     int _comp_num;
     typename Digraph::template NodeMap<int> _comp;
     std::vector<std::vector<Node> > _comp_nodes;
-    std::vector<Node>* _nodes;
     typename Digraph::template NodeMap<std::vector<Arc> > _out_arcs;
 
     // Data for the found cycle
@@ -187,8 +202,28 @@ namespace lemon {
 
     // Node map for storing path data
     PathDataNodeMap _data;
-    // The processed nodes in the last round
-    std::vector<Node> _process;
+
+    // Data of the minimum mean cycle of a component
+    struct CycleData {
+      LargeCost cost;
+      int size;
+      Node node;
+      CycleData() : cost(0), size(1), node(INVALID) {}
+    };
+
+    // Working data of a thread processing a component
+    struct ThreadData {
+      // The nodes of the current component
+      std::vector<Node>* nodes;
+      // The processed nodes in the last round
+      std::vector<Node> process;
+      // The minimum mean cycle of the current component
+      CycleData curr;
+    };
+
+    // Data for the parallel execution
+    int _thread_num;
+    std::vector<ThreadData> _thread_data;
 
     Tolerance _tolerance;
 
@@ -253,7 +288,7 @@ namespace lemon {
              const CostMap &cost ) :
       _gr(digraph), _cost(cost), _comp(digraph), _out_arcs(digraph),
       _cycle_cost(0), _cycle_size(1), _cycle_node(INVALID),
-      _cycle_path(NULL), _local_path(false), _data(digraph),
+      _cycle_path(NULL), _local_path(false), _data(digraph), _thread_num(1),
       INF(std::numeric_limits<LargeCost>::has_infinity ?
           std::numeric_limits<LargeCost>::infinity() :
           std::numeric_limits<LargeCost>::max())
@@ -305,6 +340,32 @@ namespace lemon {
       return _tolerance;
     }
 
+    /// \brief Set the number of threads used by the algorithm.
+    ///
+    /// This function sets the number of threads used by the algorithm.
+    /// The default value is 1, i.e. the algorithm runs serially.
+    /// A value less than 1 means the number of available processors.
+    ///
+    /// If LEMON is built without threading support, this setting
+    /// has no effect.
+    ///
+    /// \note Using more threads, the found cycle may differ from the
+    /// one found by the serial algorithm if several cycles have the
+    /// minimum mean cost, but \ref cycleMean() is the same.
+    ///
+    /// \return <tt>(*this)</tt>
+    KarpMmc& threadNum(int num) {
+      _thread_num = num < 1 ? bits::hardwareThreadNum() : num;
+      return *this;
+    }
+
+    /// \brief Return the number of threads used by the algorithm.
+    ///
+    /// This function returns the number of threads used by the algorithm.
+    int threadNum() const {
+      return _thread_num;
+    }
+
     /// \name Execution control
     /// The simplest way to execute the algorithm is to call the \ref run()
     /// function.\n
@@ -341,10 +402,36 @@ namespace lemon {
       findComponents();
 
       // Find the minimum cycle mean in the components
-      for (int comp = 0; comp < _comp_num; ++comp) {
-        if (!initComponent(comp)) continue;
-        processRounds();
-        updateMinMean();
+      if (_thread_num <= 1 || _comp_num <= 1) {
+        ThreadData &td = _thread_data[0];
+        for (int comp = 0; comp < _comp_num; ++comp) {
+          processComponent(comp, td, _thread_num > 1);
+          updateMinMean(td.curr);
+        }
+      } else {
+        // Process the large components one after the other using
+        // parallel rounds, then the small components concurrently
+        std::vector<CycleData> cycles(_comp_num);
+        std::vector<int> small_comps;
+        int node_num = countNodes(_gr);
+        for (int comp = 0; comp < _comp_num; ++comp) {
+          int size = _comp_nodes[comp].size();
+          if (size >= PARALLEL_COMP_SIZE &&
+              size >= node_num / _thread_num) {
+            ThreadData &td = _thread_data[0];
+            processComponent(comp, td, true);
+            cycles[comp] = td.curr;
+          } else {
+            small_comps.push_back(comp);
+          }
+        }
+        ComponentWorker worker(*this, small_comps, cycles);
+        bits::parallelFor(small_comps.size(), _thread_num, worker, 1);
+
+        // Update the minimum cycle mean in the order of the components
+        for (int comp = 0; comp < _comp_num; ++comp) {
+          updateMinMean(cycles[comp]);
+        }
       }
       return (_cycle_node != INVALID);
     }
@@ -441,12 +528,52 @@ namespace lemon {
 
   private:
 
+    // The minimum size of the components that are processed using
+    // parallel rounds
+    static const int PARALLEL_COMP_SIZE = LEMON_MMC_PARALLEL_COMP_SIZE;
+    // The minimum number of nodes processed by a thread in a round
+    static const int PARALLEL_GRAIN = LEMON_MMC_PARALLEL_GRAIN;
+
+    // Process a range of the small components on a thread
+    class ComponentWorker {
+    private:
+      KarpMmc &_mmc;
+      const std::vector<int> &_comps;
+      std::vector<CycleData> &_cycles;
+    public:
+      ComponentWorker(KarpMmc &mmc, const std::vector<int> &comps,
+                      std::vector<CycleData> &cycles)
+        : _mmc(mmc), _comps(comps), _cycles(cycles) {}
+      void operator()(int thread, int begin, int end) {
+        ThreadData &td = _mmc._thread_data[thread];
+        for (int i = begin; i < end; ++i) {
+          _mmc.processComponent(_comps[i], td, false);
+          _cycles[_comps[i]] = td.curr;
+        }
+      }
+    };
+
+    // Process a round for a range of nodes on a thread
+    class RoundWorker {
+    private:
+      KarpMmc &_mmc;
+      const ThreadData &_td;
+      int _k;
+    public:
+      RoundWorker(KarpMmc &mmc, const ThreadData &td, int k)
+        : _mmc(mmc), _td(td), _k(k) {}
+      void operator()(int, int begin, int end) {
+        _mmc.processRoundRange(_td, _k, begin, end);
+      }
+    };
+
     // Initialization
     void init() {
       if (!_cycle_path) {
         _local_path = true;
         _cycle_path = new Path;
       }
+      _thread_data.resize(_thread_num);
       _cycle_path->clear();
       _cycle_cost = 0;
       _cycle_size = 1;
@@ -483,15 +610,24 @@ namespace lemon {
       }
     }
 
+    // Find the minimum mean cycle in the given component
+    void processComponent(int comp, ThreadData &td, bool parallel) {
+      td.curr = CycleData();
+      if (!initComponent(comp, td)) return;
+      processRounds(td, parallel);
+      findMinMean(td);
+    }
+
     // Initialize path data for the current component
-    bool initComponent(int comp) {
-      _nodes = &(_comp_nodes[comp]);
-      int n = _nodes->size();
-      if (n < 1 || (n == 1 && _out_arcs[(*_nodes)[0]].size() == 0)) {
+    bool initComponent(int comp, ThreadData &td) {
+      td.nodes = &(_comp_nodes[comp]);
+      const std::vector<Node> &nodes = *td.nodes;
+      int n = nodes.size();
+      if (n < 1 || (n == 1 && _out_arcs[nodes[0]].size() == 0)) {
         return false;
       }
       for (int i = 0; i < n; ++i) {
-        _data[(*_nodes)[i]].resize(n + 1, PathData(INF));
+        _data[nodes[i]].resize(n + 1, PathData(INF));
       }
       return true;
     }
@@ -499,29 +635,37 @@ namespace lemon {
     // Process all rounds of computing path data for the current component.
     // _data[v][k] is the cost of a shortest directed walk from the root
     // node to node v containing exactly k arcs.
-    void processRounds() {
-      Node start = (*_nodes)[0];
+    void processRounds(ThreadData &td, bool parallel) {
+      Node start = (*td.nodes)[0];
       _data[start][0] = PathData(0);
-      _process.clear();
-      _process.push_back(start);
+      td.process.clear();
+      td.process.push_back(start);
 
-      int k, n = _nodes->size();
-      for (k = 1; k <= n && int(_process.size()) < n; ++k) {
-        processNextBuildRound(k);
+      int k, n = td.nodes->size();
+      for (k = 1; k <= n && int(td.process.size()) < n; ++k) {
+        processNextBuildRound(td, k);
       }
-      for ( ; k <= n; ++k) {
-        processNextFullRound(k);
+      if (parallel && _thread_num > 1) {
+        for ( ; k <= n; ++k) {
+          RoundWorker worker(*this, td, k);
+          bits::parallelFor(n, _thread_num, worker, PARALLEL_GRAIN);
+        }
+      } else {
+        for ( ; k <= n; ++k) {
+          processNextFullRound(td, k);
+        }
       }
     }
 
-    // Process one round and rebuild _process
-    void processNextBuildRound(int k) {
+    // Process one round and rebuild td.process
+    void processNextBuildRound(ThreadData &td, int k) {
       std::vector<Node> next;
+      std::vector<Node> &process = td.process;
       Node u, v;
       Arc e;
       LargeCost d;
-      for (int i = 0; i < int(_process.size()); ++i) {
-        u = _process[i];
+      for (int i = 0; i < int(process.size()); ++i) {
+        u = process[i];
         for (int j = 0; j < int(_out_arcs[u].size()); ++j) {
           e = _out_arcs[u][j];
           v = _gr.target(e);
@@ -532,16 +676,17 @@ namespace lemon {
           }
         }
       }
-      _process.swap(next);
+      process.swap(next);
     }
 
-    // Process one round using _nodes instead of _process
-    void processNextFullRound(int k) {
+    // Process one round using td.nodes instead of td.process
+    void processNextFullRound(const ThreadData &td, int k) {
+      const std::vector<Node> &nodes = *td.nodes;
       Node u, v;
       Arc e;
       LargeCost d;
-      for (int i = 0; i < int(_nodes->size()); ++i) {
-        u = (*_nodes)[i];
+      for (int i = 0; i < int(nodes.size()); ++i) {
+        u = nodes[i];
         for (int j = 0; j < int(_out_arcs[u].size()); ++j) {
           e = _out_arcs[u][j];
           v = _gr.target(e);
@@ -553,11 +698,46 @@ namespace lemon {
       }
     }
 
+    // Process one round for the given range of td.nodes. In contrast
+    // to processNextFullRound(), the path data of every node in the range
+    // is computed from its incoming arcs, so the ranges can be processed
+    // concurrently.
+    void processRoundRange(const ThreadData &td, int k, int begin, int end) {
+      const std::vector<Node> &nodes = *td.nodes;
+      Node u, v;
+      LargeCost d;
+      for (int i = begin; i < end; ++i) {
+        v = nodes[i];
+        int c = _comp[v];
+        PathData &pd = _data[v][k];
+        for (InArcIt e(_gr, v); e != INVALID; ++e) {
+          u = _gr.source(e);
+          if (_comp[u] != c || _data[u][k-1].dist == INF) continue;
+          d = _data[u][k-1].dist + _cost[e];
+          if (_tolerance.less(d, pd.dist)) {
+            pd = PathData(d, e);
+          }
+        }
+      }
+    }
+
     // Update the minimum cycle mean
-    void updateMinMean() {
-      int n = _nodes->size();
+    void updateMinMean(const CycleData &curr) {
+      if ( curr.node != INVALID && (_cycle_node == INVALID ||
+           curr.cost * _cycle_size < _cycle_cost * curr.size) ) {
+        _cycle_cost = curr.cost;
+        _cycle_size = curr.size;
+        _cycle_node = curr.node;
+      }
+    }
+
+    // Find the minimum cycle mean in the current component
+    void findMinMean(ThreadData &td) {
+      const std::vector<Node> &nodes = *td.nodes;
+      CycleData &curr = td.curr;
+      int n = nodes.size();
       for (int i = 0; i < n; ++i) {
-        Node u = (*_nodes)[i];
+        Node u = nodes[i];
         if (_data[u][n].dist == INF) continue;
         LargeCost cost, max_cost = 0;
         int size, max_size = 1;
@@ -572,11 +752,11 @@ namespace lemon {
             max_size = size;
           }
         }
-        if ( found_curr && (_cycle_node == INVALID ||
-             max_cost * _cycle_size < _cycle_cost * max_size) ) {
-          _cycle_cost = max_cost;
-          _cycle_size = max_size;
-          _cycle_node = u;
+        if ( found_curr && (curr.node == INVALID ||
+             max_cost * curr.size < curr.cost * max_size) ) {
+          curr.cost = max_cost;
+          curr.size = max_size;
+          curr.node = u;
         }
       }
     }
@@ -19,6 +19,10 @@
 ///\ingroup lemon_io
 ///\file
 ///\brief \ref lgf-format "LEMON Graph Format" reader.
+///
+///\note The readers use \ref CompressedIstream, so the programs using
+///this file have to be linked with the LEMON library (and with zlib and
+///zstd, if LEMON is built with them).
 
 
 #ifndef LEMON_LGF_READER_H
@@ -27,11 +31,13 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <limits>
 
 #include <set>
 #include <map>
 
 #include <lemon/core.h>
+#include <lemon/compressed_stream.h>
 
 #include <lemon/lgf_writer.h>
 
@@ -154,49 +160,244 @@ namespace lemon {
       }
     };
 
+    // Label index of the readers. By default, it is an std::map, but
+    // it can be switched to an open addressing hash table, or to a
+    // dense mode, in which the non-negative integer labels are used
+    // directly as indices of a vector (other labels are stored in the
+    // hash table).
+    template <typename _Item>
+    class LabelIndex {
+    public:
+
+      typedef _Item Item;
+
+      enum Type { MAP, HASH, DENSE };
+
+    private:
+
+      typedef std::map<std::string, Item> Map;
+      typedef std::vector<std::pair<std::string, Item> > Entries;
+
+      Type _type;
+
+      Map _map;
+
+      Entries _entries;
+      std::vector<unsigned int> _hashes;
+      std::vector<Index> _slots;
+
+      std::vector<Item> _dense;
+      Index _dense_num;
+
+    public:
+
+      LabelIndex() : _type(MAP), _dense_num(0) {}
+
+      Type type() const { return _type; }
+
+      // Changes the type of the index, the stored labels are kept.
+      void type(Type type) {
+        if (type == _type) return;
+        Entries entries;
+        for (typename Map::const_iterator it = _map.begin();
+             it != _map.end(); ++it) {
+          entries.push_back(*it);
+        }
+        for (Index i = 0; i < static_cast<Index>(_dense.size()); ++i) {
+          if (_dense[i] != INVALID) {
+            std::ostringstream os;
+            os << i;
+            entries.push_back(std::make_pair(os.str(), _dense[i]));
+          }
+        }
+        entries.insert(entries.end(), _entries.begin(), _entries.end());
+        clear();
+        _type = type;
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+          insert(entries[i].first, entries[i].second);
+        }
+      }
+
+      void clear() {
+        _map.clear();
+        _entries.clear();
+        _hashes.clear();
+        _slots.clear();
+        _dense.clear();
+        _dense_num = 0;
+      }
+
+      void swap(LabelIndex& other) {
+        std::swap(_type, other._type);
+        _map.swap(other._map);
+        _entries.swap(other._entries);
+        _hashes.swap(other._hashes);
+        _slots.swap(other._slots);
+        _dense.swap(other._dense);
+        std::swap(_dense_num, other._dense_num);
+      }
+
+      // Inserts a label if it is not stored yet.
+      void insert(const std::string& label, const Item& item) {
+        switch (_type) {
+        case MAP:
+          _map.insert(std::make_pair(label, item));
+          break;
+        case HASH:
+          hashInsert(label, item);
+          break;
+        case DENSE:
+          denseInsert(label, item);
+          break;
+        }
+      }
+
+      // Looks up a label, returns false if it is not found.
+      bool find(const std::string& label, Item& item) const {
+        if (_type == MAP) {
+          typename Map::const_iterator it = _map.find(label);
+          if (it == _map.end()) return false;
+          item = it->second;
+          return true;
+        }
+        if (_type == DENSE) {
+          Index id = denseId(label);
+          if (id != -1 && id < static_cast<Index>(_dense.size()) &&
+              _dense[id] != INVALID) {
+            item = _dense[id];
+            return true;
+          }
+          if (_entries.empty()) return false;
+        }
+        Index k = hashFind(label);
+        if (k == -1) return false;
+        item = _entries[k].second;
+        return true;
+      }
+
+    private:
+
+      // Returns the value of a label in canonical decimal form, or -1
+      static Index denseId(const std::string& label) {
+        int len = label.size();
+        if (len == 0 || len > std::numeric_limits<Index>::digits10 ||
+            (label[0] == '0' && len > 1)) return -1;
+        Index id = 0;
+        for (int i = 0; i < len; ++i) {
+          if (label[i] < '0' || label[i] > '9') return -1;
+          id = 10 * id + (label[i] - '0');
+        }
+        return id;
+      }
+
+      static unsigned int hashValue(const std::string& label) {
+        unsigned int h = 2166136261u;
+        for (int i = 0; i < static_cast<int>(label.size()); ++i) {
+          h = (h ^ static_cast<unsigned char>(label[i])) * 16777619u;
+        }
+        return h;
+      }
+
+      Index hashFind(const std::string& label) const {
+        return hashFind(label, hashValue(label));
+      }
+
+      Index hashFind(const std::string& label, unsigned int h) const {
+        if (_slots.empty()) return -1;
+        Index mask = _slots.size() - 1;
+        for (Index s = h & mask; _slots[s] != -1; s = (s + 1) & mask) {
+          Index k = _slots[s];
+          if (_hashes[k] == h && _entries[k].first == label) return k;
+        }
+        return -1;
+      }
+
+      void hashInsert(const std::string& label, const Item& item) {
+        unsigned int h = hashValue(label);
+        if (hashFind(label, h) != -1) return;
+        if (2 * (_entries.size() + 1) > _slots.size()) {
+          _slots.assign(_slots.empty() ? 16 : 2 * _slots.size(), -1);
+          for (Index k = 0; k < static_cast<Index>(_entries.size()); ++k) {
+            place(k);
+          }
+        }
+        _entries.push_back(std::make_pair(label, item));
+        _hashes.push_back(h);
+        place(_entries.size() - 1);
+      }
+
+      void denseInsert(const std::string& label, const Item& item) {
+        Index id = denseId(label);
+        // The size of the vector is kept linear in the number of labels
+        if (id != -1 &&
+            id <= 2 * (_dense_num + static_cast<Index>(_entries.size())) +
+              1024 && (_entries.empty() || hashFind(label) == -1)) {
+          if (id >= static_cast<Index>(_dense.size())) {
+            _dense.resize(id + 1, INVALID);
+          }
+          if (_dense[id] == INVALID) {
+            _dense[id] = item;
+            ++_dense_num;
+          }
+        } else {
+          hashInsert(label, item);
+        }
+      }
+
+      void place(Index k) {
+        Index mask = _slots.size() - 1;
+        Index s = _hashes[k] & mask;
+        while (_slots[s] != -1) s = (s + 1) & mask;
+        _slots[s] = k;
+      }
+
+    };
+
     template <typename Value,
-              typename Map = std::map<std::string, Value> >
+              typename Index = LabelIndex<Value> >
     struct MapLookUpConverter {
-      const Map& _map;
+      const Index& _index;
 
-      MapLookUpConverter(const Map& map)
-        : _map(map) {}
+      MapLookUpConverter(const Index& index)
+        : _index(index) {}
 
       Value operator()(const std::string& str) {
-        typename Map::const_iterator it = _map.find(str);
-        if (it == _map.end()) {
+        Value value;
+        if (!_index.find(str, value)) {
           std::ostringstream msg;
           msg << "Item not found: " << str;
           throw FormatError(msg.str());
         }
-        return it->second;
+        return value;
       }
     };
 
     template <typename Value,
-              typename Map1 = std::map<std::string, Value>,
-              typename Map2 = std::map<std::string, Value> >
+              typename Index1 = LabelIndex<Value>,
+              typename Index2 = LabelIndex<Value> >
     struct DoubleMapLookUpConverter {
-      const Map1& _map1;
-      const Map2& _map2;
+      const Index1& _index1;
+      const Index2& _index2;
 
-      DoubleMapLookUpConverter(const Map1& map1, const Map2& map2)
-        : _map1(map1), _map2(map2) {}
+      DoubleMapLookUpConverter(const Index1& index1, const Index2& index2)
+        : _index1(index1), _index2(index2) {}
 
       Value operator()(const std::string& str) {
-        typename Map1::const_iterator it1 = _map1.find(str);
-        typename Map2::const_iterator it2 = _map2.find(str);
-        if (it1 == _map1.end()) {
-          if (it2 == _map2.end()) {
+        typename Index1::Item value1;
+        typename Index2::Item value2;
+        bool found1 = _index1.find(str, value1);
+        bool found2 = _index2.find(str, value2);
+        if (!found1) {
+          if (!found2) {
             std::ostringstream msg;
             msg << "Item not found: " << str;
             throw FormatError(msg.str());
           } else {
-            return it2->second;
+            return value2;
           }
         } else {
-          if (it2 == _map2.end()) {
-            return it1->second;
+          if (!found2) {
+            return value1;
           } else {
             std::ostringstream msg;
             msg << "Item is ambigous: " << str;
@@ -209,23 +410,21 @@ namespace lemon {
     template <typename GR>
     struct GraphArcLookUpConverter {
       const GR& _graph;
-      const std::map<std::string, typename GR::Edge>& _map;
+      const LabelIndex<typename GR::Edge>& _index;
 
       GraphArcLookUpConverter(const GR& graph,
-                              const std::map<std::string,
-                                             typename GR::Edge>& map)
-        : _graph(graph), _map(map) {}
+                              const LabelIndex<typename GR::Edge>& index)
+        : _graph(graph), _index(index) {}
 
       typename GR::Arc operator()(const std::string& str) {
         if (str.empty() || (str[0] != '+' && str[0] != '-')) {
           throw FormatError("Item must start with '+' or '-'");
         }
-        typename std::map<std::string, typename GR::Edge>
-          ::const_iterator it = _map.find(str.substr(1));
-        if (it == _map.end()) {
+        typename GR::Edge edge;
+        if (!_index.find(str.substr(1), edge)) {
           throw FormatError("Item not found");
         }
-        return _graph.direct(it->second, str[0] == '+');
+        return _graph.direct(edge, str[0] == '+');
       }
     };
 
@@ -319,19 +518,18 @@ namespace lemon {
     }
 
     inline std::istream& readToken(std::istream& is, std::string& str) {
-      std::ostringstream os;
-
       char c;
       is >> std::ws;
 
       if (!is.get(c))
         return is;
+      str.clear();
 
       if (c == '\"') {
         while (is.get(c) && c != '\"') {
           if (c == '\\')
             c = readEscape(is);
-          os << c;
+          str += c;
         }
         if (!is)
           throw FormatError("Quoted format error");
@@ -340,7 +538,7 @@ namespace lemon {
         while (is.get(c) && !isWhiteSpace(c)) {
           if (c == '\\')
             c = readEscape(is);
-          os << c;
+          str += c;
         }
         if (!is) {
           is.clear();
@@ -348,7 +546,6 @@ namespace lemon {
           is.putback(c);
         }
       }
-      str = os.str();
       return is;
     }
 
@@ -480,6 +677,11 @@ namespace lemon {
   /// It is impossible to read this in
   /// a single pass, because the arcs are not constructed when the node
   /// maps are read.
+  ///
+  /// When the reader is constructed with a file name, \c gzip and
+  /// \c zstd compressed files are decompressed on the fly using
+  /// \ref CompressedIstream. A \ref CompressedIstream can also be
+  /// passed as the input stream, e.g. for parallel decompression.
   template <typename DGR>
   class DigraphReader {
   public:
@@ -500,9 +702,9 @@ namespace lemon {
     std::string _arcs_caption;
     std::string _attributes_caption;
 
-    typedef std::map<std::string, Node> NodeIndex;
+    typedef _reader_bits::LabelIndex<Node> NodeIndex;
     NodeIndex _node_index;
-    typedef std::map<std::string, Arc> ArcIndex;
+    typedef _reader_bits::LabelIndex<Arc> ArcIndex;
     ArcIndex _arc_index;
 
     typedef std::vector<std::pair<std::string,
@@ -542,7 +744,7 @@ namespace lemon {
     /// Construct a directed graph reader, which reads from the given
     /// file.
     DigraphReader(DGR& digraph, const std::string& fn)
-      : _is(new std::ifstream(fn.c_str())), local_is(true),
+      : _is(new CompressedIstream(fn)), local_is(true),
         _filename(fn), _digraph(digraph),
         _use_nodes(false), _use_arcs(false),
         _skip_nodes(false), _skip_arcs(false) {
@@ -557,7 +759,7 @@ namespace lemon {
     /// Construct a directed graph reader, which reads from the given
     /// file.
     DigraphReader(DGR& digraph, const char* fn)
-      : _is(new std::ifstream(fn)), local_is(true),
+      : _is(new CompressedIstream(fn)), local_is(true),
         _filename(fn), _digraph(digraph),
         _use_nodes(false), _use_arcs(false),
         _skip_nodes(false), _skip_arcs(false) {
@@ -773,7 +975,7 @@ namespace lemon {
       _use_nodes = true;
       _writer_bits::DefaultConverter<typename Map::Value> converter;
       for (NodeIt n(_digraph); n != INVALID; ++n) {
-        _node_index.insert(std::make_pair(converter(map[n]), n));
+        _node_index.insert(converter(map[n]), n);
       }
       return *this;
     }
@@ -790,7 +992,7 @@ namespace lemon {
       LEMON_ASSERT(!_use_nodes, "Multiple usage of useNodes() member");
       _use_nodes = true;
       for (NodeIt n(_digraph); n != INVALID; ++n) {
-        _node_index.insert(std::make_pair(converter(map[n]), n));
+        _node_index.insert(converter(map[n]), n);
       }
       return *this;
     }
@@ -806,7 +1008,7 @@ namespace lemon {
       _use_arcs = true;
       _writer_bits::DefaultConverter<typename Map::Value> converter;
       for (ArcIt a(_digraph); a != INVALID; ++a) {
-        _arc_index.insert(std::make_pair(converter(map[a]), a));
+        _arc_index.insert(converter(map[a]), a);
       }
       return *this;
     }
@@ -823,7 +1025,7 @@ namespace lemon {
       LEMON_ASSERT(!_use_arcs, "Multiple usage of useArcs() member");
       _use_arcs = true;
       for (ArcIt a(_digraph); a != INVALID; ++a) {
-        _arc_index.insert(std::make_pair(converter(map[a]), a));
+        _arc_index.insert(converter(map[a]), a);
       }
       return *this;
     }
@@ -855,6 +1057,38 @@ namespace lemon {
 
     /// @}
 
+    /// \name Label Index
+    /// @{
+
+    /// \brief Use hash tables for label lookup
+    ///
+    /// By default, the labels of the nodes and arcs are looked up in
+    /// balanced search trees (\c std::map). This function makes the
+    /// reader use open addressing hash tables instead, which are
+    /// faster and use less memory for large files.
+    DigraphReader& hashLabels() {
+      _node_index.type(NodeIndex::HASH);
+      _arc_index.type(ArcIndex::HASH);
+      return *this;
+    }
+
+    /// \brief Use integer labels as dense indices
+    ///
+    /// This function makes the reader use the non-negative integer
+    /// labels directly as vector indices, so no index structure is
+    /// built for them. It is the fastest mode for files that use
+    /// consecutive integers as labels, like the ones written by
+    /// \ref DigraphWriter. Other labels, and integer labels that are too
+    /// large compared to the number of items, are stored in hash
+    /// tables, so any file can be read in this mode.
+    DigraphReader& denseLabels() {
+      _node_index.type(NodeIndex::DENSE);
+      _arc_index.type(ArcIndex::DENSE);
+      return *this;
+    }
+
+    /// @}
+
   private:
 
     bool readLine() {
@@ -867,6 +1101,11 @@ namespace lemon {
           return true;
         }
       }
+      // A failing stream buffer (e.g. a truncated or corrupted
+      // compressed file) only sets the badbit of the stream
+      if (_is->bad()) {
+        throw IoError("Cannot read the input", _filename);
+      }
       return false;
     }
 
@@ -953,18 +1192,15 @@ namespace lemon {
         if (!_use_nodes) {
           n = _digraph.addNode();
           if (label_index != -1)
-            _node_index.insert(std::make_pair(tokens[label_index], n));
+            _node_index.insert(tokens[label_index], n);
         } else {
           if (label_index == -1)
             throw FormatError("Label map not found");
-          typename std::map<std::string, Node>::iterator it =
-            _node_index.find(tokens[label_index]);
-          if (it == _node_index.end()) {
+          if (!_node_index.find(tokens[label_index], n)) {
             std::ostringstream msg;
             msg << "Node with label not found: " << tokens[label_index];
             throw FormatError(msg.str());
           }
-          n = it->second;
         }
 
         for (int i = 0; i < static_cast<int>(_node_maps.size()); ++i) {
@@ -1061,38 +1297,29 @@ namespace lemon {
         Arc a;
         if (!_use_arcs) {
 
-          typename NodeIndex::iterator it;
-
-          it = _node_index.find(source_token);
-          if (it == _node_index.end()) {
+          Node source, target;
+          if (!_node_index.find(source_token, source)) {
             std::ostringstream msg;
             msg << "Item not found: " << source_token;
             throw FormatError(msg.str());
           }
-          Node source = it->second;
-
-          it = _node_index.find(target_token);
-          if (it == _node_index.end()) {
+          if (!_node_index.find(target_token, target)) {
             std::ostringstream msg;
             msg << "Item not found: " << target_token;
             throw FormatError(msg.str());
           }
-          Node target = it->second;
 
           a = _digraph.addArc(source, target);
           if (label_index != -1)
-            _arc_index.insert(std::make_pair(tokens[label_index], a));
+            _arc_index.insert(tokens[label_index], a);
         } else {
           if (label_index == -1)
             throw FormatError("Label map not found");
-          typename std::map<std::string, Arc>::iterator it =
-            _arc_index.find(tokens[label_index]);
-          if (it == _arc_index.end()) {
+          if (!_arc_index.find(tokens[label_index], a)) {
             std::ostringstream msg;
             msg << "Arc with label not found: " << tokens[label_index];
             throw FormatError(msg.str());
           }
-          a = it->second;
         }
 
         for (int i = 0; i < static_cast<int>(_arc_maps.size()); ++i) {
@@ -1334,9 +1561,9 @@ namespace lemon {
     std::string _edges_caption;
     std::string _attributes_caption;
 
-    typedef std::map<std::string, Node> NodeIndex;
+    typedef _reader_bits::LabelIndex<Node> NodeIndex;
     NodeIndex _node_index;
-    typedef std::map<std::string, Edge> EdgeIndex;
+    typedef _reader_bits::LabelIndex<Edge> EdgeIndex;
     EdgeIndex _edge_index;
 
     typedef std::vector<std::pair<std::string,
@@ -1376,7 +1603,7 @@ namespace lemon {
     /// Construct an undirected graph reader, which reads from the given
     /// file.
     GraphReader(GR& graph, const std::string& fn)
-      : _is(new std::ifstream(fn.c_str())), local_is(true),
+      : _is(new CompressedIstream(fn)), local_is(true),
         _filename(fn), _graph(graph),
         _use_nodes(false), _use_edges(false),
         _skip_nodes(false), _skip_edges(false) {
@@ -1391,7 +1618,7 @@ namespace lemon {
     /// Construct an undirected graph reader, which reads from the given
     /// file.
     GraphReader(GR& graph, const char* fn)
-      : _is(new std::ifstream(fn)), local_is(true),
+      : _is(new CompressedIstream(fn)), local_is(true),
         _filename(fn), _graph(graph),
         _use_nodes(false), _use_edges(false),
         _skip_nodes(false), _skip_edges(false) {
@@ -1651,7 +1878,7 @@ namespace lemon {
       _use_nodes = true;
       _writer_bits::DefaultConverter<typename Map::Value> converter;
       for (NodeIt n(_graph); n != INVALID; ++n) {
-        _node_index.insert(std::make_pair(converter(map[n]), n));
+        _node_index.insert(converter(map[n]), n);
       }
       return *this;
     }
@@ -1668,7 +1895,7 @@ namespace lemon {
       LEMON_ASSERT(!_use_nodes, "Multiple usage of useNodes() member");
       _use_nodes = true;
       for (NodeIt n(_graph); n != INVALID; ++n) {
-        _node_index.insert(std::make_pair(converter(map[n]), n));
+        _node_index.insert(converter(map[n]), n);
       }
       return *this;
     }
@@ -1684,7 +1911,7 @@ namespace lemon {
       _use_edges = true;
       _writer_bits::DefaultConverter<typename Map::Value> converter;
       for (EdgeIt a(_graph); a != INVALID; ++a) {
-        _edge_index.insert(std::make_pair(converter(map[a]), a));
+        _edge_index.insert(converter(map[a]), a);
       }
       return *this;
     }
@@ -1701,7 +1928,7 @@ namespace lemon {
       LEMON_ASSERT(!_use_edges, "Multiple usage of useEdges() member");
       _use_edges = true;
       for (EdgeIt a(_graph); a != INVALID; ++a) {
-        _edge_index.insert(std::make_pair(converter(map[a]), a));
+        _edge_index.insert(converter(map[a]), a);
       }
       return *this;
     }
@@ -1734,6 +1961,38 @@ namespace lemon {
 
     /// @}
 
+    /// \name Label Index
+    /// @{
+
+    /// \brief Use hash tables for label lookup
+    ///
+    /// By default, the labels of the nodes and edges are looked up in
+    /// balanced search trees (\c std::map). This function makes the
+    /// reader use open addressing hash tables instead, which are
+    /// faster and use less memory for large files.
+    GraphReader& hashLabels() {
+      _node_index.type(NodeIndex::HASH);
+      _edge_index.type(EdgeIndex::HASH);
+      return *this;
+    }
+
+    /// \brief Use integer labels as dense indices
+    ///
+    /// This function makes the reader use the non-negative integer
+    /// labels directly as vector indices, so no index structure is
+    /// built for them. It is the fastest mode for files that use
+    /// consecutive integers as labels, like the ones written by
+    /// \ref GraphWriter. Other labels, and integer labels that are too
+    /// large compared to the number of items, are stored in hash
+    /// tables, so any file can be read in this mode.
+    GraphReader& denseLabels() {
+      _node_index.type(NodeIndex::DENSE);
+      _edge_index.type(EdgeIndex::DENSE);
+      return *this;
+    }
+
+    /// @}
+
   private:
 
     bool readLine() {
@@ -1746,6 +2005,11 @@ namespace lemon {
           return true;
         }
       }
+      // A failing stream buffer (e.g. a truncated or corrupted
+      // compressed file) only sets the badbit of the stream
+      if (_is->bad()) {
+        throw IoError("Cannot read the input", _filename);
+      }
       return false;
     }
 
@@ -1832,18 +2096,15 @@ namespace lemon {
         if (!_use_nodes) {
           n = _graph.addNode();
           if (label_index != -1)
-            _node_index.insert(std::make_pair(tokens[label_index], n));
+            _node_index.insert(tokens[label_index], n);
         } else {
           if (label_index == -1)
             throw FormatError("Label map not found");
-          typename std::map<std::string, Node>::iterator it =
-            _node_index.find(tokens[label_index]);
-          if (it == _node_index.end()) {
+          if (!_node_index.find(tokens[label_index], n)) {
             std::ostringstream msg;
             msg << "Node with label not found: " << tokens[label_index];
             throw FormatError(msg.str());
           }
-          n = it->second;
         }
 
         for (int i = 0; i < static_cast<int>(_node_maps.size()); ++i) {
@@ -1940,38 +2201,29 @@ namespace lemon {
         Edge e;
         if (!_use_edges) {
 
-          typename NodeIndex::iterator it;
-
-          it = _node_index.find(source_token);
-          if (it == _node_index.end()) {
+          Node source, target;
+          if (!_node_index.find(source_token, source)) {
             std::ostringstream msg;
             msg << "Item not found: " << source_token;
             throw FormatError(msg.str());
           }
-          Node source = it->second;
-
-          it = _node_index.find(target_token);
-          if (it == _node_index.end()) {
+          if (!_node_index.find(target_token, target)) {
             std::ostringstream msg;
             msg << "Item not found: " << target_token;
             throw FormatError(msg.str());
           }
-          Node target = it->second;
 
           e = _graph.addEdge(source, target);
           if (label_index != -1)
-            _edge_index.insert(std::make_pair(tokens[label_index], e));
+            _edge_index.insert(tokens[label_index], e);
         } else {
           if (label_index == -1)
             throw FormatError("Label map not found");
-          typename std::map<std::string, Edge>::iterator it =
-            _edge_index.find(tokens[label_index]);
-          if (it == _edge_index.end()) {
+          if (!_edge_index.find(tokens[label_index], e)) {
             std::ostringstream msg;
             msg << "Edge with label not found: " << tokens[label_index];
             throw FormatError(msg.str());
           }
-          e = it->second;
         }
 
         for (int i = 0; i < static_cast<int>(_edge_maps.size()); ++i) {
@@ -2207,11 +2459,11 @@ namespace lemon {
     std::string _edges_caption;
     std::string _attributes_caption;
 
-    typedef std::map<std::string, RedNode> RedNodeIndex;
+    typedef _reader_bits::LabelIndex<RedNode> RedNodeIndex;
     RedNodeIndex _red_node_index;
-    typedef std::map<std::string, BlueNode> BlueNodeIndex;
+    typedef _reader_bits::LabelIndex<BlueNode> BlueNodeIndex;
     BlueNodeIndex _blue_node_index;
-    typedef std::map<std::string, Edge> EdgeIndex;
+    typedef _reader_bits::LabelIndex<Edge> EdgeIndex;
     EdgeIndex _edge_index;
 
     typedef std::vector<std::pair<std::string,
@@ -2254,7 +2506,7 @@ namespace lemon {
     /// Construct an undirected graph reader, which reads from the given
     /// file.
     BpGraphReader(BGR& graph, const std::string& fn)
-      : _is(new std::ifstream(fn.c_str())), local_is(true),
+      : _is(new CompressedIstream(fn)), local_is(true),
         _filename(fn), _graph(graph),
         _use_nodes(false), _use_edges(false),
         _skip_nodes(false), _skip_edges(false) {
@@ -2269,7 +2521,7 @@ namespace lemon {
     /// Construct an undirected graph reader, which reads from the given
     /// file.
     BpGraphReader(BGR& graph, const char* fn)
-      : _is(new std::ifstream(fn)), local_is(true),
+      : _is(new CompressedIstream(fn)), local_is(true),
         _filename(fn), _graph(graph),
         _use_nodes(false), _use_edges(false),
         _skip_nodes(false), _skip_edges(false) {
@@ -2616,10 +2868,10 @@ namespace lemon {
       _use_nodes = true;
       _writer_bits::DefaultConverter<typename Map::Value> converter;
       for (RedNodeIt n(_graph); n != INVALID; ++n) {
-        _red_node_index.insert(std::make_pair(converter(map[n]), n));
+        _red_node_index.insert(converter(map[n]), n);
       }
       for (BlueNodeIt n(_graph); n != INVALID; ++n) {
-        _blue_node_index.insert(std::make_pair(converter(map[n]), n));
+        _blue_node_index.insert(converter(map[n]), n);
       }
       return *this;
     }
@@ -2636,10 +2888,10 @@ namespace lemon {
       LEMON_ASSERT(!_use_nodes, "Multiple usage of useNodes() member");
       _use_nodes = true;
       for (RedNodeIt n(_graph); n != INVALID; ++n) {
-        _red_node_index.insert(std::make_pair(converter(map[n]), n));
+        _red_node_index.insert(converter(map[n]), n);
       }
       for (BlueNodeIt n(_graph); n != INVALID; ++n) {
-        _blue_node_index.insert(std::make_pair(converter(map[n]), n));
+        _blue_node_index.insert(converter(map[n]), n);
       }
       return *this;
     }
@@ -2655,7 +2907,7 @@ namespace lemon {
       _use_edges = true;
       _writer_bits::DefaultConverter<typename Map::Value> converter;
       for (EdgeIt a(_graph); a != INVALID; ++a) {
-        _edge_index.insert(std::make_pair(converter(map[a]), a));
+        _edge_index.insert(converter(map[a]), a);
       }
       return *this;
     }
@@ -2672,7 +2924,7 @@ namespace lemon {
       LEMON_ASSERT(!_use_edges, "Multiple usage of useEdges() member");
       _use_edges = true;
       for (EdgeIt a(_graph); a != INVALID; ++a) {
-        _edge_index.insert(std::make_pair(converter(map[a]), a));
+        _edge_index.insert(converter(map[a]), a);
       }
       return *this;
     }
@@ -2705,6 +2957,40 @@ namespace lemon {
 
     /// @}
 
+    /// \name Label Index
+    /// @{
+
+    /// \brief Use hash tables for label lookup
+    ///
+    /// By default, the labels of the nodes and edges are looked up in
+    /// balanced search trees (\c std::map). This function makes the
+    /// reader use open addressing hash tables instead, which are
+    /// faster and use less memory for large files.
+    BpGraphReader& hashLabels() {
+      _red_node_index.type(RedNodeIndex::HASH);
+      _blue_node_index.type(BlueNodeIndex::HASH);
+      _edge_index.type(EdgeIndex::HASH);
+      return *this;
+    }
+
+    /// \brief Use integer labels as dense indices
+    ///
+    /// This function makes the reader use the non-negative integer
+    /// labels directly as vector indices, so no index structure is
+    /// built for them. It is the fastest mode for files that use
+    /// consecutive integers as labels, like the ones written by
+    /// \ref BpGraphWriter. Other labels, and integer labels that are too
+    /// large compared to the number of items, are stored in hash
+    /// tables, so any file can be read in this mode.
+    BpGraphReader& denseLabels() {
+      _red_node_index.type(RedNodeIndex::DENSE);
+      _blue_node_index.type(BlueNodeIndex::DENSE);
+      _edge_index.type(EdgeIndex::DENSE);
+      return *this;
+    }
+
+    /// @}
+
   private:
 
     bool readLine() {
@@ -2717,6 +3003,11 @@ namespace lemon {
           return true;
         }
       }
+      // A failing stream buffer (e.g. a truncated or corrupted
+      // compressed file) only sets the badbit of the stream
+      if (_is->bad()) {
+        throw IoError("Cannot read the input", _filename);
+      }
       return false;
     }
 
@@ -2803,18 +3094,15 @@ namespace lemon {
         if (!_use_nodes) {
           n = _graph.addRedNode();
           if (label_index != -1)
-            _red_node_index.insert(std::make_pair(tokens[label_index], n));
+            _red_node_index.insert(tokens[label_index], n);
         } else {
           if (label_index == -1)
             throw FormatError("Label map not found");
-          typename std::map<std::string, RedNode>::iterator it =
-            _red_node_index.find(tokens[label_index]);
-          if (it == _red_node_index.end()) {
+          if (!_red_node_index.find(tokens[label_index], n)) {
             std::ostringstream msg;
             msg << "Node with label not found: " << tokens[label_index];
             throw FormatError(msg.str());
           }
-          n = it->second;
         }
 
         for (int i = 0; i < static_cast<int>(_red_node_maps.size()); ++i) {
@@ -2896,18 +3184,15 @@ namespace lemon {
         if (!_use_nodes) {
           n = _graph.addBlueNode();
           if (label_index != -1)
-            _blue_node_index.insert(std::make_pair(tokens[label_index], n));
+            _blue_node_index.insert(tokens[label_index], n);
         } else {
           if (label_index == -1)
             throw FormatError("Label map not found");
-          typename std::map<std::string, BlueNode>::iterator it =
-            _blue_node_index.find(tokens[label_index]);
-          if (it == _blue_node_index.end()) {
+          if (!_blue_node_index.find(tokens[label_index], n)) {
             std::ostringstream msg;
             msg << "Node with label not found: " << tokens[label_index];
             throw FormatError(msg.str());
           }
-          n = it->second;
         }
 
         for (int i = 0; i < static_cast<int>(_blue_node_maps.size()); ++i) {
@@ -2996,39 +3281,32 @@ namespace lemon {
 
         Edge e;
         if (!_use_edges) {
-          typename RedNodeIndex::iterator rit =
-            _red_node_index.find(source_token);
-          if (rit == _red_node_index.end()) {
+          RedNode source;
+          if (!_red_node_index.find(source_token, source)) {
             std::ostringstream msg;
             msg << "Item not found: " << source_token;
             throw FormatError(msg.str());
           }
-          RedNode source = rit->second;
-          typename BlueNodeIndex::iterator it =
-            _blue_node_index.find(target_token);
-          if (it == _blue_node_index.end()) {
+          BlueNode target;
+          if (!_blue_node_index.find(target_token, target)) {
             std::ostringstream msg;
             msg << "Item not found: " << target_token;
             throw FormatError(msg.str());
           }
-          BlueNode target = it->second;
 
           // It is checked that source is red and
           // target is blue, so this should be safe:
           e = _graph.addEdge(source, target);
           if (label_index != -1)
-            _edge_index.insert(std::make_pair(tokens[label_index], e));
+            _edge_index.insert(tokens[label_index], e);
         } else {
           if (label_index == -1)
             throw FormatError("Label map not found");
-          typename std::map<std::string, Edge>::iterator it =
-            _edge_index.find(tokens[label_index]);
-          if (it == _edge_index.end()) {
+          if (!_edge_index.find(tokens[label_index], e)) {
             std::ostringstream msg;
             msg << "Edge with label not found: " << tokens[label_index];
             throw FormatError(msg.str());
           }
-          e = it->second;
         }
 
         for (int i = 0; i < static_cast<int>(_edge_maps.size()); ++i) {
@@ -3275,7 +3553,7 @@ namespace lemon {
     ///
     /// Construct a section reader, which reads from the given file.
     SectionReader(const std::string& fn)
-      : _is(new std::ifstream(fn.c_str())), local_is(true),
+      : _is(new CompressedIstream(fn)), local_is(true),
         _filename(fn) {
       if (!(*_is)) {
         delete _is;
@@ -3287,7 +3565,7 @@ namespace lemon {
     ///
     /// Construct a section reader, which reads from the given file.
     SectionReader(const char* fn)
-      : _is(new std::ifstream(fn)), local_is(true),
+      : _is(new CompressedIstream(fn)), local_is(true),
         _filename(fn) {
       if (!(*_is)) {
         delete _is;
@@ -3406,6 +3684,11 @@ namespace lemon {
           return true;
         }
       }
+      // A failing stream buffer (e.g. a truncated or corrupted
+      // compressed file) only sets the badbit of the stream
+      if (_is->bad()) {
+        throw IoError("Cannot read the input", _filename);
+      }
       return false;
     }
 
@@ -3586,7 +3869,7 @@ namespace lemon {
     /// Construct an \e LGF contents reader, which reads from the given
     /// file.
     LgfContents(const std::string& fn)
-      : _is(new std::ifstream(fn.c_str())), local_is(true) {
+      : _is(new CompressedIstream(fn)), local_is(true) {
       if (!(*_is)) {
         delete _is;
         throw IoError("Cannot open file", fn);
@@ -3598,7 +3881,7 @@ namespace lemon {
     /// Construct an \e LGF contents reader, which reads from the given
     /// file.
     LgfContents(const char* fn)
-      : _is(new std::ifstream(fn)), local_is(true) {
+      : _is(new CompressedIstream(fn)), local_is(true) {
       if (!(*_is)) {
         delete _is;
         throw IoError("Cannot open file", fn);
@@ -3759,6 +4042,11 @@ namespace lemon {
           return true;
         }
       }
+      // A failing stream buffer (e.g. a truncated or corrupted
+      // compressed file) only sets the badbit of the stream
+      if (_is->bad()) {
+        throw IoError("Cannot read the input");
+      }
       return false;
     }
 
@@ -19,6 +19,10 @@
 ///\ingroup lemon_io
 ///\file
 ///\brief \ref lgf-format "LEMON Graph Format" writer.
+///
+///\note The writers use \ref CompressedOstream, so the programs using
+///this file have to be linked with the LEMON library (and with zlib and
+///zstd, if LEMON is built with them).
 
 
 #ifndef LEMON_LGF_WRITER_H
@@ -32,9 +36,12 @@
 
 #include <vector>
 #include <functional>
+#include <cstdio>
 
 #include <lemon/core.h>
 #include <lemon/maps.h>
+#include <lemon/bits/parallel.h>
+#include <lemon/compressed_stream.h>
 
 #include <lemon/concept_check.h>
 #include <lemon/concepts/maps.h>
@@ -52,6 +59,85 @@ namespace lemon {
       }
     };
 
+    // The converters of the arithmetic types avoid the construction of
+    // a string stream, but give the same result as the default one
+
+    template <typename Value>
+    inline char* formatUnsigned(char* end, Value value) {
+      do {
+        *--end = static_cast<char>('0' + value % 10);
+        value /= 10;
+      } while (value != 0);
+      return end;
+    }
+
+    template <typename Value>
+    struct UnsignedConverter {
+      std::string operator()(const Value& value) {
+        char buf[3 * sizeof(Value) + 1];
+        char* end = buf + sizeof(buf);
+        return std::string(formatUnsigned(end, value), end);
+      }
+    };
+
+    template <typename Value, typename Unsigned>
+    struct SignedConverter {
+      std::string operator()(const Value& value) {
+        char buf[3 * sizeof(Value) + 2];
+        char* end = buf + sizeof(buf);
+        char* begin;
+        if (value < 0) {
+          begin = formatUnsigned(end, Unsigned(0) -
+                                 static_cast<Unsigned>(value));
+          *--begin = '-';
+        } else {
+          begin = formatUnsigned(end, static_cast<Unsigned>(value));
+        }
+        return std::string(begin, end);
+      }
+    };
+
+    template <typename Value>
+    struct RealConverter {
+      std::string operator()(const Value& value) {
+        char buf[32];
+        std::sprintf(buf, "%g", static_cast<double>(value));
+        return buf;
+      }
+    };
+
+    template <>
+    struct DefaultConverter<int>
+      : public SignedConverter<int, unsigned int> {};
+    template <>
+    struct DefaultConverter<unsigned int>
+      : public UnsignedConverter<unsigned int> {};
+    template <>
+    struct DefaultConverter<long>
+      : public SignedConverter<long, unsigned long> {};
+    template <>
+    struct DefaultConverter<unsigned long>
+      : public UnsignedConverter<unsigned long> {};
+#ifdef LEMON_HAVE_LONG_LONG
+    template <>
+    struct DefaultConverter<long long>
+      : public SignedConverter<long long, unsigned long long> {};
+    template <>
+    struct DefaultConverter<unsigned long long>
+      : public UnsignedConverter<unsigned long long> {};
+#endif
+    template <>
+    struct DefaultConverter<float> : public RealConverter<float> {};
+    template <>
+    struct DefaultConverter<double> : public RealConverter<double> {};
+
+    template <>
+    struct DefaultConverter<std::string> {
+      std::string operator()(const std::string& value) {
+        return value;
+      }
+    };
+
     template <typename T>
     bool operator<(const T&, const T&) {
       throw FormatError("Label map is not comparable");
@@ -191,72 +277,6 @@ namespace lemon {
       }
     };
 
-    template <typename Value,
-              typename Map = std::map<Value, std::string> >
-    struct MapLookUpConverter {
-      const Map& _map;
-
-      MapLookUpConverter(const Map& map)
-        : _map(map) {}
-
-      std::string operator()(const Value& value) {
-        typename Map::const_iterator it = _map.find(value);
-        if (it == _map.end()) {
-          throw FormatError("Item not found");
-        }
-        return it->second;
-      }
-    };
-
-    template <typename Value,
-              typename Map1 = std::map<Value, std::string>,
-              typename Map2 = std::map<Value, std::string> >
-    struct DoubleMapLookUpConverter {
-      const Map1& _map1;
-      const Map2& _map2;
-
-      DoubleMapLookUpConverter(const Map1& map1, const Map2& map2)
-        : _map1(map1), _map2(map2) {}
-
-      std::string operator()(const Value& value) {
-        typename Map1::const_iterator it1 = _map1.find(value);
-        typename Map1::const_iterator it2 = _map2.find(value);
-        if (it1 == _map1.end()) {
-          if (it2 == _map2.end()) {
-            throw FormatError("Item not found");
-          } else {
-            return it2->second;
-          }
-        } else {
-          if (it2 == _map2.end()) {
-            return it1->second;
-          } else {
-            throw FormatError("Item is ambigous");
-          }
-        }
-      }
-    };
-
-    template <typename Graph>
-    struct GraphArcLookUpConverter {
-      const Graph& _graph;
-      const std::map<typename Graph::Edge, std::string>& _map;
-
-      GraphArcLookUpConverter(const Graph& graph,
-                              const std::map<typename Graph::Edge,
-                                             std::string>& map)
-        : _graph(graph), _map(map) {}
-
-      std::string operator()(const typename Graph::Arc& val) {
-        typename std::map<typename Graph::Edge, std::string>
-          ::const_iterator it = _map.find(val);
-        if (it == _map.end()) {
-          throw FormatError("Item not found");
-        }
-        return (_graph.direction(val) ? '+' : '-') + it->second;
-      }
-    };
-
     inline bool isWhiteSpace(char c) {
       return c == ' ' || c == '\t' || c == '\v' ||
         c == '\n' || c == '\r' || c == '\f';
@@ -310,10 +330,9 @@ namespace lemon {
 
     inline bool requireEscape(const std::string& str) {
       if (str.empty() || str[0] == '@') return true;
-      std::istringstream is(str);
-      char c;
-      while (is.get(c)) {
-        if (isWhiteSpace(c) || isEscaped(c)) {
+      for (std::string::const_iterator it = str.begin();
+           it != str.end(); ++it) {
+        if (isWhiteSpace(*it) || isEscaped(*it)) {
           return true;
         }
       }
@@ -335,6 +354,207 @@ namespace lemon {
       return os;
     }
 
+    inline void writeToken(std::string& buf, const std::string& str) {
+      if (requireEscape(str)) {
+        std::ostringstream os;
+        writeToken(os, str);
+        buf += os.str();
+      } else {
+        buf += str;
+      }
+    }
+
+    // Label index of the writers. The labels are stored in a vector
+    // indexed by the ids of the items. If there is no label map, the
+    // ids are used as labels and nothing is stored at all.
+    template <typename GR, typename _Item>
+    class LabelIndex {
+    public:
+      typedef _Item Item;
+
+    private:
+      const GR& _graph;
+      bool _ids;
+      std::vector<std::string> _labels;
+
+    public:
+      LabelIndex(const GR& graph) : _graph(graph), _ids(true) {}
+
+      bool ids() const { return _ids; }
+
+      void useIds() {
+        _ids = true;
+        std::vector<std::string>().swap(_labels);
+      }
+
+      void useLabels() {
+        _ids = false;
+        _labels.assign(_graph.maxId(Item()) + 1, std::string());
+      }
+
+      // It can be called concurrently for different items.
+      void set(const Item& item, const std::string& label) {
+        _labels[_graph.id(item)] = label;
+      }
+
+      bool find(const Item& item, std::string& label) const {
+        Index id = _graph.id(item);
+        if (id < 0) return false;
+        if (_ids) {
+          label = DefaultConverter<Index>()(id);
+        } else {
+          if (id >= static_cast<Index>(_labels.size())) return false;
+          label = _labels[id];
+        }
+        return true;
+      }
+
+      void write(std::string& buf, const Item& item) const {
+        if (_ids) {
+          buf += DefaultConverter<Index>()(_graph.id(item));
+        } else {
+          writeToken(buf, _labels[_graph.id(item)]);
+        }
+      }
+
+      void swap(LabelIndex& other) {
+        std::swap(_ids, other._ids);
+        _labels.swap(other._labels);
+      }
+    };
+
+    template <typename Value, typename Index>
+    struct MapLookUpConverter {
+      const Index& _index;
+
+      MapLookUpConverter(const Index& index)
+        : _index(index) {}
+
+      std::string operator()(const Value& value) {
+        std::string label;
+        if (!_index.find(value, label)) {
+          throw FormatError("Item not found");
+        }
+        return label;
+      }
+    };
+
+    template <typename BGR, typename Index>
+    struct BpGraphNodeLookUpConverter {
+      const BGR& _graph;
+      const Index& _red_index;
+      const Index& _blue_index;
+
+      BpGraphNodeLookUpConverter(const BGR& graph, const Index& red_index,
+                                 const Index& blue_index)
+        : _graph(graph), _red_index(red_index), _blue_index(blue_index) {}
+
+      std::string operator()(const typename BGR::Node& node) {
+        if (node == INVALID) {
+          throw FormatError("Item not found");
+        }
+        return MapLookUpConverter<typename BGR::Node, Index>
+          (_graph.red(node) ? _red_index : _blue_index)(node);
+      }
+    };
+
+    template <typename Graph, typename Index>
+    struct GraphArcLookUpConverter {
+      const Graph& _graph;
+      const Index& _index;
+
+      GraphArcLookUpConverter(const Graph& graph, const Index& index)
+        : _graph(graph), _index(index) {}
+
+      std::string operator()(const typename Graph::Arc& val) {
+        std::string label;
+        if (!_index.find(val, label)) {
+          throw FormatError("Item not found");
+        }
+        return (_graph.direction(val) ? '+' : '-') + label;
+      }
+    };
+
+    // Sorts the items by their ids in linear time
+    template <typename Key, typename GR, typename Item>
+    void sortById(const GR& graph, std::vector<Item>& items) {
+      std::vector<Item> slots(graph.maxId(Key()) + 1, INVALID);
+      for (std::size_t i = 0; i < items.size(); ++i) {
+        slots[graph.id(static_cast<Key>(items[i]))] = items[i];
+      }
+      std::size_t k = 0;
+      for (std::size_t i = 0; i < slots.size(); ++i) {
+        if (slots[i] != INVALID) items[k++] = slots[i];
+      }
+    }
+
+    template <typename Writer, typename Item>
+    class LineFormatter {
+    public:
+      typedef void (Writer::*Format)(std::string&, const Item&);
+
+    private:
+      Writer& _writer;
+      Format _format;
+      const std::vector<Item>& _items;
+      std::vector<std::string>& _bufs;
+      int _first, _chunk;
+
+    public:
+      LineFormatter(Writer& writer, Format format,
+                    const std::vector<Item>& items,
+                    std::vector<std::string>& bufs, int first, int chunk)
+        : _writer(writer), _format(format), _items(items), _bufs(bufs),
+          _first(first), _chunk(chunk) {}
+
+      void operator()(int, int begin, int end) {
+        int size = _items.size();
+        for (int c = begin; c < end; ++c) {
+          std::string& buf = _bufs[c];
+          buf.clear();
+          int last = std::min(_first + (c + 1) * _chunk, size);
+          for (int i = _first + c * _chunk; i < last; ++i) {
+            (_writer.*_format)(buf, _items[i]);
+          }
+        }
+      }
+    };
+
+    // Writes the lines of the items to the stream. The lines are
+    // formatted into buffers, and if more threads are used, the
+    // buffers of consecutive chunks of items are filled in parallel.
+    // The output does not depend on the number of threads.
+    template <typename Writer, typename Item>
+    void writeLines(std::ostream& os, Writer& writer,
+                    void (Writer::*format)(std::string&, const Item&),
+                    const std::vector<Item>& items, int thread_num) {
+      const int chunk = 1024;
+      int size = items.size();
+      if (thread_num <= 1) {
+        std::string buf;
+        for (int i = 0; i < size; ++i) {
+          (writer.*format)(buf, items[i]);
+          if (buf.size() >= 65536) {
+            os.write(buf.data(), buf.size());
+            buf.clear();
+          }
+        }
+        os.write(buf.data(), buf.size());
+        return;
+      }
+      int round = 16 * thread_num;
+      std::vector<std::string> bufs(round);
+      for (int first = 0; first < size; first += round * chunk) {
+        int num = std::min(round, (size - first + chunk - 1) / chunk);
+        LineFormatter<Writer, Item>
+          formatter(writer, format, items, bufs, first, chunk);
+        bits::parallelFor(num, thread_num, formatter, 1);
+        for (int c = 0; c < num; ++c) {
+          os.write(bufs[c].data(), bufs[c].size());
+        }
+      }
+    }
+
     class Section {
     public:
       virtual ~Section() {}
@@ -433,6 +653,11 @@ namespace lemon {
   /// section to the stream. The output stream can be retrieved with
   /// the \c ostream() function, hence the second pass can append its
   /// output to the output of the first pass.
+  ///
+  /// When the writer is constructed with a file name ending in
+  /// \c ".gz" or \c ".zst", the output is compressed using
+  /// \ref CompressedOstream. The compressed file is completed when
+  /// the writer is destructed.
   template <typename DGR>
   class DigraphWriter {
   public:
@@ -452,9 +677,9 @@ namespace lemon {
     std::string _arcs_caption;
     std::string _attributes_caption;
 
-    typedef std::map<Node, std::string> NodeIndex;
+    typedef _writer_bits::LabelIndex<DGR, Node> NodeIndex;
     NodeIndex _node_index;
-    typedef std::map<Arc, std::string> ArcIndex;
+    typedef _writer_bits::LabelIndex<DGR, Arc> ArcIndex;
     ArcIndex _arc_index;
 
     typedef std::vector<std::pair<std::string,
@@ -472,6 +697,8 @@ namespace lemon {
     bool _skip_nodes;
     bool _skip_arcs;
 
+    int _thread_num;
+
   public:
 
     /// \brief Constructor
@@ -480,15 +707,17 @@ namespace lemon {
     /// output stream.
     DigraphWriter(const DGR& digraph, std::ostream& os = std::cout)
       : _os(&os), local_os(false), _digraph(digraph),
-        _skip_nodes(false), _skip_arcs(false) {}
+        _node_index(digraph), _arc_index(digraph),
+        _skip_nodes(false), _skip_arcs(false), _thread_num(1) {}
 
     /// \brief Constructor
     ///
     /// Construct a directed graph writer, which writes to the given
     /// output file.
     DigraphWriter(const DGR& digraph, const std::string& fn)
-      : _os(new std::ofstream(fn.c_str())), local_os(true), _digraph(digraph),
-        _skip_nodes(false), _skip_arcs(false) {
+      : _os(new CompressedOstream(fn)), local_os(true), _digraph(digraph),
+        _node_index(digraph), _arc_index(digraph),
+        _skip_nodes(false), _skip_arcs(false), _thread_num(1) {
       if (!(*_os)) {
         delete _os;
         throw IoError("Cannot write file", fn);
@@ -500,8 +729,9 @@ namespace lemon {
     /// Construct a directed graph writer, which writes to the given
     /// output file.
     DigraphWriter(const DGR& digraph, const char* fn)
-      : _os(new std::ofstream(fn)), local_os(true), _digraph(digraph),
-        _skip_nodes(false), _skip_arcs(false) {
+      : _os(new CompressedOstream(fn)), local_os(true), _digraph(digraph),
+        _node_index(digraph), _arc_index(digraph),
+        _skip_nodes(false), _skip_arcs(false), _thread_num(1) {
       if (!(*_os)) {
         delete _os;
         throw IoError("Cannot write file", fn);
@@ -544,7 +774,9 @@ namespace lemon {
 
     DigraphWriter(DigraphWriter& other)
       : _os(other._os), local_os(other.local_os), _digraph(other._digraph),
-        _skip_nodes(other._skip_nodes), _skip_arcs(other._skip_arcs) {
+        _node_index(other._digraph), _arc_index(other._digraph),
+        _skip_nodes(other._skip_nodes), _skip_arcs(other._skip_arcs),
+        _thread_num(other._thread_num) {
 
       other._os = 0;
       other.local_os = false;
@@ -648,7 +880,7 @@ namespace lemon {
     ///
     /// Add a node writing rule to the writer.
     DigraphWriter& node(const std::string& caption, const Node& node) {
-      typedef _writer_bits::MapLookUpConverter<Node> Converter;
+      typedef _writer_bits::MapLookUpConverter<Node, NodeIndex> Converter;
       Converter converter(_node_index);
       _writer_bits::ValueStorageBase* storage =
         new _writer_bits::ValueStorage<Node, Converter>(node, converter);
@@ -660,7 +892,7 @@ namespace lemon {
     ///
     /// Add an arc writing rule to writer.
     DigraphWriter& arc(const std::string& caption, const Arc& arc) {
-      typedef _writer_bits::MapLookUpConverter<Arc> Converter;
+      typedef _writer_bits::MapLookUpConverter<Arc, ArcIndex> Converter;
       Converter converter(_arc_index);
       _writer_bits::ValueStorageBase* storage =
         new _writer_bits::ValueStorage<Arc, Converter>(arc, converter);
@@ -751,33 +983,32 @@ namespace lemon {
       }
 
       if (label == 0) {
-        IdMap<DGR, Node> id_map(_digraph);
-        _writer_bits::MapLess<IdMap<DGR, Node> > id_less(id_map);
-        std::sort(nodes.begin(), nodes.end(), id_less);
+        _writer_bits::sortById<Node>(_digraph, nodes);
+        _node_index.useIds();
       } else {
         label->sort(nodes);
+        _node_index.useLabels();
       }
 
-      for (int i = 0; i < static_cast<int>(nodes.size()); ++i) {
-        Node n = nodes[i];
-        if (label == 0) {
-          std::ostringstream os;
-          os << _digraph.id(n);
-          _writer_bits::writeToken(*_os, os.str());
-          *_os << '\t';
-          _node_index.insert(std::make_pair(n, os.str()));
-        }
-        for (typename NodeMaps::iterator it = _node_maps.begin();
-             it != _node_maps.end(); ++it) {
-          std::string value = it->second->get(n);
-          _writer_bits::writeToken(*_os, value);
-          if (it->first == "label") {
-            _node_index.insert(std::make_pair(n, value));
-          }
-          *_os << '\t';
+      _writer_bits::writeLines(*_os, *this, &DigraphWriter::writeNode,
+                               nodes, _thread_num);
+    }
+
+    void writeNode(std::string& line, const Node& n) {
+      if (_node_index.ids()) {
+        _node_index.write(line, n);
+        line += '\t';
+      }
+      for (typename NodeMaps::iterator it = _node_maps.begin();
+           it != _node_maps.end(); ++it) {
+        std::string value = it->second->get(n);
+        _writer_bits::writeToken(line, value);
+        if (it->first == "label") {
+          _node_index.set(n, value);
         }
-        *_os << std::endl;
+        line += '\t';
       }
+      line += '\n';
     }
 
     void createNodeIndex() {
@@ -791,15 +1022,11 @@ namespace lemon {
       }
 
       if (label == 0) {
-        for (NodeIt n(_digraph); n != INVALID; ++n) {
-          std::ostringstream os;
-          os << _digraph.id(n);
-          _node_index.insert(std::make_pair(n, os.str()));
-        }
+        _node_index.useIds();
       } else {
+        _node_index.useLabels();
         for (NodeIt n(_digraph); n != INVALID; ++n) {
-          std::string value = label->get(n);
-          _node_index.insert(std::make_pair(n, value));
+          _node_index.set(n, label->get(n));
         }
       }
     }
@@ -836,39 +1063,36 @@ namespace lemon {
       }
 
       if (label == 0) {
-        IdMap<DGR, Arc> id_map(_digraph);
-        _writer_bits::MapLess<IdMap<DGR, Arc> > id_less(id_map);
-        std::sort(arcs.begin(), arcs.end(), id_less);
+        _writer_bits::sortById<Arc>(_digraph, arcs);
+        _arc_index.useIds();
       } else {
         label->sort(arcs);
+        _arc_index.useLabels();
       }
 
-      for (int i = 0; i < static_cast<int>(arcs.size()); ++i) {
-        Arc a = arcs[i];
-        _writer_bits::writeToken(*_os, _node_index.
-                                 find(_digraph.source(a))->second);
-        *_os << '\t';
-        _writer_bits::writeToken(*_os, _node_index.
-                                 find(_digraph.target(a))->second);
-        *_os << '\t';
-        if (label == 0) {
-          std::ostringstream os;
-          os << _digraph.id(a);
-          _writer_bits::writeToken(*_os, os.str());
-          *_os << '\t';
-          _arc_index.insert(std::make_pair(a, os.str()));
-        }
-        for (typename ArcMaps::iterator it = _arc_maps.begin();
-             it != _arc_maps.end(); ++it) {
-          std::string value = it->second->get(a);
-          _writer_bits::writeToken(*_os, value);
-          if (it->first == "label") {
-            _arc_index.insert(std::make_pair(a, value));
-          }
-          *_os << '\t';
+      _writer_bits::writeLines(*_os, *this, &DigraphWriter::writeArc,
+                               arcs, _thread_num);
+    }
+
+    void writeArc(std::string& line, const Arc& a) {
+      _node_index.write(line, _digraph.source(a));
+      line += '\t';
+      _node_index.write(line, _digraph.target(a));
+      line += '\t';
+      if (_arc_index.ids()) {
+        _arc_index.write(line, a);
+        line += '\t';
+      }
+      for (typename ArcMaps::iterator it = _arc_maps.begin();
+           it != _arc_maps.end(); ++it) {
+        std::string value = it->second->get(a);
+        _writer_bits::writeToken(line, value);
+        if (it->first == "label") {
+          _arc_index.set(a, value);
         }
-        *_os << std::endl;
+        line += '\t';
       }
+      line += '\n';
     }
 
     void createArcIndex() {
@@ -882,15 +1106,11 @@ namespace lemon {
       }
 
       if (label == 0) {
-        for (ArcIt a(_digraph); a != INVALID; ++a) {
-          std::ostringstream os;
-          os << _digraph.id(a);
-          _arc_index.insert(std::make_pair(a, os.str()));
-        }
+        _arc_index.useIds();
       } else {
+        _arc_index.useLabels();
         for (ArcIt a(_digraph); a != INVALID; ++a) {
-          std::string value = label->get(a);
-          _arc_index.insert(std::make_pair(a, value));
+          _arc_index.set(a, label->get(a));
         }
       }
     }
@@ -915,6 +1135,31 @@ namespace lemon {
     /// \name Execution of the Writer
     /// @{
 
+    /// \brief Set the number of threads used for formatting
+    ///
+    /// This function sets the number of threads used for converting
+    /// the map values of the nodes and arcs to strings.
+    /// The default value is 1, i.e. the formatting is done serially.
+    /// A value less than 1 means the number of available processors.
+    ///
+    /// The lines are formatted in chunks and they are written in the
+    /// original order, so the output does not depend on this setting.
+    /// However, the maps and the converters are called concurrently,
+    /// so they should not modify shared data.
+    /// If LEMON is built without threading support, this setting
+    /// has no effect.
+    DigraphWriter& threadNum(int num) {
+      _thread_num = num < 1 ? bits::hardwareThreadNum() : num;
+      return *this;
+    }
+
+    /// \brief Return the number of threads used for formatting
+    ///
+    /// This function returns the number of threads used for formatting.
+    int threadNum() const {
+      return _thread_num;
+    }
+
     /// \brief Start the batch processing
     ///
     /// This function starts the batch processing.
@@ -930,6 +1175,7 @@ namespace lemon {
         createArcIndex();
       }
       writeAttributes();
+      *_os << std::flush;
     }
 
     /// \brief Give back the stream of the writer
@@ -1049,9 +1295,9 @@ namespace lemon {
     std::string _edges_caption;
     std::string _attributes_caption;
 
-    typedef std::map<Node, std::string> NodeIndex;
+    typedef _writer_bits::LabelIndex<GR, Node> NodeIndex;
     NodeIndex _node_index;
-    typedef std::map<Edge, std::string> EdgeIndex;
+    typedef _writer_bits::LabelIndex<GR, Edge> EdgeIndex;
     EdgeIndex _edge_index;
 
     typedef std::vector<std::pair<std::string,
@@ -1069,6 +1315,8 @@ namespace lemon {
     bool _skip_nodes;
     bool _skip_edges;
 
+    int _thread_num;
+
   public:
 
     /// \brief Constructor
@@ -1077,15 +1325,17 @@ namespace lemon {
     /// given output stream.
     GraphWriter(const GR& graph, std::ostream& os = std::cout)
       : _os(&os), local_os(false), _graph(graph),
-        _skip_nodes(false), _skip_edges(false) {}
+        _node_index(graph), _edge_index(graph),
+        _skip_nodes(false), _skip_edges(false), _thread_num(1) {}
 
     /// \brief Constructor
     ///
     /// Construct a undirected graph writer, which writes to the given
     /// output file.
     GraphWriter(const GR& graph, const std::string& fn)
-      : _os(new std::ofstream(fn.c_str())), local_os(true), _graph(graph),
-        _skip_nodes(false), _skip_edges(false) {
+      : _os(new CompressedOstream(fn)), local_os(true), _graph(graph),
+        _node_index(graph), _edge_index(graph),
+        _skip_nodes(false), _skip_edges(false), _thread_num(1) {
       if (!(*_os)) {
         delete _os;
         throw IoError("Cannot write file", fn);
@@ -1097,8 +1347,9 @@ namespace lemon {
     /// Construct a undirected graph writer, which writes to the given
     /// output file.
     GraphWriter(const GR& graph, const char* fn)
-      : _os(new std::ofstream(fn)), local_os(true), _graph(graph),
-        _skip_nodes(false), _skip_edges(false) {
+      : _os(new CompressedOstream(fn)), local_os(true), _graph(graph),
+        _node_index(graph), _edge_index(graph),
+        _skip_nodes(false), _skip_edges(false), _thread_num(1) {
       if (!(*_os)) {
         delete _os;
         throw IoError("Cannot write file", fn);
@@ -1139,7 +1390,9 @@ namespace lemon {
 
     GraphWriter(GraphWriter& other)
       : _os(other._os), local_os(other.local_os), _graph(other._graph),
-        _skip_nodes(other._skip_nodes), _skip_edges(other._skip_edges) {
+        _node_index(other._graph), _edge_index(other._graph),
+        _skip_nodes(other._skip_nodes), _skip_edges(other._skip_edges),
+        _thread_num(other._thread_num) {
 
       other._os = 0;
       other.local_os = false;
@@ -1277,7 +1530,7 @@ namespace lemon {
     ///
     /// Add a node writing rule to the writer.
     GraphWriter& node(const std::string& caption, const Node& node) {
-      typedef _writer_bits::MapLookUpConverter<Node> Converter;
+      typedef _writer_bits::MapLookUpConverter<Node, NodeIndex> Converter;
       Converter converter(_node_index);
       _writer_bits::ValueStorageBase* storage =
         new _writer_bits::ValueStorage<Node, Converter>(node, converter);
@@ -1289,7 +1542,7 @@ namespace lemon {
     ///
     /// Add an edge writing rule to writer.
     GraphWriter& edge(const std::string& caption, const Edge& edge) {
-      typedef _writer_bits::MapLookUpConverter<Edge> Converter;
+      typedef _writer_bits::MapLookUpConverter<Edge, EdgeIndex> Converter;
       Converter converter(_edge_index);
       _writer_bits::ValueStorageBase* storage =
         new _writer_bits::ValueStorage<Edge, Converter>(edge, converter);
@@ -1301,7 +1554,8 @@ namespace lemon {
     ///
     /// Add an arc writing rule to writer.
     GraphWriter& arc(const std::string& caption, const Arc& arc) {
-      typedef _writer_bits::GraphArcLookUpConverter<GR> Converter;
+      typedef _writer_bits::GraphArcLookUpConverter<GR, EdgeIndex>
+        Converter;
       Converter converter(_graph, _edge_index);
       _writer_bits::ValueStorageBase* storage =
         new _writer_bits::ValueStorage<Arc, Converter>(arc, converter);
@@ -1392,33 +1646,32 @@ namespace lemon {
       }
 
       if (label == 0) {
-        IdMap<GR, Node> id_map(_graph);
-        _writer_bits::MapLess<IdMap<GR, Node> > id_less(id_map);
-        std::sort(nodes.begin(), nodes.end(), id_less);
+        _writer_bits::sortById<Node>(_graph, nodes);
+        _node_index.useIds();
       } else {
         label->sort(nodes);
+        _node_index.useLabels();
       }
 
-      for (int i = 0; i < static_cast<int>(nodes.size()); ++i) {
-        Node n = nodes[i];
-        if (label == 0) {
-          std::ostringstream os;
-          os << _graph.id(n);
-          _writer_bits::writeToken(*_os, os.str());
-          *_os << '\t';
-          _node_index.insert(std::make_pair(n, os.str()));
-        }
-        for (typename NodeMaps::iterator it = _node_maps.begin();
-             it != _node_maps.end(); ++it) {
-          std::string value = it->second->get(n);
-          _writer_bits::writeToken(*_os, value);
-          if (it->first == "label") {
-            _node_index.insert(std::make_pair(n, value));
-          }
-          *_os << '\t';
+      _writer_bits::writeLines(*_os, *this, &GraphWriter::writeNode,
+                               nodes, _thread_num);
+    }
+
+    void writeNode(std::string& line, const Node& n) {
+      if (_node_index.ids()) {
+        _node_index.write(line, n);
+        line += '\t';
+      }
+      for (typename NodeMaps::iterator it = _node_maps.begin();
+           it != _node_maps.end(); ++it) {
+        std::string value = it->second->get(n);
+        _writer_bits::writeToken(line, value);
+        if (it->first == "label") {
+          _node_index.set(n, value);
         }
-        *_os << std::endl;
+        line += '\t';
       }
+      line += '\n';
     }
 
     void createNodeIndex() {
@@ -1432,15 +1685,11 @@ namespace lemon {
       }
 
       if (label == 0) {
-        for (NodeIt n(_graph); n != INVALID; ++n) {
-          std::ostringstream os;
-          os << _graph.id(n);
-          _node_index.insert(std::make_pair(n, os.str()));
-        }
+        _node_index.useIds();
       } else {
+        _node_index.useLabels();
         for (NodeIt n(_graph); n != INVALID; ++n) {
-          std::string value = label->get(n);
-          _node_index.insert(std::make_pair(n, value));
+          _node_index.set(n, label->get(n));
         }
       }
     }
@@ -1477,39 +1726,36 @@ namespace lemon {
       }
 
       if (label == 0) {
-        IdMap<GR, Edge> id_map(_graph);
-        _writer_bits::MapLess<IdMap<GR, Edge> > id_less(id_map);
-        std::sort(edges.begin(), edges.end(), id_less);
+        _writer_bits::sortById<Edge>(_graph, edges);
+        _edge_index.useIds();
       } else {
         label->sort(edges);
+        _edge_index.useLabels();
       }
 
-      for (int i = 0; i < static_cast<int>(edges.size()); ++i) {
-        Edge e = edges[i];
-        _writer_bits::writeToken(*_os, _node_index.
-                                 find(_graph.u(e))->second);
-        *_os << '\t';
-        _writer_bits::writeToken(*_os, _node_index.
-                                 find(_graph.v(e))->second);
-        *_os << '\t';
-        if (label == 0) {
-          std::ostringstream os;
-          os << _graph.id(e);
-          _writer_bits::writeToken(*_os, os.str());
-          *_os << '\t';
-          _edge_index.insert(std::make_pair(e, os.str()));
-        }
-        for (typename EdgeMaps::iterator it = _edge_maps.begin();
-             it != _edge_maps.end(); ++it) {
-          std::string value = it->second->get(e);
-          _writer_bits::writeToken(*_os, value);
-          if (it->first == "label") {
-            _edge_index.insert(std::make_pair(e, value));
-          }
-          *_os << '\t';
+      _writer_bits::writeLines(*_os, *this, &GraphWriter::writeEdge,
+                               edges, _thread_num);
+    }
+
+    void writeEdge(std::string& line, const Edge& e) {
+      _node_index.write(line, _graph.u(e));
+      line += '\t';
+      _node_index.write(line, _graph.v(e));
+      line += '\t';
+      if (_edge_index.ids()) {
+        _edge_index.write(line, e);
+        line += '\t';
+      }
+      for (typename EdgeMaps::iterator it = _edge_maps.begin();
+           it != _edge_maps.end(); ++it) {
+        std::string value = it->second->get(e);
+        _writer_bits::writeToken(line, value);
+        if (it->first == "label") {
+          _edge_index.set(e, value);
         }
-        *_os << std::endl;
+        line += '\t';
       }
+      line += '\n';
     }
 
     void createEdgeIndex() {
@@ -1523,15 +1769,11 @@ namespace lemon {
       }
 
       if (label == 0) {
-        for (EdgeIt e(_graph); e != INVALID; ++e) {
-          std::ostringstream os;
-          os << _graph.id(e);
-          _edge_index.insert(std::make_pair(e, os.str()));
-        }
+        _edge_index.useIds();
       } else {
+        _edge_index.useLabels();
         for (EdgeIt e(_graph); e != INVALID; ++e) {
-          std::string value = label->get(e);
-          _edge_index.insert(std::make_pair(e, value));
+          _edge_index.set(e, label->get(e));
         }
       }
     }
@@ -1556,6 +1798,31 @@ namespace lemon {
     /// \name Execution of the Writer
     /// @{
 
+    /// \brief Set the number of threads used for formatting
+    ///
+    /// This function sets the number of threads used for converting
+    /// the map values of the nodes and edges to strings.
+    /// The default value is 1, i.e. the formatting is done serially.
+    /// A value less than 1 means the number of available processors.
+    ///
+    /// The lines are formatted in chunks and they are written in the
+    /// original order, so the output does not depend on this setting.
+    /// However, the maps and the converters are called concurrently,
+    /// so they should not modify shared data.
+    /// If LEMON is built without threading support, this setting
+    /// has no effect.
+    GraphWriter& threadNum(int num) {
+      _thread_num = num < 1 ? bits::hardwareThreadNum() : num;
+      return *this;
+    }
+
+    /// \brief Return the number of threads used for formatting
+    ///
+    /// This function returns the number of threads used for formatting.
+    int threadNum() const {
+      return _thread_num;
+    }
+
     /// \brief Start the batch processing
     ///
     /// This function starts the batch processing.
@@ -1571,6 +1838,7 @@ namespace lemon {
         createEdgeIndex();
       }
       writeAttributes();
+      *_os << std::flush;
     }
 
     /// \brief Give back the stream of the writer
@@ -1683,11 +1951,11 @@ namespace lemon {
     std::string _edges_caption;
     std::string _attributes_caption;
 
-    typedef std::map<Node, std::string> RedNodeIndex;
+    typedef _writer_bits::LabelIndex<BGR, Node> RedNodeIndex;
     RedNodeIndex _red_node_index;
-    typedef std::map<Node, std::string> BlueNodeIndex;
+    typedef _writer_bits::LabelIndex<BGR, Node> BlueNodeIndex;
     BlueNodeIndex _blue_node_index;
-    typedef std::map<Edge, std::string> EdgeIndex;
+    typedef _writer_bits::LabelIndex<BGR, Edge> EdgeIndex;
     EdgeIndex _edge_index;
 
     typedef std::vector<std::pair<std::string,
@@ -1708,6 +1976,8 @@ namespace lemon {
     bool _skip_nodes;
     bool _skip_edges;
 
+    int _thread_num;
+
   public:
 
     /// \brief Constructor
@@ -1716,15 +1986,17 @@ namespace lemon {
     /// output stream.
     BpGraphWriter(const BGR& graph, std::ostream& os = std::cout)
       : _os(&os), local_os(false), _graph(graph),
-        _skip_nodes(false), _skip_edges(false) {}
+        _red_node_index(graph), _blue_node_index(graph), _edge_index(graph),
+        _skip_nodes(false), _skip_edges(false), _thread_num(1) {}
 
     /// \brief Constructor
     ///
     /// Construct a bipartite graph writer, which writes to the given
     /// output file.
     BpGraphWriter(const BGR& graph, const std::string& fn)
-      : _os(new std::ofstream(fn.c_str())), local_os(true), _graph(graph),
-        _skip_nodes(false), _skip_edges(false) {
+      : _os(new CompressedOstream(fn)), local_os(true), _graph(graph),
+        _red_node_index(graph), _blue_node_index(graph), _edge_index(graph),
+        _skip_nodes(false), _skip_edges(false), _thread_num(1) {
       if (!(*_os)) {
         delete _os;
         throw IoError("Cannot write file", fn);
@@ -1736,8 +2008,9 @@ namespace lemon {
     /// Construct a bipartite graph writer, which writes to the given
     /// output file.
     BpGraphWriter(const BGR& graph, const char* fn)
-      : _os(new std::ofstream(fn)), local_os(true), _graph(graph),
-        _skip_nodes(false), _skip_edges(false) {
+      : _os(new CompressedOstream(fn)), local_os(true), _graph(graph),
+        _red_node_index(graph), _blue_node_index(graph), _edge_index(graph),
+        _skip_nodes(false), _skip_edges(false), _thread_num(1) {
       if (!(*_os)) {
         delete _os;
         throw IoError("Cannot write file", fn);
@@ -1784,7 +2057,10 @@ namespace lemon {
 
     BpGraphWriter(BpGraphWriter& other)
       : _os(other._os), local_os(other.local_os), _graph(other._graph),
-        _skip_nodes(other._skip_nodes), _skip_edges(other._skip_edges) {
+        _red_node_index(other._graph), _blue_node_index(other._graph),
+        _edge_index(other._graph),
+        _skip_nodes(other._skip_nodes), _skip_edges(other._skip_edges),
+        _thread_num(other._thread_num) {
 
       other._os = 0;
       other.local_os = false;
@@ -1982,9 +2258,9 @@ namespace lemon {
     ///
     /// Add a node writing rule to the writer.
     BpGraphWriter& node(const std::string& caption, const Node& node) {
-      typedef _writer_bits::DoubleMapLookUpConverter<
-        Node, RedNodeIndex, BlueNodeIndex> Converter;
-      Converter converter(_red_node_index, _blue_node_index);
+      typedef _writer_bits::BpGraphNodeLookUpConverter<
+        BGR, RedNodeIndex> Converter;
+      Converter converter(_graph, _red_node_index, _blue_node_index);
       _writer_bits::ValueStorageBase* storage =
         new _writer_bits::ValueStorage<Node, Converter>(node, converter);
       _attributes.push_back(std::make_pair(caption, storage));
@@ -1995,7 +2271,7 @@ namespace lemon {
     ///
     /// Add a red node writing rule to the writer.
     BpGraphWriter& redNode(const std::string& caption, const RedNode& node) {
-      typedef _writer_bits::MapLookUpConverter<Node> Converter;
+      typedef _writer_bits::MapLookUpConverter<Node, RedNodeIndex> Converter;
       Converter converter(_red_node_index);
       _writer_bits::ValueStorageBase* storage =
         new _writer_bits::ValueStorage<Node, Converter>(node, converter);
@@ -2007,7 +2283,8 @@ namespace lemon {
     ///
     /// Add a blue node writing rule to the writer.
     BpGraphWriter& blueNode(const std::string& caption, const BlueNode& node) {
-      typedef _writer_bits::MapLookUpConverter<Node> Converter;
+      typedef _writer_bits::MapLookUpConverter<Node, BlueNodeIndex>
+        Converter;
       Converter converter(_blue_node_index);
       _writer_bits::ValueStorageBase* storage =
         new _writer_bits::ValueStorage<Node, Converter>(node, converter);
@@ -2019,7 +2296,7 @@ namespace lemon {
     ///
     /// Add an edge writing rule to writer.
     BpGraphWriter& edge(const std::string& caption, const Edge& edge) {
-      typedef _writer_bits::MapLookUpConverter<Edge> Converter;
+      typedef _writer_bits::MapLookUpConverter<Edge, EdgeIndex> Converter;
       Converter converter(_edge_index);
       _writer_bits::ValueStorageBase* storage =
         new _writer_bits::ValueStorage<Edge, Converter>(edge, converter);
@@ -2031,7 +2308,8 @@ namespace lemon {
     ///
     /// Add an arc writing rule to writer.
     BpGraphWriter& arc(const std::string& caption, const Arc& arc) {
-      typedef _writer_bits::GraphArcLookUpConverter<BGR> Converter;
+      typedef _writer_bits::GraphArcLookUpConverter<BGR, EdgeIndex>
+        Converter;
       Converter converter(_graph, _edge_index);
       _writer_bits::ValueStorageBase* storage =
         new _writer_bits::ValueStorage<Arc, Converter>(arc, converter);
@@ -2125,32 +2403,51 @@ namespace lemon {
       }
 
       if (label == 0) {
-        IdMap<BGR, Node> id_map(_graph);
-        _writer_bits::MapLess<IdMap<BGR, Node> > id_less(id_map);
-        std::sort(nodes.begin(), nodes.end(), id_less);
+        _writer_bits::sortById<Node>(_graph, nodes);
+        _red_node_index.useIds();
       } else {
         label->sort(nodes);
+        _red_node_index.useLabels();
       }
 
-      for (int i = 0; i < static_cast<int>(nodes.size()); ++i) {
-        RedNode n = nodes[i];
-        if (label == 0) {
-          std::ostringstream os;
-          os << _graph.id(static_cast<Node>(n));
-          _writer_bits::writeToken(*_os, os.str());
-          *_os << '\t';
-          _red_node_index.insert(std::make_pair(n, os.str()));
+      _writer_bits::writeLines(*_os, *this, &BpGraphWriter::writeRedNode,
+                               nodes, _thread_num);
+    }
+
+    void writeRedNode(std::string& line, const RedNode& n) {
+      if (_red_node_index.ids()) {
+        _red_node_index.write(line, n);
+        line += '\t';
+      }
+      for (typename RedNodeMaps::iterator it = _red_node_maps.begin();
+           it != _red_node_maps.end(); ++it) {
+        std::string value = it->second->get(n);
+        _writer_bits::writeToken(line, value);
+        if (it->first == "label") {
+          _red_node_index.set(n, value);
         }
-        for (typename RedNodeMaps::iterator it = _red_node_maps.begin();
-             it != _red_node_maps.end(); ++it) {
-          std::string value = it->second->get(n);
-          _writer_bits::writeToken(*_os, value);
-          if (it->first == "label") {
-            _red_node_index.insert(std::make_pair(n, value));
-          }
-          *_os << '\t';
+        line += '\t';
+      }
+      line += '\n';
+    }
+
+    void createRedNodeIndex() {
+      _writer_bits::MapStorageBase<RedNode>* label = 0;
+      for (typename RedNodeMaps::iterator it = _red_node_maps.begin();
+           it != _red_node_maps.end(); ++it) {
+        if (it->first == "label") {
+          label = it->second;
+          break;
+        }
+      }
+
+      if (label == 0) {
+        _red_node_index.useIds();
+      } else {
+        _red_node_index.useLabels();
+        for (RedNodeIt n(_graph); n != INVALID; ++n) {
+          _red_node_index.set(n, label->get(n));
         }
-        *_os << std::endl;
       }
     }
 
@@ -2185,57 +2482,32 @@ namespace lemon {
       }
 
       if (label == 0) {
-        IdMap<BGR, Node> id_map(_graph);
-        _writer_bits::MapLess<IdMap<BGR, Node> > id_less(id_map);
-        std::sort(nodes.begin(), nodes.end(), id_less);
+        _writer_bits::sortById<Node>(_graph, nodes);
+        _blue_node_index.useIds();
       } else {
         label->sort(nodes);
+        _blue_node_index.useLabels();
       }
 
-      for (int i = 0; i < static_cast<int>(nodes.size()); ++i) {
-        BlueNode n = nodes[i];
-        if (label == 0) {
-          std::ostringstream os;
-          os << _graph.id(static_cast<Node>(n));
-          _writer_bits::writeToken(*_os, os.str());
-          *_os << '\t';
-          _blue_node_index.insert(std::make_pair(n, os.str()));
-        }
-        for (typename BlueNodeMaps::iterator it = _blue_node_maps.begin();
-             it != _blue_node_maps.end(); ++it) {
-          std::string value = it->second->get(n);
-          _writer_bits::writeToken(*_os, value);
-          if (it->first == "label") {
-            _blue_node_index.insert(std::make_pair(n, value));
-          }
-          *_os << '\t';
-        }
-        *_os << std::endl;
-      }
+      _writer_bits::writeLines(*_os, *this, &BpGraphWriter::writeBlueNode,
+                               nodes, _thread_num);
     }
 
-    void createRedNodeIndex() {
-      _writer_bits::MapStorageBase<RedNode>* label = 0;
-      for (typename RedNodeMaps::iterator it = _red_node_maps.begin();
-           it != _red_node_maps.end(); ++it) {
-        if (it->first == "label") {
-          label = it->second;
-          break;
-        }
+    void writeBlueNode(std::string& line, const BlueNode& n) {
+      if (_blue_node_index.ids()) {
+        _blue_node_index.write(line, n);
+        line += '\t';
       }
-
-      if (label == 0) {
-        for (RedNodeIt n(_graph); n != INVALID; ++n) {
-          std::ostringstream os;
-          os << _graph.id(n);
-          _red_node_index.insert(std::make_pair(n, os.str()));
-        }
-      } else {
-        for (RedNodeIt n(_graph); n != INVALID; ++n) {
-          std::string value = label->get(n);
-          _red_node_index.insert(std::make_pair(n, value));
+      for (typename BlueNodeMaps::iterator it = _blue_node_maps.begin();
+           it != _blue_node_maps.end(); ++it) {
+        std::string value = it->second->get(n);
+        _writer_bits::writeToken(line, value);
+        if (it->first == "label") {
+          _blue_node_index.set(n, value);
         }
+        line += '\t';
       }
+      line += '\n';
     }
 
     void createBlueNodeIndex() {
@@ -2249,15 +2521,11 @@ namespace lemon {
       }
 
       if (label == 0) {
-        for (BlueNodeIt n(_graph); n != INVALID; ++n) {
-          std::ostringstream os;
-          os << _graph.id(n);
-          _blue_node_index.insert(std::make_pair(n, os.str()));
-        }
+        _blue_node_index.useIds();
       } else {
+        _blue_node_index.useLabels();
         for (BlueNodeIt n(_graph); n != INVALID; ++n) {
-          std::string value = label->get(n);
-          _blue_node_index.insert(std::make_pair(n, value));
+          _blue_node_index.set(n, label->get(n));
         }
       }
     }
@@ -2294,39 +2562,36 @@ namespace lemon {
       }
 
       if (label == 0) {
-        IdMap<BGR, Edge> id_map(_graph);
-        _writer_bits::MapLess<IdMap<BGR, Edge> > id_less(id_map);
-        std::sort(edges.begin(), edges.end(), id_less);
+        _writer_bits::sortById<Edge>(_graph, edges);
+        _edge_index.useIds();
       } else {
         label->sort(edges);
+        _edge_index.useLabels();
       }
 
-      for (int i = 0; i < static_cast<int>(edges.size()); ++i) {
-        Edge e = edges[i];
-        _writer_bits::writeToken(*_os, _red_node_index.
-                                 find(_graph.redNode(e))->second);
-        *_os << '\t';
-        _writer_bits::writeToken(*_os, _blue_node_index.
-                                 find(_graph.blueNode(e))->second);
-        *_os << '\t';
-        if (label == 0) {
-          std::ostringstream os;
-          os << _graph.id(e);
-          _writer_bits::writeToken(*_os, os.str());
-          *_os << '\t';
-          _edge_index.insert(std::make_pair(e, os.str()));
-        }
-        for (typename EdgeMaps::iterator it = _edge_maps.begin();
-             it != _edge_maps.end(); ++it) {
-          std::string value = it->second->get(e);
-          _writer_bits::writeToken(*_os, value);
-          if (it->first == "label") {
-            _edge_index.insert(std::make_pair(e, value));
-          }
-          *_os << '\t';
+      _writer_bits::writeLines(*_os, *this, &BpGraphWriter::writeEdge,
+                               edges, _thread_num);
+    }
+
+    void writeEdge(std::string& line, const Edge& e) {
+      _red_node_index.write(line, _graph.redNode(e));
+      line += '\t';
+      _blue_node_index.write(line, _graph.blueNode(e));
+      line += '\t';
+      if (_edge_index.ids()) {
+        _edge_index.write(line, e);
+        line += '\t';
+      }
+      for (typename EdgeMaps::iterator it = _edge_maps.begin();
+           it != _edge_maps.end(); ++it) {
+        std::string value = it->second->get(e);
+        _writer_bits::writeToken(line, value);
+        if (it->first == "label") {
+          _edge_index.set(e, value);
         }
-        *_os << std::endl;
+        line += '\t';
       }
+      line += '\n';
     }
 
     void createEdgeIndex() {
@@ -2340,15 +2605,11 @@ namespace lemon {
       }
 
       if (label == 0) {
-        for (EdgeIt e(_graph); e != INVALID; ++e) {
-          std::ostringstream os;
-          os << _graph.id(e);
-          _edge_index.insert(std::make_pair(e, os.str()));
-        }
+        _edge_index.useIds();
       } else {
+        _edge_index.useLabels();
         for (EdgeIt e(_graph); e != INVALID; ++e) {
-          std::string value = label->get(e);
-          _edge_index.insert(std::make_pair(e, value));
+          _edge_index.set(e, label->get(e));
         }
       }
     }
@@ -2373,6 +2634,31 @@ namespace lemon {
     /// \name Execution of the Writer
     /// @{
 
+    /// \brief Set the number of threads used for formatting
+    ///
+    /// This function sets the number of threads used for converting
+    /// the map values of the nodes and edges to strings.
+    /// The default value is 1, i.e. the formatting is done serially.
+    /// A value less than 1 means the number of available processors.
+    ///
+    /// The lines are formatted in chunks and they are written in the
+    /// original order, so the output does not depend on this setting.
+    /// However, the maps and the converters are called concurrently,
+    /// so they should not modify shared data.
+    /// If LEMON is built without threading support, this setting
+    /// has no effect.
+    BpGraphWriter& threadNum(int num) {
+      _thread_num = num < 1 ? bits::hardwareThreadNum() : num;
+      return *this;
+    }
+
+    /// \brief Return the number of threads used for formatting
+    ///
+    /// This function returns the number of threads used for formatting.
+    int threadNum() const {
+      return _thread_num;
+    }
+
     /// \brief Start the batch processing
     ///
     /// This function starts the batch processing.
@@ -2390,6 +2676,7 @@ namespace lemon {
         createEdgeIndex();
       }
       writeAttributes();
+      *_os << std::flush;
     }
 
     /// \brief Give back the stream of the writer
@@ -2501,7 +2788,7 @@ namespace lemon {
     ///
     /// Construct a section writer, which writes into the given file.
     SectionWriter(const std::string& fn)
-      : _os(new std::ofstream(fn.c_str())), local_os(true) {
+      : _os(new CompressedOstream(fn)), local_os(true) {
       if (!(*_os)) {
         delete _os;
         throw IoError("Cannot write file", fn);
@@ -2512,7 +2799,7 @@ namespace lemon {
     ///
     /// Construct a section writer, which writes into the given file.
     SectionWriter(const char* fn)
-      : _os(new std::ofstream(fn)), local_os(true) {
+      : _os(new CompressedOstream(fn)), local_os(true) {
       if (!(*_os)) {
         delete _os;
         throw IoError("Cannot write file", fn);
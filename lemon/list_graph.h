@@ -26,6 +26,7 @@
 #include <lemon/core.h>
 #include <lemon/error.h>
 #include <lemon/bits/graph_extender.h>
+#include <lemon/bits/vector_utils.h>
 
 #include <vector>
 #include <list>
@@ -306,6 +307,53 @@ namespace lemon {
       _nodes[n.id].first_out = e.id;
     }
 
+  protected:
+
+    static int renumbered(const std::vector<Index>& ids, int id) {
+      return id == -1 ? -1 : static_cast<int>(ids[id]);
+    }
+
+    // Renumbers the nodes and the arcs in the order of their iteration
+    void compact(std::vector<Index>& node_ids, std::vector<Index>& arc_ids) {
+      node_ids.assign(_nodes.size(), -1);
+      arc_ids.assign(_arcs.size(), -1);
+      int node_num = 0, arc_num = 0;
+      for (int n = first_node; n != -1; n = _nodes[n].next) {
+        node_ids[n] = node_num++;
+      }
+      for (int n = first_node; n != -1; n = _nodes[n].next) {
+        for (int a = _nodes[n].first_out; a != -1; a = _arcs[a].next_out) {
+          arc_ids[a] = arc_num++;
+        }
+      }
+
+      std::vector<NodeT> nodes(node_num);
+      for (int n = first_node; n != -1; n = _nodes[n].next) {
+        NodeT& node = nodes[node_ids[n]];
+        node.first_in = renumbered(arc_ids, _nodes[n].first_in);
+        node.first_out = renumbered(arc_ids, _nodes[n].first_out);
+        node.prev = renumbered(node_ids, _nodes[n].prev);
+        node.next = renumbered(node_ids, _nodes[n].next);
+      }
+      std::vector<ArcT> arcs(arc_num);
+      for (int a = 0; a < int(_arcs.size()); ++a) {
+        if (arc_ids[a] == -1) continue;
+        ArcT& arc = arcs[arc_ids[a]];
+        arc.source = renumbered(node_ids, _arcs[a].source);
+        arc.target = renumbered(node_ids, _arcs[a].target);
+        arc.prev_in = renumbered(arc_ids, _arcs[a].prev_in);
+        arc.prev_out = renumbered(arc_ids, _arcs[a].prev_out);
+        arc.next_in = renumbered(arc_ids, _arcs[a].next_in);
+        arc.next_out = renumbered(arc_ids, _arcs[a].next_out);
+      }
+
+      _nodes.swap(nodes);
+      _arcs.swap(arcs);
+      first_node = renumbered(node_ids, first_node);
+      first_free_node = -1;
+      first_free_arc = -1;
+    }
+
   };
 
   typedef DigraphExtender<ListDigraphBase> ExtendedListDigraphBase;
@@ -337,6 +385,7 @@ namespace lemon {
     /// \brief Assignment of a digraph to another one is \e not allowed.
     /// Use DigraphCopy instead.
     void operator=(const ListDigraph &) {}
+
   public:
 
     /// Constructor
@@ -360,6 +409,65 @@ namespace lemon {
       return Parent::addArc(s, t);
     }
 
+    ///Add several new nodes to the digraph.
+
+    ///This function adds \c n new nodes to the digraph and stores them
+    ///in the given vector (its previous content is discarded).
+    ///It is faster than calling addNode() \c n times, since the storage
+    ///of the digraph is enlarged at most once and the maps of the digraph
+    ///are notified only once about all the new nodes.
+    void addNodes(Index n, std::vector<Node>& nodes) {
+      Index k = n;
+      for (int i = first_free_node; i != -1 && k > 0; i = _nodes[i].next) {
+        --k;
+      }
+      bits::reserveMore(_nodes, k);
+      Parent::addNodes(n, nodes);
+    }
+
+    ///Add several new nodes to the digraph.
+
+    ///This is an overloaded version of addNodes(), which does not
+    ///store the new nodes.
+    void addNodes(Index n) {
+      std::vector<Node> nodes;
+      addNodes(n, nodes);
+    }
+
+    ///Add several new arcs to the digraph.
+
+    ///This function adds new arcs to the digraph and stores them in the
+    ///given vector (its previous content is discarded).
+    ///The arcs must be given in the range <tt>[begin, end)</tt>
+    ///specified by STL compatible iterators whose \c value_type is
+    ///<tt>std::pair<Node,Node></tt>, where the first node is the source
+    ///and the second node is the target of an arc.
+    ///It is faster than calling addArc() for each arc, since the storage
+    ///of the digraph is enlarged at most once and the maps of the digraph
+    ///are notified only once about all the new arcs.
+    ///The range is traversed only once, so input iterators can also be
+    ///used, but then the size of the storage is not known in advance.
+    template <typename ArcListIterator>
+    void addArcs(ArcListIterator begin, ArcListIterator end,
+                 std::vector<Arc>& arcs) {
+      std::ptrdiff_t k = bits::rangeSize(begin, end);
+      for (int i = first_free_arc; i != -1 && k > 0; i = _arcs[i].next_in) {
+        --k;
+      }
+      bits::reserveMore(_arcs, k);
+      Parent::addArcs(begin, end, arcs);
+    }
+
+    ///Add several new arcs to the digraph.
+
+    ///This is an overloaded version of addArcs(), which does not
+    ///store the new arcs.
+    template <typename ArcListIterator>
+    void addArcs(ArcListIterator begin, ArcListIterator end) {
+      std::vector<Arc> arcs;
+      addArcs(begin, end, arcs);
+    }
+
     ///\brief Erase a node from the digraph.
     ///
     ///This function erases the given node along with its outgoing and
@@ -544,6 +652,43 @@ namespace lemon {
     /// \sa reserveNode()
     void reserveArc(int m) { _arcs.reserve(m); };
 
+    /// \brief Renumber the nodes and the arcs densely.
+    ///
+    /// This function renumbers the nodes and the arcs of the digraph
+    /// so that their ids form the ranges <tt>[0..nodeNum()-1]</tt> and
+    /// <tt>[0..arcNum()-1]</tt>, and the incidence lists are stored
+    /// in the order of their iteration. It releases the storage of the
+    /// erased items and makes the traversal of the digraph cache
+    /// friendly again after many deletions.
+    ///
+    /// The maps of the digraph are remapped, they keep their values.
+    /// The old id of each node and arc is mapped to its new id by
+    /// \c nodeIds and \c arcIds, respectively, the ids of the erased
+    /// items are mapped to -1.
+    ///
+    /// \warning All \c Node and \c Arc objects (including the ones
+    /// stored as map values) are invalidated. They can be converted
+    /// using e.g. <tt>nodeFromId(nodeIds[id(node)])</tt>.
+    /// \warning This function invalidates all snapshots of the digraph,
+    /// they are detached (see \ref Snapshot::valid() "valid()").
+    /// \note The observers that do not support renumbering (e.g. the
+    /// ones of the algorithms) are cleared and built again.
+    void compact(std::vector<Index>& nodeIds, std::vector<Index>& arcIds) {
+      Parent::compact(nodeIds, arcIds);
+      notifier(Node()).renumber(nodeIds);
+      notifier(Arc()).renumber(arcIds);
+    }
+
+    /// \brief Renumber the nodes and the arcs densely.
+    ///
+    /// This function renumbers the nodes and the arcs of the digraph
+    /// densely. For more information, see
+    /// \ref compact(std::vector<Index>&, std::vector<Index>&) "compact()".
+    void compact() {
+      std::vector<Index> node_ids, arc_ids;
+      compact(node_ids, arc_ids);
+    }
+
     /// \brief Class to make a snapshot of the digraph and restore
     /// it later.
     ///
@@ -612,6 +757,9 @@ namespace lemon {
             snapshot.eraseNode(node);
           }
         }
+        virtual void renumber(const std::vector<Index>&) {
+          snapshot.renumberNodes();
+        }
 
         Snapshot& snapshot;
       };
@@ -662,6 +810,9 @@ namespace lemon {
             snapshot.eraseArc(arc);
           }
         }
+        virtual void renumber(const std::vector<Index>&) {
+          snapshot.renumberArcs();
+        }
 
         Snapshot& snapshot;
       };
@@ -689,6 +840,11 @@ namespace lemon {
           added_nodes.erase(it);
         }
       }
+      void renumberNodes() {
+        clear();
+        arc_observer_proxy.detach();
+        throw NodeNotifier::ImmediateDetach();
+      }
 
       void addArc(const Arc& arc) {
         added_arcs.push_front(arc);
@@ -704,6 +860,11 @@ namespace lemon {
           added_arcs.erase(it);
         }
       }
+      void renumberArcs() {
+        clear();
+        node_observer_proxy.detach();
+        throw ArcNotifier::ImmediateDetach();
+      }
 
       void attach(ListDigraph &_digraph) {
         digraph = &_digraph;
@@ -1170,6 +1331,55 @@ namespace lemon {
       _nodes[n.id].first_out = ((2 * e.id) | 1);
     }
 
+  protected:
+
+    static int renumbered(const std::vector<Index>& ids, int id) {
+      return id == -1 ? -1 : static_cast<int>(ids[id]);
+    }
+
+    // Renumbers the nodes and the edges in the order of their iteration
+    void compact(std::vector<Index>& node_ids, std::vector<Index>& edge_ids,
+                 std::vector<Index>& arc_ids) {
+      node_ids.assign(_nodes.size(), -1);
+      edge_ids.assign(_arcs.size() / 2, -1);
+      arc_ids.assign(_arcs.size(), -1);
+      int node_num = 0, edge_num = 0;
+      for (int n = first_node; n != -1; n = _nodes[n].next) {
+        node_ids[n] = node_num++;
+      }
+      for (int n = first_node; n != -1; n = _nodes[n].next) {
+        for (int a = _nodes[n].first_out; a != -1; a = _arcs[a].next_out) {
+          if ((a & 1) == 1) {
+            arc_ids[a - 1] = 2 * edge_num;
+            arc_ids[a] = 2 * edge_num + 1;
+            edge_ids[a / 2] = edge_num++;
+          }
+        }
+      }
+
+      std::vector<NodeT> nodes(node_num);
+      for (int n = first_node; n != -1; n = _nodes[n].next) {
+        NodeT& node = nodes[node_ids[n]];
+        node.first_out = renumbered(arc_ids, _nodes[n].first_out);
+        node.prev = renumbered(node_ids, _nodes[n].prev);
+        node.next = renumbered(node_ids, _nodes[n].next);
+      }
+      std::vector<ArcT> arcs(2 * edge_num);
+      for (int a = 0; a < int(_arcs.size()); ++a) {
+        if (arc_ids[a] == -1) continue;
+        ArcT& arc = arcs[arc_ids[a]];
+        arc.target = renumbered(node_ids, _arcs[a].target);
+        arc.prev_out = renumbered(arc_ids, _arcs[a].prev_out);
+        arc.next_out = renumbered(arc_ids, _arcs[a].next_out);
+      }
+
+      _nodes.swap(nodes);
+      _arcs.swap(arcs);
+      first_node = renumbered(node_ids, first_node);
+      first_free_node = -1;
+      first_free_arc = -1;
+    }
+
   };
 
   typedef GraphExtender<ListGraphBase> ExtendedListGraphBase;
@@ -1356,6 +1566,44 @@ namespace lemon {
     /// \sa reserveNode()
     void reserveEdge(int m) { _arcs.reserve(2 * m); };
 
+    /// \brief Renumber the nodes and the edges densely.
+    ///
+    /// This function renumbers the nodes and the edges of the graph
+    /// so that their ids form the ranges <tt>[0..nodeNum()-1]</tt> and
+    /// <tt>[0..edgeNum()-1]</tt>, and the incidence lists are stored
+    /// in the order of their iteration. The two arcs of an edge keep
+    /// the ids <tt>2*id(edge)</tt> and <tt>2*id(edge)+1</tt>.
+    ///
+    /// The maps of the graph are remapped, they keep their values.
+    /// The old id of each node and edge is mapped to its new id by
+    /// \c nodeIds and \c edgeIds, respectively, the ids of the erased
+    /// items are mapped to -1.
+    ///
+    /// \warning All \c Node, \c Edge and \c Arc objects (including the
+    /// ones stored as map values) are invalidated. They can be converted
+    /// using e.g. <tt>nodeFromId(nodeIds[id(node)])</tt>.
+    /// \warning This function invalidates all snapshots of the graph,
+    /// they are detached (see \ref Snapshot::valid() "valid()").
+    /// \note The observers that do not support renumbering (e.g. the
+    /// ones of the algorithms) are cleared and built again.
+    void compact(std::vector<Index>& nodeIds, std::vector<Index>& edgeIds) {
+      std::vector<Index> arc_ids;
+      Parent::compact(nodeIds, edgeIds, arc_ids);
+      notifier(Node()).renumber(nodeIds);
+      notifier(Edge()).renumber(edgeIds);
+      notifier(Arc()).renumber(arc_ids);
+    }
+
+    /// \brief Renumber the nodes and the edges densely.
+    ///
+    /// This function renumbers the nodes and the edges of the graph
+    /// densely. For more information, see
+    /// \ref compact(std::vector<Index>&, std::vector<Index>&) "compact()".
+    void compact() {
+      std::vector<Index> node_ids, edge_ids;
+      compact(node_ids, edge_ids);
+    }
+
     /// \brief Class to make a snapshot of the graph and restore
     /// it later.
     ///
@@ -1424,6 +1672,9 @@ namespace lemon {
             snapshot.eraseNode(node);
           }
         }
+        virtual void renumber(const std::vector<Index>&) {
+          snapshot.renumberNodes();
+        }
 
         Snapshot& snapshot;
       };
@@ -1474,6 +1725,9 @@ namespace lemon {
             snapshot.eraseEdge(edge);
           }
         }
+        virtual void renumber(const std::vector<Index>&) {
+          snapshot.renumberEdges();
+        }
 
         Snapshot& snapshot;
       };
@@ -1501,6 +1755,11 @@ namespace lemon {
           added_nodes.erase(it);
         }
       }
+      void renumberNodes() {
+        clear();
+        edge_observer_proxy.detach();
+        throw NodeNotifier::ImmediateDetach();
+      }
 
       void addEdge(const Edge& edge) {
         added_edges.push_front(edge);
@@ -1516,6 +1775,11 @@ namespace lemon {
           added_edges.erase(it);
         }
       }
+      void renumberEdges() {
+        clear();
+        node_observer_proxy.detach();
+        throw EdgeNotifier::ImmediateDetach();
+      }
 
       void attach(ListGraph &_graph) {
         graph = &_graph;
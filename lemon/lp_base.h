@@ -22,6 +22,7 @@
 #include<iostream>
 #include<vector>
 #include<map>
+#include<utility>
 #include<limits>
 #include<lemon/math.h>
 
@@ -365,6 +366,14 @@ namespace lemon {
     ///double c=*e;
     ///\endcode
     ///
+    ///The terms are stored in a flat array. The operators above and
+    ///add() append the new terms to it and the terms of the same column
+    ///are merged only when it is needed (e.g. when the expression is
+    ///iterated or added to the LP) or when finalize() is called, so
+    ///building large expressions does not allocate memory per term.
+    ///\note The references returned by \ref operator[]() may be
+    ///invalidated when further terms are added to the expression.
+    ///
     ///\sa Constr
     class Expr {
       friend class LpBase;
@@ -376,7 +385,7 @@ namespace lemon {
 
     protected:
       Value const_comp;
-      std::map<int, Value> comps;
+      _solver_bits::SparseVector<Value> comps;
 
     public:
       typedef True SolverExpr;
@@ -390,8 +399,7 @@ namespace lemon {
       /// Construct an expression, which has a term with \c c variable
       /// and 1.0 coefficient.
       Expr(const Col &c) : const_comp(0) {
-        typedef std::map<int, Value>::value_type pair_type;
-        comps.insert(pair_type(id(c), 1));
+        comps.add(id(c), 1);
       }
       /// Construct an expression from a constant
 
@@ -400,22 +408,35 @@ namespace lemon {
       Expr(const Value &v) : const_comp(v) {}
       /// Returns the coefficient of the column
       Value operator[](const Col& c) const {
-        std::map<int, Value>::const_iterator it=comps.find(id(c));
-        if (it != comps.end()) {
-          return it->second;
-        } else {
-          return 0;
-        }
+        return comps.value(id(c));
       }
       /// Returns the coefficient of the column
       Value& operator[](const Col& c) {
         return comps[id(c)];
       }
+      /// Adds a value to the coefficient of the column
+
+      /// Adds \c v to the coefficient of the column in amortized
+      /// constant time. The new term is stored separately and it is
+      /// merged with the other terms of the column by finalize() or
+      /// by the first function that needs the merged form, so this
+      /// is the fast way of building large expressions.
+      void add(const Col& c, const Value &v) {
+        comps.add(id(c), v);
+      }
+      /// Merges the terms of the same column
+
+      /// Sorts the terms and merges the terms of the same column.
+      /// It is called automatically when it is needed, but calling
+      /// it explicitly after building the expression with add() makes
+      /// the later read-only accesses cheaper.
+      void finalize() {
+        comps.normalize();
+      }
       /// Sets the coefficient of the column
       void set(const Col &c, const Value &v) {
         if (v != 0.0) {
-          typedef std::map<int, Value>::value_type pair_type;
-          comps.insert(pair_type(id(c), v));
+          comps.set(id(c), v);
         } else {
           comps.erase(id(c));
         }
@@ -428,16 +449,12 @@ namespace lemon {
       /// not exceed \c epsilon. It also sets to zero the constant
       /// component, if it does not exceed epsilon in absolute value.
       void simplify(Value epsilon = 0.0) {
-        std::map<int, Value>::iterator it=comps.begin();
-        while (it != comps.end()) {
-          std::map<int, Value>::iterator jt=it;
-          ++jt;
-          if (std::fabs((*it).second) <= epsilon) comps.erase(it);
-          it=jt;
-        }
+        comps.simplify(epsilon);
         if (std::fabs(const_comp) <= epsilon) const_comp = 0;
       }
 
+      // It merges and removes the stored terms in spite of being const,
+      // so it must not be called concurrently with other accesses
       void simplify(Value epsilon = 0.0) const {
         const_cast<Expr*>(this)->simplify(epsilon);
       }
@@ -448,35 +465,32 @@ namespace lemon {
         const_comp=0;
       }
 
+      ///Reserves storage for the given number of terms.
+      void reserve(int n) {
+        comps.reserve(n);
+      }
+
       ///Compound assignment
       Expr &operator+=(const Expr &e) {
-        for (std::map<int, Value>::const_iterator it=e.comps.begin();
-             it!=e.comps.end(); ++it)
-          comps[it->first]+=it->second;
+        comps.add(e.comps, 1);
         const_comp+=e.const_comp;
         return *this;
       }
       ///Compound assignment
       Expr &operator-=(const Expr &e) {
-        for (std::map<int, Value>::const_iterator it=e.comps.begin();
-             it!=e.comps.end(); ++it)
-          comps[it->first]-=it->second;
+        comps.add(e.comps, -1);
         const_comp-=e.const_comp;
         return *this;
       }
       ///Multiply with a constant
       Expr &operator*=(const Value &v) {
-        for (std::map<int, Value>::iterator it=comps.begin();
-             it!=comps.end(); ++it)
-          it->second*=v;
+        comps.scale(v);
         const_comp*=v;
         return *this;
       }
       ///Division with a constant
       Expr &operator/=(const Value &c) {
-        for (std::map<int, Value>::iterator it=comps.begin();
-             it!=comps.end(); ++it)
-          it->second/=c;
+        comps.divide(c);
         const_comp/=c;
         return *this;
       }
@@ -493,7 +507,7 @@ namespace lemon {
       class CoeffIt {
       private:
 
-        std::map<int, Value>::iterator _it, _end;
+        _solver_bits::SparseVector<Value>::iterator _it, _end;
 
       public:
 
@@ -538,7 +552,15 @@ namespace lemon {
       class ConstCoeffIt {
       private:
 
-        std::map<int, Value>::const_iterator _it, _end;
+        // The terms of an expression that is not in canonical form
+        // are merged in a private copy, the expression is not modified
+        _solver_bits::SparseVector<Value> _copy;
+        const _solver_bits::SparseVector<Value>* _host;
+        int _pos;
+
+        const _solver_bits::SparseVector<Value>& terms() const {
+          return _host ? *_host : _copy;
+        }
 
       public:
 
@@ -547,26 +569,32 @@ namespace lemon {
         /// Sets the iterator to the first term of the expression.
         ///
         ConstCoeffIt(const Expr& e)
-          : _it(e.comps.begin()), _end(e.comps.end()){}
+          : _host(&e.comps.normalized(_copy)), _pos(0) {
+          if (_host == &_copy) _host = 0;
+        }
 
         /// Convert the iterator to the column of the term
         operator Col() const {
-          return colFromId(_it->first);
+          return colFromId(terms().begin()[_pos].first);
         }
 
         /// Returns the coefficient of the term
-        const Value& operator*() const { return _it->second; }
+        const Value& operator*() const {
+          return terms().begin()[_pos].second;
+        }
 
         /// Next term
 
         /// Assign the iterator to the next term.
         ///
-        ConstCoeffIt& operator++() { ++_it; return *this; }
+        ConstCoeffIt& operator++() { ++_pos; return *this; }
 
         /// Equality operator
-        bool operator==(Invalid) const { return _it == _end; }
+        bool operator==(Invalid) const {
+          return _pos == terms().end() - terms().begin();
+        }
         /// Inequality operator
-        bool operator!=(Invalid) const { return _it != _end; }
+        bool operator!=(Invalid) const { return !(*this == INVALID); }
       };
 
     };
@@ -615,6 +643,13 @@ namespace lemon {
         _expr(e), _lb(lb), _ub(ub) {}
       Constr(const Expr &e) :
         _expr(e), _lb(NaN), _ub(NaN) {}
+#if __cplusplus >= 201103L
+      ///\e
+      Constr(Value lb, Expr &&e, Value ub) :
+        _expr(std::move(e)), _lb(lb), _ub(ub) {}
+      Constr(Expr &&e) :
+        _expr(std::move(e)), _lb(NaN), _ub(NaN) {}
+#endif
       ///\e
       void clear()
       {
@@ -692,6 +727,8 @@ namespace lemon {
     ///e/=5;
     ///\endcode
     ///
+    ///The terms are stored in the same way as in \ref Expr.
+    ///
     ///\sa Expr
     class DualExpr {
       friend class LpBase;
@@ -702,7 +739,7 @@ namespace lemon {
       typedef LpBase::Value Value;
 
     protected:
-      std::map<int, Value> comps;
+      _solver_bits::SparseVector<Value> comps;
 
     public:
       typedef True SolverExpr;
@@ -716,27 +753,39 @@ namespace lemon {
       /// Construct an expression, which has a term with \c r dual
       /// variable and 1.0 coefficient.
       DualExpr(const Row &r) {
-        typedef std::map<int, Value>::value_type pair_type;
-        comps.insert(pair_type(id(r), 1));
+        comps.add(id(r), 1);
       }
       /// Returns the coefficient of the row
       Value operator[](const Row& r) const {
-        std::map<int, Value>::const_iterator it = comps.find(id(r));
-        if (it != comps.end()) {
-          return it->second;
-        } else {
-          return 0;
-        }
+        return comps.value(id(r));
       }
       /// Returns the coefficient of the row
       Value& operator[](const Row& r) {
         return comps[id(r)];
       }
+      /// Adds a value to the coefficient of the row
+
+      /// Adds \c v to the coefficient of the row in amortized
+      /// constant time. The new term is stored separately and it is
+      /// merged with the other terms of the row by finalize() or
+      /// by the first function that needs the merged form, so this
+      /// is the fast way of building large expressions.
+      void add(const Row& r, const Value &v) {
+        comps.add(id(r), v);
+      }
+      /// Merges the terms of the same row
+
+      /// Sorts the terms and merges the terms of the same row.
+      /// It is called automatically when it is needed, but calling
+      /// it explicitly after building the expression with add() makes
+      /// the later read-only accesses cheaper.
+      void finalize() {
+        comps.normalize();
+      }
       /// Sets the coefficient of the row
       void set(const Row &r, const Value &v) {
         if (v != 0.0) {
-          typedef std::map<int, Value>::value_type pair_type;
-          comps.insert(pair_type(id(r), v));
+          comps.set(id(r), v);
         } else {
           comps.erase(id(r));
         }
@@ -744,15 +793,11 @@ namespace lemon {
       /// \brief Removes the coefficients which's absolute value does
       /// not exceed \c epsilon.
       void simplify(Value epsilon = 0.0) {
-        std::map<int, Value>::iterator it=comps.begin();
-        while (it != comps.end()) {
-          std::map<int, Value>::iterator jt=it;
-          ++jt;
-          if (std::fabs((*it).second) <= epsilon) comps.erase(it);
-          it=jt;
-        }
+        comps.simplify(epsilon);
       }
 
+      // It merges and removes the stored terms in spite of being const,
+      // so it must not be called concurrently with other accesses
       void simplify(Value epsilon = 0.0) const {
         const_cast<DualExpr*>(this)->simplify(epsilon);
       }
@@ -761,32 +806,29 @@ namespace lemon {
       void clear() {
         comps.clear();
       }
+
+      ///Reserves storage for the given number of terms.
+      void reserve(int n) {
+        comps.reserve(n);
+      }
       ///Compound assignment
       DualExpr &operator+=(const DualExpr &e) {
-        for (std::map<int, Value>::const_iterator it=e.comps.begin();
-             it!=e.comps.end(); ++it)
-          comps[it->first]+=it->second;
+        comps.add(e.comps, 1);
         return *this;
       }
       ///Compound assignment
       DualExpr &operator-=(const DualExpr &e) {
-        for (std::map<int, Value>::const_iterator it=e.comps.begin();
-             it!=e.comps.end(); ++it)
-          comps[it->first]-=it->second;
+        comps.add(e.comps, -1);
         return *this;
       }
       ///Multiply with a constant
       DualExpr &operator*=(const Value &v) {
-        for (std::map<int, Value>::iterator it=comps.begin();
-             it!=comps.end(); ++it)
-          it->second*=v;
+        comps.scale(v);
         return *this;
       }
       ///Division with a constant
       DualExpr &operator/=(const Value &v) {
-        for (std::map<int, Value>::iterator it=comps.begin();
-             it!=comps.end(); ++it)
-          it->second/=v;
+        comps.divide(v);
         return *this;
       }
 
@@ -802,7 +844,7 @@ namespace lemon {
       class CoeffIt {
       private:
 
-        std::map<int, Value>::iterator _it, _end;
+        _solver_bits::SparseVector<Value>::iterator _it, _end;
 
       public:
 
@@ -848,7 +890,15 @@ namespace lemon {
       class ConstCoeffIt {
       private:
 
-        std::map<int, Value>::const_iterator _it, _end;
+        // The terms of an expression that is not in canonical form
+        // are merged in a private copy, the expression is not modified
+        _solver_bits::SparseVector<Value> _copy;
+        const _solver_bits::SparseVector<Value>* _host;
+        int _pos;
+
+        const _solver_bits::SparseVector<Value>& terms() const {
+          return _host ? *_host : _copy;
+        }
 
       public:
 
@@ -857,26 +907,32 @@ namespace lemon {
         /// Sets the iterator to the first term of the expression.
         ///
         ConstCoeffIt(const DualExpr& e)
-          : _it(e.comps.begin()), _end(e.comps.end()){}
+          : _host(&e.comps.normalized(_copy)), _pos(0) {
+          if (_host == &_copy) _host = 0;
+        }
 
         /// Convert the iterator to the row of the term
         operator Row() const {
-          return rowFromId(_it->first);
+          return rowFromId(terms().begin()[_pos].first);
         }
 
         /// Returns the coefficient of the term
-        const Value& operator*() const { return _it->second; }
+        const Value& operator*() const {
+          return terms().begin()[_pos].second;
+        }
 
         /// Next term
 
         /// Assign the iterator to the next term.
         ///
-        ConstCoeffIt& operator++() { ++_it; return *this; }
+        ConstCoeffIt& operator++() { ++_pos; return *this; }
 
         /// Equality operator
-        bool operator==(Invalid) const { return _it == _end; }
+        bool operator==(Invalid) const {
+          return _pos == terms().end() - terms().begin();
+        }
         /// Inequality operator
-        bool operator!=(Invalid) const { return _it != _end; }
+        bool operator!=(Invalid) const { return !(*this == INVALID); }
       };
     };
 
@@ -886,7 +942,7 @@ namespace lemon {
     class InsertIterator {
     private:
 
-      std::map<int, Value>& _host;
+      _solver_bits::SparseVector<Value>& _host;
       const _solver_bits::VarIndex& _index;
 
     public:
@@ -897,13 +953,12 @@ namespace lemon {
       typedef void reference;
       typedef void pointer;
 
-      InsertIterator(std::map<int, Value>& host,
+      InsertIterator(_solver_bits::SparseVector<Value>& host,
                    const _solver_bits::VarIndex& index)
         : _host(host), _index(index) {}
 
       InsertIterator& operator=(const std::pair<int, Value>& value) {
-        typedef std::map<int, Value>::value_type pair_type;
-        _host.insert(pair_type(_index[value.first], value.second));
+        _host.add(_index[value.first], value.second);
         return *this;
       }
 
@@ -915,7 +970,7 @@ namespace lemon {
 
     class ExprIterator {
     private:
-      std::map<int, Value>::const_iterator _host_it;
+      _solver_bits::SparseVector<Value>::const_iterator _host_it;
       const _solver_bits::VarIndex& _index;
     public:
 
@@ -932,7 +987,8 @@ namespace lemon {
         value_type value;
       };
 
-      ExprIterator(const std::map<int, Value>::const_iterator& host_it,
+      ExprIterator(const _solver_bits::SparseVector<Value>::const_iterator&
+                   host_it,
                    const _solver_bits::VarIndex& index)
         : _host_it(host_it), _index(index) {}
 
@@ -985,6 +1041,51 @@ namespace lemon {
       return row;
     }
 
+    // Add num rows at once. The terms of the i-th row are
+    // (index[k], value[k]) for start[i] <= k < start[i+1], where
+    // index[k] is a solver column index. The solver indices of the
+    // new rows are stored in rows[0..num-1]. By default, the rows are
+    // added one by one, each with a single _addRow() call.
+    virtual void _addRows(int num, const Value *lower, const int *start,
+                          const int *index, const Value *value,
+                          const Value *upper, int *rows) {
+      _solver_bits::SparseVector<Value> terms;
+      for (int i = 0; i < num; ++i) {
+        terms.clear();
+        for (int k = start[i]; k < start[i + 1]; ++k) {
+          terms.add(_cols[index[k]], value[k]);
+        }
+        rows[i] = _addRow(lower[i], ExprIterator(terms.begin(), _cols),
+                          ExprIterator(terms.end(), _cols), upper[i]);
+      }
+    }
+
+    // Add num columns at once. The terms of the i-th column are
+    // (index[k], value[k]) for start[i] <= k < start[i+1], where
+    // index[k] is a solver row index. The solver indices of the
+    // new columns are stored in cols[0..num-1]. By default, the
+    // columns are added one by one, and the coefficients of each
+    // column are set with a single _setColCoeffs() call.
+    virtual void _addCols(int num, const Value *obj, const int *start,
+                          const int *index, const Value *value,
+                          const Value *lower, const Value *upper,
+                          int *cols) {
+      _solver_bits::SparseVector<Value> terms;
+      for (int i = 0; i < num; ++i) {
+        int col = _addCol();
+        terms.clear();
+        for (int k = start[i]; k < start[i + 1]; ++k) {
+          terms.add(_rows[index[k]], value[k]);
+        }
+        _setColCoeffs(col, ExprIterator(terms.begin(), _rows),
+                      ExprIterator(terms.end(), _rows));
+        _setObjCoeff(col, obj[i]);
+        _setColLowerBound(col, lower[i]);
+        _setColUpperBound(col, upper[i]);
+        cols[i] = col;
+      }
+    }
+
     virtual void _eraseCol(int col) = 0;
     virtual void _eraseRow(int row) = 0;
 
@@ -1299,6 +1400,102 @@ namespace lemon {
                                 c.upperBounded()?c.upperBound()-*c.expr():INF));
       return r;
     }
+
+    ///Add several rows (i.e constraints) to the LP at once
+
+    ///This function adds \c num rows to the LP in one step. It is
+    ///faster than adding the rows with addRow() when a large model
+    ///is built, since no \ref Expr objects have to be constructed.
+    ///
+    ///The rows are given in compressed sparse row format: the terms
+    ///of the <tt>i</tt>-th row are <tt>(cols[k], values[k])</tt> for
+    ///<tt>start[i] <= k < start[i+1]</tt>. A column may appear at most
+    ///once in each row.
+    ///\param num The number of the new rows.
+    ///\param lower The lower bounds of the rows (-\ref INF means no
+    ///bound). If it is \c NULL, the rows are not bounded from below.
+    ///\param start An array of <tt>num+1</tt> increasing positions.
+    ///\param cols The columns of the terms.
+    ///\param values The coefficients of the terms.
+    ///\param upper The upper bounds of the rows (\ref INF means no
+    ///bound). If it is \c NULL, the rows are not bounded from above.
+    ///\param rows If it is not \c NULL, the created rows are stored
+    ///in <tt>rows[0..num-1]</tt>.
+    void addRows(int num, const Value *lower, const int *start,
+                 const Col *cols, const Value *values, const Value *upper,
+                 Row *rows = 0) {
+      if (num <= 0) return;
+      int offset = start[0];
+      std::vector<int> beg(num + 1);
+      for (int i = 0; i <= num; ++i) {
+        beg[i] = start[i] - offset;
+      }
+      std::vector<int> index(beg[num] + 1);
+      for (int k = 0; k < beg[num]; ++k) {
+        index[k] = _cols(id(cols[offset + k]));
+      }
+      std::vector<Value> lo(num, -INF), up(num, INF);
+      if (lower) lo.assign(lower, lower + num);
+      if (upper) up.assign(upper, upper + num);
+      std::vector<int> ids(num);
+      _addRows(num, &lo[0], &beg[0], &index[0],
+               beg[num] > 0 ? values + offset : 0, &up[0], &ids[0]);
+      for (int i = 0; i < num; ++i) {
+        int r = _addRowId(ids[i]);
+        if (rows) rows[i]._id = r;
+      }
+    }
+
+    ///Add several columns (i.e variables) to the LP at once
+
+    ///This function adds \c num columns to the LP in one step
+    ///together with their objective coefficients and bounds. It is
+    ///faster than adding the columns with addCol() and setting their
+    ///coefficients one by one, since the coefficients of each column
+    ///are passed to the solver in a single call.
+    ///
+    ///The columns are given in compressed sparse column format: the
+    ///terms of the <tt>i</tt>-th column are <tt>(rows[k], values[k])</tt>
+    ///for <tt>start[i] <= k < start[i+1]</tt>. A row may appear at
+    ///most once in each column.
+    ///\param num The number of the new columns.
+    ///\param obj The objective coefficients of the columns. If it is
+    ///\c NULL, they are zero.
+    ///\param start An array of <tt>num+1</tt> increasing positions.
+    ///\param rows The rows of the terms.
+    ///\param values The coefficients of the terms.
+    ///\param lower The lower bounds of the columns (-\ref INF means no
+    ///bound). If it is \c NULL, the columns are not bounded from below.
+    ///\param upper The upper bounds of the columns (\ref INF means no
+    ///bound). If it is \c NULL, the columns are not bounded from above.
+    ///\param cols If it is not \c NULL, the created columns are stored
+    ///in <tt>cols[0..num-1]</tt>.
+    void addCols(int num, const Value *obj, const int *start,
+                 const Row *rows, const Value *values,
+                 const Value *lower, const Value *upper, Col *cols = 0) {
+      if (num <= 0) return;
+      int offset = start[0];
+      std::vector<int> beg(num + 1);
+      for (int i = 0; i <= num; ++i) {
+        beg[i] = start[i] - offset;
+      }
+      std::vector<int> index(beg[num] + 1);
+      for (int k = 0; k < beg[num]; ++k) {
+        index[k] = _rows(id(rows[offset + k]));
+      }
+      std::vector<Value> ob(num, 0), lo(num, -INF), up(num, INF);
+      if (obj) ob.assign(obj, obj + num);
+      if (lower) lo.assign(lower, lower + num);
+      if (upper) up.assign(upper, upper + num);
+      std::vector<int> ids(num);
+      _addCols(num, &ob[0], &beg[0], &index[0],
+               beg[num] > 0 ? values + offset : 0, &lo[0], &up[0], &ids[0]);
+      for (int i = 0; i < num; ++i) {
+        int c = _addColId(ids[i]);
+        if (cols) cols[i]._id = c;
+      }
+    }
+
     ///Erase a column (i.e a variable) from the LP
 
     ///\param c is the column to be deleted
@@ -1590,8 +1787,11 @@ namespace lemon {
     ///\param e is a linear expression of type \ref Expr.
     ///
     void obj(const Expr& e) {
-      _setObjCoeffs(ExprIterator(e.comps.begin(), _cols),
-                    ExprIterator(e.comps.end(), _cols));
+      _solver_bits::SparseVector<Value> tmp;
+      const _solver_bits::SparseVector<Value>& comps =
+        e.comps.normalized(tmp);
+      _setObjCoeffs(ExprIterator(comps.begin(), _cols),
+                    ExprIterator(comps.end(), _cols));
       obj_const_comp = *e;
     }
 
@@ -1691,6 +1891,75 @@ namespace lemon {
     return tmp;
   }
 
+#if __cplusplus >= 201103L
+  // The following overloads reuse the storage of a temporary operand.
+
+  ///Addition
+
+  ///\relates LpBase::Expr
+  ///
+  inline LpBase::Expr operator+(LpBase::Expr &&a, const LpBase::Expr &b) {
+    a+=b;
+    return std::move(a);
+  }
+  ///Addition
+
+  ///\relates LpBase::Expr
+  ///
+  inline LpBase::Expr operator+(const LpBase::Expr &a, LpBase::Expr &&b) {
+    b+=a;
+    return std::move(b);
+  }
+  ///Addition
+
+  ///\relates LpBase::Expr
+  ///
+  inline LpBase::Expr operator+(LpBase::Expr &&a, LpBase::Expr &&b) {
+    a+=b;
+    return std::move(a);
+  }
+  ///Substraction
+
+  ///\relates LpBase::Expr
+  ///
+  inline LpBase::Expr operator-(LpBase::Expr &&a, const LpBase::Expr &b) {
+    a-=b;
+    return std::move(a);
+  }
+  ///Substraction
+
+  ///\relates LpBase::Expr
+  ///
+  inline LpBase::Expr operator-(LpBase::Expr &&a, LpBase::Expr &&b) {
+    a-=b;
+    return std::move(a);
+  }
+  ///Multiply with constant
+
+  ///\relates LpBase::Expr
+  ///
+  inline LpBase::Expr operator*(LpBase::Expr &&a, const LpBase::Value &b) {
+    a*=b;
+    return std::move(a);
+  }
+  ///Multiply with constant
+
+  ///\relates LpBase::Expr
+  ///
+  inline LpBase::Expr operator*(const LpBase::Value &a, LpBase::Expr &&b) {
+    b*=a;
+    return std::move(b);
+  }
+  ///Divide with constant
+
+  ///\relates LpBase::Expr
+  ///
+  inline LpBase::Expr operator/(LpBase::Expr &&a, const LpBase::Value &b) {
+    a/=b;
+    return std::move(a);
+  }
+#endif
+
   ///Create constraint
 
   ///\relates LpBase::Constr
@@ -1813,6 +2082,53 @@ namespace lemon {
     return tmp;
   }
 
+#if __cplusplus >= 201103L
+  // The following overloads reuse the storage of a temporary constraint.
+
+  ///Create constraint
+
+  ///\relates LpBase::Constr
+  ///
+  inline LpBase::Constr operator<=(const LpBase::Value &n,
+                                   LpBase::Constr &&c) {
+    LEMON_ASSERT(isNaN(c.lowerBound()), "Wrong LP constraint");
+    c.lowerBound()=n;
+    return std::move(c);
+  }
+  ///Create constraint
+
+  ///\relates LpBase::Constr
+  ///
+  inline LpBase::Constr operator<=(LpBase::Constr &&c,
+                                   const LpBase::Value &n)
+  {
+    LEMON_ASSERT(isNaN(c.upperBound()), "Wrong LP constraint");
+    c.upperBound()=n;
+    return std::move(c);
+  }
+  ///Create constraint
+
+  ///\relates LpBase::Constr
+  ///
+  inline LpBase::Constr operator>=(const LpBase::Value &n,
+                                   LpBase::Constr &&c) {
+    LEMON_ASSERT(isNaN(c.upperBound()), "Wrong LP constraint");
+    c.upperBound()=n;
+    return std::move(c);
+  }
+  ///Create constraint
+
+  ///\relates LpBase::Constr
+  ///
+  inline LpBase::Constr operator>=(LpBase::Constr &&c,
+                                   const LpBase::Value &n)
+  {
+    LEMON_ASSERT(isNaN(c.lowerBound()), "Wrong LP constraint");
+    c.lowerBound()=n;
+    return std::move(c);
+  }
+#endif
+
   ///Addition
 
   ///\relates LpBase::DualExpr
@@ -1865,6 +2181,83 @@ namespace lemon {
     return tmp;
   }
 
+#if __cplusplus >= 201103L
+  // The following overloads reuse the storage of a temporary operand.
+
+  ///Addition
+
+  ///\relates LpBase::DualExpr
+  ///
+  inline LpBase::DualExpr operator+(LpBase::DualExpr &&a,
+                                    const LpBase::DualExpr &b) {
+    a+=b;
+    return std::move(a);
+  }
+  ///Addition
+
+  ///\relates LpBase::DualExpr
+  ///
+  inline LpBase::DualExpr operator+(const LpBase::DualExpr &a,
+                                    LpBase::DualExpr &&b) {
+    b+=a;
+    return std::move(b);
+  }
+  ///Addition
+
+  ///\relates LpBase::DualExpr
+  ///
+  inline LpBase::DualExpr operator+(LpBase::DualExpr &&a,
+                                    LpBase::DualExpr &&b) {
+    a+=b;
+    return std::move(a);
+  }
+  ///Substraction
+
+  ///\relates LpBase::DualExpr
+  ///
+  inline LpBase::DualExpr operator-(LpBase::DualExpr &&a,
+                                    const LpBase::DualExpr &b) {
+    a-=b;
+    return std::move(a);
+  }
+  ///Substraction
+
+  ///\relates LpBase::DualExpr
+  ///
+  inline LpBase::DualExpr operator-(LpBase::DualExpr &&a,
+                                    LpBase::DualExpr &&b) {
+    a-=b;
+    return std::move(a);
+  }
+  ///Multiply with constant
+
+  ///\relates LpBase::DualExpr
+  ///
+  inline LpBase::DualExpr operator*(LpBase::DualExpr &&a,
+                                    const LpBase::Value &b) {
+    a*=b;
+    return std::move(a);
+  }
+  ///Multiply with constant
+
+  ///\relates LpBase::DualExpr
+  ///
+  inline LpBase::DualExpr operator*(const LpBase::Value &a,
+                                    LpBase::DualExpr &&b) {
+    b*=a;
+    return std::move(b);
+  }
+  ///Divide with constant
+
+  ///\relates LpBase::DualExpr
+  ///
+  inline LpBase::DualExpr operator/(LpBase::DualExpr &&a,
+                                    const LpBase::Value &b) {
+    a/=b;
+    return std::move(a);
+  }
+#endif
+
   /// \ingroup lp_group
   ///
   /// \brief Common base class for LP solvers
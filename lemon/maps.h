@@ -1960,6 +1960,8 @@ namespace lemon {
     typedef K Key;
     /// The value type of CrossRefMap.
     typedef V Value;
+    /// Indicates that the map cannot be set concurrently.
+    typedef False ConcurrentSetTag;
 
     /// \brief Constructor.
     ///
@@ -2121,6 +2123,20 @@ namespace lemon {
       Map::clear();
     }
 
+    /// \brief Renumber the keys of the map and the inverse map.
+    ///
+    /// Renumber the keys of the map and the inverse map. It is called by
+    /// the \c AlterationNotifier.
+    virtual void renumber(const std::vector<Index>& ids) {
+      Map::renumber(ids);
+      _inv_map.clear();
+      Key it;
+      const typename Map::Notifier* nf = Map::notifier();
+      for (nf->first(it); it != INVALID; nf->next(it)) {
+        _inv_map.insert(std::make_pair(Map::operator[](it), it));
+      }
+    }
+
   public:
 
     /// \brief The inverse map type of CrossRefMap.
@@ -2202,6 +2218,8 @@ namespace lemon {
     typedef K Key;
     /// The value type of RangeIdMap.
     typedef int Value;
+    /// Indicates that the map cannot be set concurrently.
+    typedef False ConcurrentSetTag;
 
     /// \brief Constructor.
     ///
@@ -2286,6 +2304,19 @@ namespace lemon {
       Map::clear();
     }
 
+    /// \brief Renumber the keys of the map.
+    ///
+    /// Renumber the keys of the map. The values of the items are not
+    /// changed. It is called by the \c AlterationNotifier.
+    virtual void renumber(const std::vector<Index>& ids) {
+      Map::renumber(ids);
+      Item it;
+      const typename Map::Notifier* nf = Map::notifier();
+      for (nf->first(it); it != INVALID; nf->next(it)) {
+        _inv_map[Map::operator[](it)] = it;
+      }
+    }
+
   public:
 
     /// \brief Returns the maximal value plus one.
@@ -2415,6 +2446,8 @@ namespace lemon {
 
     /// Indicates that the map is reference map.
     typedef True ReferenceMapTag;
+    /// Indicates that the map cannot be set concurrently.
+    typedef False ConcurrentSetTag;
 
     /// The key type
     typedef K Key;
@@ -2766,6 +2799,15 @@ namespace lemon {
       Parent::clear();
     }
 
+    virtual void renumber(const std::vector<Index>& ids) {
+      Parent::renumber(ids);
+      typename Parent::Notifier* nf = Parent::notifier();
+      Key it;
+      for (nf->first(it); it != INVALID; nf->next(it)) {
+        _array[position(it)] = it;
+      }
+    }
+
   };
 
 
@@ -2817,6 +2859,8 @@ namespace lemon {
     typedef int Value;
     /// The graph type
     typedef GR Graph;
+    /// Indicates that the map cannot be set concurrently.
+    typedef False ConcurrentSetTag;
 
     /// \brief Constructor of the map.
     ///
@@ -3067,6 +3111,14 @@ namespace lemon {
       Parent::clear();
     }
 
+    virtual void renumber(const std::vector<Index>& ids) {
+      Parent::renumber(ids);
+      _first.assign(_first.size(), INVALID);
+      for (typename Parent::ItemIt it(*this); it != INVALID; ++it) {
+        lace(it);
+      }
+    }
+
   private:
     std::vector<Key> _first;
   };
@@ -3119,6 +3171,8 @@ namespace lemon {
     typedef V Value;
     /// The graph type
     typedef GR Graph;
+    /// Indicates that the map cannot be set concurrently.
+    typedef False ConcurrentSetTag;
 
   public:
 
@@ -3339,6 +3393,14 @@ namespace lemon {
       Parent::clear();
     }
 
+    virtual void renumber(const std::vector<Index>& ids) {
+      Parent::renumber(ids);
+      _first.clear();
+      for (typename Parent::ItemIt it(*this); it != INVALID; ++it) {
+        lace(it);
+      }
+    }
+
   private:
     std::map<Value, Key> _first;
   };
@@ -29,6 +29,7 @@
 #include <lemon/bin_heap.h>
 #include <lemon/maps.h>
 #include <lemon/fractional_matching.h>
+#include <lemon/stats.h>
 
 ///\ingroup matching
 ///\file
@@ -705,11 +706,15 @@ namespace lemon {
   /// \tparam GR The undirected graph type the algorithm runs on.
   /// \tparam WM The type edge weight map. The default type is
   /// \ref concepts::Graph::EdgeMap "GR::EdgeMap<int>".
+  /// \tparam ST The type of the statistics collector. By default, it is
+  /// \ref NoStats, which records nothing. Use \ref Stats to record the
+  /// operation counters and the phase times of the algorithm.
 #ifdef DOXYGEN
-  template <typename GR, typename WM>
+  template <typename GR, typename WM, typename ST>
 #else
   template <typename GR,
-            typename WM = typename GR::template EdgeMap<int> >
+            typename WM = typename GR::template EdgeMap<int>,
+            typename ST = NoStats>
 #endif
   class MaxWeightedMatching {
   public:
@@ -718,6 +723,8 @@ namespace lemon {
     typedef GR Graph;
     /// The type of the edge weight map
     typedef WM WeightMap;
+    /// The type of the statistics collector
+    typedef ST Stats;
     /// The value type of the edge weights
     typedef typename WeightMap::Value Value;
 
@@ -732,6 +739,36 @@ namespace lemon {
     static const int dualScale =
       std::numeric_limits<Value>::is_integer ? 4 : 1;
 
+    /// \brief Operation counters of the algorithm.
+    ///
+    /// Operation counters of the algorithm, see \ref stats().
+    enum StatCounter {
+      /// The number of dual updates, i.e. iterations of the algorithm.
+      DUAL_UPDATES,
+      /// The number of nodes left unmatched because of their zero
+      /// dual value.
+      UNMATCHED_NODES,
+      /// The number of augmentations.
+      AUGMENTATIONS,
+      /// The number of alternating tree extensions.
+      TREE_EXTENSIONS,
+      /// The number of blossom shrinking operations.
+      BLOSSOM_SHRINKS,
+      /// The number of blossom expanding operations.
+      BLOSSOM_EXPANSIONS
+    };
+
+    /// \brief Phases of the algorithm.
+    ///
+    /// Phases of the algorithm, see \ref stats().
+    enum StatPhase {
+      /// The \ref init() "initialization" or the
+      /// \ref fractionalInit() "fractional initialization".
+      INIT_PHASE,
+      /// The \ref start() "main phase".
+      MAIN_PHASE
+    };
+
   private:
 
     TEMPLATE_GRAPH_TYPEDEFS(Graph);
@@ -823,6 +860,8 @@ namespace lemon {
     typedef MaxWeightedFractionalMatching<Graph, WeightMap> FractionalMatching;
     FractionalMatching *_fractional;
 
+    Stats _stats;
+
     void createStructures() {
       _node_num = countNodes(_graph);
       _blossom_num = _node_num * 3 / 2;
@@ -1645,6 +1684,8 @@ namespace lemon {
     ///
     /// This function initializes the algorithm.
     void init() {
+      _stats.reset();
+      _stats.startPhase(INIT_PHASE);
       createStructures();
 
       _blossom_node_list.clear();
@@ -1707,6 +1748,7 @@ namespace lemon {
                             dualScale * _weight[e]) / 2);
         }
       }
+      _stats.stopPhase(INIT_PHASE);
     }
 
     /// \brief Initialize the algorithm with fractional matching
@@ -1714,6 +1756,8 @@ namespace lemon {
     /// This function initializes the algorithm with a fractional
     /// matching. This initialization is also called jumpstart heuristic.
     void fractionalInit() {
+      _stats.reset();
+      _stats.startPhase(INIT_PHASE);
       createStructures();
 
       _blossom_node_list.clear();
@@ -1856,6 +1900,7 @@ namespace lemon {
           _delta2->push(nb, _blossom_set->classPrio(nb));
         }
       }
+      _stats.stopPhase(INIT_PHASE);
     }
 
     /// \brief Start the algorithm
@@ -1869,7 +1914,9 @@ namespace lemon {
         D1, D2, D3, D4
       };
 
+      _stats.startPhase(MAIN_PHASE);
       while (_unmatched > 0) {
+        _stats.count(DUAL_UPDATES);
         Value d1 = !_delta1->empty() ?
           _delta1->prio() : std::numeric_limits<Value>::max();
 
@@ -1893,6 +1940,7 @@ namespace lemon {
             Node n = _delta1->top();
             unmatchNode(n);
             --_unmatched;
+            _stats.count(UNMATCHED_NODES);
           }
           break;
         case D2:
@@ -1903,8 +1951,10 @@ namespace lemon {
             if ((*_blossom_data)[blossom].next == INVALID) {
               augmentOnArc(a);
               --_unmatched;
+              _stats.count(AUGMENTATIONS);
             } else {
               extendOnArc(a);
+              _stats.count(TREE_EXTENSIONS);
             }
           }
           break;
@@ -1923,18 +1973,22 @@ namespace lemon {
 
               if (left_tree == right_tree) {
                 shrinkOnEdge(e, left_tree);
+                _stats.count(BLOSSOM_SHRINKS);
               } else {
                 augmentOnEdge(e);
                 _unmatched -= 2;
+                _stats.count(AUGMENTATIONS);
               }
             }
           } break;
         case D4:
           splitBlossom(_delta4->top());
+          _stats.count(BLOSSOM_EXPANSIONS);
           break;
         }
       }
       extractMatching();
+      _stats.stopPhase(MAIN_PHASE);
     }
 
     /// \brief Run the algorithm.
@@ -1951,6 +2005,17 @@ namespace lemon {
       start();
     }
 
+    /// \brief Returns the statistics of the algorithm.
+    ///
+    /// Returns the operation counters and the phase times of the last
+    /// execution, which are indexed by \ref StatCounter and
+    /// \ref StatPhase, respectively. They are recorded only if the
+    /// \c ST template parameter is set to \ref lemon::Stats "Stats",
+    /// otherwise all values are zero.
+    const Stats& stats() const {
+      return _stats;
+    }
+
     /// @}
 
     /// \name Primal Solution
@@ -30,6 +30,7 @@
 
 #include <lemon/core.h>
 #include <lemon/math.h>
+#include <lemon/stats.h>
 
 namespace lemon {
 
@@ -63,6 +64,9 @@ namespace lemon {
   /// and supply values in the algorithm. By default, it is \c int.
   /// \tparam C The number type used for costs and potentials in the
   /// algorithm. By default, it is the same as \c V.
+  /// \tparam ST The type of the statistics collector. By default, it is
+  /// \ref NoStats, which records nothing. Use \ref Stats to record the
+  /// operation counters and the phase times of the algorithm.
   ///
   /// \warning Both \c V and \c C must be signed number types.
   /// \warning All input data (capacities, supply values, and costs) must
@@ -71,7 +75,8 @@ namespace lemon {
   /// \note %NetworkSimplex provides five different pivot rule
   /// implementations, from which the most efficient one is used
   /// by default. For more information, see \ref PivotRule.
-  template <typename GR, typename V = int, typename C = V>
+  template <typename GR, typename V = int, typename C = V,
+            typename ST = NoStats>
   class NetworkSimplex
   {
   public:
@@ -80,6 +85,8 @@ namespace lemon {
     typedef V Value;
     /// The type of the arc costs
     typedef C Cost;
+    /// The type of the statistics collector
+    typedef ST Stats;
 
   public:
 
@@ -164,6 +171,29 @@ namespace lemon {
       ALTERING_LIST
     };
 
+    /// \brief Operation counters of the algorithm.
+    ///
+    /// Operation counters of the algorithm, see \ref stats().
+    enum StatCounter {
+      /// The number of pivots (including the initial heuristic pivots).
+      PIVOTS,
+      /// The number of degenerate pivots, i.e. pivots that do not
+      /// change the flow.
+      DEGENERATE_PIVOTS,
+      /// The number of pivots changing the spanning tree.
+      TREE_UPDATES
+    };
+
+    /// \brief Phases of the algorithm.
+    ///
+    /// Phases of the algorithm, see \ref stats().
+    enum StatPhase {
+      /// The initialization of the data structures.
+      INIT_PHASE,
+      /// The pivots and the transformation of the solution.
+      PIVOT_PHASE
+    };
+
   private:
 
     TEMPLATE_DIGRAPH_TYPEDEFS(GR);
@@ -236,6 +266,9 @@ namespace lemon {
 
     const Value MAX;
 
+    // Operation statistics
+    Stats _stats;
+
   public:
 
     /// \brief Constant for infinite upper bounds (capacities).
@@ -830,7 +863,11 @@ namespace lemon {
     /// \see ProblemType, PivotRule
     /// \see resetParams(), reset()
     ProblemType run(PivotRule pivot_rule = BLOCK_SEARCH) {
-      if (!init()) return INFEASIBLE;
+      _stats.reset();
+      _stats.startPhase(INIT_PHASE);
+      bool feasible = init();
+      _stats.stopPhase(INIT_PHASE);
+      if (!feasible) return INFEASIBLE;
       return start(pivot_rule);
     }
 
@@ -1051,6 +1088,17 @@ namespace lemon {
       }
     }
 
+    /// \brief Returns the statistics of the algorithm.
+    ///
+    /// Returns the operation counters and the phase times of the last
+    /// execution, which are indexed by \ref StatCounter and
+    /// \ref StatPhase, respectively. They are recorded only if the
+    /// \c ST template parameter is set to \ref lemon::Stats "Stats",
+    /// otherwise all values are zero.
+    const Stats& stats() const {
+      return _stats;
+    }
+
     /// @}
 
   private:
@@ -1560,6 +1608,7 @@ namespace lemon {
         findJoinNode();
         bool change = findLeavingArc();
         if (delta >= MAX) return false;
+        countPivot(change);
         changeFlow(change);
         if (change) {
           updateTreeStructure();
@@ -1569,22 +1618,37 @@ namespace lemon {
       return true;
     }
 
+    // Update the statistics of a pivot
+    void countPivot(bool change) {
+      _stats.count(PIVOTS);
+      if (delta == 0) _stats.count(DEGENERATE_PIVOTS);
+      if (change) _stats.count(TREE_UPDATES);
+    }
+
     // Execute the algorithm
     ProblemType start(PivotRule pivot_rule) {
+      ProblemType result = INFEASIBLE;
+      _stats.startPhase(PIVOT_PHASE);
       // Select the pivot rule implementation
       switch (pivot_rule) {
         case FIRST_ELIGIBLE:
-          return start<FirstEligiblePivotRule>();
+          result = start<FirstEligiblePivotRule>();
+          break;
         case BEST_ELIGIBLE:
-          return start<BestEligiblePivotRule>();
+          result = start<BestEligiblePivotRule>();
+          break;
         case BLOCK_SEARCH:
-          return start<BlockSearchPivotRule>();
+          result = start<BlockSearchPivotRule>();
+          break;
         case CANDIDATE_LIST:
-          return start<CandidateListPivotRule>();
+          result = start<CandidateListPivotRule>();
+          break;
         case ALTERING_LIST:
-          return start<AlteringListPivotRule>();
+          result = start<AlteringListPivotRule>();
+          break;
       }
-      return INFEASIBLE; // avoid warning
+      _stats.stopPhase(PIVOT_PHASE);
+      return result;
     }
 
     template <typename PivotRuleImpl>
@@ -1599,6 +1663,7 @@ namespace lemon {
         findJoinNode();
         bool change = findLeavingArc();
         if (delta >= MAX) return UNBOUNDED;
+        countPivot(change);
         changeFlow(change);
         if (change) {
           updateTreeStructure();
@@ -20,6 +20,7 @@
 #define LEMON_PREFLOW_H
 
 #include <lemon/tolerance.h>
+#include <lemon/stats.h>
 #include <lemon/elevator.h>
 
 /// \file
@@ -93,6 +94,13 @@ namespace lemon {
     /// The tolerance used by the algorithm to handle inexact computation.
     typedef lemon::Tolerance<Value> Tolerance;
 
+    /// \brief The type of the statistics collector.
+    ///
+    /// The type of the statistics collector. The default \ref NoStats
+    /// records nothing, use \ref Stats to record the operation counters
+    /// and the phase times of the algorithm.
+    typedef NoStats Stats;
+
   };
 
 
@@ -149,6 +157,32 @@ namespace lemon {
     typedef typename Traits::Elevator Elevator;
     ///The type of the tolerance.
     typedef typename Traits::Tolerance Tolerance;
+    ///The type of the statistics collector.
+    typedef typename Traits::Stats Stats;
+
+    /// \brief Operation counters of the algorithm.
+    ///
+    /// Operation counters of the algorithm, see \ref stats().
+    enum StatCounter {
+      /// The number of push operations.
+      PUSHES,
+      /// The number of relabel operations.
+      RELABELS,
+      /// The number of levels lifted to the top by the gap heuristic.
+      GAP_RELABELS
+    };
+
+    /// \brief Phases of the algorithm.
+    ///
+    /// Phases of the algorithm, see \ref stats().
+    enum StatPhase {
+      /// The \ref init() "initialization".
+      INIT_PHASE,
+      /// The \ref startFirstPhase() "first phase".
+      FIRST_PHASE,
+      /// The \ref startSecondPhase() "second phase".
+      SECOND_PHASE
+    };
 
   private:
 
@@ -174,6 +208,7 @@ namespace lemon {
 
     bool _phase;
 
+    Stats _stats;
 
     void createStructures() {
       _node_num = countNodes(_graph);
@@ -285,6 +320,23 @@ namespace lemon {
                       SetStandardElevatorTraits<T> > Create;
     };
 
+    template <typename T>
+    struct SetStatsTraits : public Traits {
+      typedef T Stats;
+    };
+
+    /// \brief \ref named-templ-param "Named parameter" for setting
+    /// Stats type
+    ///
+    /// \ref named-templ-param "Named parameter" for setting the type of
+    /// the statistics collector, e.g. \ref Stats.
+    template <typename T>
+    struct SetStats
+      : public Preflow<Digraph, CapacityMap, SetStatsTraits<T> > {
+      typedef Preflow<Digraph, CapacityMap,
+                      SetStatsTraits<T> > Create;
+    };
+
     /// @}
 
   protected:
@@ -418,6 +470,8 @@ namespace lemon {
     /// Initializes the internal data structures and sets the initial
     /// flow to zero on each arc.
     void init() {
+      _stats.reset();
+      _stats.startPhase(INIT_PHASE);
       createStructures();
 
       _phase = true;
@@ -468,6 +522,7 @@ namespace lemon {
           }
         }
       }
+      _stats.stopPhase(INIT_PHASE);
     }
 
     /// \brief Initializes the internal data structures using the
@@ -481,6 +536,8 @@ namespace lemon {
     /// \return \c false if the given \c flowMap is not a preflow.
     template <typename FlowMap>
     bool init(const FlowMap& flowMap) {
+      _stats.reset();
+      _stats.startPhase(INIT_PHASE);
       createStructures();
 
       for (ArcIt e(_graph); e != INVALID; ++e) {
@@ -495,7 +552,10 @@ namespace lemon {
         for (OutArcIt e(_graph, n); e != INVALID; ++e) {
           excess -= (*_flow)[e];
         }
-        if (_tolerance.negative(excess) && n != _source) return false;
+        if (_tolerance.negative(excess) && n != _source) {
+          _stats.stopPhase(INIT_PHASE);
+          return false;
+        }
         (*_excess)[n] = excess;
       }
 
@@ -558,6 +618,7 @@ namespace lemon {
         if(n!=_source && n!=_target && _tolerance.positive((*_excess)[n]))
           _level->activate(n);
 
+      _stats.stopPhase(INIT_PHASE);
       return true;
     }
 
@@ -573,6 +634,7 @@ namespace lemon {
     /// using this function.
     void startFirstPhase() {
       _phase = true;
+      _stats.startPhase(FIRST_PHASE);
 
       while (true) {
         int num = _node_num;
@@ -594,6 +656,7 @@ namespace lemon {
             if (!_tolerance.positive(rem)) continue;
             Node v = _graph.target(e);
             if ((*_level)[v] < level) {
+              _stats.count(PUSHES);
               if (!_level->active(v) && v != _target) {
                 _level->activate(v);
               }
@@ -617,6 +680,7 @@ namespace lemon {
             if (!_tolerance.positive(rem)) continue;
             Node v = _graph.source(e);
             if ((*_level)[v] < level) {
+              _stats.count(PUSHES);
               if (!_level->active(v) && v != _target) {
                 _level->activate(v);
               }
@@ -640,12 +704,14 @@ namespace lemon {
           (*_excess)[n] = excess;
 
           if (_tolerance.nonZero(excess)) {
+            _stats.count(RELABELS);
             if (new_level + 1 < _level->maxLevel()) {
               _level->liftHighestActive(new_level + 1);
             } else {
               _level->liftHighestActiveToTop();
             }
             if (_level->emptyLevel(level)) {
+              _stats.count(GAP_RELABELS);
               _level->liftToTop(level);
             }
           } else {
@@ -675,6 +741,7 @@ namespace lemon {
             if (!_tolerance.positive(rem)) continue;
             Node v = _graph.target(e);
             if ((*_level)[v] < level) {
+              _stats.count(PUSHES);
               if (!_level->active(v) && v != _target) {
                 _level->activate(v);
               }
@@ -698,6 +765,7 @@ namespace lemon {
             if (!_tolerance.positive(rem)) continue;
             Node v = _graph.source(e);
             if ((*_level)[v] < level) {
+              _stats.count(PUSHES);
               if (!_level->active(v) && v != _target) {
                 _level->activate(v);
               }
@@ -721,12 +789,14 @@ namespace lemon {
           (*_excess)[n] = excess;
 
           if (_tolerance.nonZero(excess)) {
+            _stats.count(RELABELS);
             if (new_level + 1 < _level->maxLevel()) {
               _level->liftActiveOn(level, new_level + 1);
             } else {
               _level->liftActiveToTop(level);
             }
             if (_level->emptyLevel(level)) {
+              _stats.count(GAP_RELABELS);
               _level->liftToTop(level);
             }
           } else {
@@ -734,7 +804,8 @@ namespace lemon {
           }
         }
       }
-    first_phase_done:;
+    first_phase_done:
+      _stats.stopPhase(FIRST_PHASE);
     }
 
     /// \brief Starts the second phase of the preflow algorithm.
@@ -748,6 +819,7 @@ namespace lemon {
     /// must be called before using this function.
     void startSecondPhase() {
       _phase = false;
+      _stats.startPhase(SECOND_PHASE);
 
       typename Digraph::template NodeMap<bool> reached(_graph);
       for (NodeIt n(_graph); n != INVALID; ++n) {
@@ -807,6 +879,7 @@ namespace lemon {
           if (!_tolerance.positive(rem)) continue;
           Node v = _graph.target(e);
           if ((*_level)[v] < level) {
+            _stats.count(PUSHES);
             if (!_level->active(v) && v != _source) {
               _level->activate(v);
             }
@@ -830,6 +903,7 @@ namespace lemon {
           if (!_tolerance.positive(rem)) continue;
           Node v = _graph.source(e);
           if ((*_level)[v] < level) {
+            _stats.count(PUSHES);
             if (!_level->active(v) && v != _source) {
               _level->activate(v);
             }
@@ -853,6 +927,7 @@ namespace lemon {
         (*_excess)[n] = excess;
 
         if (_tolerance.nonZero(excess)) {
+          _stats.count(RELABELS);
           if (new_level + 1 < _level->maxLevel()) {
             _level->liftHighestActive(new_level + 1);
           } else {
@@ -860,6 +935,7 @@ namespace lemon {
             _level->liftHighestActiveToTop();
           }
           if (_level->emptyLevel(level)) {
+            _stats.count(GAP_RELABELS);
             // Calculation error
             _level->liftToTop(level);
           }
@@ -868,6 +944,7 @@ namespace lemon {
         }
 
       }
+      _stats.stopPhase(SECOND_PHASE);
     }
 
     /// \brief Runs the preflow algorithm.
@@ -978,6 +1055,17 @@ namespace lemon {
       }
     }
 
+    /// \brief Returns the statistics of the algorithm.
+    ///
+    /// Returns the operation counters and the phase times of the last
+    /// execution, which are indexed by \ref StatCounter and
+    /// \ref StatPhase, respectively. They are recorded only if the
+    /// \ref SetStats "Stats" type is set to \ref lemon::Stats "Stats",
+    /// otherwise all values are zero.
+    const Stats& stats() const {
+      return _stats;
+    }
+
     /// @}
   };
 }
@@ -0,0 +1,280 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+///\file
+///\brief Implementation of the hardware counters and the profiler.
+
+#include <lemon/profiler.h>
+#include <lemon/concept_check.h>
+
+#ifdef LEMON_HAVE_PERF_EVENT
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+namespace lemon {
+
+#ifdef LEMON_HAVE_PERF_EVENT
+  namespace {
+
+    int openPerfEvent(PerfCounters::Event event) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      switch (event) {
+      case PerfCounters::CYCLES:
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+      case PerfCounters::INSTRUCTIONS:
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+      case PerfCounters::CACHE_MISSES:
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+      case PerfCounters::BRANCH_MISSES:
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+      }
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      // The calling thread on any cpu
+      return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1,
+                                      -1, 0));
+    }
+
+  }
+#endif
+
+  bool PerfCounters::supported() {
+#ifdef LEMON_HAVE_PERF_EVENT
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  PerfCounters::PerfCounters(bool run) : _running(false) {
+    for (int i = 0; i < EVENT_NUM; ++i) {
+#ifdef LEMON_HAVE_PERF_EVENT
+      _fd[i] = openPerfEvent(Event(i));
+      if (_fd[i] < 0) _fd[i] = -1;
+#else
+      _fd[i] = -1;
+#endif
+    }
+    if (run) start();
+  }
+
+  PerfCounters::~PerfCounters() {
+#ifdef LEMON_HAVE_PERF_EVENT
+    for (int i = 0; i < EVENT_NUM; ++i) {
+      if (_fd[i] >= 0) close(_fd[i]);
+    }
+#endif
+  }
+
+  bool PerfCounters::available() const {
+    for (int i = 0; i < EVENT_NUM; ++i) {
+      if (_fd[i] >= 0) return true;
+    }
+    return false;
+  }
+
+  void PerfCounters::start() {
+#ifdef LEMON_HAVE_PERF_EVENT
+    for (int i = 0; i < EVENT_NUM; ++i) {
+      if (_fd[i] >= 0) ioctl(_fd[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+    _running = true;
+  }
+
+  void PerfCounters::stop() {
+#ifdef LEMON_HAVE_PERF_EVENT
+    for (int i = 0; i < EVENT_NUM; ++i) {
+      if (_fd[i] >= 0) ioctl(_fd[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+#endif
+    _running = false;
+  }
+
+  void PerfCounters::reset() {
+#ifdef LEMON_HAVE_PERF_EVENT
+    for (int i = 0; i < EVENT_NUM; ++i) {
+      if (_fd[i] >= 0) ioctl(_fd[i], PERF_EVENT_IOC_RESET, 0);
+    }
+#endif
+  }
+
+  long long PerfCounters::value(Event event) const {
+#ifdef LEMON_HAVE_PERF_EVENT
+    if (_fd[event] >= 0) {
+      long long value;
+      if (read(_fd[event], &value, sizeof(value)) == sizeof(value)) {
+        return value;
+      }
+    }
+#else
+    ignore_unused_variable_warning(event);
+#endif
+    return 0;
+  }
+
+  const char* PerfCounters::name(Event event) {
+    switch (event) {
+    case CYCLES:
+      return "cycles";
+    case INSTRUCTIONS:
+      return "instructions";
+    case CACHE_MISSES:
+      return "cache-misses";
+    case BRANCH_MISSES:
+      return "branch-misses";
+    }
+    return "";
+  }
+
+  Profiler::Region::Region(Profiler& profiler, const std::string& name)
+    : _profiler(profiler), _name(name), _counters(0)
+  {
+    _profiler._lock.lock();
+    _profiler.insert(name);
+    _profiler._lock.unlock();
+    if (_profiler._record_counters) {
+      _counters = new PerfCounters(true);
+    }
+    _start.stamp(TimeStamp::THREAD_TIME);
+  }
+
+  Profiler::Region::~Region() {
+    TimeStamp now;
+    now.stamp(TimeStamp::THREAD_TIME);
+    if (_counters) {
+      _counters->stop();
+      long long values[PerfCounters::EVENT_NUM];
+      for (int i = 0; i < PerfCounters::EVENT_NUM; ++i) {
+        values[i] = _counters->value(PerfCounters::Event(i));
+      }
+      bool available = _counters->available();
+      delete _counters;
+      _profiler.add(_name, now - _start, available ? values : 0);
+    } else {
+      _profiler.add(_name, now - _start);
+    }
+  }
+
+  void Profiler::reset() {
+    _lock.lock();
+    _data.clear();
+    _index.clear();
+    _lock.unlock();
+  }
+
+  Profiler::Data& Profiler::insert(const std::string& name) {
+    std::map<std::string, int>::iterator it = _index.find(name);
+    if (it == _index.end()) {
+      it = _index.insert(std::make_pair(name, int(_data.size()))).first;
+      _data.push_back(Data());
+      Data& data = _data.back();
+      data.name = name;
+      data.count = 0;
+      for (int i = 0; i < PerfCounters::EVENT_NUM; ++i) {
+        data.counters[i] = 0;
+      }
+      data.has_counters = false;
+    }
+    return _data[it->second];
+  }
+
+  void Profiler::add(const std::string& name, const TimeStamp& time,
+                     const long long* counters) {
+    _lock.lock();
+    Data& data = insert(name);
+    ++data.count;
+    data.time += time;
+    if (counters) {
+      for (int i = 0; i < PerfCounters::EVENT_NUM; ++i) {
+        data.counters[i] += counters[i];
+      }
+      data.has_counters = true;
+    }
+    _lock.unlock();
+  }
+
+  const Profiler::Data* Profiler::find(const std::string& name) const {
+    std::map<std::string, int>::const_iterator it = _index.find(name);
+    return it != _index.end() ? &_data[it->second] : 0;
+  }
+
+  int Profiler::count(const std::string& name) const {
+    _lock.lock();
+    const Data* data = find(name);
+    int result = data ? data->count : 0;
+    _lock.unlock();
+    return result;
+  }
+
+  TimeStamp Profiler::time(const std::string& name) const {
+    _lock.lock();
+    const Data* data = find(name);
+    TimeStamp result = data ? data->time : TimeStamp();
+    _lock.unlock();
+    return result;
+  }
+
+  long long Profiler::value(const std::string& name,
+                            PerfCounters::Event event) const {
+    _lock.lock();
+    const Data* data = find(name);
+    long long result = data ? data->counters[event] : 0;
+    _lock.unlock();
+    return result;
+  }
+
+  std::vector<std::string> Profiler::regions() const {
+    _lock.lock();
+    std::vector<std::string> result;
+    for (int i = 0; i < int(_data.size()); ++i) {
+      result.push_back(_data[i].name);
+    }
+    _lock.unlock();
+    return result;
+  }
+
+  void Profiler::report(std::ostream& os) const {
+    _lock.lock();
+    for (int i = 0; i < int(_data.size()); ++i) {
+      const Data& data = _data[i];
+      os << data.name << ": " << data.count << " calls, " << data.time;
+      if (data.has_counters) {
+        for (int j = 0; j < PerfCounters::EVENT_NUM; ++j) {
+          os << ", " << PerfCounters::name(PerfCounters::Event(j))
+             << ": " << data.counters[j];
+        }
+      }
+      os << std::endl;
+    }
+    _lock.unlock();
+  }
+
+}
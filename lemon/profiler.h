@@ -0,0 +1,268 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_PROFILER_H
+#define LEMON_PROFILER_H
+
+///\ingroup timecount
+///\file
+///\brief Hardware performance counters and a region profiler.
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <lemon/config.h>
+#include <lemon/time_measure.h>
+#include <lemon/bits/lock.h>
+
+namespace lemon {
+
+  /// \addtogroup timecount
+  /// @{
+
+  /// \brief Hardware performance counters of the calling thread.
+  ///
+  /// This class reads hardware performance counters (e.g. cpu cycles
+  /// and cache misses) of the thread that created the object. It uses
+  /// the \c perf_event interface of Linux. On other systems, or if the
+  /// counters cannot be opened (e.g. because of the
+  /// <tt>/proc/sys/kernel/perf_event_paranoid</tt> setting or the lack
+  /// of hardware support), the counters are not \ref available() and
+  /// their values are zero.
+  ///
+  /// Similarly to \ref Timer, the counters can be started and stopped
+  /// several times, and they collect the events while they are running.
+  /// Only the events in user space are counted.
+  ///
+  ///\code
+  /// PerfCounters pc;
+  /// pc.start();
+  /// doSomething();
+  /// pc.stop();
+  /// std::cout << pc.value(PerfCounters::CACHE_MISSES) << '\n';
+  ///\endcode
+  ///
+  /// \sa Profiler
+  class PerfCounters {
+  public:
+
+    /// \brief The measured events.
+    ///
+    /// The measured events.
+    enum Event {
+      /// Cpu cycles.
+      CYCLES,
+      /// Retired instructions.
+      INSTRUCTIONS,
+      /// Last level cache misses.
+      CACHE_MISSES,
+      /// Mispredicted branch instructions.
+      BRANCH_MISSES
+    };
+
+    /// The number of the events.
+    static const int EVENT_NUM = 4;
+
+    /// \brief Checks whether the hardware counters are supported.
+    ///
+    /// This function returns \c true if LEMON was compiled with
+    /// \c perf_event support. Note that the counters may still be
+    /// unavailable at runtime.
+    static bool supported();
+
+    /// \brief Constructor.
+    ///
+    /// Constructor, which opens the counters for the calling thread.
+    /// \param run indicates whether the counters start immediately.
+    explicit PerfCounters(bool run = false);
+
+    /// \brief Destructor.
+    ~PerfCounters();
+
+    /// \brief Checks whether a counter is available.
+    bool available(Event event) const {
+      return _fd[event] >= 0;
+    }
+
+    /// \brief Checks whether any counter is available.
+    bool available() const;
+
+    /// \brief Starts the counters.
+    void start();
+
+    /// \brief Stops the counters.
+    void stop();
+
+    /// \brief Sets the counters to zero.
+    void reset();
+
+    /// \brief Checks whether the counters are running.
+    bool running() const {
+      return _running;
+    }
+
+    /// \brief The value of a counter.
+    ///
+    /// This function returns the number of the given events measured
+    /// so far, or zero if the counter is not available.
+    long long value(Event event) const;
+
+    /// \brief The name of an event.
+    static const char* name(Event event);
+
+  private:
+    int _fd[EVENT_NUM];
+    bool _running;
+
+    PerfCounters(const PerfCounters&);
+    void operator=(const PerfCounters&);
+  };
+
+  /// \brief Profiler aggregating the running times of named regions.
+  ///
+  /// This class measures the running times of named regions of the
+  /// code, and it aggregates the times of the regions having the same
+  /// name. A region is measured by a \ref Profiler::Region "Region"
+  /// object from its construction to its destruction. The regions can
+  /// be nested, and they can be measured in several threads
+  /// concurrently. The cpu times of a region are the cpu times of the
+  /// executing thread (see \ref TimeStamp::THREAD_TIME), and optionally
+  /// the \ref PerfCounters "hardware counters" of the thread are also
+  /// recorded.
+  ///
+  ///\code
+  /// Profiler prof;
+  /// for (int i = 0; i < n; ++i) {
+  ///   Profiler::Region r(prof, "search");
+  ///   doSomething();
+  /// }
+  /// {
+  ///   Profiler::Region r(prof, "update");
+  ///   doSomethingElse();
+  /// }
+  /// prof.report(std::cout);
+  ///\endcode
+  ///
+  /// \note Opening the hardware counters requires some system calls,
+  /// so they are recommended only for regions that are not too short.
+  ///
+  /// \sa TimeReport
+  class Profiler {
+  public:
+
+    /// \brief Scoped measurement of a region.
+    ///
+    /// The object of this class measures the region of the code
+    /// between its construction and its destruction, and it adds
+    /// the results to the given \ref Profiler.
+    class Region {
+    public:
+      /// \brief Constructor.
+      ///
+      /// Constructor, which starts the measurement of the region
+      /// with the given name.
+      Region(Profiler& profiler, const std::string& name);
+
+      /// \brief Destructor.
+      ///
+      /// Destructor, which stops the measurement and adds the results
+      /// to the profiler.
+      ~Region();
+
+    private:
+      Profiler& _profiler;
+      std::string _name;
+      TimeStamp _start;
+      PerfCounters* _counters;
+
+      Region(const Region&);
+      void operator=(const Region&);
+    };
+
+    /// \brief Constructor.
+    ///
+    /// Constructor.
+    /// \param counters indicates whether the hardware counters are
+    /// also recorded.
+    explicit Profiler(bool counters = false)
+      : _record_counters(counters) {}
+
+    /// \brief Clears the collected data.
+    void reset();
+
+    /// \brief Adds a measurement to a region.
+    ///
+    /// This function adds an execution of the given region with the
+    /// given running time to the profiler.
+    void add(const std::string& name, const TimeStamp& time,
+             const long long* counters = 0);
+
+    /// \brief The number of the executions of a region.
+    int count(const std::string& name) const;
+
+    /// \brief The total running time of a region.
+    TimeStamp time(const std::string& name) const;
+
+    /// \brief The total value of a hardware counter of a region.
+    long long value(const std::string& name,
+                    PerfCounters::Event event) const;
+
+    /// \brief The names of the regions.
+    ///
+    /// This function returns the names of the regions in the order
+    /// in which they were first entered.
+    std::vector<std::string> regions() const;
+
+    /// \brief Prints a report.
+    ///
+    /// This function prints the number of the executions, the total
+    /// running time and the hardware counters of each region in the
+    /// order in which they were first entered.
+    void report(std::ostream& os = std::cerr) const;
+
+  private:
+
+    struct Data {
+      std::string name;
+      int count;
+      TimeStamp time;
+      long long counters[PerfCounters::EVENT_NUM];
+      bool has_counters;
+    };
+
+    bool _record_counters;
+    std::vector<Data> _data;
+    std::map<std::string, int> _index;
+    mutable bits::Lock _lock;
+
+    Data& insert(const std::string& name);
+    const Data* find(const std::string& name) const;
+
+    Profiler(const Profiler&);
+    void operator=(const Profiler&);
+
+    friend class Region;
+  };
+
+  /// @}
+
+}
+
+#endif
@@ -84,7 +84,7 @@
 
 ///\ingroup misc
 ///\file
-///\brief Mersenne Twister random number generator
+///\brief Mersenne Twister and Philox random number generators
 
 namespace lemon {
 
@@ -240,6 +240,28 @@ namespace lemon {
         return RandomTraits<Word>::tempering(rnd);
       }
 
+      void generate(Word* out, int num) {
+        while (num > 0) {
+          if (current == state) fillState();
+          int len = static_cast<int>(current - state);
+          if (len > num) len = num;
+          const Word *curr = current;
+          for (int i = 0; i < len; ++i) {
+            out[i] = RandomTraits<Word>::tempering(curr[- 1 - i]);
+          }
+          current -= len; out += len; num -= len;
+        }
+      }
+
+      void discard(unsigned long long num) {
+        while (num > 0) {
+          if (current == state) fillState();
+          unsigned long long len = current - state;
+          if (len > num) len = num;
+          current -= len; num -= len;
+        }
+      }
+
     private:
 
       void fillState() {
@@ -274,6 +296,139 @@ namespace lemon {
 
     };
 
+    // Philox4x32-10 counter-based generator of Salmon et al. The n-th
+    // block of 128 bits is a keyed bijection of the counter whose high
+    // 64 bits are the stream id and low 64 bits are n, so any position
+    // of any stream can be computed directly.
+    template <typename _Word>
+    class PhiloxCore {
+    public:
+
+      typedef _Word Word;
+
+    private:
+
+      static const int bits = std::numeric_limits<Word>::digits;
+      static const int block = 128 / bits;
+
+      typedef unsigned int Half;
+      typedef unsigned long long Long;
+
+    public:
+
+      void initState() {
+        initKey(0x12345u);
+      }
+
+      void initState(Word seed) {
+        initKey(Long(seed));
+      }
+
+      template <typename Iterator>
+      void initState(Iterator begin, Iterator end) {
+        Long key = 0;
+        for (Iterator it = begin; it != end; ++it) {
+          key = mix(key ^ Long(*it));
+        }
+        initKey(key);
+      }
+
+      void copyState(const PhiloxCore& other) {
+        *this = other;
+      }
+
+      Word operator()() {
+        if (pos == block) {
+          compute(index++, buffer);
+          pos = 0;
+        }
+        return buffer[pos++];
+      }
+
+      void generate(Word* out, int num) {
+        while (num > 0 && pos < block) {
+          *out++ = buffer[pos++];
+          --num;
+        }
+        while (num >= block) {
+          compute(index++, out);
+          out += block; num -= block;
+        }
+        if (num > 0) {
+          compute(index++, buffer);
+          for (pos = 0; pos < num; ++pos) out[pos] = buffer[pos];
+        }
+      }
+
+      void discard(unsigned long long num) {
+        unsigned long long rest = block - pos;
+        if (num <= rest) {
+          pos += static_cast<int>(num);
+          return;
+        }
+        num -= rest;
+        index += num / block;
+        pos = block;
+        if (num % block != 0) {
+          compute(index++, buffer);
+          pos = static_cast<int>(num % block);
+        }
+      }
+
+      void stream(unsigned long long id) {
+        sid = id;
+        index = 0;
+        pos = block;
+      }
+
+    private:
+
+      static Long mix(Long x) {
+        x += (Long(0x9E3779B9u) << 32 | Long(0x7F4A7C15u));
+        x = (x ^ (x >> 30)) * (Long(0xBF58476Du) << 32 | Long(0x1CE4E5B9u));
+        x = (x ^ (x >> 27)) * (Long(0x94D049BBu) << 32 | Long(0x133111EBu));
+        return x ^ (x >> 31);
+      }
+
+      void initKey(Long seed) {
+        key[0] = Half(seed & 0xFFFFFFFFu);
+        key[1] = Half(seed >> 32);
+        sid = 0;
+        index = 0;
+        pos = block;
+      }
+
+      void compute(Long n, Word* out) const {
+        Half c0 = Half(n & 0xFFFFFFFFu), c1 = Half(n >> 32);
+        Half c2 = Half(sid & 0xFFFFFFFFu), c3 = Half(sid >> 32);
+        Half k0 = key[0], k1 = key[1];
+        for (int r = 0; r < 10; ++r) {
+          Long p0 = Long(0xD2511F53u) * c0;
+          Long p1 = Long(0xCD9E8D57u) * c2;
+          Half h0 = Half(p0 >> 32), l0 = Half(p0 & 0xFFFFFFFFu);
+          Half h1 = Half(p1 >> 32), l1 = Half(p1 & 0xFFFFFFFFu);
+          c0 = (h1 ^ c1 ^ k0) & 0xFFFFFFFFu; c1 = l1;
+          c2 = (h0 ^ c3 ^ k1) & 0xFFFFFFFFu; c3 = l0;
+          k0 = (k0 + 0x9E3779B9u) & 0xFFFFFFFFu;
+          k1 = (k1 + 0xBB67AE85u) & 0xFFFFFFFFu;
+        }
+        if (block == 4) {
+          out[0] = Word(c0); out[1] = Word(c1);
+          out[2] = Word(c2); out[3] = Word(c3);
+        } else {
+          out[0] = Word(Long(c1) << 32 | c0);
+          out[1] = Word(Long(c3) << 32 | c2);
+        }
+      }
+
+      Half key[2];
+      Long sid;
+      Long index;
+      int pos;
+      Word buffer[4];
+
+    };
+
 
     template <typename Result,
               int shift = (std::numeric_limits<Result>::digits + 1) / 2>
@@ -297,7 +452,8 @@ namespace lemon {
     struct IntConversion {
       static const int bits = std::numeric_limits<Word>::digits;
 
-      static Result convert(RandomCore<Word>& rnd) {
+      template <typename Core>
+      static Result convert(Core& rnd) {
         return static_cast<Result>(rnd() >> (bits - rest)) << shift;
       }
 
@@ -307,7 +463,8 @@ namespace lemon {
     struct IntConversion<Result, Word, rest, shift, false> {
       static const int bits = std::numeric_limits<Word>::digits;
 
-      static Result convert(RandomCore<Word>& rnd) {
+      template <typename Core>
+      static Result convert(Core& rnd) {
         return (static_cast<Result>(rnd()) << shift) |
           IntConversion<Result, Word, rest - bits, shift + bits>::convert(rnd);
       }
@@ -318,7 +475,8 @@ namespace lemon {
               bool one_word = (std::numeric_limits<Word>::digits <
                                std::numeric_limits<Result>::digits) >
     struct Mapping {
-      static Result map(RandomCore<Word>& rnd, const Result& bound) {
+      template <typename Core>
+      static Result map(Core& rnd, const Result& bound) {
         Word max = Word(bound - 1);
         Result mask = Masker<Result>::mask(bound - 1);
         Result num;
@@ -331,7 +489,8 @@ namespace lemon {
 
     template <typename Result, typename Word>
     struct Mapping<Result, Word, false> {
-      static Result map(RandomCore<Word>& rnd, const Result& bound) {
+      template <typename Core>
+      static Result map(Core& rnd, const Result& bound) {
         Word max = Word(bound - 1);
         Word mask = Masker<Word, (std::numeric_limits<Result>::digits + 1) / 2>
           ::mask(max);
@@ -401,7 +560,8 @@ namespace lemon {
     struct RealConversion{
       static const int bits = std::numeric_limits<Word>::digits;
 
-      static Result convert(RandomCore<Word>& rnd) {
+      template <typename Core>
+      static Result convert(Core& rnd) {
         return Shifting<Result, shift + rest>::
           shift(static_cast<Result>(rnd() >> (bits - rest)));
       }
@@ -411,7 +571,8 @@ namespace lemon {
     struct RealConversion<Result, Word, rest, shift, false> {
       static const int bits = std::numeric_limits<Word>::digits;
 
-      static Result convert(RandomCore<Word>& rnd) {
+      template <typename Core>
+      static Result convert(Core& rnd) {
         return Shifting<Result, shift + bits>::
           shift(static_cast<Result>(rnd())) +
           RealConversion<Result, Word, rest-bits, shift + bits>::
@@ -422,8 +583,8 @@ namespace lemon {
     template <typename Result, typename Word>
     struct Initializer {
 
-      template <typename Iterator>
-      static void init(RandomCore<Word>& rnd, Iterator begin, Iterator end) {
+      template <typename Core, typename Iterator>
+      static void init(Core& rnd, Iterator begin, Iterator end) {
         std::vector<Word> ws;
         for (Iterator it = begin; it != end; ++it) {
           ws.push_back(Word(*it));
@@ -431,14 +592,16 @@ namespace lemon {
         rnd.initState(ws.begin(), ws.end());
       }
 
-      static void init(RandomCore<Word>& rnd, Result seed) {
+      template <typename Core>
+      static void init(Core& rnd, Result seed) {
         rnd.initState(seed);
       }
     };
 
     template <typename Word>
     struct BoolConversion {
-      static bool convert(RandomCore<Word>& rnd) {
+      template <typename Core>
+      static bool convert(Core& rnd) {
         return (rnd() & 1) == 1;
       }
     };
@@ -450,7 +613,8 @@ namespace lemon {
 
       BoolProducer() : num(0) {}
 
-      bool convert(RandomCore<Word>& rnd) {
+      template <typename Core>
+      bool convert(Core& rnd) {
         if (num == 0) {
           buffer = rnd();
           num = RandomTraits<Word>::bits;
@@ -462,6 +626,17 @@ namespace lemon {
       }
     };
 
+    template <typename Word>
+    struct WordBuffer {
+      const Word* current;
+
+      WordBuffer(const Word* words) : current(words) {}
+
+      Word operator()() {
+        return *current++;
+      }
+    };
+
     /// \ingroup misc
     ///
     /// \brief Mersenne Twister random number generator
@@ -518,12 +693,19 @@ namespace lemon {
     /// \ref lemon::rnd "rnd". In most cases, it is a good practice
     /// to use this global generator to get random numbers.
     ///
-    /// \sa \ref Random, \ref Random32 or \ref Random64.
-    template<class Word>
+    /// The second template parameter selects the underlying generator.
+    /// By default, it is the Mersenne Twister, while \ref Philox and
+    /// \ref Philox32 use the counter-based Philox4x32-10 generator,
+    /// which provides independent \ref stream() "streams" for parallel
+    /// computations.
+    ///
+    /// \sa \ref Random, \ref Random32, \ref Random64, \ref Philox or
+    /// \ref Philox32.
+    template<class Word, class Core = RandomCore<Word> >
     class Random {
     private:
 
-      _random_bits::RandomCore<Word> core;
+      Core core;
       _random_bits::BoolProducer<Word> bool_producer;
 
 
@@ -660,6 +842,33 @@ namespace lemon {
         return true;
       }
 
+      /// \brief Skips words of the random sequence
+      ///
+      /// This function advances the generator as if \c num words were
+      /// generated. It takes constant time for the counter-based
+      /// generators (\ref Philox, \ref Philox32), and linear time with
+      /// a small constant factor for the Mersenne Twister.
+      void discard(unsigned long long num) {
+        core.discard(num);
+      }
+
+      /// \brief Selects a stream of a counter-based generator
+      ///
+      /// This function restarts the generator at the beginning of the
+      /// stream with the given identifier. The streams of a seed are
+      /// independent and reproducible sequences, so the threads of a
+      /// parallel computation can use the same seed and their own
+      /// streams, e.g. the thread index.
+      ///\code
+      /// Philox gen(seed);
+      /// gen.stream(thread);
+      ///\endcode
+      /// \note This function is available only for the counter-based
+      /// generators, i.e. \ref Philox and \ref Philox32.
+      void stream(unsigned long long id) {
+        core.stream(id);
+      }
+
       /// @}
 
       ///\name Uniform Distributions
@@ -998,6 +1207,151 @@ namespace lemon {
       }
 
       ///@}
+
+      ///\name Bulk Generation
+      /// The following functions fill a range with random numbers. They
+      /// generate the random words in blocks and convert them in tight
+      /// loops, so they are considerably faster than the repeated calls
+      /// of the corresponding single value functions.
+      ///@{
+
+      /// \brief Fills a range with random words
+      ///
+      /// This function fills the array of \c num words with random words.
+      /// The result is the same as that of \c num calls of
+      /// <tt>uinteger<Word>()</tt>.
+      void fillWords(Word* out, int num) {
+        core.generate(out, num);
+      }
+
+      /// \brief Fills a range with random real numbers from [0, 1)
+      ///
+      /// This function fills the given range with random real numbers
+      /// from the range [0, 1). The result is the same as that of the
+      /// repeated calls of \c real() with the value type of the range.
+      template <typename Iterator>
+      void fillReal(Iterator begin, Iterator end) {
+        typedef typename std::iterator_traits<Iterator>::value_type Number;
+        Number buf[BULK];
+        while (begin != end) {
+          int num = 0;
+          for (Iterator it = begin; num < BULK && it != end; ++it) ++num;
+          fillReals(buf, num);
+          for (int i = 0; i < num; ++i, ++begin) *begin = buf[i];
+        }
+      }
+
+      /// \brief Fills a range with random real numbers from [a, b)
+      ///
+      /// This function fills the given range with random real numbers
+      /// from the range [a, b). The result is the same as that of the
+      /// repeated calls of <tt>operator()(a, b)</tt>.
+      template <typename Iterator>
+      void fillReal(Iterator begin, Iterator end, double a, double b) {
+        double buf[BULK];
+        while (begin != end) {
+          int num = 0;
+          for (Iterator it = begin; num < BULK && it != end; ++it) ++num;
+          fillReals(buf, num);
+          for (int i = 0; i < num; ++i, ++begin) {
+            *begin = buf[i] * (b - a) + a;
+          }
+        }
+      }
+
+      /// \brief Fills a range with random integers from a range
+      ///
+      /// This function fills the given range with random integers from
+      /// the range {a, a + 1, ..., b - 1}. The result is the same as
+      /// that of the repeated calls of <tt>integer(a, b)</tt>.
+      template <typename Iterator, typename Number>
+      void fillInteger(Iterator begin, Iterator end, Number a, Number b) {
+        for (; begin != end; ++begin) {
+          *begin = _random_bits::Mapping<Number, Word>::map(core, b - a) + a;
+        }
+      }
+
+      /// \brief Fills a range with random integers from a range
+      ///
+      /// This function fills the given range with random integers from
+      /// the range {0, 1, ..., b - 1}. The result is the same as that of
+      /// the repeated calls of <tt>integer(b)</tt>.
+      template <typename Iterator, typename Number>
+      void fillInteger(Iterator begin, Iterator end, Number b) {
+        fillInteger(begin, end, Number(0), b);
+      }
+
+      /// \brief Fills a range with normal (Gauss) random numbers
+      ///
+      /// This function fills the given range with random numbers of
+      /// normal distribution with the given mean and standard deviation.
+      /// \note Unlike \ref gauss(), this function uses both random
+      /// variables provided by each step of the Box-Muller method, so
+      /// the generated sequence differs from that of the repeated calls
+      /// of \ref gauss().
+      template <typename Iterator>
+      void fillGauss(Iterator begin, Iterator end,
+                     double mean = 0.0, double std_dev = 1.0) {
+        double buf[BULK];
+        while (begin != end) {
+          int num = 0;
+          for (Iterator it = begin; num < BULK && it != end; ++it) ++num;
+          num += num & 1;
+          fillReals(buf, num);
+          for (int i = 0; i < num && begin != end; i += 2) {
+            double V1 = 2 * buf[i] - 1;
+            double V2 = 2 * buf[i + 1] - 1;
+            double S = V1 * V1 + V2 * V2;
+            if (S >= 1 || S == 0) continue;
+            double W = std::sqrt(-2 * std::log(S) / S) * std_dev;
+            *begin = W * V1 + mean;
+            if (++begin == end) break;
+            *begin = W * V2 + mean;
+            ++begin;
+          }
+        }
+      }
+
+      /// \brief Fills a range with exponential random numbers
+      ///
+      /// This function fills the given range with random numbers of
+      /// exponential distribution with mean <tt>1/lambda</tt>. The result
+      /// is the same as that of the repeated calls of
+      /// <tt>exponential(lambda)</tt>.
+      template <typename Iterator>
+      void fillExponential(Iterator begin, Iterator end, double lambda = 1.0) {
+        double buf[BULK];
+        while (begin != end) {
+          int num = 0;
+          for (Iterator it = begin; num < BULK && it != end; ++it) ++num;
+          fillReals(buf, num);
+          for (int i = 0; i < num; ++i) {
+            buf[i] = -std::log(1.0 - buf[i]) / lambda;
+          }
+          for (int i = 0; i < num; ++i, ++begin) *begin = buf[i];
+        }
+      }
+
+      ///@}
+
+    private:
+
+      static const int BULK = 256;
+
+      template <typename Number>
+      void fillReals(Number* out, int num) {
+        static const int bits = std::numeric_limits<Word>::digits;
+        static const int words =
+          (std::numeric_limits<Number>::digits + bits - 1) / bits;
+        Word buf[words * BULK];
+        core.generate(buf, words * num);
+        _random_bits::WordBuffer<Word> words_buf(buf);
+        for (int i = 0; i < num; ++i) {
+          out[i] = _random_bits::RealConversion<Number, Word>::
+            convert(words_buf);
+        }
+      }
+
     };
 
 
@@ -1048,6 +1402,43 @@ namespace lemon {
   /// \sa \ref _random_bits::Random
   typedef _random_bits::Random<unsigned long long> Random64;
 
+  /// \ingroup misc
+  ///
+  /// \brief Counter-based Philox random number generator
+  ///
+  /// This class implements the Philox4x32-10 counter-based random number
+  /// generator of Salmon et al. producing 64-bit words. The n-th block of
+  /// the random sequence is computed directly from the seed, the stream
+  /// identifier and n, therefore \ref _random_bits::Random::discard()
+  /// "discard()" takes constant time, and each seed provides
+  /// 2<sup>64</sup> independent and reproducible
+  /// \ref _random_bits::Random::stream() "streams". It is recommended to
+  /// be used in parallel computations, where each thread should use its
+  /// own stream of the same seed. The generated sequences are the same
+  /// on every platform.
+  ///
+  /// For the API description, see its base class
+  /// \ref _random_bits::Random.
+  ///
+  /// \sa \ref _random_bits::Random
+  typedef _random_bits::Random<unsigned long long,
+    _random_bits::PhiloxCore<unsigned long long> > Philox;
+
+  /// \ingroup misc
+  ///
+  /// \brief Counter-based Philox random number generator (32-bit version)
+  ///
+  /// This class implements the Philox4x32-10 counter-based random number
+  /// generator producing 32-bit words. Apart from the word size, it is
+  /// the same as \ref Philox.
+  ///
+  /// For the API description, see its base class
+  /// \ref _random_bits::Random.
+  ///
+  /// \sa \ref _random_bits::Random
+  typedef _random_bits::Random<unsigned int,
+    _random_bits::PhiloxCore<unsigned int> > Philox32;
+
   extern Random rnd;
   
 }
@@ -28,6 +28,7 @@
 #include <lemon/core.h>
 #include <lemon/error.h>
 #include <lemon/bits/graph_extender.h>
+#include <lemon/bits/vector_utils.h>
 
 namespace lemon {
 
@@ -38,12 +39,12 @@ namespace lemon {
 
     struct NodeT
     {
-      int first_in, first_out;
+      Index first_in, first_out;
       NodeT() {}
     };
     struct ArcT
     {
-      int target, source, next_in, next_out;
+      Index target, source, next_in, next_out;
       ArcT() {}
     };
 
@@ -66,14 +67,14 @@ namespace lemon {
     typedef True NodeNumTag;
     typedef True ArcNumTag;
 
-    int nodeNum() const { return _nodes.size(); }
-    int arcNum() const { return _arcs.size(); }
+    Index nodeNum() const { return _nodes.size(); }
+    Index arcNum() const { return _arcs.size(); }
 
-    int maxNodeId() const { return _nodes.size()-1; }
-    int maxArcId() const { return _arcs.size()-1; }
+    Index maxNodeId() const { return _nodes.size()-1; }
+    Index maxArcId() const { return _arcs.size()-1; }
 
     Node addNode() {
-      int n = _nodes.size();
+      Index n = _nodes.size();
       _nodes.push_back(NodeT());
       _nodes[n].first_in = -1;
       _nodes[n].first_out = -1;
@@ -81,7 +82,7 @@ namespace lemon {
     }
 
     Arc addArc(Node u, Node v) {
-      int n = _arcs.size();
+      Index n = _arcs.size();
       _arcs.push_back(ArcT());
       _arcs[n].source = u._id;
       _arcs[n].target = v._id;
@@ -100,17 +101,17 @@ namespace lemon {
     Node source(Arc a) const { return Node(_arcs[a._id].source); }
     Node target(Arc a) const { return Node(_arcs[a._id].target); }
 
-    static int id(Node v) { return v._id; }
-    static int id(Arc a) { return a._id; }
+    static Index id(Node v) { return v._id; }
+    static Index id(Arc a) { return a._id; }
 
-    static Node nodeFromId(int id) { return Node(id);}
-    static Arc arcFromId(int id) { return Arc(id);}
+    static Node nodeFromId(Index id) { return Node(id);}
+    static Arc arcFromId(Index id) { return Arc(id);}
 
     bool valid(Node n) const {
-      return n._id >= 0 && n._id < static_cast<int>(_nodes.size());
+      return n._id >= 0 && n._id < static_cast<Index>(_nodes.size());
     }
     bool valid(Arc a) const {
-      return a._id >= 0 && a._id < static_cast<int>(_arcs.size());
+      return a._id >= 0 && a._id < static_cast<Index>(_arcs.size());
     }
 
     class Node {
@@ -118,8 +119,8 @@ namespace lemon {
       friend class SmartDigraph;
 
     protected:
-      int _id;
-      explicit Node(int id) : _id(id) {}
+      Index _id;
+      explicit Node(Index id) : _id(id) {}
     public:
       Node() {}
       Node (Invalid) : _id(-1) {}
@@ -134,8 +135,8 @@ namespace lemon {
       friend class SmartDigraph;
 
     protected:
-      int _id;
-      explicit Arc(int id) : _id(id) {}
+      Index _id;
+      explicit Arc(Index id) : _id(id) {}
     public:
       Arc() { }
       Arc (Invalid) : _id(-1) {}
@@ -231,6 +232,57 @@ namespace lemon {
       return Parent::addArc(s, t);
     }
 
+    ///Add several new nodes to the digraph.
+
+    ///This function adds \c n new nodes to the digraph and stores them
+    ///in the given vector (its previous content is discarded).
+    ///It is faster than calling addNode() \c n times, since the storage
+    ///of the digraph is enlarged at most once and the maps of the digraph
+    ///are notified only once about all the new nodes.
+    void addNodes(Index n, std::vector<Node>& nodes) {
+      bits::reserveMore(_nodes, n);
+      Parent::addNodes(n, nodes);
+    }
+
+    ///Add several new nodes to the digraph.
+
+    ///This is an overloaded version of addNodes(), which does not
+    ///store the new nodes.
+    void addNodes(Index n) {
+      std::vector<Node> nodes;
+      addNodes(n, nodes);
+    }
+
+    ///Add several new arcs to the digraph.
+
+    ///This function adds new arcs to the digraph and stores them in the
+    ///given vector (its previous content is discarded).
+    ///The arcs must be given in the range <tt>[begin, end)</tt>
+    ///specified by STL compatible iterators whose \c value_type is
+    ///<tt>std::pair<Node,Node></tt>, where the first node is the source
+    ///and the second node is the target of an arc.
+    ///It is faster than calling addArc() for each arc, since the storage
+    ///of the digraph is enlarged at most once and the maps of the digraph
+    ///are notified only once about all the new arcs.
+    ///The range is traversed only once, so input iterators can also be
+    ///used, but then the size of the storage is not known in advance.
+    template <typename ArcListIterator>
+    void addArcs(ArcListIterator begin, ArcListIterator end,
+                 std::vector<Arc>& arcs) {
+      bits::reserveMore(_arcs, bits::rangeSize(begin, end));
+      Parent::addArcs(begin, end, arcs);
+    }
+
+    ///Add several new arcs to the digraph.
+
+    ///This is an overloaded version of addArcs(), which does not
+    ///store the new arcs.
+    template <typename ArcListIterator>
+    void addArcs(ArcListIterator begin, ArcListIterator end) {
+      std::vector<Arc> arcs;
+      addArcs(begin, end, arcs);
+    }
+
     /// \brief Node validity check
     ///
     /// This function gives back \c true if the given node is valid,
@@ -268,7 +320,7 @@ namespace lemon {
       Node b = addNode();
       _nodes[b._id].first_out=_nodes[n._id].first_out;
       _nodes[n._id].first_out=-1;
-      for(int i=_nodes[b._id].first_out; i!=-1; i=_arcs[i].next_out) {
+      for(Index i=_nodes[b._id].first_out; i!=-1; i=_arcs[i].next_out) {
         _arcs[i].source=b._id;
       }
       if(connect) addArc(n,b);
@@ -291,7 +343,7 @@ namespace lemon {
     /// then it is worth reserving space for this amount before starting
     /// to build the digraph.
     /// \sa reserveArc()
-    void reserveNode(int n) { _nodes.reserve(n); };
+    void reserveNode(Index n) { _nodes.reserve(n); };
 
     /// Reserve memory for arcs.
 
@@ -301,7 +353,7 @@ namespace lemon {
     /// then it is worth reserving space for this amount before starting
     /// to build the digraph.
     /// \sa reserveNode()
-    void reserveArc(int m) { _arcs.reserve(m); };
+    void reserveArc(Index m) { _arcs.reserve(m); };
 
   public:
 
@@ -311,14 +363,14 @@ namespace lemon {
 
     void restoreSnapshot(const Snapshot &s)
     {
-      while(s.arc_num<_arcs.size()) {
+      while(s.arc_num<Index(_arcs.size())) {
         Arc arc = arcFromId(_arcs.size()-1);
         Parent::notifier(Arc()).erase(arc);
         _nodes[_arcs.back().source].first_out=_arcs.back().next_out;
         _nodes[_arcs.back().target].first_in=_arcs.back().next_in;
         _arcs.pop_back();
       }
-      while(s.node_num<_nodes.size()) {
+      while(s.node_num<Index(_nodes.size())) {
         Node node = nodeFromId(_nodes.size()-1);
         Parent::notifier(Node()).erase(node);
         _nodes.pop_back();
@@ -349,8 +401,8 @@ namespace lemon {
       SmartDigraph *_graph;
     protected:
       friend class SmartDigraph;
-      unsigned int node_num;
-      unsigned int arc_num;
+      Index node_num;
+      Index arc_num;
     public:
       ///Default constructor.
 
@@ -52,8 +52,8 @@ namespace lemon {
     class Node {
       friend class StaticDigraphBase;
     protected:
-      int id;
-      Node(int _id) : id(_id) {}
+      Index id;
+      Node(Index _id) : id(_id) {}
     public:
       Node() {}
       Node (Invalid) : id(-1) {}
@@ -65,8 +65,8 @@ namespace lemon {
     class Arc {
       friend class StaticDigraphBase;
     protected:
-      int id;
-      Arc(int _id) : id(_id) {}
+      Index id;
+      Arc(Index _id) : id(_id) {}
     public:
       Arc() { }
       Arc (Invalid) : id(-1) {}
@@ -93,19 +93,19 @@ namespace lemon {
     void firstIn(Arc& e, const Node& n) const { e.id = node_first_in[n.id]; }
     void nextIn(Arc& e) const { e.id = arc_next_in[e.id]; }
 
-    static int id(const Node& n) { return n.id; }
-    static Node nodeFromId(int id) { return Node(id); }
-    int maxNodeId() const { return node_num - 1; }
+    static Index id(const Node& n) { return n.id; }
+    static Node nodeFromId(Index id) { return Node(id); }
+    Index maxNodeId() const { return node_num - 1; }
 
-    static int id(const Arc& e) { return e.id; }
-    static Arc arcFromId(int id) { return Arc(id); }
-    int maxArcId() const { return arc_num - 1; }
+    static Index id(const Arc& e) { return e.id; }
+    static Arc arcFromId(Index id) { return Arc(id); }
+    Index maxArcId() const { return arc_num - 1; }
 
     typedef True NodeNumTag;
     typedef True ArcNumTag;
 
-    int nodeNum() const { return node_num; }
-    int arcNum() const { return arc_num; }
+    Index nodeNum() const { return node_num; }
+    Index arcNum() const { return arc_num; }
 
   private:
 
@@ -153,15 +153,15 @@ namespace lemon {
       node_num = countNodes(digraph);
       arc_num = countArcs(digraph);
 
-      node_first_out = new int[node_num + 1];
-      node_first_in = new int[node_num];
+      node_first_out = new Index[node_num + 1];
+      node_first_in = new Index[node_num];
 
-      arc_source = new int[arc_num];
-      arc_target = new int[arc_num];
-      arc_next_out = new int[arc_num];
-      arc_next_in = new int[arc_num];
+      arc_source = new Index[arc_num];
+      arc_target = new Index[arc_num];
+      arc_next_out = new Index[arc_num];
+      arc_next_in = new Index[arc_num];
 
-      int node_index = 0;
+      Index node_index = 0;
       for (typename Digraph::NodeIt n(digraph); n != INVALID; ++n) {
         nodeRef[n] = Node(node_index);
         node_first_in[node_index] = -1;
@@ -170,9 +170,9 @@ namespace lemon {
 
       ArcLess<Digraph, NodeRefMap> arcLess(digraph, nodeRef);
 
-      int arc_index = 0;
+      Index arc_index = 0;
       for (typename Digraph::NodeIt n(digraph); n != INVALID; ++n) {
-        int source = nodeRef[n].id;
+        Index source = nodeRef[n].id;
         std::vector<GArc> arcs;
         for (typename Digraph::OutArcIt e(digraph, n); e != INVALID; ++e) {
           arcs.push_back(e);
@@ -182,7 +182,7 @@ namespace lemon {
           std::sort(arcs.begin(), arcs.end(), arcLess);
           for (typename std::vector<GArc>::iterator it = arcs.begin();
                it != arcs.end(); ++it) {
-            int target = nodeRef[digraph.target(*it)].id;
+            Index target = nodeRef[digraph.target(*it)].id;
             arcRef[*it] = Arc(arc_index);
             arc_source[arc_index] = source;
             arc_target[arc_index] = target;
@@ -200,29 +200,29 @@ namespace lemon {
     }
 
     template <typename ArcListIterator>
-    void build(int n, ArcListIterator first, ArcListIterator last) {
+    void build(Index n, ArcListIterator first, ArcListIterator last) {
       built = true;
 
       node_num = n;
-      arc_num = static_cast<int>(std::distance(first, last));
+      arc_num = static_cast<Index>(std::distance(first, last));
 
-      node_first_out = new int[node_num + 1];
-      node_first_in = new int[node_num];
+      node_first_out = new Index[node_num + 1];
+      node_first_in = new Index[node_num];
 
-      arc_source = new int[arc_num];
-      arc_target = new int[arc_num];
-      arc_next_out = new int[arc_num];
-      arc_next_in = new int[arc_num];
+      arc_source = new Index[arc_num];
+      arc_target = new Index[arc_num];
+      arc_next_out = new Index[arc_num];
+      arc_next_in = new Index[arc_num];
 
-      for (int i = 0; i != node_num; ++i) {
+      for (Index i = 0; i != node_num; ++i) {
         node_first_in[i] = -1;
       }
 
-      int arc_index = 0;
-      for (int i = 0; i != node_num; ++i) {
+      Index arc_index = 0;
+      for (Index i = 0; i != node_num; ++i) {
         node_first_out[i] = arc_index;
         for ( ; first != last && (*first).first == i; ++first) {
-          int j = (*first).second;
+          Index j = (*first).second;
           LEMON_ASSERT(j >= 0 && j < node_num,
             "Wrong arc list for StaticDigraph::build()");
           arc_source[arc_index] = i;
@@ -240,6 +240,54 @@ namespace lemon {
       node_first_out[node_num] = arc_num;
     }
 
+    template <typename Digraph>
+    void freeze(const Digraph& digraph, std::vector<Index>& nodeCrossRef,
+                std::vector<Index>& arcCrossRef) {
+      built = true;
+
+      node_num = countNodes(digraph);
+      arc_num = countArcs(digraph);
+
+      node_first_out = new Index[node_num + 1];
+      node_first_in = new Index[node_num];
+
+      arc_source = new Index[arc_num];
+      arc_target = new Index[arc_num];
+      arc_next_out = new Index[arc_num];
+      arc_next_in = new Index[arc_num];
+
+      nodeCrossRef.resize(node_num);
+      arcCrossRef.resize(arc_num);
+      std::vector<Index> node_ref(digraph.maxNodeId() + 1);
+
+      Index node_index = 0;
+      for (typename Digraph::NodeIt n(digraph); n != INVALID; ++n) {
+        node_ref[digraph.id(n)] = node_index;
+        nodeCrossRef[node_index] = digraph.id(n);
+        node_first_in[node_index] = -1;
+        ++node_index;
+      }
+
+      Index arc_index = 0;
+      for (Index source = 0; source != node_num; ++source) {
+        node_first_out[source] = arc_index;
+        typename Digraph::Node n = digraph.nodeFromId(nodeCrossRef[source]);
+        for (typename Digraph::OutArcIt e(digraph, n); e != INVALID; ++e) {
+          Index target = node_ref[digraph.id(digraph.target(e))];
+          arcCrossRef[arc_index] = digraph.id(e);
+          arc_source[arc_index] = source;
+          arc_target[arc_index] = target;
+          arc_next_in[arc_index] = node_first_in[target];
+          node_first_in[target] = arc_index;
+          arc_next_out[arc_index] = arc_index + 1;
+          ++arc_index;
+        }
+        if (arc_index > node_first_out[source])
+          arc_next_out[arc_index - 1] = -1;
+      }
+      node_first_out[node_num] = arc_num;
+    }
+
   protected:
 
     void fastFirstOut(Arc& e, const Node& n) const {
@@ -255,14 +303,14 @@ namespace lemon {
 
   protected:
     bool built;
-    int node_num;
-    int arc_num;
-    int *node_first_out;
-    int *node_first_in;
-    int *arc_source;
-    int *arc_target;
-    int *arc_next_in;
-    int *arc_next_out;
+    Index node_num;
+    Index arc_num;
+    Index *node_first_out;
+    Index *node_first_in;
+    Index *arc_source;
+    Index *arc_target;
+    Index *arc_next_in;
+    Index *arc_next_out;
   };
 
   typedef DigraphExtender<StaticDigraphBase> ExtendedStaticDigraphBase;
@@ -274,10 +322,11 @@ namespace lemon {
   ///
   /// \ref StaticDigraph is a highly efficient digraph implementation,
   /// but it is fully static.
-  /// It stores only two \c int values for each node and only four \c int
-  /// values for each arc. Moreover it provides faster item iteration than
-  /// \ref ListDigraph and \ref SmartDigraph, especially using \c OutArcIt
-  /// iterators, since its arcs are stored in an appropriate order.
+  /// It stores only two \ref Index values for each node and only four
+  /// \ref Index values for each arc. Moreover it provides faster item
+  /// iteration than \ref ListDigraph and \ref SmartDigraph, especially
+  /// using \c OutArcIt iterators, since its arcs are stored in an
+  /// appropriate order.
   /// However it only provides build() and clear() functions and does not
   /// support any other modification of the digraph.
   ///
@@ -320,35 +369,35 @@ namespace lemon {
     ///
     /// This function returns the node with the given index.
     /// \sa index()
-    static Node node(int ix) { return Parent::nodeFromId(ix); }
+    static Node node(Index ix) { return Parent::nodeFromId(ix); }
 
     /// \brief The arc with the given index.
     ///
     /// This function returns the arc with the given index.
     /// \sa index()
-    static Arc arc(int ix) { return Parent::arcFromId(ix); }
+    static Arc arc(Index ix) { return Parent::arcFromId(ix); }
 
     /// \brief The index of the given node.
     ///
     /// This function returns the index of the the given node.
     /// \sa node()
-    static int index(Node node) { return Parent::id(node); }
+    static Index index(Node node) { return Parent::id(node); }
 
     /// \brief The index of the given arc.
     ///
     /// This function returns the index of the the given arc.
     /// \sa arc()
-    static int index(Arc arc) { return Parent::id(arc); }
+    static Index index(Arc arc) { return Parent::id(arc); }
 
     /// \brief Number of nodes.
     ///
     /// This function returns the number of nodes.
-    int nodeNum() const { return node_num; }
+    Index nodeNum() const { return node_num; }
 
     /// \brief Number of arcs.
     ///
     /// This function returns the number of arcs.
-    int arcNum() const { return arc_num; }
+    Index arcNum() const { return arc_num; }
 
     /// \brief Build the digraph copying another digraph.
     ///
@@ -411,13 +460,69 @@ namespace lemon {
     ///   gr.build(4, arcs.begin(), arcs.end());
     /// \endcode
     template <typename ArcListIterator>
-    void build(int n, ArcListIterator begin, ArcListIterator end) {
+    void build(Index n, ArcListIterator begin, ArcListIterator end) {
       if (built) Parent::clear();
       StaticDigraphBase::build(n, begin, end);
       notifier(Node()).build();
       notifier(Arc()).build();
     }
 
+    /// \brief Freeze a digraph.
+    ///
+    /// This function builds the digraph as a compressed snapshot of
+    /// another digraph of any kind. It is a faster variant of
+    /// \ref build(const Digraph&, NodeRefMap&, ArcRefMap&) "build()"
+    /// for alternating modification and computation phases.
+    /// It can be called more than once, but in such case, the whole
+    /// structure and all maps will be cleared and rebuilt.
+    ///
+    /// The nodes are numbered in the order of their iteration in the
+    /// given digraph, and the outgoing arcs of each node keep their
+    /// order (they are not sorted by their targets). Instead of maps,
+    /// the cross references are stored in plain id arrays:
+    /// <tt>nodeCrossRef[index(n)]</tt> and <tt>arcCrossRef[index(a)]</tt>
+    /// are the ids of the original items of \c n and \c a, respectively.
+    ///
+    /// The function returns \c true if each item has the same id in
+    /// both digraphs. It is the case e.g. for a \ref ListDigraph after
+    /// \ref ListDigraph::compact() "compact()". Then the maps of the
+    /// original digraph can be used directly for the frozen digraph
+    /// through \ref FrozenMap, which makes both the freezing and the
+    /// thawing of the map data free.
+    ///
+    /// \param digraph An existing digraph to be copied.
+    /// \param nodeCrossRef The node cross references will be stored in
+    /// this vector.
+    /// \param arcCrossRef The arc cross references will be stored in
+    /// this vector.
+    template <typename Digraph>
+    bool freeze(const Digraph& digraph, std::vector<Index>& nodeCrossRef,
+                std::vector<Index>& arcCrossRef) {
+      if (built) Parent::clear();
+      StaticDigraphBase::freeze(digraph, nodeCrossRef, arcCrossRef);
+      notifier(Node()).build();
+      notifier(Arc()).build();
+      for (Index i = 0; i != node_num; ++i) {
+        if (nodeCrossRef[i] != i) return false;
+      }
+      for (Index i = 0; i != arc_num; ++i) {
+        if (arcCrossRef[i] != i) return false;
+      }
+      return true;
+    }
+
+    /// \brief Freeze a digraph.
+    ///
+    /// This function builds the digraph as a compressed snapshot of
+    /// another digraph. For more information, see
+    /// \ref freeze(const Digraph&, std::vector<Index>&, std::vector<Index>&)
+    /// "freeze()".
+    template <typename Digraph>
+    bool freeze(const Digraph& digraph) {
+      std::vector<Index> node_cross_ref, arc_cross_ref;
+      return freeze(digraph, node_cross_ref, arc_cross_ref);
+    }
+
     /// \brief Clear the digraph.
     ///
     /// This function erases all nodes and arcs from the digraph.
@@ -480,6 +585,69 @@ namespace lemon {
 
   };
 
+  /// \ingroup graphs
+  ///
+  /// \brief Map of a frozen digraph stored in a map of the original one.
+  ///
+  /// This map adaptor makes it possible to use a node or arc map of a
+  /// digraph as a map of a \ref StaticDigraph that was built from it
+  /// using \ref StaticDigraph::freeze() "freeze()". The values are read
+  /// and written directly in the underlying map, so the results of an
+  /// algorithm run on the frozen digraph need not be copied back.
+  ///
+  /// \tparam GR The type of the original digraph.
+  /// \tparam K The key type of the map, either \c StaticDigraph::Node
+  /// or \c StaticDigraph::Arc.
+  /// \tparam M The type of the underlying map. Its key type must be the
+  /// node or arc type of \c GR (corresponding to \c K).
+  template <typename GR, typename K, typename M>
+  class FrozenMap {
+  public:
+    ///\e
+    typedef K Key;
+    ///\e
+    typedef typename M::Value Value;
+
+    /// \brief Constructor for identical ids.
+    ///
+    /// Constructor for the case when \ref StaticDigraph::freeze()
+    /// "freeze()" returned \c true, i.e. each item kept its id.
+    FrozenMap(const GR& digraph, M& map)
+      : _digraph(digraph), _map(map), _cross_ref(0) {}
+
+    /// \brief Constructor.
+    ///
+    /// Constructor.
+    /// \param digraph The original digraph.
+    /// \param map The underlying map.
+    /// \param crossRef The node or arc cross references obtained from
+    /// \ref StaticDigraph::freeze() "freeze()".
+    FrozenMap(const GR& digraph, M& map, const std::vector<Index>& crossRef)
+      : _digraph(digraph), _map(map), _cross_ref(&crossRef) {}
+
+    ///\e
+    Value operator[](const Key& key) const {
+      return _map[item(key)];
+    }
+
+    ///\e
+    void set(const Key& key, const Value& val) {
+      _map.set(item(key), val);
+    }
+
+  private:
+
+    typename M::Key item(const Key& key) const {
+      Index id = StaticDigraph::index(key);
+      return _digraph.fromId(_cross_ref ? (*_cross_ref)[id] : id,
+                             typename M::Key());
+    }
+
+    const GR& _digraph;
+    M& _map;
+    const std::vector<Index>* _cross_ref;
+  };
+
 }
 
 #endif
@@ -0,0 +1,172 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#ifndef LEMON_STATS_H
+#define LEMON_STATS_H
+
+#include <lemon/time_measure.h>
+
+///\ingroup timecount
+///\file
+///\brief Operation statistics of the algorithms
+
+namespace lemon {
+
+  /// \addtogroup timecount
+  /// @{
+
+  /// \brief Operation statistics of an algorithm.
+  ///
+  /// This class records operation counters and phase timings of an
+  /// algorithm. It can be set as the \c Stats type of the algorithms
+  /// supporting statistics, e.g. \ref Preflow, \ref NetworkSimplex,
+  /// \ref CostScaling and \ref MaxWeightedMatching. By default, these
+  /// algorithms use \ref NoStats, which records nothing and has no
+  /// overhead at all.
+  ///
+  /// The meaning of the counter and phase indices are defined by the
+  /// algorithms in the \c StatCounter and \c StatPhase enums,
+  /// respectively. The statistics can be obtained by the \c stats()
+  /// function of the algorithm, and they are reset when the algorithm
+  /// is initialized.
+  ///
+  ///\code
+  /// Preflow<ListDigraph>::SetStats<Stats>::Create preflow(g, cap, s, t);
+  /// preflow.run();
+  /// std::cout << preflow.stats().counter(preflow.PUSHES) << ' '
+  ///           << preflow.stats().phaseTime(preflow.FIRST_PHASE) << '\n';
+  ///\endcode
+  ///
+  /// \sa NoStats
+  class Stats {
+  public:
+
+    /// The maximum number of counters.
+    static const int MAX_COUNTERS = 8;
+    /// The maximum number of phases.
+    static const int MAX_PHASES = 4;
+
+    /// Indicates whether the statistics are recorded.
+    static const bool enabled = true;
+
+  private:
+
+    long long _counters[MAX_COUNTERS];
+    TimeStamp _start[MAX_PHASES];
+    TimeStamp _times[MAX_PHASES];
+
+  public:
+
+    /// \brief Constructor.
+    ///
+    /// Constructor.
+    Stats() {
+      reset();
+    }
+
+    /// \brief Resets the statistics.
+    ///
+    /// This function sets all counters and phase times to zero.
+    void reset() {
+      for (int i = 0; i < MAX_COUNTERS; ++i) {
+        _counters[i] = 0;
+      }
+      for (int i = 0; i < MAX_PHASES; ++i) {
+        _times[i].reset();
+      }
+    }
+
+    /// \brief Increases a counter.
+    ///
+    /// This function increases the given counter by \c num.
+    void count(int counter, long long num = 1) {
+      _counters[counter] += num;
+    }
+
+    /// \brief The value of a counter.
+    ///
+    /// This function returns the value of the given counter.
+    long long counter(int counter) const {
+      return _counters[counter];
+    }
+
+    /// \brief Starts the time measurement of a phase.
+    ///
+    /// This function starts the time measurement of the given phase.
+    void startPhase(int phase) {
+      _start[phase].stamp();
+    }
+
+    /// \brief Stops the time measurement of a phase.
+    ///
+    /// This function stops the time measurement of the given phase
+    /// and adds the elapsed time to the time of the phase.
+    void stopPhase(int phase) {
+      TimeStamp now;
+      now.stamp();
+      _times[phase] += now - _start[phase];
+    }
+
+    /// \brief The time of a phase.
+    ///
+    /// This function returns the total time spent in the given phase.
+    const TimeStamp& phaseTime(int phase) const {
+      return _times[phase];
+    }
+
+  };
+
+  /// \brief Statistics class recording nothing.
+  ///
+  /// This class has the same interface as \ref Stats, but it does
+  /// not record anything, so the compiler can remove all statistics
+  /// related code from the algorithms. It is the default \c Stats
+  /// type of the algorithms.
+  ///
+  /// \sa Stats
+  class NoStats {
+  public:
+
+    /// The maximum number of counters.
+    static const int MAX_COUNTERS = Stats::MAX_COUNTERS;
+    /// The maximum number of phases.
+    static const int MAX_PHASES = Stats::MAX_PHASES;
+
+    /// Indicates whether the statistics are recorded.
+    static const bool enabled = false;
+
+    /// \e
+    void reset() {}
+    /// \e
+    void count(int, long long = 1) {}
+    /// \e
+    long long counter(int) const { return 0; }
+    /// \e
+    void startPhase(int) {}
+    /// \e
+    void stopPhase(int) {}
+    /// \e
+    TimeStamp phaseTime(int) const { return TimeStamp(); }
+
+  };
+
+  ///@}
+
+}
+
+#endif
@@ -29,8 +29,10 @@
 #include <lemon/bits/windows.h>
 #else
 #include <unistd.h>
+#include <time.h>
 #include <sys/times.h>
 #include <sys/time.h>
+#include <sys/resource.h>
 #endif
 
 #include <string>
@@ -55,6 +57,12 @@ namespace lemon {
   /// TimeStamp's can be added to or substracted from each other and
   /// they can be pushed to a stream.
   ///
+  /// The real time is read from a monotonic clock and the cpu times
+  /// are read with \c getrusage() if they are available, so the
+  /// resolution of the values is about a microsecond on most systems.
+  /// The cpu times can be obtained either for the whole process or
+  /// for the calling thread, see \ref Clock.
+  ///
   /// In most cases, perhaps the \ref Timer or the \ref TimeReport
   /// class is what you want to use instead.
 
@@ -78,8 +86,21 @@ namespace lemon {
       SHORT = 1
     };
 
+    ///Cpu time specifier
+
+    ///\e
+    ///
+    enum Clock {
+      /// The cpu times of the whole process (including all threads)
+      PROCESS_TIME = 0,
+      /// The cpu times of the calling thread. The cpu times of the
+      /// children are not calculated in this mode.
+      THREAD_TIME = 1
+    };
+
   private:
     static Format _format;
+    static Clock _clock;
 
     void _reset() {
       utime = stime = cutime = cstime = rtime = 0;
@@ -100,24 +121,74 @@ namespace lemon {
     ///The output format is global for all timestamp instances.
     static Format format() { return _format; }
 
+    ///Set the default cpu time clock
+
+    ///Set the clock used by \ref stamp() for the cpu times.
+    ///
+    ///The clock is global for all timestamp instances, its default
+    ///value is \ref PROCESS_TIME. It affects the \ref Timer and
+    ///\ref TimeReport classes, as well.
+    ///\warning Do not change the clock while a \ref Timer is running.
+    static void clock(Clock c) { _clock = c; }
+    ///Retrieve the default cpu time clock
+
+    ///Retrieve the default cpu time clock.
+    ///
+    ///The clock is global for all timestamp instances.
+    static Clock clock() { return _clock; }
 
     ///Read the current time values of the process
     void stamp()
     {
+      stamp(_clock);
+    }
+
+    ///Read the current time values using the given cpu time clock
+
+    ///Read the current real time and the cpu times of the process or
+    ///the calling thread according to \c c.
+    ///\note If the cpu times of a thread cannot be obtained on the
+    ///platform, then the cpu times of the process are read.
+    void stamp(Clock c)
+    {
 #ifndef LEMON_WIN32
+#if defined(_POSIX_TIMERS) && _POSIX_TIMERS > 0 && defined(CLOCK_MONOTONIC)
+      timespec tp;
+      clock_gettime(CLOCK_MONOTONIC, &tp);
+      rtime=tp.tv_sec+double(tp.tv_nsec)/1e9;
+#else
       timeval tv;
       gettimeofday(&tv, 0);
       rtime=tv.tv_sec+double(tv.tv_usec)/1e6;
+#endif
 
-      tms ts;
-      double tck=sysconf(_SC_CLK_TCK);
-      times(&ts);
-      utime=ts.tms_utime/tck;
-      stime=ts.tms_stime/tck;
-      cutime=ts.tms_cutime/tck;
-      cstime=ts.tms_cstime/tck;
+      rusage ru;
+#ifdef RUSAGE_THREAD
+      if (c == THREAD_TIME) {
+        getrusage(RUSAGE_THREAD, &ru);
+        utime=ru.ru_utime.tv_sec+double(ru.ru_utime.tv_usec)/1e6;
+        stime=ru.ru_stime.tv_sec+double(ru.ru_stime.tv_usec)/1e6;
+        cutime=cstime=0;
+        return;
+      }
+#endif
+      getrusage(RUSAGE_SELF, &ru);
+      utime=ru.ru_utime.tv_sec+double(ru.ru_utime.tv_usec)/1e6;
+      stime=ru.ru_stime.tv_sec+double(ru.ru_stime.tv_usec)/1e6;
+      if (c == THREAD_TIME) {
+        cutime=cstime=0;
+      } else {
+        getrusage(RUSAGE_CHILDREN, &ru);
+        cutime=ru.ru_utime.tv_sec+double(ru.ru_utime.tv_usec)/1e6;
+        cstime=ru.ru_stime.tv_sec+double(ru.ru_stime.tv_usec)/1e6;
+      }
 #else
-      bits::getWinProcTimes(rtime, utime, stime, cutime, cstime);
+      if (c == THREAD_TIME) {
+        bits::getWinThreadTimes(rtime, utime, stime);
+        cutime=cstime=0;
+      } else {
+        bits::getWinProcTimes(rtime, utime, stime, cutime, cstime);
+      }
 #endif
     }
 
@@ -306,12 +377,17 @@ namespace lemon {
   ///\ref start() "started" again, so it is possible to compute collected
   ///running times.
   ///
+  ///The cpu times of the whole process or the calling thread are
+  ///measured according to the global \ref TimeStamp::clock() "clock"
+  ///setting of \ref TimeStamp.
+  ///
   ///\warning Depending on the operation system and its actual configuration
-  ///the time counters have a certain (10ms on a typical Linux system)
-  ///granularity.
+  ///the time counters have a certain granularity (about a microsecond
+  ///on a typical Linux system, but it can be 10ms on other systems).
   ///Therefore this tool is not appropriate to measure very short times.
   ///Also, if you start and stop the timer very frequently, it could lead to
-  ///distorted results.
+  ///distorted results. For measuring many short sections of the code,
+  ///consider the usage of \ref Profiler instead.
   ///
   ///\note If you want to measure the running time of the execution of a certain
   ///function, consider the usage of \ref TimeReport instead.
@@ -25,6 +25,7 @@
 #include <lemon/core.h>
 #include <lemon/concepts/graph.h>
 #include <lemon/bits/vf2_internals.h>
+#include <lemon/bits/parallel.h>
 
 #include <vector>
 #include <algorithm>
@@ -32,6 +33,145 @@
 
 namespace lemon {
 
+  ///Prepared target graph for the %VF2 Plus Plus algorithm.
+
+  ///\ingroup graph_isomorphism This class indexes a labeled graph once
+  ///so that many (small) pattern graphs can be matched against it by
+  ///\ref Vf2pp efficiently. It stores the number of the nodes of each
+  ///label, which the \ref Vf2pp "Vf2pp" instances would compute for
+  ///each pattern again, and the nodes of each label sorted by their
+  ///degrees, which restrict the candidates of the first node of the
+  ///search in the parallel search functions of \ref Vf2pp.
+  ///
+  ///\code
+  ///  Vf2ppTarget<ListGraph> target(g2, labels2);
+  ///  for (int i = 0; i < pattern_num; ++i) {
+  ///    Vf2pp<ListGraph> alg(patterns[i], target, mapping[i], labels1[i]);
+  ///    alg.threadNum(8);
+  ///    counts[i] = alg.count();
+  ///  }
+  ///\endcode
+  ///
+  ///\tparam G2 The type of the target graph.
+  ///The default type is \ref ListGraph.
+  ///\tparam M2 The type of the NodeMap storing the integer node labels.
+  ///The labels must be the numbers {0,1,2,..,K-1}, where K is the number of
+  ///different labels. By default, it is G2::NodeMap<int>.
+  ///
+  ///\note The graph and the labels must not be changed while the object
+  ///is in use.
+  ///
+  ///\sa Vf2pp
+#ifdef DOXYGEN
+  template<class G2, class M2>
+#else
+  template<class G2 = ListGraph,
+           class M2 = typename G2::template NodeMap<int> >
+#endif
+  class Vf2ppTarget {
+    const G2 &_g2;
+    M2 &_intLabels2;
+
+    //largest label
+    int _maxLabel;
+
+    //_labelCount[i] is the number of nodes with label i
+    std::vector<int> _labelCount;
+
+    //the nodes in the order of NodeIt
+    std::vector<typename G2::Node> _nodes;
+
+    //_candidates[i] contains the (degree, index in _nodes) pairs
+    //of the nodes with label i in decreasing order of degrees
+    std::vector<std::vector<std::pair<int,int> > > _candidates;
+
+    struct DegreeGreater {
+      bool operator()(const std::pair<int,int> &a,
+                      const std::pair<int,int> &b) const {
+        return a.first>b.first||(a.first==b.first&&a.second<b.second);
+      }
+    };
+
+  public:
+    ///Constructor
+
+    ///Constructor, which indexes the graph.
+    ///\param g2 The target graph.
+    ///\param intLabels2 The NodeMap storing the integer node labels of
+    ///the target graph.
+    Vf2ppTarget(const G2 &g2, M2 &intLabels2) :
+      _g2(g2), _intLabels2(intLabels2), _maxLabel(-1)
+    {
+      for(typename G2::NodeIt n2(_g2); n2!=INVALID; ++n2) {
+        _nodes.push_back(n2);
+        const int currIntLabel = _intLabels2[n2];
+        if(currIntLabel>_maxLabel)
+          _maxLabel=currIntLabel;
+      }
+      _labelCount.resize(_maxLabel+1,0);
+      _candidates.resize(_maxLabel+1);
+      for(unsigned int i = 0; i < _nodes.size(); ++i) {
+        const int currIntLabel = _intLabels2[_nodes[i]];
+        int deg=0;
+        for(typename G2::IncEdgeIt e2(_g2,_nodes[i]); e2!=INVALID; ++e2)
+          ++deg;
+        ++_labelCount[currIntLabel];
+        _candidates[currIntLabel].push_back(std::make_pair(deg,int(i)));
+      }
+      for(unsigned int i = 0; i < _candidates.size(); ++i)
+        std::sort(_candidates[i].begin(),_candidates[i].end(),
+                  DegreeGreater());
+    }
+
+    ///Returns the target graph.
+    const G2& graph() const
+    {
+      return _g2;
+    }
+
+    ///Returns the node labels of the target graph.
+    M2& labels() const
+    {
+      return _intLabels2;
+    }
+
+    ///Returns the largest label of the target graph.
+
+    ///Returns the largest label of the target graph or -1 if the graph
+    ///is empty.
+    int maxLabel() const
+    {
+      return _maxLabel;
+    }
+
+    ///Returns the number of the nodes with the given label.
+    int labelCount(int label) const
+    {
+      return label>=0&&label<=_maxLabel?_labelCount[label]:0;
+    }
+
+    ///Collects the candidate images of a node.
+
+    ///This function collects the nodes of the target graph that have
+    ///the given label and at least \c deg incident edges, i.e. the
+    ///possible images of a node of degree \c deg. The nodes are put
+    ///into \c nodes in the order of \c G2::NodeIt.
+    void candidates(int label, int deg,
+                    std::vector<typename G2::Node> &nodes) const
+    {
+      nodes.clear();
+      if(label<0||label>_maxLabel)
+        return;
+      const std::vector<std::pair<int,int> > &cands=_candidates[label];
+      std::vector<int> ids;
+      for(unsigned int i = 0; i < cands.size() && cands[i].first>=deg; ++i)
+        ids.push_back(cands[i].second);
+      std::sort(ids.begin(),ids.end());
+      for(unsigned int i = 0; i < ids.size(); ++i)
+        nodes.push_back(_nodes[ids[i]]);
+    }
+  };
+
   ///%VF2 Plus Plus algorithm class \cite VF2PP.
 
   ///\ingroup graph_isomorphism This class provides an efficient
@@ -55,7 +195,18 @@ namespace lemon {
   ///The labels must be the numbers {0,1,2,..,K-1}, where K is the number of
   ///different labels. By default, it is G2::NodeMap<int>.
   ///
-  ///\sa vf2pp()
+  ///The search can also be run on several threads (see \ref threadNum(),
+  ///\ref findFirst(), \ref count() and \ref findAll()). Then the
+  ///candidates of the root of the search tree are distributed
+  ///dynamically among the threads, each of them having its own copy of
+  ///the search state. The found mappings and their number are the
+  ///same as in the serial search.
+  ///
+  ///When many pattern graphs are matched against the same graph,
+  ///the latter can be indexed once by a \ref Vf2ppTarget object, which
+  ///can be passed to the constructor instead of the graph and its labels.
+  ///
+  ///\sa vf2pp(), Vf2ppTarget
 #ifdef DOXYGEN
   template<class G1, class G2, class M, class M1, class M2 >
 #else
@@ -107,6 +258,9 @@ namespace lemon {
     //(i is in {0,1,2,..,K-1}, where K is the number of diff. labels)
     M2 &_intLabels2;
 
+    //the prepared target graph or 0
+    const Vf2ppTarget<G2, M2> *_target;
+
     //largest label
     const int _maxLabel;
 
@@ -119,6 +273,27 @@ namespace lemon {
     //indicates whether the mapping or the labels must be deleted in the destructor
     bool _deallocMappingAfterUse,_deallocLabelsAfterUse;
 
+    //the search stops when _depth gets below _minDepth
+    //(it is 1 for the searches of the threads, which map _order[0]
+    //to a fixed node)
+    int _minDepth;
+
+    //the index of the candidate of _order[0] in a search of a thread
+    //(-1 before the first search)
+    int _root;
+
+    //a search of a thread is abandoned if *_bound<_root
+    //(it is used for finding the first mapping)
+    volatile int *_bound;
+
+    //number of threads
+    int _thread_num;
+
+    template<class, class, class, class, class> friend class Vf2pp;
+
+    typedef typename G1::template NodeMap<typename G2::Node> WorkMapping;
+    typedef Vf2pp<G1, G2, WorkMapping, M1, M2> Worker;
+
 
     //improved cutting function
     template<MappingType MT>
@@ -320,8 +495,12 @@ namespace lemon {
 
     //we will find pairs for the nodes of g1 in this order
     void initOrder(){
-      for(typename G2::NodeIt n2(_g2); n2!=INVALID; ++n2)
-        ++_labelTmp1[_intLabels2[n2]];
+      if(_target)
+        for(int i = 0; i <= _target->maxLabel(); ++i)
+          _labelTmp1[i]=_target->labelCount(i);
+      else
+        for(typename G2::NodeIt n2(_g2); n2!=INVALID; ++n2)
+          ++_labelTmp1[_intLabels2[n2]];
 
       typename G1::template NodeMap<int> dm1(_g1,0);
       for(typename G1::EdgeIt e(_g1); e!=INVALID; ++e) {
@@ -354,7 +533,9 @@ namespace lemon {
 
     template<MappingType MT>
     bool extMatch(){
-      while(_depth>=0) {
+      while(_depth>=_minDepth) {
+        if(_bound&&*_bound<_root)
+          return false;
         if(_depth==static_cast<int>(_order.size())) {
           //all nodes of g1 are mapped to nodes of g2
           --_depth;
@@ -474,6 +655,8 @@ namespace lemon {
         if(currIntLabel>m)
           m=currIntLabel;
       }
+      if(_target)
+        return std::max(m,_target->maxLabel());
       for(typename G2::NodeIt n2(_g2); n2!=INVALID; ++n2) {
         const int& currIntLabel = _intLabels2[n2];
         if(currIntLabel>m)
@@ -482,6 +665,166 @@ namespace lemon {
       return m;
     }
 
+    //copies the preprocessed data of other, but not its search state
+    template<class MO>
+    Vf2pp(const Vf2pp<G1, G2, MO, M1, M2> &other, M &m) :
+      _g1(other._g1), _g2(other._g2), _depth(0), _mapping(m),
+      _order(other._order), _conn(other._g2,0),
+      _currEdgeIts(other._order.size(),INVALID), _rNewLabels1(other._g1),
+      _rInOutLabels1(other._g1), _intLabels1(other._intLabels1),
+      _intLabels2(other._intLabels2), _target(other._target),
+      _maxLabel(other._maxLabel),
+      _labelTmp1(_maxLabel+1), _labelTmp2(_maxLabel+1),
+      _mapping_type(other._mapping_type), _deallocMappingAfterUse(0),
+      _deallocLabelsAfterUse(0), _minDepth(1), _root(-1), _bound(0),
+      _thread_num(1)
+    {
+      for(typename G1::NodeIt n(_g1);n!=INVALID;++n) {
+        _rNewLabels1[n]=other._rNewLabels1[n];
+        _rInOutLabels1[n]=other._rInOutLabels1[n];
+        m[n]=INVALID;
+      }
+    }
+
+    //starts the search of the mappings that map _order[0] to n2,
+    //which is the root-th node of g2
+    template<MappingType MT>
+    bool startRoot(int root,const typename G2::Node n2) {
+      _root=root;
+      _depth=0;
+      if(!feas<MT>(_order[0],n2))
+        return false;
+      addPair(_order[0],n2);
+      _depth=1;
+      return true;
+    }
+
+    //finishes the search started by startRoot()
+    void finishRoot() {
+      subPair(_order[0],_mapping[_order[0]]);
+      _depth=0;
+    }
+
+    //the default callback of findAll()
+    struct NoCallback {
+      void operator()(int, const WorkMapping&) const {}
+    };
+
+    //searches the mappings of the candidates of _order[0] on a thread
+    template<MappingType MT, typename F>
+    class SearchWorker {
+    private:
+      Vf2pp &_alg;
+      const std::vector<typename G2::Node> &_roots;
+      std::vector<Worker*> _workers;
+      std::vector<long long> _counts;
+      F &_f;
+      bool _first;
+      volatile int _bound;
+    public:
+      SearchWorker(Vf2pp &alg, const std::vector<typename G2::Node> &roots,
+                   F &f, bool first)
+        : _alg(alg), _roots(roots),
+          _workers(alg._thread_num, static_cast<Worker*>(0)),
+          _counts(alg._thread_num,0), _f(f), _first(first),
+          _bound(static_cast<int>(roots.size())) {}
+
+      ~SearchWorker() {
+        for(unsigned int i = 0; i < _workers.size(); ++i)
+          delete _workers[i];
+      }
+
+      void operator()(int thread, int begin, int end) {
+        Worker *&w = _workers[thread];
+        if(!w) {
+          w = new Worker(_alg,*new WorkMapping(_alg._g1));
+          w->_deallocMappingAfterUse=true;
+          if(_first)
+            w->_bound=&_bound;
+        }
+        for(int i = begin; i < end; ++i) {
+          if(_first&&_bound<i)
+            break;
+          if(!w->template startRoot<MT>(i,_roots[i]))
+            continue;
+          if(_first) {
+            if(w->template extMatch<MT>()) {
+              //keep the state of the search for the continuation
+              int b=_bound;
+              while(i<b&&!bits::atomicCompareAndSwap(_bound,b,i))
+                b=_bound;
+              return;
+            }
+          }
+          else
+            while(w->template extMatch<MT>()) {
+              ++_counts[thread];
+              _f(thread,w->_mapping);
+            }
+          w->finishRoot();
+        }
+      }
+
+      long long count() const {
+        long long c=0;
+        for(unsigned int i = 0; i < _counts.size(); ++i)
+          c+=_counts[i];
+        return c;
+      }
+
+      //the thread that found the first mapping or 0
+      Worker* first() const {
+        for(unsigned int i = 0; i < _workers.size(); ++i)
+          if(_workers[i]&&_workers[i]->_root==_bound)
+            return _workers[i];
+        return 0;
+      }
+    };
+
+    template<MappingType MT, typename F>
+    long long parallelFind(F &f, bool first) {
+      std::vector<typename G2::Node> roots;
+      if(_target) {
+        int deg=0;
+        for(typename G1::IncEdgeIt e1(_g1,_order[0]); e1!=INVALID; ++e1)
+          ++deg;
+        _target->candidates(_intLabels1[_order[0]],deg,roots);
+      }
+      else
+        for(typename G2::NodeIt n2(_g2); n2!=INVALID; ++n2)
+          roots.push_back(n2);
+      SearchWorker<MT,F> worker(*this,roots,f,first);
+      bits::parallelFor(static_cast<int>(roots.size()),_thread_num,worker,1);
+      if(!first)
+        return worker.count();
+
+      //continue the serial search from the first mapping
+      const Worker *w=worker.first();
+      for(typename G1::NodeIt n(_g1); n!=INVALID; ++n)
+        _mapping.set(n,w?w->_mapping[n]:INVALID);
+      for(typename G2::NodeIt n2(_g2); n2!=INVALID; ++n2)
+        _conn[n2]=w?w->_conn[n2]:0;
+      for(unsigned int i = 0; i < _currEdgeIts.size(); ++i)
+        _currEdgeIts[i]=w?w->_currEdgeIts[i]:typename G2::IncEdgeIt(INVALID);
+      _depth=w?w->_depth:-1;
+      return w?1:0;
+    }
+
+    template<typename F>
+    long long runParallel(F &f, bool first) {
+      switch(_mapping_type)
+        {
+        case SUBGRAPH:
+          return parallelFind<SUBGRAPH>(f,first);
+        case INDUCED:
+          return parallelFind<INDUCED>(f,first);
+        case ISOMORPH:
+          return parallelFind<ISOMORPH>(f,first);
+        default:
+          return 0;
+        }
+    }
+
   public:
     ///Constructor
 
@@ -500,9 +843,45 @@ namespace lemon {
       _g1(g1), _g2(g2), _depth(0), _mapping(m), _order(countNodes(g1),INVALID),
       _conn(g2,0), _currEdgeIts(countNodes(g1),INVALID), _rNewLabels1(_g1),
       _rInOutLabels1(_g1), _intLabels1(intLabels1) ,_intLabels2(intLabels2),
-      _maxLabel(getMaxLabel()), _labelTmp1(_maxLabel+1),_labelTmp2(_maxLabel+1),
+      _target(0), _maxLabel(getMaxLabel()),
+      _labelTmp1(_maxLabel+1),_labelTmp2(_maxLabel+1),
       _mapping_type(SUBGRAPH), _deallocMappingAfterUse(0),
-      _deallocLabelsAfterUse(0)
+      _deallocLabelsAfterUse(0), _minDepth(0), _root(0), _bound(0),
+      _thread_num(1)
+    {
+      initOrder();
+      initRNew1tRInOut1t();
+
+      //reset mapping
+      for(typename G1::NodeIt n(g1);n!=INVALID;++n)
+        m[n]=INVALID;
+    }
+
+    ///Constructor with a prepared target graph
+
+    ///Constructor with a prepared target graph. The node label counts
+    ///of the target graph are taken from \c target, and the parallel
+    ///search functions try only the candidates provided by
+    ///\ref Vf2ppTarget::candidates() "target.candidates()" for the
+    ///first node of the search.
+    ///\param g1 The graph to be embedded.
+    ///\param target The prepared graph \e g1 will be embedded into.
+    ///\param m The type of the NodeMap storing the mapping.
+    ///\param intLabels1 The NodeMap storing the integer node labels of G1.
+    ///The labels must be the numbers {0,1,2,..,K-1}, where K is the number of
+    ///different labels.
+    Vf2pp(const G1 &g1, const Vf2ppTarget<G2, M2> &target, M &m,
+          M1 &intLabels1) :
+      _g1(g1), _g2(target.graph()), _depth(0), _mapping(m),
+      _order(countNodes(g1),INVALID), _conn(target.graph(),0),
+      _currEdgeIts(countNodes(g1),INVALID), _rNewLabels1(_g1),
+      _rInOutLabels1(_g1), _intLabels1(intLabels1),
+      _intLabels2(target.labels()), _target(&target),
+      _maxLabel(getMaxLabel()),
+      _labelTmp1(_maxLabel+1),_labelTmp2(_maxLabel+1),
+      _mapping_type(SUBGRAPH), _deallocMappingAfterUse(0),
+      _deallocLabelsAfterUse(0), _minDepth(0), _root(0), _bound(0),
+      _thread_num(1)
     {
       initOrder();
       initRNew1tRInOut1t();
@@ -570,6 +949,87 @@ namespace lemon {
           return false;
         }
     }
+
+    ///Sets the number of threads.
+
+    ///Sets the number of threads used by \ref findFirst(), \ref count()
+    ///and \ref findAll().
+    ///The default value is 1, i.e. the search runs serially.
+    ///A value less than 1 means the number of available processors.
+    ///
+    ///If LEMON is built without threading support, this setting
+    ///has no effect.
+    ///\return <tt>(*this)</tt>
+    Vf2pp& threadNum(int num)
+    {
+      _thread_num = num < 1 ? bits::hardwareThreadNum() : num;
+      return *this;
+    }
+
+    ///Returns the number of threads.
+
+    ///Returns the number of threads.
+    ///
+    int threadNum() const
+    {
+      return _thread_num;
+    }
+
+    ///Finds the first mapping using several threads.
+
+    ///This method finds the first mapping from g1 into g2 using
+    ///\ref threadNum() threads. The found mapping is the same as the
+    ///one found by the first call of \ref find(), and the subsequent
+    ///calls of \ref find() return the further mappings one-by-one.
+    ///
+    ///\retval true if a mapping is found.
+    ///\retval false if there is no mapping.
+    bool findFirst()
+    {
+      if(_order.empty()) {
+        _depth=0;
+        return find();
+      }
+      NoCallback f;
+      return runParallel(f,true)!=0;
+    }
+
+    ///Counts the mappings using several threads.
+
+    ///This method counts all mappings from g1 into g2 using
+    ///\ref threadNum() threads. It does not change the state of
+    ///\ref find() and the mapping.
+    ///
+    ///\return The number of mappings.
+    long long count()
+    {
+      NoCallback f;
+      return findAll(f);
+    }
+
+    ///Enumerates all mappings using several threads.
+
+    ///This method enumerates all mappings from g1 into g2 using
+    ///\ref threadNum() threads and calls <tt>f(thread, m)</tt> for each
+    ///of them, where \c thread is the index of the calling thread in
+    ///<tt>[0, threadNum())</tt> and \c m is the found mapping as a
+    ///<tt>G1::NodeMap<G2::Node></tt>. The functor is called concurrently
+    ///from different threads, so it must be thread-safe, e.g. it can
+    ///collect the results of each thread separately. The order of the
+    ///calls is unspecified. This method does not change the state of
+    ///\ref find() and the mapping.
+    ///
+    ///\return The number of mappings.
+    template<typename F>
+    long long findAll(F &f)
+    {
+      if(_order.empty()) {
+        WorkMapping m(_g1);
+        f(0,m);
+        return 1;
+      }
+      return runParallel(f,false);
+    }
   };
 
   template<typename G1, typename G2>
@@ -583,6 +1043,8 @@ namespace lemon {
 
     MappingType _mapping_type;
 
+    int _thread_num;
+
     typedef typename G1::template NodeMap<typename G2::Node> Mapping;
     bool _local_mapping;
     void *_mapping;
@@ -600,7 +1062,7 @@ namespace lemon {
     }
 
     Vf2ppWizardBase(const G1 &g1,const G2 &g2)
-      : _g1(g1), _g2(g2), _mapping_type(SUBGRAPH),
+      : _g1(g1), _g2(g2), _mapping_type(SUBGRAPH), _thread_num(1),
         _local_mapping(1), _local_nodeLabels(1) { }
   };
 
@@ -627,6 +1089,7 @@ namespace lemon {
     using TR::_g1;
     using TR::_g2;
     using TR::_mapping_type;
+    using TR::_thread_num;
     using TR::_mapping;
     using TR::_nodeLabels1;
     using TR::_nodeLabels2;
@@ -723,6 +1186,18 @@ namespace lemon {
       return *this;
     }
 
+    ///\brief \ref named-templ-param "Named parameter" for setting
+    ///the number of threads.
+    ///
+    ///\ref named-templ-param "Named parameter" for setting
+    ///the number of threads used by \ref run() and \ref count().
+    ///
+    ///\sa Vf2pp::threadNum()
+    Vf2ppWizard<Base> &threadNum(int num) {
+      _thread_num = num < 1 ? bits::hardwareThreadNum() : num;
+      return *this;
+    }
+
     ///Runs the %VF2 Plus Plus algorithm.
 
     ///This method runs the VF2 Plus Plus algorithm.
@@ -741,8 +1216,9 @@ namespace lemon {
             *reinterpret_cast<NodeLabels2*>(_nodeLabels2));
 
       alg.mappingType(_mapping_type);
+      alg.threadNum(_thread_num);
 
-      const bool ret = alg.find();
+      const bool ret = _thread_num > 1 ? alg.findFirst() : alg.find();
 
       if(Base::_local_nodeLabels) {
         delete reinterpret_cast<NodeLabels1*>(_nodeLabels1);
@@ -773,6 +1249,7 @@ namespace lemon {
          *reinterpret_cast<NodeLabels1*>(_nodeLabels1),
          *reinterpret_cast<NodeLabels2*>(_nodeLabels2));
       ptr->mappingType(_mapping_type);
+      ptr->threadNum(_thread_num);
       if(Base::_local_mapping)
         ptr->_deallocMappingAfterUse=true;
       if(Base::_local_nodeLabels)
@@ -798,10 +1275,14 @@ namespace lemon {
             *reinterpret_cast<NodeLabels2*>(_nodeLabels2));
 
       alg.mappingType(_mapping_type);
+      alg.threadNum(_thread_num);
 
       int ret = 0;
-      while(alg.find())
-        ++ret;
+      if(_thread_num > 1)
+        ret = static_cast<int>(alg.count());
+      else
+        while(alg.find())
+          ++ret;
 
       if(Base::_local_nodeLabels) {
         delete reinterpret_cast<NodeLabels1*>(_nodeLabels1);
@@ -0,0 +1,225 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+
+#include <lemon/assignment.h>
+#include <lemon/matching.h>
+#include <lemon/smart_graph.h>
+#include <lemon/list_graph.h>
+#include <lemon/concepts/bpgraph.h>
+#include <lemon/random.h>
+
+#include "test_tools.h"
+
+using namespace lemon;
+
+void checkAssignmentCompile()
+{
+  typedef concepts::BpGraph BpGraph;
+  typedef BpGraph::Node Node;
+  typedef BpGraph::Edge Edge;
+  typedef BpGraph::EdgeMap<int> WeightMap;
+
+  BpGraph g;
+  Node n;
+  Edge e;
+  WeightMap w(g);
+
+  Assignment<BpGraph> as_test(g, w);
+  const Assignment<BpGraph>& const_as_test = as_test;
+
+  as_test.threadNum(2);
+  as_test.run();
+  as_test.run(Assignment<BpGraph>::AUCTION, 8);
+  as_test.run(Assignment<BpGraph>::SHORTEST_PATH);
+
+  const_as_test.threadNum();
+  const_as_test.matchingWeight();
+  const_as_test.matching(e);
+  const_as_test.matching(n);
+  const Assignment<BpGraph>::MatchingMap& mmap =
+    const_as_test.matchingMap();
+  e = mmap[n];
+  const_as_test.mate(n);
+}
+
+template <typename BGR, typename WM>
+void checkAssignment(const BGR& graph, const WM& weight,
+                     const Assignment<BGR, WM>& as) {
+  typedef typename WM::Value Value;
+  Value sum = 0;
+  for (typename BGR::NodeIt n(graph); n != INVALID; ++n) {
+    check(as.matching(n) != INVALID, "Not a perfect matching");
+    check(graph.source(as.matching(n)) == n, "Wrong matching arc");
+    check(as.mate(as.mate(n)) == n, "Wrong mate");
+    check(as.matching(static_cast<typename BGR::Edge>(as.matching(n))),
+          "Wrong matching edge");
+    if (graph.red(n)) sum += weight[as.matching(n)];
+  }
+  check(sum == as.matchingWeight(), "Wrong matching weight");
+}
+
+template <typename BGR, typename WM>
+void checkAssignmentAlgs(const BGR& graph, const WM& weight,
+                         bool perfect, typename WM::Value opt) {
+  typedef Assignment<BGR, WM> Alg;
+  for (int t = 1; t <= 4; t *= 4) {
+    Alg auction(graph, weight);
+    auction.threadNum(t);
+    check(auction.run(Alg::AUCTION) == perfect, "Wrong result");
+    if (perfect) {
+      checkAssignment(graph, weight, auction);
+      check(auction.matchingWeight() == opt, "Wrong matching weight");
+    }
+
+    Alg scaled(graph, weight);
+    scaled.threadNum(t);
+    check(scaled.run(Alg::AUCTION, 16) == perfect, "Wrong result");
+    if (perfect) {
+      check(scaled.matchingWeight() == opt, "Wrong matching weight");
+    }
+  }
+
+  Alg sap(graph, weight);
+  check(sap.run(Alg::SHORTEST_PATH) == perfect, "Wrong result");
+  if (perfect) {
+    checkAssignment(graph, weight, sap);
+    check(sap.matchingWeight() == opt, "Wrong matching weight");
+  }
+}
+
+template <typename BGR>
+void checkRandomAssignment(int n, int deg, int max_weight) {
+  BGR graph;
+  std::vector<typename BGR::RedNode> red;
+  std::vector<typename BGR::BlueNode> blue;
+  for (int i = 0; i < n; ++i) {
+    red.push_back(graph.addRedNode());
+    blue.push_back(graph.addBlueNode());
+  }
+  typename BGR::template EdgeMap<int> weight(graph);
+  for (int i = 0; i < n; ++i) {
+    // A perfect matching always exists
+    weight[graph.addEdge(red[i], blue[i])] = rnd[max_weight];
+    for (int j = 0; j < deg; ++j) {
+      weight[graph.addEdge(red[i], blue[rnd[n]])] =
+        rnd[max_weight] - max_weight / 2;
+    }
+  }
+
+  MaxWeightedPerfectMatching<BGR> mwpm(graph, weight);
+  check(mwpm.run(), "Wrong result");
+  checkAssignmentAlgs(graph, weight, true, mwpm.matchingWeight());
+}
+
+void checkSmallAssignments() {
+  typedef SmartBpGraph BGR;
+
+  // Empty graph
+  {
+    BGR graph;
+    BGR::EdgeMap<int> weight(graph);
+    checkAssignmentAlgs(graph, weight, true, 0);
+  }
+
+  // 3x3 instance with a unique optimum and parallel edges
+  {
+    BGR graph;
+    BGR::RedNode r[3];
+    BGR::BlueNode b[3];
+    for (int i = 0; i < 3; ++i) {
+      r[i] = graph.addRedNode();
+      b[i] = graph.addBlueNode();
+    }
+    int w[3][3] = { { 7, 5, 1 }, { 4, 6, 8 }, { 3, 9, 2 } };
+    BGR::EdgeMap<int> weight(graph);
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        weight[graph.addEdge(r[i], b[j])] = w[i][j];
+      }
+    }
+    weight[graph.addEdge(r[0], b[0])] = 10;
+    checkAssignmentAlgs(graph, weight, true, 27);
+
+    Assignment<BGR> as(graph, weight);
+    as.run();
+    check(as.mate(r[0]) == b[0] && as.mate(r[1]) == b[2] &&
+          as.mate(r[2]) == b[1], "Wrong matching");
+  }
+
+  // No perfect matching: two red nodes share their only neighbor
+  {
+    BGR graph;
+    BGR::RedNode r1 = graph.addRedNode(), r2 = graph.addRedNode();
+    BGR::BlueNode b1 = graph.addBlueNode(), b2 = graph.addBlueNode();
+    BGR::EdgeMap<int> weight(graph);
+    weight[graph.addEdge(r1, b1)] = 1;
+    weight[graph.addEdge(r2, b1)] = 1;
+    checkAssignmentAlgs(graph, weight, false, 0);
+    weight[graph.addEdge(r1, b2)] = 1;
+    checkAssignmentAlgs(graph, weight, true, 2);
+  }
+
+  // Different numbers of red and blue nodes
+  {
+    BGR graph;
+    BGR::RedNode r = graph.addRedNode();
+    BGR::BlueNode b1 = graph.addBlueNode(), b2 = graph.addBlueNode();
+    BGR::EdgeMap<int> weight(graph);
+    weight[graph.addEdge(r, b1)] = 1;
+    weight[graph.addEdge(r, b2)] = 1;
+    checkAssignmentAlgs(graph, weight, false, 0);
+  }
+
+  // Real weights
+  {
+    BGR graph;
+    BGR::RedNode r[2];
+    BGR::BlueNode b[2];
+    for (int i = 0; i < 2; ++i) {
+      r[i] = graph.addRedNode();
+      b[i] = graph.addBlueNode();
+    }
+    BGR::EdgeMap<double> weight(graph);
+    weight[graph.addEdge(r[0], b[0])] = 1.5;
+    weight[graph.addEdge(r[0], b[1])] = 2.25;
+    weight[graph.addEdge(r[1], b[0])] = 2.5;
+    weight[graph.addEdge(r[1], b[1])] = 0.5;
+
+    typedef Assignment<BGR, BGR::EdgeMap<double> > Alg;
+    Alg sap(graph, weight);
+    check(sap.run(Alg::SHORTEST_PATH), "Wrong result");
+    check(sap.matchingWeight() == 4.75, "Wrong matching weight");
+    Alg auction(graph, weight);
+    check(auction.run(Alg::AUCTION), "Wrong result");
+    check(auction.mate(r[0]) == b[1], "Wrong matching");
+  }
+}
+
+int main() {
+  checkSmallAssignments();
+
+  checkRandomAssignment<SmartBpGraph>(10, 2, 10);
+  checkRandomAssignment<SmartBpGraph>(100, 5, 1000);
+  checkRandomAssignment<ListBpGraph>(60, 3, 100);
+  checkRandomAssignment<SmartBpGraph>(200, 10, 3);
+
+  return 0;
+}
@@ -19,9 +19,12 @@
 #include <lemon/concepts/digraph.h>
 #include <lemon/smart_graph.h>
 #include <lemon/list_graph.h>
+#include <lemon/static_graph.h>
+#include <lemon/compact_graph.h>
 #include <lemon/lgf_reader.h>
 #include <lemon/bfs.h>
 #include <lemon/path.h>
+#include <lemon/random.h>
 
 #include "graph_test.h"
 #include "test_tools.h"
@@ -142,6 +145,79 @@ void checkBfsCompile()
   }
 }
 
+void checkParallelBfsCompile()
+{
+  typedef concepts::Digraph Digraph;
+  typedef ParallelBfs<Digraph> BType;
+  typedef Digraph::Node Node;
+  typedef Digraph::Arc Arc;
+
+  Digraph G;
+  Node s, t;
+  Arc e;
+  int l, i;
+  ::lemon::ignore_unused_variable_warning(l,i);
+  bool b;
+  ::lemon::ignore_unused_variable_warning(b);
+  BType::DistMap d(G);
+  BType::PredMap p(G);
+  Path<Digraph> pp;
+
+  {
+    BType bfs_test(G);
+    const BType& const_bfs_test = bfs_test;
+
+    bfs_test.threadNum(2).directionOptimizing(true);
+    i = const_bfs_test.threadNum();
+    b = const_bfs_test.directionOptimizing();
+
+    b = const_bfs_test.emptyQueue();
+    i = const_bfs_test.queueSize();
+
+    l  = const_bfs_test.dist(t);
+    e  = const_bfs_test.predArc(t);
+    s  = const_bfs_test.predNode(t);
+    b  = const_bfs_test.reached(t);
+    d  = const_bfs_test.distMap();
+    p  = const_bfs_test.predMap();
+    pp = const_bfs_test.path(t);
+  }
+  {
+    BType
+      ::SetPredMap<concepts::ReadWriteMap<Node,Arc> >
+      ::SetDistMap<concepts::ReadWriteMap<Node,int> >
+      ::SetReachedMap<concepts::ReadWriteMap<Node,bool> >
+      ::Create bfs_test(G);
+
+    concepts::ReadWriteMap<Node,Arc> pred_map;
+    concepts::ReadWriteMap<Node,int> dist_map;
+    concepts::ReadWriteMap<Node,bool> reached_map;
+
+    bfs_test
+      .predMap(pred_map)
+      .distMap(dist_map)
+      .reachedMap(reached_map);
+
+    bfs_test.run(s);
+    b = bfs_test.run(s,t);
+
+    bfs_test.init();
+    bfs_test.addSource(s);
+    bfs_test.processNextLevel();
+    b = bfs_test.emptyQueue();
+    i = bfs_test.queueSize();
+
+    bfs_test.start();
+    bfs_test.start(t);
+
+    l  = bfs_test.dist(t);
+    e  = bfs_test.predArc(t);
+    s  = bfs_test.predNode(t);
+    b  = bfs_test.reached(t);
+    pp = bfs_test.path(t);
+  }
+}
+
 void checkBfsFunctionCompile()
 {
   typedef int VType;
@@ -231,9 +307,101 @@ void checkBfs() {
   }
 }
 
+template <class Digraph>
+void checkParallelBfs() {
+  TEMPLATE_DIGRAPH_TYPEDEFS(Digraph);
+
+  Digraph G;
+  Node s, t;
+
+  std::istringstream input(test_lgf);
+  digraphReader(G, input).
+    node("source", s).
+    node("target", t).
+    run();
+
+  for (int k = 1; k <= 4; ++k) {
+    ParallelBfs<Digraph> bfs_test(G);
+    check(bfs_test.threadNum(k).run(s, t), "Bfs found a wrong path.");
+    check(bfs_test.dist(t)==2,"Bfs found a wrong path.");
+
+    Path<Digraph> p = bfs_test.path(t);
+    check(p.length()==2,"path() found a wrong path.");
+    check(checkPath(G, p),"path() found a wrong path.");
+    check(pathSource(G, p) == s,"path() found a wrong path.");
+    check(pathTarget(G, p) == t,"path() found a wrong path.");
+  }
+}
+
+// Compare the parallel BFS with the serial one on the given digraph
+template <typename Digraph>
+void checkParallelBfs(const Digraph& G, typename Digraph::Node s,
+                      const Bfs<Digraph>& bfs, int k, bool bottom_up) {
+  TEMPLATE_DIGRAPH_TYPEDEFS(Digraph);
+
+  ParallelBfs<Digraph> bfs_test(G);
+  bfs_test.threadNum(k).directionOptimizing(bottom_up).run(s);
+
+  for(NodeIt v(G); v!=INVALID; ++v) {
+    check(bfs_test.reached(v) == bfs.reached(v), "Wrong reached map.");
+    if (!bfs.reached(v)) continue;
+    check(bfs_test.dist(v) == bfs.dist(v), "Wrong distance.");
+    check(v==s || bfs_test.predArc(v)!=INVALID, "Wrong tree.");
+    if (bfs_test.predArc(v)!=INVALID ) {
+      Arc a=bfs_test.predArc(v);
+      check(G.target(a) == v, "Wrong tree.");
+      check(bfs_test.predNode(v) == G.source(a), "Wrong tree.");
+      check(bfs_test.dist(v) - bfs_test.dist(G.source(a)) == 1,
+            "Wrong tree.");
+    }
+  }
+}
+
+void checkRandomParallelBfs(int node_num, int arc_num) {
+  ListDigraph G;
+  std::vector<ListDigraph::Node> nodes;
+  for (int i = 0; i < node_num; ++i) nodes.push_back(G.addNode());
+  for (int i = 0; i < arc_num; ++i) {
+    G.addArc(nodes[rnd[node_num]], nodes[rnd[node_num]]);
+  }
+  // Node ids that do not belong to nodes
+  for (int i = 1; i < node_num; i += 7) G.erase(nodes[i]);
+  ListDigraph::Node s = nodes[0];
+
+  StaticDigraph SG;
+  CompactDigraph CG;
+  ListDigraph::NodeMap<StaticDigraph::Node> snr(G);
+  ListDigraph::NodeMap<CompactDigraph::Node> cnr(G);
+  digraphCopy(G, SG).nodeRef(snr).run();
+  digraphCopy(G, CG).nodeRef(cnr).run();
+
+  Bfs<ListDigraph> bfs(G);
+  bfs.run(s);
+  Bfs<StaticDigraph> sbfs(SG);
+  sbfs.run(snr[s]);
+  Bfs<CompactDigraph> cbfs(CG);
+  cbfs.run(cnr[s]);
+
+  for (int k = 1; k <= 4; ++k) {
+    checkParallelBfs(G, s, bfs, k, true);
+    checkParallelBfs(G, s, bfs, k, false);
+    checkParallelBfs(SG, snr[s], sbfs, k, true);
+    checkParallelBfs(CG, cnr[s], cbfs, k, false);
+  }
+  ParallelBfs<CompactDigraph> cbfs_test(CG);
+  check(!cbfs_test.directionOptimizing(), "Wrong default direction.");
+  checkParallelBfs(CG, cnr[s], cbfs, 2, true);
+}
+
 int main()
 {
   checkBfs<ListDigraph>();
   checkBfs<SmartDigraph>();
+  checkParallelBfs<ListDigraph>();
+  checkParallelBfs<SmartDigraph>();
+  for (int i = 0; i < 5; ++i) {
+    checkRandomParallelBfs(100, 200);
+    checkRandomParallelBfs(2000, 40000);
+  }
   return 0;
 }
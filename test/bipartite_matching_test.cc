@@ -0,0 +1,157 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+
+#include <lemon/bipartite_matching.h>
+#include <lemon/matching.h>
+#include <lemon/smart_graph.h>
+#include <lemon/list_graph.h>
+#include <lemon/concepts/bpgraph.h>
+#include <lemon/random.h>
+
+#include "test_tools.h"
+
+using namespace lemon;
+
+void checkMaxBipartiteMatchingCompile()
+{
+  typedef concepts::BpGraph BpGraph;
+  typedef BpGraph::Node Node;
+  typedef BpGraph::Edge Edge;
+
+  BpGraph g;
+  Node n;
+  Edge e;
+
+  MaxBipartiteMatching<BpGraph> mat_test(g);
+  const MaxBipartiteMatching<BpGraph>& const_mat_test = mat_test;
+
+  mat_test.threadNum(2);
+  mat_test.init();
+  mat_test.greedyInit();
+  mat_test.start();
+  mat_test.run();
+
+  const_mat_test.threadNum();
+  const_mat_test.matchingSize();
+  const_mat_test.matching(e);
+  const_mat_test.matching(n);
+  const MaxBipartiteMatching<BpGraph>::MatchingMap& mmap =
+    const_mat_test.matchingMap();
+  e = mmap[n];
+  const_mat_test.mate(n);
+}
+
+template <typename BGR>
+void checkMatching(const BGR& graph, const MaxBipartiteMatching<BGR>& mbm,
+                   int size) {
+  int num = 0;
+  for (typename BGR::NodeIt n(graph); n != INVALID; ++n) {
+    if (mbm.matching(n) != INVALID) {
+      ++num;
+      check(graph.source(mbm.matching(n)) == n, "Wrong matching arc");
+      check(mbm.mate(mbm.mate(n)) == n, "Wrong mate");
+      check(mbm.matching(static_cast<typename BGR::Edge>(mbm.matching(n))),
+            "Wrong matching edge");
+    } else {
+      check(mbm.mate(n) == INVALID, "Wrong mate");
+    }
+  }
+  check(num == 2 * mbm.matchingSize(), "Wrong matching size");
+  check(mbm.matchingSize() == size, "The matching is not maximum");
+
+  // There is no edge between two unmatched nodes
+  for (typename BGR::EdgeIt e(graph); e != INVALID; ++e) {
+    check(mbm.matching(graph.u(e)) != INVALID ||
+          mbm.matching(graph.v(e)) != INVALID, "The matching is not maximal");
+  }
+}
+
+template <typename BGR>
+void checkBipartiteMatching(const BGR& graph) {
+  MaxMatching<BGR> mm(graph);
+  mm.run(false);
+  int size = mm.matchingSize();
+
+  for (int t = 1; t <= 4; t *= 4) {
+    MaxBipartiteMatching<BGR> mbm(graph);
+    mbm.threadNum(t);
+    mbm.run();
+    checkMatching(graph, mbm, size);
+
+    MaxBipartiteMatching<BGR> mbm2(graph);
+    mbm2.threadNum(t);
+    mbm2.init();
+    mbm2.start();
+    checkMatching(graph, mbm2, size);
+  }
+}
+
+template <typename BGR>
+void checkRandomBipartiteMatching(int red_num, int blue_num, int edge_num) {
+  BGR graph;
+  std::vector<typename BGR::RedNode> red;
+  std::vector<typename BGR::BlueNode> blue;
+  for (int i = 0; i < red_num; ++i) {
+    red.push_back(graph.addRedNode());
+  }
+  for (int i = 0; i < blue_num; ++i) {
+    blue.push_back(graph.addBlueNode());
+  }
+  for (int i = 0; i < edge_num; ++i) {
+    graph.addEdge(red[rnd[red_num]], blue[rnd[blue_num]]);
+  }
+  checkBipartiteMatching(graph);
+}
+
+int main() {
+  {
+    SmartBpGraph graph;
+    checkBipartiteMatching(graph);
+    graph.addRedNode();
+    graph.addBlueNode();
+    checkBipartiteMatching(graph);
+  }
+
+  // A path on which the greedy matching is not maximum
+  {
+    SmartBpGraph graph;
+    SmartBpGraph::RedNode r1 = graph.addRedNode(), r2 = graph.addRedNode();
+    SmartBpGraph::BlueNode b1 = graph.addBlueNode(), b2 = graph.addBlueNode();
+    graph.addEdge(r1, b1);
+    graph.addEdge(r1, b2);
+    graph.addEdge(r2, b1);
+    checkBipartiteMatching(graph);
+
+    MaxBipartiteMatching<SmartBpGraph> mbm(graph);
+    mbm.run();
+    check(mbm.matchingSize() == 2 && mbm.mate(r2) == b1 &&
+          mbm.mate(r1) == b2, "Wrong matching");
+  }
+
+  for (int i = 0; i < 10; ++i) {
+    checkRandomBipartiteMatching<SmartBpGraph>(20, 20, 30);
+    checkRandomBipartiteMatching<ListBpGraph>(30, 15, 40);
+  }
+  checkRandomBipartiteMatching<SmartBpGraph>(500, 600, 1000);
+  checkRandomBipartiteMatching<SmartBpGraph>(3000, 3000, 6000);
+
+  return 0;
+}
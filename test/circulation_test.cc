@@ -20,7 +20,9 @@
 
 #include "test_tools.h"
 #include <lemon/list_graph.h>
+#include <lemon/smart_graph.h>
 #include <lemon/circulation.h>
+#include <lemon/random.h>
 #include <lemon/lgf_reader.h>
 #include <lemon/concepts/digraph.h>
 #include <lemon/concepts/maps.h>
@@ -93,6 +95,9 @@ void checkCirculationCompile()
   circ_test.elevator(const_cast<CirculationType::Elevator&>(elev));
   CirculationType::Tolerance tol = const_circ_test.tolerance();
   circ_test.tolerance(tol);
+  circ_test.threadNum(2);
+  int tn = const_circ_test.threadNum();
+  ::lemon::ignore_unused_variable_warning(tn);
 
   circ_test.init();
   circ_test.greedyInit();
@@ -109,9 +114,10 @@ void checkCirculationCompile()
 
 template <class G, class LM, class UM, class DM>
 void checkCirculation(const G& g, const LM& lm, const UM& um,
-                      const DM& dm, bool find)
+                      const DM& dm, bool find, int thread_num = 1)
 {
   Circulation<G, LM, UM, DM> circ(g, lm, um, dm);
+  circ.threadNum(thread_num);
   bool ret = circ.run();
   if (find) {
     check(ret, "A feasible solution should have been found.");
@@ -123,6 +129,71 @@ void checkCirculation(const G& g, const LM& lm, const UM& um,
   }
 }
 
+template <class G, class LM, class UM, class DM>
+void checkCirculations(const G& g, const LM& lm, const UM& um,
+                       const DM& dm, bool find)
+{
+  checkCirculation(g, lm, um, dm, find);
+  checkCirculation(g, lm, um, dm, find, 2);
+  checkCirculation(g, lm, um, dm, find, 4);
+}
+
+void checkParallelCirculation(int node_num, int arc_num, int perturb)
+{
+  typedef SmartDigraph Digraph;
+  DIGRAPH_TYPEDEFS(Digraph);
+
+  Digraph g;
+  for (int i = 0; i < node_num; ++i) g.addNode();
+  for (int i = 0; i < arc_num; ++i) {
+    g.addArc(g.nodeFromId(rnd[node_num]), g.nodeFromId(rnd[node_num]));
+  }
+
+  // The supplies are given by a random feasible flow, then some of
+  // them are perturbed
+  IntArcMap lo(g), up(g);
+  IntNodeMap supply(g, 0);
+  for (ArcIt a(g); a != INVALID; ++a) {
+    lo[a] = rnd[4];
+    up[a] = lo[a] + rnd[10];
+    int f = lo[a] + rnd[up[a] - lo[a] + 1];
+    supply[g.source(a)] += f;
+    supply[g.target(a)] -= f;
+  }
+  for (int i = 0; i < perturb; ++i) {
+    supply[g.nodeFromId(rnd[node_num])] += rnd[11] - 5;
+  }
+
+  Circulation<Digraph> circ(g, lo, up, supply);
+  bool feasible = circ.run();
+  check(feasible ? circ.checkFlow() : circ.checkBarrier(),
+        "Wrong result of the sequential algorithm");
+
+  IntArcMap flow(g);
+  BoolNodeMap bar(g);
+  for (int t = 2; t <= 4; ++t) {
+    Circulation<Digraph> pcirc(g, lo, up, supply);
+    pcirc.threadNum(t);
+    check(pcirc.run() == feasible, "Wrong feasibility");
+    if (feasible) {
+      check(pcirc.checkFlow(), "The found flow is corrupt.");
+      check(!pcirc.checkBarrier(), "A barrier should not have been found.");
+    } else {
+      check(pcirc.checkBarrier(), "The found barrier is corrupt.");
+    }
+    for (ArcIt a(g); a != INVALID; ++a) {
+      if (t == 2) flow[a] = pcirc.flow(a);
+      else check(pcirc.flow(a) == flow[a],
+                 "The result depends on the number of threads");
+    }
+    for (NodeIt n(g); n != INVALID; ++n) {
+      if (t == 2) bar[n] = pcirc.barrier(n);
+      else check(pcirc.barrier(n) == bar[n],
+                 "The result depends on the number of threads");
+    }
+  }
+}
+
 int main (int, char*[])
 {
   typedef ListDigraph Digraph;
@@ -142,28 +213,33 @@ int main (int, char*[])
     run();
 
   delta[s] = 7; delta[t] = -7;
-  checkCirculation(g, lo, up, delta, true);
+  checkCirculations(g, lo, up, delta, true);
 
   delta[s] = 13; delta[t] = -13;
-  checkCirculation(g, lo, up, delta, true);
+  checkCirculations(g, lo, up, delta, true);
 
   delta[s] = 6; delta[t] = -6;
-  checkCirculation(g, lo, up, delta, false);
+  checkCirculations(g, lo, up, delta, false);
 
   delta[s] = 14; delta[t] = -14;
-  checkCirculation(g, lo, up, delta, false);
+  checkCirculations(g, lo, up, delta, false);
 
   delta[s] = 7; delta[t] = -13;
-  checkCirculation(g, lo, up, delta, true);
+  checkCirculations(g, lo, up, delta, true);
 
   delta[s] = 5; delta[t] = -15;
-  checkCirculation(g, lo, up, delta, true);
+  checkCirculations(g, lo, up, delta, true);
 
   delta[s] = 10; delta[t] = -11;
-  checkCirculation(g, lo, up, delta, true);
+  checkCirculations(g, lo, up, delta, true);
 
   delta[s] = 11; delta[t] = -10;
-  checkCirculation(g, lo, up, delta, false);
+  checkCirculations(g, lo, up, delta, false);
+
+  for (int i = 0; i < 10; ++i) {
+    checkParallelCirculation(200, 1000, i);
+    checkParallelCirculation(1000, 3000, 3 * i);
+  }
 
   return 0;
 }
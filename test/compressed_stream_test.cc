@@ -0,0 +1,285 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <lemon/compressed_stream.h>
+#include <lemon/smart_graph.h>
+#include <lemon/lgf_reader.h>
+#include <lemon/lgf_writer.h>
+#include <lemon/random.h>
+
+#include "test_tools.h"
+
+using namespace lemon;
+
+typedef CompressedStreamBase::Format Format;
+
+// The output of 'gzip -n', which is not split into BGZF blocks
+const unsigned char gzip_data[] = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x73, 0x48,
+  0x2c, 0x29, 0x29, 0xca, 0x4c, 0x2a, 0x2d, 0x49, 0x2d, 0xe6, 0x4a, 0x4e,
+  0x2c, 0x28, 0xc9, 0xcc, 0xcf, 0x53, 0x50, 0x4a, 0xaf, 0xca, 0x2c, 0x50,
+  0xe2, 0x02, 0x00, 0x88, 0x76, 0x59, 0x55, 0x1b, 0x00, 0x00, 0x00
+};
+
+const std::string gzip_text = "@attributes\ncaption \"gzip\"\n";
+
+void checkCompressedStreamCompile() {
+  CompressedIstream is;
+  const CompressedIstream& const_is = is;
+  std::istringstream iss;
+  is.open("file");
+  is.open(iss);
+  is.threadNum(2);
+  ::lemon::ignore_unused_variable_warning(const_is.is_open());
+  ::lemon::ignore_unused_variable_warning(const_is.threadNum());
+  ::lemon::ignore_unused_variable_warning(const_is.format());
+  is.close();
+
+  CompressedOstream os;
+  const CompressedOstream& const_os = os;
+  std::ostringstream oss;
+  os.open("file");
+  os.open("file", CompressedStreamBase::GZIP);
+  os.open(oss, CompressedStreamBase::ZSTD);
+  os.threadNum(2);
+  ::lemon::ignore_unused_variable_warning(const_os.is_open());
+  ::lemon::ignore_unused_variable_warning(const_os.threadNum());
+  ::lemon::ignore_unused_variable_warning(const_os.format());
+  os.close();
+}
+
+std::string compress(const std::string& data, Format format, int threads) {
+  std::ostringstream oss;
+  CompressedOstream os(oss, format);
+  os.threadNum(threads);
+  os << data;
+  os.close();
+  check(os, "Compression failed");
+  return oss.str();
+}
+
+std::string decompress(const std::string& data, int threads,
+                       Format format) {
+  std::istringstream iss(data);
+  CompressedIstream is(iss);
+  is.threadNum(threads);
+  std::ostringstream oss;
+  char c;
+  while (is.get(c)) oss.put(c);
+  check(!is.bad(), "Decompression failed");
+  check(is.format() == format, "Wrong format");
+  return oss.str();
+}
+
+void checkFormat(Format format) {
+  std::string data;
+  for (int i = 0; i < 50000; ++i) {
+    data += "line ";
+    data += char('a' + rnd[26]);
+    data += (i % 7 == 0 ? '\n' : ' ');
+  }
+  std::string empty;
+
+  for (int t = 1; t <= 4; t *= 4) {
+    std::string comp = compress(data, format, t);
+    check(format == CompressedStreamBase::PLAIN || comp.size() < data.size(),
+          "The data is not compressed");
+    for (int s = 1; s <= 4; s *= 4) {
+      check(decompress(comp, s, format) == data, "Wrong data");
+    }
+    check(decompress(compress(empty, format, t), t, format) == empty,
+          "Wrong data");
+
+    // Concatenated streams
+    if (format != CompressedStreamBase::PLAIN) {
+      std::string comp2 = compress("second", format, t);
+      for (int s = 1; s <= 4; s *= 4) {
+        check(decompress(comp + comp2, s, format) == data + "second",
+              "Wrong data");
+      }
+    }
+  }
+
+  // The compressed output does not depend on the number of threads
+  check(compress(data, format, 1) == compress(data, format, 4),
+        "Wrong data");
+}
+
+void checkCorrupted(Format format) {
+  std::string data;
+  for (int i = 0; i < 100000; ++i) {
+    data += (i % 80 == 0 ? '\n' : char('a' + rnd[26]));
+  }
+  std::string comp = compress(data, format, 1);
+  for (int t = 1; t <= 4; t *= 4) {
+    std::string trunc = comp.substr(0, comp.size() / 2);
+    std::istringstream iss(trunc);
+    CompressedIstream is(iss);
+    is.threadNum(t);
+    std::string line;
+    while (std::getline(is, line)) {}
+    check(is.bad(), "Truncated data is not detected");
+
+    std::string corr = comp;
+    corr[corr.size() / 2] ^= 0x55;
+    corr[corr.size() / 2 + 1] ^= 0x55;
+    std::istringstream iss2(corr);
+    CompressedIstream is2(iss2);
+    is2.threadNum(t);
+    while (std::getline(is2, line)) {}
+    check(is2.bad(), "Corrupted data is not detected");
+  }
+}
+
+void checkLgf(const std::string& fn) {
+  SmartDigraph digraph;
+  SmartDigraph::NodeMap<int> node_map(digraph);
+  SmartDigraph::ArcMap<int> arc_map(digraph);
+  for (int i = 0; i < 1000; ++i) {
+    node_map[digraph.addNode()] = i;
+  }
+  for (int i = 0; i < 5000; ++i) {
+    SmartDigraph::Arc a = digraph.addArc(digraph.nodeFromId(rnd[1000]),
+                                         digraph.nodeFromId(rnd[1000]));
+    arc_map[a] = rnd[100000];
+  }
+  digraphWriter(digraph, fn)
+    .nodeMap("value", node_map)
+    .arcMap("value", arc_map)
+    .attribute("caption", fn)
+    .run();
+
+  for (int t = 1; t <= 4; t *= 4) {
+    SmartDigraph other;
+    SmartDigraph::NodeMap<int> other_node_map(other);
+    SmartDigraph::ArcMap<int> other_arc_map(other);
+    std::string caption;
+    CompressedIstream is(fn);
+    is.threadNum(t);
+    check(is.is_open(), "Cannot open the file");
+    digraphReader(other, is)
+      .nodeMap("value", other_node_map)
+      .arcMap("value", other_arc_map)
+      .attribute("caption", caption)
+      .run();
+    check(is.format() == CompressedStreamBase::fileFormat(fn),
+          "Wrong format");
+    check(countNodes(other) == 1000 && countArcs(other) == 5000,
+          "Wrong graph");
+    for (SmartDigraph::NodeIt n(other); n != INVALID; ++n) {
+      check(other_node_map[n] == other.id(n), "Wrong map");
+    }
+    for (SmartDigraph::ArcIt a(other); a != INVALID; ++a) {
+      SmartDigraph::Arc o = digraph.arcFromId(other.id(a));
+      check(other_arc_map[a] == arc_map[o] &&
+            other.id(other.source(a)) == digraph.id(digraph.source(o)) &&
+            other.id(other.target(a)) == digraph.id(digraph.target(o)),
+            "Wrong arc");
+    }
+    check(caption == fn, "Wrong attribute");
+  }
+
+  // The file name constructor of the reader
+  SmartDigraph other;
+  digraphReader(other, fn).run();
+  check(countArcs(other) == 5000, "Wrong graph");
+
+  // A truncated compressed file is not read as a partial graph
+  if (CompressedStreamBase::fileFormat(fn) != CompressedStreamBase::PLAIN) {
+    std::string data;
+    {
+      std::ifstream ifs(fn.c_str(), std::ios::binary);
+      std::ostringstream oss;
+      oss << ifs.rdbuf();
+      data = oss.str();
+    }
+    {
+      std::ofstream ofs(fn.c_str(), std::ios::binary);
+      ofs.write(data.data(), data.size() / 2);
+    }
+    bool error = false;
+    try {
+      SmartDigraph trunc;
+      digraphReader(trunc, fn).run();
+    } catch (const IoError&) {
+      error = true;
+    }
+    check(error, "Truncated file is not detected");
+    for (int t = 1; t <= 4; t *= 4) {
+      CompressedIstream is(fn);
+      is.threadNum(t);
+      error = false;
+      try {
+        SmartDigraph trunc;
+        digraphReader(trunc, is).run();
+      } catch (const IoError&) {
+        error = true;
+      }
+      check(error, "Truncated file is not detected");
+    }
+  }
+
+  std::remove(fn.c_str());
+}
+
+int main() {
+  check(CompressedStreamBase::supported(CompressedStreamBase::PLAIN),
+        "Wrong support");
+  check(CompressedStreamBase::fileFormat("graph.lgf") ==
+        CompressedStreamBase::PLAIN, "Wrong format");
+  check(CompressedStreamBase::fileFormat("graph.lgf.gz") ==
+        CompressedStreamBase::GZIP, "Wrong format");
+  check(CompressedStreamBase::fileFormat("graph.lgf.zst") ==
+        CompressedStreamBase::ZSTD, "Wrong format");
+
+  checkFormat(CompressedStreamBase::PLAIN);
+  checkLgf("test_compressed_stream.lgf");
+
+  if (CompressedStreamBase::supported(CompressedStreamBase::GZIP)) {
+    checkFormat(CompressedStreamBase::GZIP);
+    checkCorrupted(CompressedStreamBase::GZIP);
+    checkLgf("test_compressed_stream.lgf.gz");
+
+    std::string data(reinterpret_cast<const char*>(gzip_data),
+                     sizeof(gzip_data));
+    for (int t = 1; t <= 4; t *= 4) {
+      check(decompress(data, t, CompressedStreamBase::GZIP) == gzip_text,
+            "Wrong data");
+      check(decompress(data + data, t, CompressedStreamBase::GZIP) ==
+            gzip_text + gzip_text, "Wrong data");
+    }
+  } else {
+    std::ostringstream oss;
+    CompressedOstream os(oss, CompressedStreamBase::GZIP);
+    check(!os, "Unsupported format");
+  }
+
+  if (CompressedStreamBase::supported(CompressedStreamBase::ZSTD)) {
+    checkFormat(CompressedStreamBase::ZSTD);
+    checkCorrupted(CompressedStreamBase::ZSTD);
+    checkLgf("test_compressed_stream.lgf.zst");
+  }
+
+  return 0;
+}
@@ -19,11 +19,24 @@
 #include <lemon/connectivity.h>
 #include <lemon/list_graph.h>
 #include <lemon/adaptors.h>
+#include <lemon/random.h>
 
 #include "test_tools.h"
 
 using namespace lemon;
 
+// Check whether two maps describe the same partition of the items
+template <typename ItemIt, typename Graph, typename Map>
+bool samePartition(const Graph& g, const Map& map1, const Map& map2,
+                   int num) {
+  std::vector<int> map(num, -1);
+  for (ItemIt it(g); it != INVALID; ++it) {
+    if (map[map1[it]] != -1 && map[map1[it]] != map2[it]) return false;
+    map[map1[it]] = map2[it];
+  }
+  return true;
+}
+
 
 int main()
 {
@@ -240,6 +253,12 @@ int main()
           scomp2[n8] == 1, "Wrong stronglyConnectedComponents()");
     check(scomp2[n4] == 2 && scomp2[n6] == 2 && scomp2[n7] == 2,
           "Wrong stronglyConnectedComponents()");
+    Digraph::NodeMap<int> scomp3(d);
+    check(stronglyConnectedComponents(d, scomp3, 2) == 3,
+          "This digraph has 3 strongly connected components");
+    for (Digraph::NodeIt n(d); n != INVALID; ++n) {
+      check(scomp3[n] == scomp2[n], "Wrong stronglyConnectedComponents()");
+    }
     Digraph::ArcMap<bool> scut2(d, false);
     check(stronglyConnectedCutArcs(d, scut2) == 5,
           "This digraph has 5 strongly connected cut arcs.");
@@ -248,6 +267,126 @@ int main()
     }
   }
 
+  {
+    // Parallel versions on random digraphs
+    for (int k = 0; k < 12; ++k) {
+      Digraph d;
+      Graph g(d);
+      int n = 100 + 50 * k;
+      std::vector<Digraph::Node> nodes;
+      for (int i = 0; i < n; ++i) nodes.push_back(d.addNode());
+      for (int i = 0; i < n * (1 + k % 3); ++i) {
+        int a = rnd[n], b = rnd[n];
+        // Mostly acyclic arcs in every second digraph, and acyclic arcs
+        // in every fourth digraph
+        if (k % 4 == 3 && a == b) continue;
+        if (k % 2 == 1 && a > b && (k % 4 == 3 || rnd.boolean(0.95))) {
+          std::swap(a, b);
+        }
+        d.addArc(nodes[a], nodes[b]);
+      }
+
+      Graph::NodeMap<int> gcomp1(g), gcomp2(g);
+      int gnum = connectedComponents(g, gcomp1);
+      Digraph::NodeMap<int> scomp1(d), scomp2(d), scomp3(d);
+      int snum = stronglyConnectedComponents(d, scomp1);
+
+      for (int t = 1; t <= 4; ++t) {
+        check(connectedComponents(g, gcomp2, t) == gnum,
+              "Wrong parallel connectedComponents()");
+        for (Digraph::NodeIt u(d); u != INVALID; ++u) {
+          check(gcomp2[u] == gcomp1[u],
+                "Wrong parallel connectedComponents()");
+        }
+
+        check(stronglyConnectedComponents(d, scomp2, t) == snum,
+              "Wrong parallel stronglyConnectedComponents()");
+        std::vector<int> map(snum, -1);
+        for (Digraph::NodeIt u(d); u != INVALID; ++u) {
+          check(map[scomp1[u]] == -1 || map[scomp1[u]] == scomp2[u],
+                "Wrong parallel stronglyConnectedComponents()");
+          map[scomp1[u]] = scomp2[u];
+          if (t == 1) scomp3[u] = scomp2[u];
+          check(scomp3[u] == scomp2[u],
+                "The result depends on the number of threads");
+        }
+        for (Digraph::ArcIt a(d); a != INVALID; ++a) {
+          check(scomp2[d.source(a)] <= scomp2[d.target(a)],
+                "Wrong parallel stronglyConnectedComponents()");
+        }
+      }
+
+      bool acyclic = dag(d);
+      check(k % 4 != 3 || acyclic, "This digraph is DAG.");
+      Digraph::NodeMap<int> order1(d), order2(d);
+      for (int t = 1; t <= 4; ++t) {
+        check(checkedTopologicalSort(d, order2, t) == acyclic,
+              "Wrong parallel checkedTopologicalSort()");
+        if (acyclic) topologicalSort(d, order2, t);
+        std::vector<bool> used(n, false);
+        for (Digraph::NodeIt u(d); u != INVALID; ++u) {
+          if (t == 1) order1[u] = order2[u];
+          check(order1[u] == order2[u],
+                "The result depends on the number of threads");
+          if (order2[u] < 0) continue;
+          check(order2[u] < n && !used[order2[u]],
+                "Wrong parallel topologicalSort()");
+          used[order2[u]] = true;
+        }
+        for (Digraph::ArcIt a(d); a != INVALID; ++a) {
+          int s = order2[d.source(a)], r = order2[d.target(a)];
+          check(s < 0 ? r < 0 : r < 0 || s < r,
+                "Wrong parallel topologicalSort()");
+        }
+      }
+
+      Graph::EdgeMap<int> bncomp1(g), bncomp2(g), bncomp3(g);
+      Graph::NodeMap<int> becomp1(g), becomp2(g), becomp3(g);
+      Graph::NodeMap<bool> cutnodes1(g, false);
+      Graph::EdgeMap<bool> cutedges1(g, false);
+      int bnnum = biNodeConnectedComponents(g, bncomp1);
+      int benum = biEdgeConnectedComponents(g, becomp1);
+      int cnnum = biNodeConnectedCutNodes(g, cutnodes1);
+      int cenum = biEdgeConnectedCutEdges(g, cutedges1);
+
+      for (int t = 1; t <= 4; ++t) {
+        check(biNodeConnectedComponents(g, bncomp2, t) == bnnum,
+              "Wrong parallel biNodeConnectedComponents()");
+        check(samePartition<Graph::EdgeIt>(g, bncomp1, bncomp2, bnnum),
+              "Wrong parallel biNodeConnectedComponents()");
+        check(biEdgeConnectedComponents(g, becomp2, t) == benum,
+              "Wrong parallel biEdgeConnectedComponents()");
+        check(samePartition<Graph::NodeIt>(g, becomp1, becomp2, benum),
+              "Wrong parallel biEdgeConnectedComponents()");
+        for (Graph::EdgeIt e(g); e != INVALID; ++e) {
+          if (t == 1) bncomp3[e] = bncomp2[e];
+          check(bncomp3[e] == bncomp2[e],
+                "The result depends on the number of threads");
+        }
+        for (Graph::NodeIt u(g); u != INVALID; ++u) {
+          if (t == 1) becomp3[u] = becomp2[u];
+          check(becomp3[u] == becomp2[u],
+                "The result depends on the number of threads");
+        }
+
+        Graph::NodeMap<bool> cutnodes2(g, false);
+        Graph::EdgeMap<bool> cutedges2(g, false);
+        check(biNodeConnectedCutNodes(g, cutnodes2, t) == cnnum,
+              "Wrong parallel biNodeConnectedCutNodes()");
+        check(biEdgeConnectedCutEdges(g, cutedges2, t) == cenum,
+              "Wrong parallel biEdgeConnectedCutEdges()");
+        for (Graph::NodeIt u(g); u != INVALID; ++u) {
+          check(cutnodes1[u] == cutnodes2[u],
+                "Wrong parallel biNodeConnectedCutNodes()");
+        }
+        for (Graph::EdgeIt e(g); e != INVALID; ++e) {
+          check(cutedges1[e] == cutedges2[e],
+                "Wrong parallel biEdgeConnectedCutEdges()");
+        }
+      }
+    }
+  }
+
   {
     // DAG example for topological sort from the book New Algorithms
     // (T. H. Cormen, C. E. Leiserson, R. L. Rivest, C. Stein)
@@ -281,6 +420,12 @@ int main()
       check(order[d.source(a)] < order[d.target(a)],
             "Wrong topologicalSort()");
     }
+
+    check(checkedTopologicalSort(d, order, 2), "This digraph is DAG.");
+    for (Digraph::ArcIt a(d); a != INVALID; ++a) {
+      check(order[d.source(a)] < order[d.target(a)],
+            "Wrong topologicalSort()");
+    }
   }
 
   {
@@ -100,6 +100,54 @@ void counterTest(bool output) {
   }
 }
 
+struct CountWork {
+  ParallelCounter &even, &odd;
+  CountWork(ParallelCounter &e, ParallelCounter &o) : even(e), odd(o) {}
+  void operator()(int thread, int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      if (i % 2 == 0) ++even[thread];
+      else odd[thread] += 2;
+    }
+  }
+};
+
+void parallelCounterTest() {
+  std::stringstream s1, s2, s3, s4;
+  {
+    ParallelCounter all("All", s1);
+    all.threadNum(4);
+    check(all.threadNum() == 4, "Wrong thread number");
+    ParallelCounter even(all, "Even", s2);
+    ParallelCounter odd(all, "Odd", s3);
+    check(odd.threadNum() == 4, "Wrong thread number");
+    CountWork work(even, odd);
+    bits::parallelFor(100000, 4, work, 100);
+    check(even.value() == 50000 && odd.value() == 100000,
+          "Wrong counter");
+    check(all.value() == 150000, "Wrong counter");
+    {
+      ParallelCounter::SubCounter sub(all, "Sub: ", s4);
+      sub += 5;
+    }
+    ++all;
+    check(all.value() == 150006, "Wrong counter");
+
+    std::ostringstream json, csv;
+    all.writeJson(json);
+    check(json.str().find("{\"title\": \"All\", \"value\": 150006") == 0,
+          "Wrong JSON");
+    check(json.str().find("{\"title\": \"Odd\", \"value\": 100000") !=
+          std::string::npos, "Wrong JSON");
+    all.writeCsv(csv);
+    check(csv.str() == "counter,value\n\"All\",150006\n"
+          "\"All/Even\",50000\n\"All/Odd\",100000\n", "Wrong CSV");
+  }
+  check(s1.str() == "All150006\n", "Wrong counter");
+  check(s2.str() == "Even50000\n", "Wrong counter");
+  check(s3.str() == "Odd100000\n", "Wrong counter");
+  check(s4.str() == "Sub: 5\n", "Wrong subcounter");
+}
+
 void init(std::vector<int>& v) {
   v[0] = 10; v[1] = 60; v[2] = 20; v[3] = 90; v[4] = 100;
   v[5] = 80; v[6] = 40; v[7] = 30; v[8] = 50; v[9] = 70;
@@ -109,6 +157,8 @@ int main()
 {
   counterTest<Counter>(true);
   counterTest<NoCounter>(false);
+  counterTest<ParallelCounter>(true);
+  parallelCounterTest();
 
   std::vector<int> x(10);
   init(x); bubbleSort(x);
@@ -0,0 +1,268 @@
+/* -*- mode: C++; indent-tabs-mode: nil; -*-
+ *
+ * This file is a part of LEMON, a generic C++ optimization library.
+ *
+ * Copyright (C) 2003-2013
+ * Egervary Jeno Kombinatorikus Optimalizalasi Kutatocsoport
+ * (Egervary Research Group on Combinatorial Optimization, EGRES).
+ *
+ * Permission to use, modify and distribute this software is granted
+ * provided that this copyright notice appears in all copies. For
+ * precise terms see the accompanying LICENSE file.
+ *
+ * This software is provided "AS IS" with no warranty of any kind,
+ * express or implied, and with no claim as to its suitability for any
+ * purpose.
+ *
+ */
+
+#include <lemon/concepts/digraph.h>
+#include <lemon/smart_graph.h>
+#include <lemon/list_graph.h>
+#include <lemon/lgf_reader.h>
+#include <lemon/dag_path.h>
+#include <lemon/bellman_ford.h>
+#include <lemon/path.h>
+#include <lemon/random.h>
+
+#include "graph_test.h"
+#include "test_tools.h"
+
+using namespace lemon;
+
+char test_lgf[] =
+  "@nodes\n"
+  "label\n"
+  "0\n"
+  "1\n"
+  "2\n"
+  "3\n"
+  "4\n"
+  "@arcs\n"
+  "    length\n"
+  "0 1 3\n"
+  "1 2 -3\n"
+  "1 2 -5\n"
+  "1 3 -2\n"
+  "0 2 -1\n"
+  "1 2 -4\n"
+  "0 3 2\n"
+  "4 2 -5\n"
+  "2 3 1\n"
+  "@attributes\n"
+  "source 0\n"
+  "target 3\n";
+
+
+void checkDagPathCompile()
+{
+  typedef int Value;
+  typedef concepts::Digraph Digraph;
+  typedef concepts::ReadMap<Digraph::Arc,Value> LengthMap;
+  typedef DagPath<Digraph, LengthMap> DP;
+  typedef Digraph::Node Node;
+  typedef Digraph::Arc Arc;
+
+  Digraph gr;
+  Node s, t, n;
+  Arc e;
+  Value l;
+  ::lemon::ignore_unused_variable_warning(l);
+  int k=3;
+  bool b;
+  ::lemon::ignore_unused_variable_warning(b);
+  DP::DistMap d(gr);
+  DP::PredMap p(gr);
+  LengthMap length;
+  concepts::Path<Digraph> pp;
+
+  {
+    DP dp_test(gr,length);
+    const DP& const_dp_test = dp_test;
+
+    dp_test.run(s);
+
+    dp_test.threadNum(k);
+    k = const_dp_test.threadNum();
+    dp_test.init();
+    dp_test.addSource(s);
+    dp_test.addSource(s, 1);
+    dp_test.start();
+
+    b  = const_dp_test.dag();
+    l  = const_dp_test.dist(t);
+    e  = const_dp_test.predArc(t);
+    s  = const_dp_test.predNode(t);
+    b  = const_dp_test.reached(t);
+    d  = const_dp_test.distMap();
+    p  = const_dp_test.predMap();
+    pp = const_dp_test.path(t);
+  }
+  {
+    DP::SetPredMap<concepts::ReadWriteMap<Node,Arc> >
+      ::SetDistMap<concepts::ReadWriteMap<Node,Value> >
+      ::SetOperationTraits<DagPathLongestOperationTraits<Value> >
+      ::Create dp_test(gr,length);
+
+    LengthMap length_map;
+    concepts::ReadWriteMap<Node,Arc> pred_map;
+    concepts::ReadWriteMap<Node,Value> dist_map;
+
+    dp_test
+      .lengthMap(length_map)
+      .predMap(pred_map)
+      .distMap(dist_map)
+      .threadNum(k);
+
+    dp_test.run(s);
+
+    dp_test.init();
+    dp_test.addSource(s);
+    dp_test.addSource(s, 1);
+    dp_test.start();
+
+    b  = dp_test.dag();
+    l  = dp_test.dist(t);
+    e  = dp_test.predArc(t);
+    s  = dp_test.predNode(t);
+    b  = dp_test.reached(t);
+    pp = dp_test.path(t);
+  }
+}
+
+template <typename Digraph, typename DP>
+void checkDagPathTree(const Digraph& gr,
+                      const typename Digraph::template ArcMap<int>& length,
+                      const DP& dp, typename Digraph::Node s) {
+  TEMPLATE_DIGRAPH_TYPEDEFS(Digraph);
+
+  for(NodeIt v(gr); v!=INVALID; ++v) {
+    if (dp.reached(v)) {
+      check(v==s || dp.predArc(v)!=INVALID, "Wrong tree.");
+      if (dp.predArc(v)!=INVALID ) {
+        Arc e=dp.predArc(v);
+        Node u=gr.source(e);
+        check(u==dp.predNode(v),"Wrong tree.");
+        check(dp.reached(u), "Wrong tree.");
+        check(dp.dist(v) - dp.dist(u) == length[e],
+              "Wrong distance! Difference: " <<
+              dp.dist(v) - dp.dist(u) - length[e]);
+      }
+      Path<Digraph> p = dp.path(v);
+      check(checkPath(gr, p), "path() found a wrong path.");
+      check(p.empty() || pathSource(gr, p) == s,
+            "path() found a wrong path.");
+    } else {
+      check(dp.predArc(v)==INVALID, "Wrong tree.");
+    }
+  }
+}
+
+template <typename Digraph>
+void checkDagPath() {
+  TEMPLATE_DIGRAPH_TYPEDEFS(Digraph);
+  typedef typename Digraph::template ArcMap<int> LengthMap;
+
+  Digraph gr;
+  Node s, t;
+  LengthMap length(gr);
+
+  std::istringstream input(test_lgf);
+  digraphReader(gr, input).
+    arcMap("length", length).
+    node("source", s).
+    node("target", t).
+    run();
+
+  for (int k = 1; k <= 4; ++k) {
+    DagPath<Digraph, LengthMap> dp(gr, length);
+    dp.threadNum(k).run(s);
+    Path<Digraph> p = dp.path(t);
+
+    check(dp.dag(), "This digraph is DAG.");
+    check(dp.reached(t) && dp.dist(t) == -1, "DagPath found a wrong path.");
+    check(p.length() == 3, "path() found a wrong path.");
+    check(checkPath(gr, p), "path() found a wrong path.");
+    check(pathSource(gr, p) == s, "path() found a wrong path.");
+    check(pathTarget(gr, p) == t, "path() found a wrong path.");
+    checkDagPathTree(gr, length, dp, s);
+
+    typename DagPath<Digraph, LengthMap>
+      ::template SetOperationTraits<DagPathLongestOperationTraits<int> >
+      ::Create lp(gr, length);
+    lp.threadNum(k).run(s);
+
+    check(lp.reached(t) && lp.dist(t) == 2, "DagPath found a wrong path.");
+    check(lp.path(t).length() == 1, "path() found a wrong path.");
+    check(!lp.reached(gr.nodeFromId(4)), "Wrong reached() value.");
+    checkDagPathTree(gr, length, lp, s);
+  }
+}
+
+void checkRandomDagPath(int node_num, int arc_num) {
+  DIGRAPH_TYPEDEFS(SmartDigraph);
+
+  SmartDigraph gr;
+  IntArcMap length(gr), neg_length(gr);
+  std::vector<Node> nodes;
+  for (int i = 0; i < node_num; ++i) nodes.push_back(gr.addNode());
+  for (int i = 0; i < arc_num; ++i) {
+    int a = rnd[node_num], b = rnd[node_num];
+    if (a == b) continue;
+    if (a > b) std::swap(a, b);
+    Arc e = gr.addArc(nodes[a], nodes[b]);
+    length[e] = rnd[201] - 100;
+    neg_length[e] = -length[e];
+  }
+  Node s = nodes[rnd[node_num / 4]];
+
+  BellmanFord<SmartDigraph, IntArcMap> bf(gr, length);
+  bf.run(s);
+  BellmanFord<SmartDigraph, IntArcMap> bf_neg(gr, neg_length);
+  bf_neg.run(s);
+
+  IntNodeMap dist(gr), long_dist(gr);
+  for (int k = 1; k <= 4; ++k) {
+    DagPath<SmartDigraph, IntArcMap> dp(gr, length);
+    dp.threadNum(k).run(s);
+    DagPath<SmartDigraph, IntArcMap>
+      ::SetOperationTraits<DagPathLongestOperationTraits<int> >
+      ::Create lp(gr, length);
+    lp.threadNum(k).run(s);
+
+    check(dp.dag() && lp.dag(), "This digraph is DAG.");
+    checkDagPathTree(gr, length, dp, s);
+    checkDagPathTree(gr, length, lp, s);
+    for (NodeIt v(gr); v != INVALID; ++v) {
+      check(dp.reached(v) == bf.reached(v) && lp.reached(v) == bf.reached(v),
+            "Wrong reached() value.");
+      if (!bf.reached(v)) continue;
+      check(dp.dist(v) == bf.dist(v), "Wrong shortest distance.");
+      check(lp.dist(v) == -bf_neg.dist(v), "Wrong longest distance.");
+      if (k == 1) {
+        dist[v] = dp.dist(v);
+        long_dist[v] = lp.dist(v);
+      }
+      check(dist[v] == dp.dist(v) && long_dist[v] == lp.dist(v),
+            "The result depends on the number of threads");
+    }
+  }
+
+  // A directed cycle is not processed
+  gr.addArc(nodes[node_num - 1], nodes[node_num - 2]);
+  gr.addArc(nodes[node_num - 2], nodes[node_num - 1]);
+  DagPath<SmartDigraph, IntArcMap> dp(gr, length);
+  dp.threadNum(2).run(s);
+  check(!dp.dag(), "This digraph is not DAG.");
+  check(!dp.reached(nodes[node_num - 1]), "Wrong reached() value.");
+}
+
+int main() {
+  checkDagPath<ListDigraph>();
+  checkDagPath<SmartDigraph>();
+  for (int i = 0; i < 5; ++i) {
+    checkRandomDagPath(100, 300);
+    checkRandomDagPath(1000, 5000);
+  }
+  return 0;
+}
@@ -21,7 +21,10 @@
 #include <lemon/smart_graph.h>
 #include <lemon/static_graph.h>
 #include <lemon/compact_graph.h>
+#include <lemon/compressed_graph.h>
 #include <lemon/full_graph.h>
+#include <lemon/maps.h>
+#include <lemon/edge_set.h>
 
 #include "test_tools.h"
 #include "graph_test.h"
@@ -86,6 +89,95 @@ void checkDigraphBuild() {
   checkGraphArcMap(G);
 }
 
+// Iterator of a vector that reports to be a single pass input iterator
+template <typename T>
+class InputIterator {
+public:
+  typedef std::input_iterator_tag iterator_category;
+  typedef T value_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef const T* pointer;
+  typedef const T& reference;
+
+  explicit InputIterator(typename std::vector<T>::const_iterator it)
+    : _it(it) {}
+
+  reference operator*() const { return *_it; }
+  InputIterator& operator++() { ++_it; return *this; }
+
+  bool operator==(const InputIterator& other) const {
+    return _it == other._it;
+  }
+  bool operator!=(const InputIterator& other) const {
+    return _it != other._it;
+  }
+
+private:
+  typename std::vector<T>::const_iterator _it;
+};
+
+template <class Digraph>
+void checkDigraphBulkBuild() {
+  TEMPLATE_DIGRAPH_TYPEDEFS(Digraph);
+  Digraph G;
+  IntNodeMap nm(G);
+  typename Digraph::template NodeMap<std::string> sm(G);
+  typename Digraph::template ArcMap<std::string> am(G);
+
+  Node n0 = G.addNode();
+  nm[n0] = 1;
+  sm[n0] = "a";
+  std::vector<Node> nodes;
+  G.addNodes(4, nodes);
+  check(nodes.size() == 4, "Wrong number of new nodes");
+  checkGraphNodeList(G, 5);
+  for (int i = 0; i < 4; ++i) {
+    check(nodes[i] != n0 && nm[nodes[i]] == 0 && sm[nodes[i]] == "",
+          "Wrong map value");
+  }
+  check(nm[n0] == 1 && sm[n0] == "a", "Wrong map value");
+
+  std::vector<std::pair<Node, Node> > list;
+  list.push_back(std::make_pair(n0, nodes[0]));
+  list.push_back(std::make_pair(nodes[0], nodes[1]));
+  list.push_back(std::make_pair(nodes[1], nodes[2]));
+  list.push_back(std::make_pair(nodes[1], nodes[2]));
+  list.push_back(std::make_pair(nodes[3], nodes[3]));
+  std::vector<Arc> arcs;
+  G.addArcs(list.begin(), list.end(), arcs);
+  check(arcs.size() == list.size(), "Wrong number of new arcs");
+  for (int i = 0; i < int(arcs.size()); ++i) {
+    check(G.source(arcs[i]) == list[i].first &&
+          G.target(arcs[i]) == list[i].second, "Wrong arc");
+    check(am[arcs[i]] == "", "Wrong map value");
+  }
+  checkGraphArcList(G, 5);
+  checkGraphOutArcList(G, n0, 1);
+  checkGraphOutArcList(G, nodes[1], 2);
+  checkGraphInArcList(G, nodes[2], 2);
+  checkGraphInArcList(G, nodes[3], 1);
+
+  G.addNodes(3);
+  G.addArcs(list.begin(), list.begin() + 2);
+  checkGraphNodeList(G, 8);
+  checkGraphArcList(G, 7);
+  checkGraphConArcList(G, 7);
+
+  typedef InputIterator<std::pair<Node, Node> > ArcListIt;
+  G.addArcs(ArcListIt(list.begin()), ArcListIt(list.end()), arcs);
+  check(arcs.size() == list.size(), "Wrong number of new arcs");
+  for (int i = 0; i < int(arcs.size()); ++i) {
+    check(G.source(arcs[i]) == list[i].first &&
+          G.target(arcs[i]) == list[i].second, "Wrong arc");
+  }
+  checkGraphArcList(G, 12);
+
+  checkNodeIds(G);
+  checkArcIds(G);
+  checkGraphNodeMap(G);
+  checkGraphArcMap(G);
+}
+
 template <class Digraph>
 void checkDigraphSplit() {
   TEMPLATE_DIGRAPH_TYPEDEFS(Digraph);
@@ -245,9 +337,151 @@ void checkDigraphErase() {
   checkGraphInArcList(G, n4, 0);
 
   checkGraphConArcList(G, 1);
+
+  // Check bulk insertion reusing the erased items
+  std::vector<Node> nodes;
+  G.addNodes(3, nodes);
+  checkGraphNodeList(G, 6);
+
+  std::vector<std::pair<Node, Node> > list(5, std::make_pair(n1, nodes[2]));
+  std::vector<Arc> arcs;
+  G.addArcs(list.begin(), list.end(), arcs);
+  checkGraphArcList(G, 6);
+  checkGraphOutArcList(G, n1, 5);
+  checkGraphInArcList(G, nodes[2], 5);
+
+  checkNodeIds(G);
+  checkArcIds(G);
+  checkGraphNodeMap(G);
+  checkGraphArcMap(G);
 }
 
 
+void checkDigraphCompact() {
+  DIGRAPH_TYPEDEFS(ListDigraph);
+  typedef ListArcSet<ListDigraph> ArcSet;
+
+  ListDigraph G;
+  IntNodeMap label(G);
+  ListDigraph::ArcMap<std::string> name(G);
+  CrossRefMap<ListDigraph, Node, int> cross(G);
+  IterableIntMap<ListDigraph, Arc> iter(G);
+  ArcSet set(G);
+
+  std::vector<Node> nodes;
+  for (int i = 0; i < 10; ++i) {
+    nodes.push_back(G.addNode());
+    label[nodes[i]] = i;
+    cross.set(nodes[i], 10 * i);
+  }
+  std::vector<Arc> arcs;
+  for (int i = 0; i < 10; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      Arc a = G.addArc(nodes[i], nodes[(i + j + 1) % 10]);
+      name[a] = std::string(1, char('a' + i)) + char('0' + j);
+      iter.set(a, j);
+      arcs.push_back(a);
+    }
+    set.addArc(nodes[i], nodes[(i + 5) % 10]);
+  }
+  for (int i = 0; i < 10; i += 3) G.erase(nodes[i]);
+  for (int i = 1; i < int(arcs.size()); i += 4) {
+    if (G.valid(arcs[i])) G.erase(arcs[i]);
+  }
+  int node_num = countNodes(G), arc_num = countArcs(G);
+  int set_num = countArcs(set);
+  check(G.maxNodeId() >= node_num && G.maxArcId() >= arc_num,
+        "The ids should be sparse");
+
+  std::vector<std::pair<int, std::string> > old_arcs;
+  for (ArcIt a(G); a != INVALID; ++a) {
+    old_arcs.push_back(std::make_pair(label[G.source(a)], name[a]));
+  }
+
+  std::vector<Index> node_ids, arc_ids;
+  G.compact(node_ids, arc_ids);
+
+  check(G.maxNodeId() == node_num - 1 && G.maxArcId() == arc_num - 1,
+        "Wrong compaction");
+  checkGraphNodeList(G, node_num);
+  checkGraphArcList(G, arc_num);
+  checkNodeIds(G);
+  checkArcIds(G);
+  checkGraphNodeMap(G);
+  checkGraphArcMap(G);
+
+  for (int i = 0; i < 10; ++i) {
+    check((node_ids[G.id(nodes[i])] == -1) == (i % 3 == 0),
+          "Wrong node id map");
+    if (i % 3 == 0) continue;
+    Node n = G.nodeFromId(node_ids[G.id(nodes[i])]);
+    check(label[n] == i && cross[n] == 10 * i &&
+          cross(10 * i) == n, "Wrong map value");
+  }
+  int k = 0;
+  for (ArcIt a(G); a != INVALID; ++a, ++k) {
+    check(G.id(a) == k, "Wrong arc order");
+    check(label[G.source(a)] == old_arcs[k].first &&
+          name[a] == old_arcs[k].second, "Wrong map value");
+    check(label[G.target(a)] ==
+          (old_arcs[k].first + old_arcs[k].second[1] - '0' + 1) % 10,
+          "Wrong arc");
+    check(iter[a] == old_arcs[k].second[1] - '0', "Wrong map value");
+  }
+  for (int j = 0; j < 3; ++j) {
+    int num = 0;
+    for (IterableIntMap<ListDigraph, Arc>::ItemIt a(iter, j);
+         a != INVALID; ++a) {
+      check(iter[a] == j, "Wrong iterable map");
+      ++num;
+    }
+    for (int i = 0; i < arc_num; ++i) {
+      if (old_arcs[i].second[1] - '0' == j) --num;
+    }
+    check(num == 0, "Wrong iterable map");
+  }
+
+  check(countArcs(set) == set_num && set_num > 0, "Wrong arc set");
+  for (ArcSet::ArcIt a(set); a != INVALID; ++a) {
+    check(G.valid(set.source(a)) && G.valid(set.target(a)) &&
+          label[set.target(a)] == (label[set.source(a)] + 5) % 10,
+          "Wrong arc set");
+  }
+
+  G.erase(G.nodeFromId(0));
+  G.compact();
+  check(G.maxNodeId() == node_num - 2, "Wrong compaction");
+  checkGraphNodeList(G, node_num - 1);
+  checkGraphConArcList(G, countArcs(G));
+  checkNodeIds(G);
+  checkArcIds(G);
+
+  // The snapshots are detached
+  ListDigraph H;
+  IntArcMap value(H);
+  Node n1 = H.addNode(), n2 = H.addNode(), n3 = H.addNode();
+  H.addArc(n1, n2);
+  H.addArc(n2, n3);
+  H.erase(H.addArc(n3, n1));
+  for (ArcIt a(H); a != INVALID; ++a) value[a] = 7;
+  ListDigraph::Snapshot snapshot(H);
+  H.compact();
+  check(!snapshot.valid(), "The snapshot should be detached");
+  checkGraphArcList(H, 2);
+  for (ArcIt a(H); a != INVALID; ++a) {
+    check(value[a] == 7, "Wrong map value");
+  }
+
+  snapshot.save(H);
+  H.addArc(H.addNode(), n1);
+  H.erase(n2);
+  H.compact();
+  check(!snapshot.valid(), "The snapshot should be detached");
+  checkGraphNodeList(H, 3);
+  checkGraphArcList(H, 1);
+  check(value[ArcIt(H)] == 0, "Wrong map value");
+}
+
 template <class Digraph>
 void checkDigraphSnapshot() {
   TEMPLATE_DIGRAPH_TYPEDEFS(Digraph);
@@ -343,6 +577,10 @@ void checkConcepts() {
     checkConcept<Digraph, CompactDigraph>();
     checkConcept<ClearableDigraphComponent<>, CompactDigraph>();
   }
+  { // Checking CompressedDigraph
+    checkConcept<Digraph, CompressedDigraph>();
+    checkConcept<ClearableDigraphComponent<>, CompressedDigraph>();
+  }
   { // Checking FullDigraph
     checkConcept<Digraph, FullDigraph>();
   }
@@ -368,6 +606,9 @@ void checkDigraphValidity() {
 
   check(!g.valid(g.nodeFromId(-1)), "Wrong validity check");
   check(!g.valid(g.arcFromId(-1)), "Wrong validity check");
+
+  check(sizeof(g.id(n1)) == sizeof(Index), "Wrong id type");
+  check(sizeof(g.maxArcId()) == sizeof(Index), "Wrong id type");
 }
 
 template <typename Digraph>
@@ -502,10 +743,143 @@ void checkStaticDigraph() {
   checkGraphNodeMap(G);
   checkGraphArcMap(G);
 
-  int n = G.nodeNum();
-  int m = G.arcNum();
+  Index n = G.nodeNum();
+  Index m = G.arcNum();
   check(G.index(G.node(n-1)) == n-1, "Wrong index.");
   check(G.index(G.arc(m-1)) == m-1, "Wrong index.");
+  check(sizeof(G.index(G.node(0))) == sizeof(Index), "Wrong index type.");
+  check(sizeof(G.id(G.arc(0))) == sizeof(Index), "Wrong index type.");
+}
+
+void checkStaticDigraphFreeze() {
+  DIGRAPH_TYPEDEFS(ListDigraph);
+  typedef StaticDigraph::Node SNode;
+  typedef StaticDigraph::Arc SArc;
+
+  ListDigraph G;
+  IntNodeMap label(G);
+  IntArcMap length(G);
+  std::vector<Node> nodes;
+  for (int i = 0; i < 8; ++i) {
+    nodes.push_back(G.addNode());
+    label[nodes[i]] = i;
+  }
+  for (int i = 0; i < 8; ++i) {
+    for (int j = 1; j <= 3; ++j) {
+      length[G.addArc(nodes[i], nodes[(i * j + 1) % 8])] = 10 * i + j;
+    }
+  }
+  G.erase(nodes[2]);
+  G.erase(nodes[5]);
+
+  StaticDigraph S;
+  StaticDigraph::NodeMap<int> slabel(S);
+  std::vector<Index> node_cross_ref, arc_cross_ref;
+  check(!S.freeze(G, node_cross_ref, arc_cross_ref), "Wrong ids");
+  checkGraphNodeList(S, 6);
+  checkGraphArcList(S, countArcs(G));
+  checkGraphConArcList(S, countArcs(G));
+  checkNodeIds(S);
+  checkArcIds(S);
+  checkGraphNodeMap(S);
+  checkGraphArcMap(S);
+
+  FrozenMap<ListDigraph, SNode, IntNodeMap>
+    flabel(G, label, node_cross_ref);
+  FrozenMap<ListDigraph, SArc, IntArcMap>
+    flength(G, length, arc_cross_ref);
+  for (StaticDigraph::ArcIt a(S); a != INVALID; ++a) {
+    Arc e = G.arcFromId(arc_cross_ref[S.index(a)]);
+    check(G.id(G.source(e)) == node_cross_ref[S.index(S.source(a))] &&
+          G.id(G.target(e)) == node_cross_ref[S.index(S.target(a))],
+          "Wrong arc");
+    check(flength[a] == length[e], "Wrong map value");
+    check(flength[a] / 10 == flabel[S.source(a)], "Wrong map value");
+  }
+  for (StaticDigraph::NodeIt n(S); n != INVALID; ++n) {
+    check(slabel[n] == 0, "Wrong map value");
+    flabel.set(n, flabel[n] + 100);
+    int k = 0;
+    for (StaticDigraph::OutArcIt a(S, n); a != INVALID; ++a) ++k;
+    check(k == countOutArcs(G, G.nodeFromId(node_cross_ref[S.index(n)])),
+          "Wrong out degree");
+  }
+  for (NodeIt n(G); n != INVALID; ++n) {
+    check(label[n] >= 100, "Wrong map value");
+    label[n] -= 100;
+  }
+
+  G.compact();
+  check(S.freeze(G, node_cross_ref, arc_cross_ref), "Wrong ids");
+  check(S.freeze(G), "Wrong ids");
+  checkGraphNodeList(S, 6);
+  checkGraphConArcList(S, countArcs(G));
+  FrozenMap<ListDigraph, SArc, IntArcMap> slength(G, length);
+  for (ArcIt a(G); a != INVALID; ++a) {
+    SArc e = S.arc(G.id(a));
+    check(S.index(S.source(e)) == G.id(G.source(a)) &&
+          S.index(S.target(e)) == G.id(G.target(a)), "Wrong arc");
+    check(slength[e] == length[a], "Wrong map value");
+  }
+}
+
+void checkCompressedDigraph() {
+  // Arcs with small and large differences, multiple arcs and loops
+  int n = 20000;
+  std::vector<std::pair<int,int> > arcs;
+  for (int i = 0; i < n; i += 7) {
+    arcs.push_back(std::make_pair(i, (i + 1) % n));
+    arcs.push_back(std::make_pair(i, (i * 37 + 11) % n));
+    arcs.push_back(std::make_pair(i, i));
+    arcs.push_back(std::make_pair(i, 0));
+    arcs.push_back(std::make_pair(i, 0));
+    arcs.push_back(std::make_pair(i, n - 1));
+  }
+  CompactDigraph CG;
+  CG.build(n, arcs.begin(), arcs.end());
+  CompressedDigraph G;
+  G.build(n, arcs.begin(), arcs.end());
+
+  check(G.nodeNum() == n && G.arcNum() == int(arcs.size()),
+        "Wrong number of items.");
+  check(G.byteNum() < 4 * arcs.size(), "Wrong compression.");
+  for (int k = 0; k < int(arcs.size()); ++k) {
+    CompressedDigraph::Arc a = G.arc(k);
+    check(G.index(a) == k, "Wrong index.");
+    check(G.index(G.source(a)) == arcs[k].first &&
+          G.index(G.target(a)) == arcs[k].second, "Wrong arc.");
+  }
+  for (int i = 0; i < n; ++i) {
+    CompactDigraph::OutArcIt ca(CG, CG.node(i));
+    for (CompressedDigraph::OutArcIt a(G, G.node(i)); a != INVALID; ++a) {
+      check(ca != INVALID && CG.index(ca) == G.index(a) &&
+            CG.index(CG.target(ca)) == G.index(G.target(a)),
+            "Wrong out arcs.");
+      ++ca;
+    }
+    check(ca == INVALID, "Wrong out arcs.");
+  }
+  int in_num = 0;
+  for (int k = 0; k < int(arcs.size()); ++k) {
+    if (arcs[k].second == 0) ++in_num;
+  }
+  checkGraphInArcList(G, G.node(0), in_num);
+  checkArcIds(G);
+  checkGraphArcMap(G);
+
+  // Copying a digraph sorts the outgoing arcs by their targets
+  CompressedDigraph H;
+  CompactDigraph::NodeMap<CompressedDigraph::Node> nref(CG);
+  CompactDigraph::ArcMap<CompressedDigraph::Arc> aref(CG);
+  H.build(CG, nref, aref);
+  check(H.byteNum() <= G.byteNum(), "Wrong compression.");
+  for (CompactDigraph::ArcIt a(CG); a != INVALID; ++a) {
+    check(H.source(aref[a]) == nref[CG.source(a)] &&
+          H.target(aref[a]) == nref[CG.target(a)], "Wrong arc references.");
+    check(H.arc(H.index(aref[a])) == aref[a] &&
+          H.target(H.arc(H.index(aref[a]))) == nref[CG.target(a)],
+          "Wrong arc references.");
+  }
 }
 
 void checkFullDigraph(int num) {
@@ -548,14 +922,17 @@ void checkFullDigraph(int num) {
 void checkDigraphs() {
   { // Checking ListDigraph
     checkDigraphBuild<ListDigraph>();
+    checkDigraphBulkBuild<ListDigraph>();
     checkDigraphSplit<ListDigraph>();
     checkDigraphAlter<ListDigraph>();
     checkDigraphErase<ListDigraph>();
+    checkDigraphCompact();
     checkDigraphSnapshot<ListDigraph>();
     checkDigraphValidityErase<ListDigraph>();
   }
   { // Checking SmartDigraph
     checkDigraphBuild<SmartDigraph>();
+    checkDigraphBulkBuild<SmartDigraph>();
     checkDigraphSplit<SmartDigraph>();
     checkDigraphSnapshot<SmartDigraph>();
     checkDigraphValidity<SmartDigraph>();
@@ -563,6 +940,9 @@ void checkDigraphs() {
   { // Checking StaticDigraph
     checkStaticDigraph<StaticDigraph>();
     checkStaticDigraph<CompactDigraph>();
+    checkStaticDigraph<CompressedDigraph>();
+    checkStaticDigraphFreeze();
+    checkCompressedDigraph();
   }
   { // Checking FullDigraph
     checkFullDigraph(8);
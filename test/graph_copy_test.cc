@@ -28,13 +28,13 @@ using namespace std;
 using namespace lemon;
 
 template <typename GR>
-void digraph_copy_test() {
-  const int nn = 10;
+void digraph_copy_test(int nn = 10, int thread_num = 1) {
 
   // Build a digraph
   SmartDigraph from;
   SmartDigraph::NodeMap<int> fnm(from);
   SmartDigraph::ArcMap<int> fam(from);
+  SmartDigraph::ArcMap<bool> fbm(from);
   SmartDigraph::Node fn = INVALID;
   SmartDigraph::Arc fa = INVALID;
 
@@ -50,6 +50,7 @@ void digraph_copy_test() {
     for (int j = 0; j < nn; ++j) {
       SmartDigraph::Arc arc = from.addArc(fnv[i], fnv[j]);
       fam[arc] = i + j * j;
+      fbm[arc] = (i + j) % 3 == 0;
       if (i == 0 && j == 0) fa = arc;
     }
   }
@@ -58,6 +59,7 @@ void digraph_copy_test() {
   GR to;
   typename GR::template NodeMap<int> tnm(to);
   typename GR::template ArcMap<int> tam(to);
+  typename GR::template ArcMap<bool> tbm(to);
   typename GR::Node tn;
   typename GR::Arc ta;
 
@@ -68,10 +70,10 @@ void digraph_copy_test() {
   typename GR::template ArcMap<SmartDigraph::Arc> ecr(to);
 
   digraphCopy(from, to).
-    nodeMap(fnm, tnm).arcMap(fam, tam).
+    nodeMap(fnm, tnm).arcMap(fam, tam).arcMap(fbm, tbm).
     nodeRef(nr).arcRef(er).
     nodeCrossRef(ncr).arcCrossRef(ecr).
-    node(fn, tn).arc(fa, ta).run();
+    node(fn, tn).arc(fa, ta).threadNum(thread_num).run();
 
   check(countNodes(from) == countNodes(to), "Wrong copy.");
   check(countArcs(from) == countArcs(to), "Wrong copy.");
@@ -84,6 +86,7 @@ void digraph_copy_test() {
   for (SmartDigraph::ArcIt it(from); it != INVALID; ++it) {
     check(ecr[er[it]] == it, "Wrong copy.");
     check(fam[it] == tam[er[it]], "Wrong copy.");
+    check(fbm[it] == tbm[er[it]], "Wrong copy.");
     check(nr[from.source(it)] == to.source(er[it]), "Wrong copy.");
     check(nr[from.target(it)] == to.target(er[it]), "Wrong copy.");
   }
@@ -106,8 +109,43 @@ void digraph_copy_test() {
 }
 
 template <typename GR>
-void graph_copy_test() {
-  const int nn = 10;
+void crossref_copy_test(int nn, int thread_num) {
+
+  // Build a digraph
+  SmartDigraph from;
+  SmartDigraph::ArcMap<int> fam(from);
+
+  std::vector<SmartDigraph::Node> fnv;
+  for (int i = 0; i < nn; ++i) {
+    fnv.push_back(from.addNode());
+  }
+  for (int i = 0; i < nn; ++i) {
+    for (int j = 0; j < nn; ++j) {
+      fam[from.addArc(fnv[i], fnv[j])] = i * nn + j;
+    }
+  }
+
+  // Test digraph copy into maps that cannot be set concurrently
+  GR to;
+  CrossRefMap<GR, typename GR::Arc, int> tam(to);
+  SmartDigraph::ArcMap<typename GR::Arc> er(from);
+  CrossRefMap<GR, typename GR::Arc, SmartDigraph::Arc> ecr(to);
+
+  digraphCopy(from, to).arcMap(fam, tam).arcRef(er).arcCrossRef(ecr).
+    threadNum(thread_num).run();
+
+  check(countArcs(from) == countArcs(to), "Wrong copy.");
+  for (SmartDigraph::ArcIt it(from); it != INVALID; ++it) {
+    check(tam[er[it]] == fam[it], "Wrong copy.");
+    check(tam(fam[it]) == er[it], "Wrong copy.");
+    check(tam.count(fam[it]) == 1, "Wrong copy.");
+    check(ecr[er[it]] == it, "Wrong copy.");
+    check(ecr(it) == er[it], "Wrong copy.");
+  }
+}
+
+template <typename GR>
+void graph_copy_test(int nn = 10, int thread_num = 1) {
 
   // Build a graph
   SmartGraph from;
@@ -158,7 +196,7 @@ void graph_copy_test() {
     nodeMap(fnm, tnm).arcMap(fam, tam).edgeMap(fem, tem).
     nodeRef(nr).arcRef(ar).edgeRef(er).
     nodeCrossRef(ncr).arcCrossRef(acr).edgeCrossRef(ecr).
-    node(fn, tn).arc(fa, ta).edge(fe, te).run();
+    node(fn, tn).arc(fa, ta).edge(fe, te).threadNum(thread_num).run();
 
   check(countNodes(from) == countNodes(to), "Wrong copy.");
   check(countEdges(from) == countEdges(to), "Wrong copy.");
@@ -379,8 +417,15 @@ int main() {
   digraph_copy_test<SmartDigraph>();
   digraph_copy_test<ListDigraph>();
   digraph_copy_test<StaticDigraph>();
+  digraph_copy_test<SmartDigraph>(60, 4);
+  digraph_copy_test<ListDigraph>(60, 4);
+  digraph_copy_test<StaticDigraph>(60, 4);
+  crossref_copy_test<SmartDigraph>(300, 4);
+  crossref_copy_test<ListDigraph>(300, 4);
   graph_copy_test<SmartGraph>();
   graph_copy_test<ListGraph>();
+  graph_copy_test<SmartGraph>(60, 4);
+  graph_copy_test<ListGraph>(60, 4);
   bpgraph_copy_test<SmartBpGraph>();
   bpgraph_copy_test<ListBpGraph>();
 
@@ -212,6 +212,114 @@ void checkGraphErase() {
 }
 
 
+void checkGraphCompact() {
+  GRAPH_TYPEDEFS(ListGraph);
+
+  ListGraph G;
+  IntNodeMap label(G);
+  IntEdgeMap weight(G);
+  BoolArcMap forward(G);
+
+  std::vector<Node> nodes;
+  for (int i = 0; i < 10; ++i) {
+    nodes.push_back(G.addNode());
+    label[nodes[i]] = i;
+  }
+  std::vector<Edge> edges;
+  for (int i = 0; i < 10; ++i) {
+    for (int j = 1; j <= 3; ++j) {
+      Edge e = G.addEdge(nodes[i], nodes[(i + j) % 10]);
+      weight[e] = 10 * i + (i + j) % 10;
+      forward[G.direct(e, true)] = true;
+      forward[G.direct(e, false)] = false;
+      edges.push_back(e);
+    }
+  }
+  for (int i = 0; i < 10; i += 4) G.erase(nodes[i]);
+  for (int i = 1; i < int(edges.size()); i += 5) {
+    if (G.valid(edges[i])) G.erase(edges[i]);
+  }
+  int node_num = countNodes(G), edge_num = countEdges(G);
+
+  std::vector<Index> node_ids, edge_ids;
+  G.compact(node_ids, edge_ids);
+
+  check(G.maxNodeId() == node_num - 1 && G.maxEdgeId() == edge_num - 1 &&
+        G.maxArcId() == 2 * edge_num - 1, "Wrong compaction");
+  checkGraphNodeList(G, node_num);
+  checkGraphEdgeList(G, edge_num);
+  checkGraphArcList(G, 2 * edge_num);
+  checkGraphConEdgeList(G, edge_num);
+  checkGraphConArcList(G, 2 * edge_num);
+  checkArcDirections(G);
+  checkNodeIds(G);
+  checkEdgeIds(G);
+  checkArcIds(G);
+  checkGraphNodeMap(G);
+  checkGraphEdgeMap(G);
+  checkGraphArcMap(G);
+
+  for (int i = 0; i < 10; ++i) {
+    check((node_ids[G.id(nodes[i])] == -1) == (i % 4 == 0),
+          "Wrong node id map");
+    if (i % 4 != 0) {
+      check(label[G.nodeFromId(node_ids[G.id(nodes[i])])] == i,
+            "Wrong map value");
+    }
+  }
+  int k = 0;
+  for (EdgeIt e(G); e != INVALID; ++e, ++k) {
+    check(G.id(e) == k, "Wrong edge order");
+    check(weight[e] == 10 * label[G.u(e)] + label[G.v(e)],
+          "Wrong map value");
+    check(forward[G.direct(e, true)] && !forward[G.direct(e, false)],
+          "Wrong map value");
+  }
+  for (int i = 0; i < int(edges.size()); ++i) {
+    if (edge_ids[G.id(edges[i])] == -1) continue;
+    Edge e = G.edgeFromId(edge_ids[G.id(edges[i])]);
+    check(weight[e] == 10 * (i / 3) + (i / 3 + i % 3 + 1) % 10,
+          "Wrong edge id map");
+  }
+
+  G.erase(G.nodeFromId(0));
+  G.compact();
+  check(G.maxNodeId() == node_num - 2, "Wrong compaction");
+  checkGraphNodeList(G, node_num - 1);
+  checkGraphConEdgeList(G, countEdges(G));
+  checkNodeIds(G);
+  checkEdgeIds(G);
+  checkArcIds(G);
+
+  // The snapshots are detached
+  ListGraph H;
+  IntEdgeMap value(H);
+  IntArcMap arc_value(H);
+  Node n1 = H.addNode(), n2 = H.addNode(), n3 = H.addNode();
+  H.addEdge(n1, n2);
+  H.addEdge(n2, n3);
+  H.erase(H.addEdge(n3, n1));
+  for (EdgeIt e(H); e != INVALID; ++e) value[e] = 7;
+  for (ArcIt a(H); a != INVALID; ++a) arc_value[a] = 8;
+  ListGraph::Snapshot snapshot(H);
+  H.compact();
+  check(!snapshot.valid(), "The snapshot should be detached");
+  checkGraphEdgeList(H, 2);
+  for (EdgeIt e(H); e != INVALID; ++e) {
+    check(value[e] == 7 && arc_value[H.direct(e, true)] == 8 &&
+          arc_value[H.direct(e, false)] == 8, "Wrong map value");
+  }
+
+  snapshot.save(H);
+  H.addEdge(H.addNode(), n1);
+  H.erase(n2);
+  H.compact();
+  check(!snapshot.valid(), "The snapshot should be detached");
+  checkGraphNodeList(H, 3);
+  checkGraphEdgeList(H, 1);
+  check(value[EdgeIt(H)] == 0, "Wrong map value");
+}
+
 template <class Graph>
 void checkGraphSnapshot() {
   TEMPLATE_GRAPH_TYPEDEFS(Graph);
@@ -569,6 +677,7 @@ void checkGraphs() {
     checkGraphBuild<ListGraph>();
     checkGraphAlter<ListGraph>();
     checkGraphErase<ListGraph>();
+    checkGraphCompact();
     checkGraphSnapshot<ListGraph>();
     checkGraphValidityErase<ListGraph>();
   }
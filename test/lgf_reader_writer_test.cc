@@ -72,6 +72,9 @@ void checkDigraphReaderCompile() {
   reader.skipNodes();
   reader.skipArcs();
 
+  reader.hashLabels();
+  reader.denseLabels();
+
   reader.run();
 
   lemon::DigraphReader<Digraph> reader2(digraph, std::cin);
@@ -103,6 +106,8 @@ void checkDigraphWriterCompile() {
   writer.skipNodes();
   writer.skipArcs();
 
+  writer.threadNum(2);
+
   writer.run();
 }
 
@@ -142,6 +147,9 @@ void checkGraphReaderCompile() {
   reader.skipNodes();
   reader.skipEdges();
 
+  reader.hashLabels();
+  reader.denseLabels();
+
   reader.run();
 
   lemon::GraphReader<Graph> reader2(graph, std::cin);
@@ -178,6 +186,8 @@ void checkGraphWriterCompile() {
   writer.skipNodes();
   writer.skipEdges();
 
+  writer.threadNum(2);
+
   writer.run();
 
   lemon::GraphWriter<Graph> writer2(graph, std::cout);
@@ -229,6 +239,9 @@ void checkBpGraphReaderCompile() {
   reader.skipNodes();
   reader.skipEdges();
 
+  reader.hashLabels();
+  reader.denseLabels();
+
   reader.run();
 
   lemon::BpGraphReader<BpGraph> reader2(graph, std::cin);
@@ -274,6 +287,8 @@ void checkBpGraphWriterCompile() {
   writer.skipNodes();
   writer.skipEdges();
 
+  writer.threadNum(2);
+
   writer.run();
 
   lemon::BpGraphWriter<BpGraph> writer2(graph, std::cout);
@@ -563,6 +578,61 @@ void checkBpGraphReaderWriter() {
   check(exp_attr2 == 100, "Wrong attr value");
 }
 
+void checkParallelWriter() {
+  typedef lemon::SmartDigraph Digraph;
+  Digraph digraph;
+  for (int i = 0; i < 5000; ++i) {
+    digraph.addNode();
+  }
+  for (int i = 0; i < 20000; ++i) {
+    digraph.addArc(digraph.nodeFromId(i % 5000),
+                   digraph.nodeFromId(i * 7 % 5000));
+  }
+
+  Digraph::NodeMap<std::string> label(digraph);
+  Digraph::NodeMap<double> node_map(digraph);
+  for (Digraph::NodeIt n(digraph); n != lemon::INVALID; ++n) {
+    std::ostringstream os;
+    os << "node " << digraph.id(n);
+    label[n] = os.str();
+    node_map[n] = digraph.id(n) / 7.0;
+  }
+  Digraph::ArcMap<int> arc_map(digraph);
+  for (Digraph::ArcIt a(digraph); a != lemon::INVALID; ++a) {
+    arc_map[a] = -digraph.id(a);
+  }
+
+  std::ostringstream os1, os2;
+  lemon::digraphWriter(digraph, os1)
+    .nodeMap("label", label)
+    .nodeMap("node_map", node_map)
+    .arcMap("arc_map", arc_map)
+    .run();
+  lemon::digraphWriter(digraph, os2)
+    .nodeMap("label", label)
+    .nodeMap("node_map", node_map)
+    .arcMap("arc_map", arc_map)
+    .threadNum(4)
+    .run();
+  check(os1.str() == os2.str(), "Wrong parallel output");
+
+  Digraph exp_digraph;
+  Digraph::NodeMap<std::string> exp_label(exp_digraph);
+  Digraph::ArcMap<int> exp_arc_map(exp_digraph);
+  std::istringstream is(os2.str());
+  lemon::digraphReader(exp_digraph, is)
+    .nodeMap("label", exp_label)
+    .arcMap("arc_map", exp_arc_map)
+    .run();
+  check(lemon::countNodes(exp_digraph) == 5000, "Wrong number of nodes");
+  check(lemon::countArcs(exp_digraph) == 20000, "Wrong number of arcs");
+  for (Digraph::ArcIt a(exp_digraph); a != lemon::INVALID; ++a) {
+    Digraph::Arc b = digraph.arcFromId(-exp_arc_map[a]);
+    check(exp_label[exp_digraph.source(a)] == label[digraph.source(b)] &&
+          exp_label[exp_digraph.target(a)] == label[digraph.target(b)],
+          "Wrong arc");
+  }
+}
 
 int main() {
   { // Check digrpah
@@ -574,5 +644,8 @@ int main() {
   { // Check bipartite graph
     checkBpGraphReaderWriter();
   }
+  { // Check parallel formatting
+    checkParallelWriter();
+  }
   return 0;
 }
@@ -62,6 +62,112 @@ char test_lgf_bad2[] =
   "     label -\n"
   "0 1\n";
 
+char test_lgf_labels[] =
+  "@nodes\n"
+  "label      id\n"
+  "0          0\n"
+  "2          1\n"
+  "01         2\n"
+  "1          3\n"
+  "abc        4\n"
+  "999999999  5\n"
+  "-1         6\n"
+  "@arcs\n"
+  "                label\n"
+  "0 01            a\n"
+  "01 1            0\n"
+  "1 abc           5\n"
+  "abc 999999999   7\n"
+  "999999999 -1    1000000\n"
+  "-1 2            x\n"
+  "@attributes\n"
+  "source 01\n"
+  "target 999999999\n"
+  "arc 1000000\n";
+
+enum LabelIndexMode { MAP_LABELS, HASH_LABELS, DENSE_LABELS };
+
+template <typename Reader>
+void setLabelIndex(Reader& reader, LabelIndexMode mode)
+{
+  if (mode == HASH_LABELS) reader.hashLabels();
+  if (mode == DENSE_LABELS) reader.denseLabels();
+}
+
+void checkDigraphLabels(LabelIndexMode mode)
+{
+  ListDigraph d;
+  ListDigraph::NodeMap<int> id(d);
+  ListDigraph::ArcMap<std::string> label(d);
+  ListDigraph::Node s, t;
+  ListDigraph::Arc a;
+  std::istringstream input(test_lgf_labels);
+  DigraphReader<ListDigraph> reader(d, input);
+  setLabelIndex(reader, mode);
+  reader.
+    nodeMap("id", id).
+    arcMap("label", label).
+    node("source", s).
+    node("target", t).
+    arc("arc", a).
+    run();
+  check(countNodes(d) == 7, "There should be 7 nodes");
+  check(countArcs(d) == 6, "There should be 6 arcs");
+  check(id[s] == 2 && id[t] == 5, "Wrong nodes");
+  check(label[a] == "1000000" && id[d.source(a)] == 5 &&
+        id[d.target(a)] == 6, "Wrong arc");
+
+  const char* arc_labels[] = { "a", "0", "5", "7", "1000000", "x" };
+  for (ListDigraph::ArcIt e(d); e != INVALID; ++e) {
+    int k = id[d.source(e)] == 0 ? 0 : id[d.source(e)] - 1;
+    check(label[e] == arc_labels[k], "Wrong arc label");
+    check(id[d.target(e)] == (k == 5 ? 1 : k + 2), "Wrong arc");
+  }
+
+  // Reading the node set again into the previously constructed nodes
+  const char* node_labels[] =
+    { "0", "2", "01", "1", "abc", "999999999", "-1" };
+  ListDigraph::NodeMap<std::string> node_label(d);
+  for (ListDigraph::NodeIt n(d); n != INVALID; ++n) {
+    node_label[n] = node_labels[id[n]];
+  }
+  ListDigraph::NodeMap<int> id2(d);
+  std::istringstream input2(test_lgf_labels);
+  DigraphReader<ListDigraph> reader2(d, input2);
+  reader2.useNodes(node_label);
+  setLabelIndex(reader2, mode);
+  reader2.
+    nodeMap("id", id2).
+    node("target", t).
+    skipArcs().
+    run();
+  check(countNodes(d) == 7, "There should be 7 nodes");
+  check(id[t] == 5, "Wrong node");
+  for (ListDigraph::NodeIt n(d); n != INVALID; ++n) {
+    check(id2[n] == id[n], "Wrong node map");
+  }
+}
+
+void checkGraphLabels(LabelIndexMode mode)
+{
+  ListGraph g;
+  ListGraph::NodeMap<int> id(g);
+  ListGraph::EdgeMap<std::string> label(g);
+  ListGraph::Edge e;
+  std::istringstream input(test_lgf_labels);
+  GraphReader<ListGraph> reader(g, input);
+  setLabelIndex(reader, mode);
+  reader.
+    nodeMap("id", id).
+    edgeMap("label", label).
+    edge("arc", e).
+    run();
+  check(countNodes(g) == 7, "There should be 7 nodes");
+  check(countEdges(g) == 6, "There should be 6 edges");
+  check(label[e] == "1000000" && id[g.u(e)] == 5 && id[g.v(e)] == 6,
+        "Wrong edge");
+}
+
 
 int main()
 {
@@ -166,4 +272,9 @@ int main()
       }
     check(ok,"FormatError exception should have occured");
   }
+
+  for (int mode = MAP_LABELS; mode <= DENSE_LABELS; ++mode) {
+    checkDigraphLabels(LabelIndexMode(mode));
+    checkGraphLabels(LabelIndexMode(mode));
+  }
 }
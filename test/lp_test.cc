@@ -86,6 +86,22 @@ void lpTest(LpSolver& lp)
   check(countCols(lp)==3, "Wrong number of cols");
   lp.clear();
 
+  // Test the bulk loading functions
+  {
+    LP::Col c[3];
+    int col_start[] = {0, 0, 0, 0};
+    lp.addCols(3, 0, col_start, 0, 0, 0, 0, c);
+    LP::Row r[2];
+    int row_start[] = {0, 2, 3};
+    LP::Col row_cols[] = {c[0], c[2], c[1]};
+    double row_values[] = {1, 2, 3};
+    lp.addRows(2, 0, row_start, row_cols, row_values, 0, r);
+    check(countRows(lp)==2, "Wrong number of rows");
+    check(countCols(lp)==3, "Wrong number of cols");
+    check(lp.id(c[2])==2 && lp.id(r[1])==1, "Wrong ids");
+    lp.clear();
+  }
+
   std::vector<LP::Col> x(10);
   //  for(int i=0;i<10;i++) x.push_back(lp.addCol());
   lp.addColSet(x);
@@ -248,6 +264,31 @@ void lpTest(LpSolver& lp)
     buf << "Coeff. of p2 should be 0";
     check(const_cast<const LpSolver::Expr&>(e)[p2]==0, buf.str());
 
+    // Test the merging of the terms of the same column
+    e=p1+2*p2+p1-p2+3*p1+1;
+    check(e[p1]==5 && e[p2]==1 && *e==1, "Wrong expression");
+    int terms=0;
+    for (LP::Expr::ConstCoeffIt i(e); i!=INVALID; ++i) ++terms;
+    check(terms==2, "Wrong number of terms");
+    e.set(p2,4);
+    e+=e;
+    check(e[p1]==10 && e[p2]==8 && *e==2, "Wrong expression");
+    e.set(p1,0);
+    check(const_cast<const LpSolver::Expr&>(e)[p1]==0, "Wrong expression");
+
+    // Test the accumulation of the terms with add()
+    e=p2+p1;
+    e.add(p2,2);
+    e.add(p1,1);
+    e[p2]=5;
+    check(e[p1]==2 && e[p2]==5, "Wrong expression");
+    e.add(p1,3);
+    e.finalize();
+    terms=0;
+    for (LP::Expr::ConstCoeffIt i(e); i!=INVALID; ++i) ++terms;
+    check(terms==2 && const_cast<const LpSolver::Expr&>(e)[p1]==5,
+          "Wrong expression");
+
     //Test for clone/new
     LP* lpnew = lp.newSolver();
     LP* lpclone = lp.cloneSolver();
@@ -453,6 +494,50 @@ void rangeConstraintTest()
   check(lp.primal(x2) <= 10.001 && lp.primal(x2) >= 9.999, "Wrong value for x2");
 }
 
+template<class LP>
+void bulkLoadTest()
+{
+  LP lp;
+  // The problem of rangeConstraintTest() loaded in blocks
+  typename LP::Col x[2];
+  double obj[] = {5, 3};
+  double col_lower[] = {0, -LP::INF};
+  double col_upper[] = {LP::INF, 10};
+  int col_start[] = {0, 0, 0};
+  lp.addCols(2, obj, col_start, 0, 0, col_lower, col_upper, x);
+
+  typename LP::Row r[2];
+  int row_start[] = {0, 2, 4};
+  typename LP::Col row_cols[] = {x[0], x[1], x[0], x[1]};
+  double row_values[] = {1, -1, 2, 1};
+  double row_lower[] = {-LP::INF, 0};
+  double row_upper[] = {5, 25};
+  lp.addRows(2, row_lower, row_start, row_cols, row_values, row_upper, r);
+
+  check(lp.coeff(r[0], x[1]) == -1, "Wrong coefficient");
+  check(lp.coeff(r[1], x[0]) == 2, "Wrong coefficient");
+  check(lp.rowLowerBound(r[0]) == -LP::INF, "Wrong lower bound");
+  check(lp.rowUpperBound(r[1]) == 25, "Wrong upper bound");
+  check(lp.colUpperBound(x[1]) == 10, "Wrong upper bound");
+  check(lp.objCoeff(x[0]) == 5, "Wrong objective coefficient");
+
+  lp.max();
+  lp.solve();
+  check(lp.primalType() == LP::OPTIMAL, "Optimal solution is not found");
+  check(lp.primal() <= 67.501 && lp.primal() >= 67.499, "Wrong objective value");
+
+  // A column with terms in both rows
+  typename LP::Col y;
+  int y_start[] = {0, 2};
+  double y_values[] = {1, 1};
+  double y_obj[] = {-1};
+  lp.addCols(1, y_obj, y_start, r, y_values, 0, 0, &y);
+  check(lp.coeff(r[0], y) == 1 && lp.coeff(r[1], y) == 1,
+        "Wrong coefficient");
+  check(lp.colLowerBound(y) == -LP::INF, "Wrong lower bound");
+  check(lp.objCoeff(y) == -1, "Wrong objective coefficient");
+}
+
 int main()
 {
   LpSkeleton lp_skel;
@@ -474,6 +559,7 @@ int main()
     aTest(lp_glpk2);
     cloneTest<GlpkLp>();
     rangeConstraintTest<GlpkLp>();
+    bulkLoadTest<GlpkLp>();
   }
 #endif
 
@@ -484,6 +570,7 @@ int main()
     aTest(lp_cplex2);
     cloneTest<CplexLp>();
     rangeConstraintTest<CplexLp>();
+    bulkLoadTest<CplexLp>();
   } catch (CplexEnv::LicenseError& error) {
     check(false, error.what());
   }
@@ -496,6 +583,7 @@ int main()
     aTest(lp_soplex2);
     cloneTest<SoplexLp>();
     rangeConstraintTest<Soplex>();
+    bulkLoadTest<SoplexLp>();
   }
 #endif
 
@@ -506,6 +594,7 @@ int main()
     aTest(lp_clp2);
     cloneTest<ClpLp>();
     rangeConstraintTest<ClpLp>();
+    bulkLoadTest<ClpLp>();
   }
 #endif
 
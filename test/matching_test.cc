@@ -190,6 +190,12 @@ void checkMaxWeightedMatchingCompile()
   const_mat_test.blossomNum();
   const_mat_test.blossomSize(k);
   const_mat_test.blossomValue(k);
+
+  MaxWeightedMatching<Graph, WeightMap, Stats> stats_test(g, w);
+  stats_test.run();
+  const Stats& stats = stats_test.stats();
+  stats.counter(stats_test.AUGMENTATIONS);
+  stats.phaseTime(stats_test.MAIN_PHASE);
 }
 
 void checkMaxWeightedPerfectMatchingCompile()
@@ -492,6 +498,20 @@ int main() {
       mwm.init();
       mwm.start();
       checkWeightedMatching(graph, weight, mwm);
+
+      MaxWeightedMatching<SmartGraph, SmartGraph::EdgeMap<int>, Stats>
+        mwms(graph, weight);
+      mwms.init();
+      mwms.start();
+      check(mwms.matchingWeight() == mwm.matchingWeight(),
+            "Wrong matching weight");
+      const Stats& stats = mwms.stats();
+      check(stats.counter(mwms.DUAL_UPDATES) >=
+            stats.counter(mwms.UNMATCHED_NODES) +
+            stats.counter(mwms.AUGMENTATIONS) +
+            stats.counter(mwms.TREE_EXTENSIONS) +
+            stats.counter(mwms.BLOSSOM_SHRINKS) +
+            stats.counter(mwms.BLOSSOM_EXPANSIONS), "Wrong statistics");
     }
 
     {
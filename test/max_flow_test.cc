@@ -176,6 +176,7 @@ void checkPreflowCompile()
   typedef Preflow<Digraph, CapMap>
       ::SetElevator<Elev>
       ::SetStandardElevator<LinkedElev>
+      ::SetStats<Stats>
       ::Create PreflowType;
   PreflowType preflow_test(g, cap, n, n);
   const PreflowType& const_preflow_test = preflow_test;
@@ -188,7 +189,11 @@ void checkPreflowCompile()
   preflow_test.startSecondPhase();
   preflow_test.runMinCut();
 
+  const Stats& stats = const_preflow_test.stats();
+  long long c = stats.counter(PreflowType::PUSHES);
+
   ::lemon::ignore_unused_variable_warning(b);
+  ::lemon::ignore_unused_variable_warning(c);
 }
 
 // Checks the specific parts of EdmondsKarp's interface
@@ -274,6 +279,31 @@ void checkInitPreflow()
   check(!pre.minCut(t), "Wrong min cut (Node t).");
 }
 
+void checkPreflowStats()
+{
+  DIGRAPH_TYPEDEFS(SmartDigraph);
+
+  SmartDigraph g;
+  SmartDigraph::ArcMap<int> cap(g);
+  Node s, t;
+  std::istringstream input(test_lgf);
+  DigraphReader<SmartDigraph>(g, input)
+      .arcMap("capacity", cap)
+      .node("source", s)
+      .node("target", t)
+      .run();
+
+  Preflow<SmartDigraph>::SetStats<Stats>::Create pre(g, cap, s, t);
+  pre.run();
+  check(pre.flowValue() == 13, "Incorrect max flow value.");
+  check(pre.stats().counter(pre.PUSHES) > 0, "Wrong statistics.");
+  check(pre.stats().counter(pre.RELABELS) > 0, "Wrong statistics.");
+
+  Preflow<SmartDigraph> nostats(g, cap, s, t);
+  nostats.run();
+  check(nostats.stats().counter(nostats.PUSHES) == 0, "Wrong statistics.");
+}
+
 template <typename MF, typename SF>
 void checkMaxFlowAlg(const char *input_lgf,  typename MF::Value expected) {
   typedef SmartDigraph Digraph;
@@ -423,6 +453,7 @@ int main() {
   checkMaxFlowAlg<PType3, PreflowStartFunctions<PType3> >(test_lgf_float, 0.3);
 
   checkInitPreflow();
+  checkPreflowStats();
 
   // Check EdmondsKarp
   typedef EdmondsKarp<SmartDigraph, SmartDigraph::ArcMap<int> > EKType1;
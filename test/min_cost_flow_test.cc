@@ -465,6 +465,8 @@ int main()
                   NetworkSimplex<GR, double> >();
     checkConcept< McfClassConcept<GR, int, double>,
                   NetworkSimplex<GR, int, double> >();
+    checkConcept< McfClassConcept<GR, int, int>,
+                  NetworkSimplex<GR, int, int, Stats> >();
   }
 
   // Check the interface of CapacityScaling
@@ -493,6 +495,9 @@ int main()
     typedef CostScaling<GR>::
       SetLargeCost<double>::Create COS;
     checkConcept< McfClassConcept<GR, int, int>, COS >();
+    typedef CostScaling<GR>::
+      SetStats<Stats>::Create COSS;
+    checkConcept< McfClassConcept<GR, int, int>, COSS >();
   }
 
   // Check the interface of CycleCanceling
@@ -519,6 +524,15 @@ int main()
     runMcfLeqTests<MCF>(MCF::CANDIDATE_LIST, "NS-CL");
     runMcfGeqTests<MCF>(MCF::ALTERING_LIST,  "NS-AL", true);
     runMcfLeqTests<MCF>(MCF::ALTERING_LIST,  "NS-AL");
+
+    typedef NetworkSimplex<Digraph, int, int, Stats> MCFS;
+    runMcfGeqTests<MCFS>(MCFS::BLOCK_SEARCH, "NS-BS-STATS", true);
+    MCFS mcf(gr);
+    mcf.upperMap(u).costMap(c).supplyMap(s1);
+    mcf.run();
+    check(mcf.stats().counter(mcf.PIVOTS) > 0 &&
+          mcf.stats().counter(mcf.PIVOTS) >=
+          mcf.stats().counter(mcf.TREE_UPDATES), "Wrong statistics");
   }
 
   // Test CapacityScaling
@@ -534,6 +548,14 @@ int main()
     runMcfGeqTests<MCF>(MCF::PUSH, "COS-PR");
     runMcfGeqTests<MCF>(MCF::AUGMENT, "COS-AR");
     runMcfGeqTests<MCF>(MCF::PARTIAL_AUGMENT, "COS-PAR");
+
+    typedef CostScaling<Digraph>::SetStats<Stats>::Create MCFS;
+    runMcfGeqTests<MCFS>(MCFS::PARTIAL_AUGMENT, "COS-PAR-STATS");
+    MCFS mcf(gr);
+    mcf.upperMap(u).costMap(c).supplyMap(s1);
+    mcf.run(MCFS::PUSH);
+    check(mcf.stats().counter(mcf.PUSHES) > 0 &&
+          mcf.stats().counter(mcf.SCALING_PHASES) > 0, "Wrong statistics");
   }
 
   // Test CycleCanceling
@@ -16,12 +16,18 @@
  *
  */
 
+// Lower the thresholds of the parallel processing of large components,
+// so that checkParallelMmc() runs it on several threads
+#define LEMON_MMC_PARALLEL_COMP_SIZE 64
+#define LEMON_MMC_PARALLEL_GRAIN 16
+
 #include <iostream>
 #include <sstream>
 
 #include <lemon/smart_graph.h>
 #include <lemon/lgf_reader.h>
 #include <lemon/path.h>
+#include <lemon/random.h>
 #include <lemon/concepts/digraph.h>
 #include <lemon/concept_check.h>
 
@@ -108,8 +114,10 @@ template <typename MMC>
 void checkMmcAlg(const SmartDigraph& gr,
                  const SmartDigraph::ArcMap<int>& lm,
                  const SmartDigraph::ArcMap<int>& cm,
-                 int cost, int size) {
+                 int cost, int size, int threads = 1) {
   MMC alg(gr, lm);
+  alg.threadNum(threads);
+  check(alg.threadNum() == threads, "Wrong thread number");
   check(alg.findCycleMean(), "Wrong result");
   check(alg.cycleMean() == static_cast<double>(cost) / size,
         "Wrong cycle mean");
@@ -125,6 +133,71 @@ void checkMmcAlg(const SmartDigraph& gr,
   }
 }
 
+// Compare the serial and the parallel execution on a random digraph
+template <typename MMC>
+void checkParallelMmc(const SmartDigraph& gr,
+                      const SmartDigraph::ArcMap<int>& cost) {
+  MMC serial(gr, cost);
+  MMC parallel(gr, cost);
+  parallel.threadNum(4);
+  bool found = serial.run();
+  check(parallel.run() == found, "Wrong result");
+  if (found) {
+    check(serial.cycleMean() == parallel.cycleMean(), "Wrong cycle mean");
+    int c = 0, s = 0;
+    for (typename MMC::Path::ArcIt a(parallel.cycle()); a != INVALID; ++a) {
+      c += cost[a];
+      ++s;
+    }
+    check(c == parallel.cycleCost() && s == parallel.cycleSize(),
+          "Wrong path");
+  }
+}
+
+template <typename MMC>
+void checkParallelMmc() {
+  typedef SmartDigraph GR;
+  DIGRAPH_TYPEDEFS(GR);
+
+  // One large strongly connected component
+  {
+    GR gr;
+    IntArcMap cost(gr);
+    const int n = 300;
+    for (int i = 0; i < n; ++i) gr.addNode();
+    for (int i = 0; i < n; ++i) {
+      cost[gr.addArc(gr.nodeFromId(i), gr.nodeFromId((i + 1) % n))] =
+        rnd[1000];
+    }
+    for (int i = 0; i < 4 * n; ++i) {
+      cost[gr.addArc(gr.nodeFromId(rnd[n]), gr.nodeFromId(rnd[n]))] =
+        rnd[1000] - 200;
+    }
+    checkParallelMmc<MMC>(gr, cost);
+  }
+
+  // Many small strongly connected components
+  {
+    GR gr;
+    IntArcMap cost(gr);
+    const int k = 10, n = 200;
+    for (int i = 0; i < k * n; ++i) gr.addNode();
+    for (int c = 0; c < n; ++c) {
+      for (int i = 0; i < k; ++i) {
+        cost[gr.addArc(gr.nodeFromId(c * k + i),
+                       gr.nodeFromId(c * k + (i + 1) % k))] = rnd[1000];
+        cost[gr.addArc(gr.nodeFromId(c * k + i),
+                       gr.nodeFromId(c * k + rnd[k]))] = rnd[1000];
+      }
+      if (c > 0) {
+        cost[gr.addArc(gr.nodeFromId((c - 1) * k),
+                       gr.nodeFromId(c * k))] = -1000;
+      }
+    }
+    checkParallelMmc<MMC>(gr, cost);
+  }
+}
+
 // Class for comparing types
 template <typename T1, typename T2>
 struct IsSameType {
@@ -217,7 +290,20 @@ int main() {
       "Wrong termination cause");
     check((mmc.findCycleMean(4) == HowardMmc<GR, IntArcMap>::OPTIMAL),
       "Wrong termination cause");
+
+    // Parallel execution
+    checkMmcAlg<KarpMmc<GR, IntArcMap> >(gr, l1, c1,  6, 3, 4);
+    checkMmcAlg<KarpMmc<GR, IntArcMap> >(gr, l4, c4, -1, 1, 4);
+    checkMmcAlg<HartmannOrlinMmc<GR, IntArcMap> >(gr, l1, c1,  6, 3, 4);
+    checkMmcAlg<HartmannOrlinMmc<GR, IntArcMap> >(gr, l4, c4, -1, 1, 4);
+    checkMmcAlg<HowardMmc<GR, IntArcMap> >(gr, l1, c1,  6, 3, 4);
+    checkMmcAlg<HowardMmc<GR, IntArcMap> >(gr, l4, c4, -1, 1, 4);
   }
 
+  // Compare the serial and the parallel execution
+  checkParallelMmc<KarpMmc<SmartDigraph> >();
+  checkParallelMmc<HartmannOrlinMmc<SmartDigraph> >();
+  checkParallelMmc<HowardMmc<SmartDigraph> >();
+
   return 0;
 }
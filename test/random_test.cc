@@ -16,6 +16,8 @@
  *
  */
 
+#include <vector>
+
 #include <lemon/random.h>
 #include "test_tools.h"
 
@@ -47,6 +49,108 @@ void seq_test() {
   }
 }
 
+// Known answers of Philox4x32-10 from the reference implementation
+void philox_test() {
+  lemon::Philox32 p32(0);
+  check(p32.uinteger<unsigned int>() == 0x6627e8d5u &&
+        p32.uinteger<unsigned int>() == 0xe169c58du &&
+        p32.uinteger<unsigned int>() == 0xbc57ac4cu &&
+        p32.uinteger<unsigned int>() == 0x9b00dbd8u,
+        "Wrong random sequence");
+
+  lemon::Philox p64((0x299f31d0ull << 32) | 0xa4093822ull);
+  p64.stream((0x03707344ull << 32) | 0x13198a2eull);
+  p64.discard((0x85a308d3ull << 32) | 0x243f6a88ull);
+  p64.discard((0x85a308d3ull << 32) | 0x243f6a88ull);
+  check(p64.uinteger<unsigned long long>() ==
+        ((0x94fdccebull << 32) | 0xd16cfe09ull) &&
+        p64.uinteger<unsigned long long>() ==
+        ((0x24126ea1ull << 32) | 0x5001e420ull),
+        "Wrong random sequence");
+
+  // Streams are reproducible and different
+  lemon::Philox a(42), b(42), c(42);
+  b.stream(1);
+  c.stream(1);
+  bool differ = false;
+  for (int i = 0; i < 100; ++i) {
+    unsigned long long x = a.uinteger<unsigned long long>();
+    unsigned long long y = b.uinteger<unsigned long long>();
+    check(y == c.uinteger<unsigned long long>(), "Wrong stream");
+    if (x != y) differ = true;
+  }
+  check(differ, "Wrong stream");
+}
+
+template <typename Rnd, typename Word>
+void discard_test() {
+  for (int n = 0; n < 2000; n += 333) {
+    Rnd r1(7), r2(7);
+    r1.template uinteger<Word>();
+    r2.template uinteger<Word>();
+    for (int i = 0; i < n; ++i) r1.template uinteger<Word>();
+    r2.discard(n);
+    for (int i = 0; i < 10; ++i) {
+      check(r1.template uinteger<Word>() == r2.template uinteger<Word>(),
+            "Wrong discard");
+    }
+  }
+}
+
+template <typename Rnd, typename Word>
+void bulk_test() {
+  Rnd r1(13), r2(13);
+  std::vector<Word> words(1000);
+  r1.template uinteger<Word>();
+  r2.template uinteger<Word>();
+  r1.fillWords(&words[0], int(words.size()));
+  for (int i = 0; i < int(words.size()); ++i) {
+    check(words[i] == r2.template uinteger<Word>(), "Wrong bulk words");
+  }
+
+  std::vector<double> reals(777);
+  r1.fillReal(reals.begin(), reals.end());
+  for (int i = 0; i < int(reals.size()); ++i) {
+    check(reals[i] == r2.real(), "Wrong bulk reals");
+  }
+  std::vector<float> floats(300);
+  r1.fillReal(floats.begin(), floats.end());
+  for (int i = 0; i < int(floats.size()); ++i) {
+    check(floats[i] == r2.template real<float>(), "Wrong bulk reals");
+  }
+  r1.fillReal(reals.begin(), reals.end(), -2.0, 3.0);
+  for (int i = 0; i < int(reals.size()); ++i) {
+    check(reals[i] == r2(-2.0, 3.0) && reals[i] >= -2.0 && reals[i] < 3.0,
+          "Wrong bulk reals");
+  }
+  std::vector<int> ints(500);
+  r1.fillInteger(ints.begin(), ints.end(), 10, 1000);
+  for (int i = 0; i < int(ints.size()); ++i) {
+    check(ints[i] == r2.integer(10, 1000), "Wrong bulk integers");
+  }
+  r1.fillExponential(reals.begin(), reals.end(), 2.0);
+  for (int i = 0; i < int(reals.size()); ++i) {
+    check(reals[i] == r2.exponential(2.0), "Wrong bulk exponential");
+  }
+
+  std::vector<double> gauss(20001);
+  r1.fillGauss(gauss.begin(), gauss.end(), 5.0, 2.0);
+  double sum = 0, sqsum = 0;
+  for (int i = 0; i < int(gauss.size()); ++i) {
+    sum += gauss[i];
+    sqsum += gauss[i] * gauss[i];
+  }
+  double mean = sum / gauss.size();
+  double var = sqsum / gauss.size() - mean * mean;
+  check(mean > 4.9 && mean < 5.1 && var > 3.8 && var < 4.2,
+        "Wrong bulk gauss");
+  Rnd r3(13), r4(13);
+  std::vector<double> gauss2(gauss.size());
+  r3.fillGauss(gauss.begin(), gauss.end());
+  r4.fillGauss(gauss2.begin(), gauss2.end());
+  check(gauss == gauss2, "Wrong bulk gauss");
+}
+
 
 int main()
 {
@@ -64,5 +168,16 @@ int main()
                   (sizeof(seed_array) / sizeof(seed_array[0])));
 
   seq_test();
+  philox_test();
+
+  discard_test<lemon::Random32, unsigned int>();
+  discard_test<lemon::Random64, unsigned long long>();
+  discard_test<lemon::Philox32, unsigned int>();
+  discard_test<lemon::Philox, unsigned long long>();
+
+  bulk_test<lemon::Random32, unsigned int>();
+  bulk_test<lemon::Random64, unsigned long long>();
+  bulk_test<lemon::Philox32, unsigned int>();
+  bulk_test<lemon::Philox, unsigned long long>();
   return 0;
 }
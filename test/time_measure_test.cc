@@ -17,8 +17,11 @@
  */
 
 #include <lemon/time_measure.h>
+#include <lemon/profiler.h>
 #include <lemon/concept_check.h>
 
+#include "test_tools.h"
+
 using namespace lemon;
 
 void f()
@@ -39,6 +42,78 @@ void g()
     }
 }
 
+void h()
+{
+  volatile double d=0;
+  for(int i=0;i<1000000;i++)
+    d+=0.1;
+}
+
+void checkClock()
+{
+  TimeStamp p, t;
+  p.stamp(TimeStamp::PROCESS_TIME);
+  t.stamp(TimeStamp::THREAD_TIME);
+  h();
+  p=p.ellapsed();
+  TimeStamp e;
+  e.stamp(TimeStamp::THREAD_TIME);
+  t=e-t;
+  check(t.cUserTime()==0 && t.cSystemTime()==0, "Wrong thread time");
+  check(p.userTime()+p.systemTime()>=0 && t.userTime()>=0,
+        "Wrong cpu time");
+  check(p.realTime()>0, "Wrong real time");
+
+  TimeStamp::clock(TimeStamp::THREAD_TIME);
+  check(TimeStamp::clock()==TimeStamp::THREAD_TIME, "Wrong clock");
+  Timer T;
+  h();
+  check(T.realTime()>0, "Wrong timer");
+  TimeStamp::clock(TimeStamp::PROCESS_TIME);
+}
+
+void checkProfiler()
+{
+  for(int c=0;c<2;c++) {
+    Profiler prof(c==1);
+    for(int i=0;i<3;i++) {
+      Profiler::Region r(prof,"outer");
+      h();
+      {
+        Profiler::Region q(prof,"inner");
+        h();
+      }
+    }
+    check(prof.count("outer")==3 && prof.count("inner")==3 &&
+          prof.count("none")==0, "Wrong profiler");
+    check(prof.time("outer").realTime()>=prof.time("inner").realTime(),
+          "Wrong profiler");
+    check(prof.regions().size()==2 && prof.regions()[0]=="outer",
+          "Wrong profiler");
+    PerfCounters pc;
+    if(c==1 && pc.available(PerfCounters::INSTRUCTIONS))
+      check(prof.value("outer",PerfCounters::INSTRUCTIONS)>=
+            prof.value("inner",PerfCounters::INSTRUCTIONS), "Wrong profiler");
+    prof.report(std::cout);
+    prof.reset();
+    check(prof.count("outer")==0, "Wrong profiler");
+  }
+
+  PerfCounters pc(true);
+  h();
+  pc.stop();
+  check(pc.running()==false, "Wrong counters");
+  if(pc.available(PerfCounters::INSTRUCTIONS)) {
+    long long v=pc.value(PerfCounters::INSTRUCTIONS);
+    check(v>0, "Wrong counters");
+    h();
+    check(pc.value(PerfCounters::INSTRUCTIONS)==v, "Wrong counters");
+    pc.reset();
+    check(pc.value(PerfCounters::INSTRUCTIONS)==0, "Wrong counters");
+  }
+  else check(pc.value(PerfCounters::INSTRUCTIONS)==0, "Wrong counters");
+}
+
 int main()
 {
   Timer T;
@@ -56,5 +131,8 @@ int main()
   std::cout << t << " (" << n << " tests)\n";
   std::cout << "Total: " << full << "\n";
 
+  checkClock();
+  checkProfiler();
+
   return 0;
 }
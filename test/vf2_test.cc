@@ -24,6 +24,7 @@
 
 #include <test/test_tools.h>
 #include <sstream>
+#include <vector>
 
 using namespace lemon;
 
@@ -267,7 +268,20 @@ void checkVf2ppCompile() {
         concepts::ReadMap<typename G2::Node, int> >
     myVf2pp(g,h,r,c1,c2);
   myVf2pp.find();
+  myVf2pp.threadNum(2);
+  ::lemon::ignore_unused_variable_warning(myVf2pp.threadNum());
+  succ = myVf2pp.findFirst();
+  long long cnt = myVf2pp.count();
+  ::lemon::ignore_unused_variable_warning(cnt);
 
+  Vf2ppTarget<G2,concepts::ReadMap<typename G2::Node, int> > target(h,c2);
+  Vf2pp<G1,G2,concepts::ReadWriteMap<typename G1::Node, typename G2::Node>,
+        concepts::ReadMap<typename G1::Node, int>,
+        concepts::ReadMap<typename G2::Node, int> >
+    myVf2pp_t(g,target,r,c1);
+  myVf2pp_t.find();
+
+  succ = vf2pp(g,h).threadNum(2).run();
   succ = vf2pp(g,h).nodeLabels(c1,c2).mapping(r).run();
   succ = vf2pp(g,h).nodeLabels(c1,c2).mapping(r).run();
 
@@ -407,8 +421,113 @@ void checkSub(const G1 &g1, const G2 &g2, const L1 &l1, const L2 &l2, bool expec
   check(checkSub(g1,g2,l1,l2,vf2pp(g1,g2)) == expected, msg);
 }
 
+struct MappingCounter {
+  std::vector<long long> counts;
+  MappingCounter(int threads) : counts(threads, 0) {}
+  template<class M>
+  void operator()(int thread, const M &) {
+    ++counts[thread];
+  }
+};
+
+template<class G1, class G2, class Labels1, class Labels2>
+void checkParallelVf2pp(const G1 &g1, const G2 &g2,
+                        Labels1 &l1, Labels2 &l2, MappingType type) {
+  typedef typename G1::template NodeMap<typename G2::Node> Mapping;
+  Vf2ppTarget<G2,Labels2> target(g2,l2);
+
+  // The serial sequence of mappings
+  Mapping m(g1);
+  Vf2pp<G1,G2,Mapping,Labels1,Labels2> serial(g1,g2,m,l1,l2);
+  serial.mappingType(type);
+  std::vector<std::vector<int> > seq;
+  while(serial.find()) {
+    std::vector<int> ids;
+    for(typename G1::NodeIt n(g1); n!=INVALID; ++n)
+      ids.push_back(g2.id(m[n]));
+    seq.push_back(ids);
+  }
+
+  for(int t = 1; t <= 8; ++t) {
+    Mapping pm(g1);
+    Vf2pp<G1,G2,Mapping,Labels1,Labels2> par1(g1,g2,pm,l1,l2);
+    Vf2pp<G1,G2,Mapping,Labels1,Labels2> par2(g1,target,pm,l1);
+    // Without and with the prepared target
+    Vf2pp<G1,G2,Mapping,Labels1,Labels2> &par = t <= 4 ? par1 : par2;
+    par.mappingType(type);
+    par.threadNum(t);
+    check(par.count() == static_cast<long long>(seq.size()),
+          "Wrong number of mappings");
+    MappingCounter mc(t);
+    check(par.findAll(mc) == static_cast<long long>(seq.size()),
+          "Wrong number of mappings");
+    long long sum = 0;
+    for(int i = 0; i < t; ++i) sum += mc.counts[i];
+    check(sum == static_cast<long long>(seq.size()),
+          "Wrong number of mappings");
+
+    // findFirst() and the continuation by find() give the serial sequence
+    check(par.findFirst() == !seq.empty(), "Wrong result of findFirst()");
+    for(int i = 0; i < static_cast<int>(seq.size()); ++i) {
+      check(i == 0 || par.find(), "Missing mapping");
+      std::vector<int> ids;
+      for(typename G1::NodeIt n(g1); n!=INVALID; ++n)
+        ids.push_back(g2.id(pm[n]));
+      check(ids == seq[i], "Wrong mapping");
+    }
+    check(!par.find(), "Too many mappings");
+  }
+  check(vf2pp(g1,g2).nodeLabels(l1,l2).mappingType(type).threadNum(3)
+        .count() == static_cast<int>(seq.size()),
+        "Wrong number of mappings");
+  check(vf2pp(g1,g2).nodeLabels(l1,l2).mappingType(type).threadNum(3)
+        .run() == !seq.empty(), "Wrong result");
+}
+
+template<class G1, class G2>
+void checkParallelVf2pp(const G1 &g1, const G2 &g2, MappingType type) {
+  typename G1::template NodeMap<int> l1(g1,0);
+  typename G2::template NodeMap<int> l2(g2,0);
+  checkParallelVf2pp(g1,g2,l1,l2,type);
+}
+
+void checkParallelVf2pp() {
+  SmartGraph two_edges;
+  SmartGraph::Node a = two_edges.addNode(), b = two_edges.addNode(),
+    c = two_edges.addNode(), d = two_edges.addNode();
+  two_edges.addEdge(a,b);
+  two_edges.addEdge(c,d);
+  SmartGraph single;
+  single.addNode();
+
+  MappingType types[] = { SUBGRAPH, INDUCED, ISOMORPH };
+  for(int i = 0; i < 3; ++i) {
+    checkParallelVf2pp(c5,petersen,types[i]);
+    checkParallelVf2pp(p10,petersen,types[i]);
+    checkParallelVf2pp(petersen,petersen,types[i]);
+    checkParallelVf2pp(c10,c10,types[i]);
+    checkParallelVf2pp(c7,petersen,types[i]);
+    checkParallelVf2pp(two_edges,petersen,types[i]);
+    checkParallelVf2pp(single,c5,types[i]);
+    checkParallelVf2pp(c5,petersen,c5_col,petersen_col1,types[i]);
+    checkParallelVf2pp(c5,petersen,c5_col,petersen_col2,types[i]);
+  }
+
+  Vf2ppTarget<SmartGraph> target(petersen,petersen_col2);
+  check(target.maxLabel() == 5 && target.labelCount(1) == 2 &&
+        target.labelCount(0) == 0, "Wrong label counts");
+  std::vector<SmartGraph::Node> cands;
+  target.candidates(1,3,cands);
+  // In the order of NodeIt
+  check(cands.size() == 2 && cands[0] == petersen.nodeFromId(5) &&
+        cands[1] == petersen.nodeFromId(0), "Wrong candidates");
+  target.candidates(1,4,cands);
+  check(cands.empty(), "Wrong candidates");
+}
+
 int main() {
   make_graphs();
+  checkParallelVf2pp();
 
   checkSub(c5,petersen,true,
       "There should exist a C5->Petersen mapping.");
@@ -36,6 +36,7 @@
 #include <lemon/smart_graph.h>
 #include <lemon/dimacs.h>
 #include <lemon/lgf_writer.h>
+#include <lemon/compressed_stream.h>
 
 #include <lemon/arg_parser.h>
 #include <lemon/error.h>
@@ -60,22 +61,24 @@ int main(int argc, const char *argv[]) {
   ArgParser ap(argc, argv);
   ap.other("[INFILE [OUTFILE]]",
            "If either the INFILE or OUTFILE file is missing the standard\n"
-           "     input/output will be used instead.")
+           "     input/output will be used instead. Compressed input is\n"
+           "     detected automatically, and OUTFILE is compressed if its\n"
+           "     name ends with '.gz' or '.zst'.")
     .run();
 
-  ifstream input;
-  ofstream output;
+  CompressedIstream input;
+  CompressedOstream output;
 
   switch(ap.files().size())
     {
     case 2:
-      output.open(ap.files()[1].c_str());
+      output.open(ap.files()[1]);
       if (!output) {
         throw IoError("Cannot open the file for writing", ap.files()[1]);
       }
       // fall through
     case 1:
-      input.open(ap.files()[0].c_str());
+      input.open(ap.files()[0]);
       if (!input) {
         throw IoError("File cannot be found", ap.files()[0]);
       }
@@ -86,7 +89,11 @@ int main(int argc, const char *argv[]) {
       cerr << ap.commandName() << ": too many arguments\n";
       return 1;
   }
-  istream& is = (ap.files().size()<1 ? cin : input);
+  if (ap.files().size()<1) input.open(cin);
+  input.threadNum(0);
+  // Report the errors of truncated or corrupted compressed input
+  input.exceptions(std::ios::badbit);
+  istream& is = input;
   ostream& os = (ap.files().size()<2 ? cout : output);
 
   DimacsDescriptor desc = dimacsType(is);